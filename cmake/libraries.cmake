@@ -244,14 +244,6 @@ FetchContent_Declare(
     GIT_PROGRESS   TRUE
 )
 
-FetchContent_Declare(
-    taskflow
-    GIT_REPOSITORY https://github.com/taskflow/taskflow.git
-    GIT_TAG        v3.6.0
-    GIT_SHALLOW    TRUE
-    GIT_PROGRESS   TRUE
-)
-
 FetchContent_Declare(
     tracy
     GIT_REPOSITORY https://github.com/wolfpld/tracy.git
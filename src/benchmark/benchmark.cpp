@@ -0,0 +1,77 @@
+#include "benchmark.hpp"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+// Counting replacements of the global allocation functions. Over-aligned
+// allocations use the default implementation and are not counted.
+namespace {
+
+std::atomic<uint64_t> s_allocation_count{0};
+
+} // anonymous namespace
+
+auto operator new(const std::size_t size) -> void*
+{
+    s_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    void* const pointer = std::malloc((size > 0) ? size : 1);
+    if (pointer == nullptr) {
+        throw std::bad_alloc{};
+    }
+    return pointer;
+}
+
+void operator delete(void* const pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* const pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace benchmark {
+
+namespace {
+
+volatile uint64_t s_sink{0};
+
+} // anonymous namespace
+
+auto get_allocation_count() -> uint64_t
+{
+    return s_allocation_count.load(std::memory_order_relaxed);
+}
+
+void keep(const uint64_t value)
+{
+    s_sink = s_sink + value;
+}
+
+auto get_thread_counts() -> std::vector<std::size_t>
+{
+    const std::size_t hardware_concurrency = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::size_t> result;
+    for (std::size_t count = 1; count < hardware_concurrency; count *= 2) {
+        result.push_back(count);
+    }
+    result.push_back(hardware_concurrency);
+    return result;
+}
+
+void print_header(const std::string_view title)
+{
+    fmt::print("\n{}\n", title);
+}
+
+void print_timing(const std::string_view label, const Timing& timing)
+{
+    fmt::print("  {:<48} min {:>10.3f} ms  median {:>10.3f} ms\n", label, timing.min_ms, timing.median_ms);
+}
+
+} // namespace benchmark
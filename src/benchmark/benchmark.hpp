@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace benchmark {
+
+struct Timing
+{
+    double min_ms   {0.0};
+    double median_ms{0.0};
+};
+
+// Runs function repeat_count times and returns the fastest and the median run
+template <typename Function>
+[[nodiscard]] auto measure(const int repeat_count, Function&& function) -> Timing
+{
+    std::vector<double> samples;
+    samples.reserve(static_cast<std::size_t>(repeat_count));
+    for (int i = 0; i < repeat_count; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return Timing{
+        .min_ms    = samples.front(),
+        .median_ms = samples[samples.size() / 2]
+    };
+}
+
+// Like measure(), but calls setup() before each run and passes its result
+// to function. Only function is timed.
+template <typename Setup, typename Function>
+[[nodiscard]] auto measure_with_setup(const int repeat_count, Setup&& setup, Function&& function) -> Timing
+{
+    std::vector<double> samples;
+    samples.reserve(static_cast<std::size_t>(repeat_count));
+    for (int i = 0; i < repeat_count; ++i) {
+        auto       state = setup();
+        const auto start = std::chrono::steady_clock::now();
+        function(state);
+        const auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return Timing{
+        .min_ms    = samples.front(),
+        .median_ms = samples[samples.size() / 2]
+    };
+}
+
+// 1, 2, 4, ... up to hardware concurrency, always including hardware concurrency
+[[nodiscard]] auto get_thread_counts() -> std::vector<std::size_t>;
+
+void print_header(std::string_view title);
+void print_timing(std::string_view label, const Timing& timing);
+
+// Number of global operator new calls so far
+[[nodiscard]] auto get_allocation_count() -> uint64_t;
+
+// Prevents the optimizer from removing a computed value
+void keep(uint64_t value);
+
+void run_geometry_attributes_benchmark();
+void run_geometry_edges_benchmark     ();
+void run_geometry_iteration_benchmark ();
+void run_parallel_for_benchmark       ();
+void run_physics_benchmark            ();
+void run_task_allocations_benchmark   ();
+void run_thread_pool_benchmark        ();
+
+} // namespace benchmark
@@ -0,0 +1,92 @@
+#include "benchmark.hpp"
+#include "geometry_grid.hpp"
+
+#include "erhe_concurrency/thread_pool.hpp"
+#include "erhe_geometry/geometry.hpp"
+#include "erhe_geometry/property_map.hpp"
+
+#include <fmt/format.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+namespace benchmark {
+
+namespace {
+
+constexpr int      c_repeat_count     = 5;
+constexpr uint32_t c_grid_size        = 512;
+constexpr uint32_t c_map_key_count    = 1024 * 1024;
+constexpr int      c_map_repeat_count = 9;
+
+} // anonymous namespace
+
+// Attribute heavy geometry kernels and Property_map access patterns
+void run_geometry_attributes_benchmark()
+{
+    using erhe::geometry::Geometry;
+
+    print_header(fmt::format("Geometry attributes: {} x {} quad grid", c_grid_size, c_grid_size));
+
+    print_timing(
+        "compute_point_normals()",
+        measure_with_setup(
+            c_repeat_count,
+            []() { return make_grid_geometry(c_grid_size); },
+            [](Geometry& geometry) { geometry.compute_point_normals(erhe::geometry::c_point_normals); }
+        )
+    );
+    erhe::concurrency::Thread_pool pool{std::max(1u, std::thread::hardware_concurrency())};
+    for (erhe::concurrency::Thread_pool* thread_pool : { static_cast<erhe::concurrency::Thread_pool*>(nullptr), &pool }) {
+        print_timing(
+            fmt::format("compute_tangents() {}", (thread_pool != nullptr) ? "pool" : "serial"),
+            measure_with_setup(
+                c_repeat_count,
+                []() {
+                    Geometry geometry = make_grid_geometry(c_grid_size);
+                    geometry.compute_point_normals(erhe::geometry::c_point_normals);
+                    return geometry;
+                },
+                [thread_pool](Geometry& geometry) {
+                    geometry.compute_tangents(
+                        erhe::geometry::Tangent_options{
+                            .corner_tangents   = true,
+                            .corner_bitangents = true
+                        },
+                        thread_pool
+                    );
+                }
+            )
+        );
+    }
+
+    print_header(fmt::format("Property_map<uint32_t, vec3>: {} keys", c_map_key_count));
+    erhe::geometry::Property_map<uint32_t, glm::vec3> map{erhe::geometry::c_point_normals};
+    for (uint32_t key = 0; key < c_map_key_count; ++key) {
+        map.put(key, glm::vec3{static_cast<float>(key), 1.0f, 0.0f});
+    }
+    glm::vec3 sum{0.0f};
+    print_timing(
+        "has() + get() loop",
+        measure(c_map_repeat_count, [&]() {
+            for (uint32_t key = 0; key < c_map_key_count; ++key) {
+                if (map.has(key)) {
+                    sum += map.get(key);
+                }
+            }
+        })
+    );
+    print_timing(
+        "get_span() loop",
+        measure(c_map_repeat_count, [&]() {
+            for (const glm::vec3& value : map.get_span(c_map_key_count)) {
+                sum += value;
+            }
+        })
+    );
+    keep(static_cast<uint64_t>(sum.x + sum.y));
+}
+
+} // namespace benchmark
@@ -0,0 +1,48 @@
+#include "benchmark.hpp"
+#include "geometry_grid.hpp"
+
+#include "erhe_concurrency/thread_pool.hpp"
+#include "erhe_geometry/geometry.hpp"
+
+#include <fmt/format.h>
+
+#include <thread>
+
+namespace benchmark {
+
+namespace {
+
+constexpr int c_repeat_count = 5;
+
+} // anonymous namespace
+
+// Geometry::build_edges() on open grids. The grid boundary makes
+// build_edges() take its second pass, which used to scan all edges for
+// each corner. Time per polygon stays flat when edge construction is linear.
+void run_geometry_edges_benchmark()
+{
+    print_header("Geometry::build_edges(), open quad grids");
+
+    erhe::concurrency::Thread_pool pool{std::max(1u, std::thread::hardware_concurrency())};
+    for (const uint32_t size : { 100u, 316u, 1000u }) {
+        const std::size_t polygon_count = static_cast<std::size_t>(size) * size;
+        for (erhe::concurrency::Thread_pool* thread_pool : { static_cast<erhe::concurrency::Thread_pool*>(nullptr), &pool }) {
+            const Timing timing = measure_with_setup(
+                c_repeat_count,
+                [size]() { return make_grid_geometry(size); },
+                [thread_pool](erhe::geometry::Geometry& geometry) { geometry.build_edges(false, thread_pool); }
+            );
+            print_timing(
+                fmt::format(
+                    "{:>8} polygons {} {:>6.1f} ns / polygon",
+                    polygon_count,
+                    (thread_pool != nullptr) ? "pool  " : "serial",
+                    timing.median_ms * 1'000'000.0 / static_cast<double>(polygon_count)
+                ),
+                timing
+            );
+        }
+    }
+}
+
+} // namespace benchmark
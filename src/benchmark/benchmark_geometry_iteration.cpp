@@ -0,0 +1,189 @@
+#include "benchmark.hpp"
+#include "geometry_grid.hpp"
+
+#include "erhe_geometry/geometry.hpp"
+#include "erhe_graphics/vertex_attribute.hpp"
+#include "erhe_graphics/vertex_format.hpp"
+#include "erhe_primitive/buffer_info.hpp"
+#include "erhe_primitive/buffer_sink.hpp"
+#include "erhe_primitive/buffer_writer.hpp"
+#include "erhe_primitive/build_info.hpp"
+#include "erhe_primitive/primitive_builder.hpp"
+
+#include <fmt/format.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace benchmark {
+
+namespace {
+
+using erhe::geometry::Geometry;
+using erhe::geometry::Polygon;
+
+constexpr int      c_repeat_count = 5;
+constexpr uint32_t c_grid_size    = 512;
+
+// Keeps built vertex and index data in CPU memory
+class Cpu_buffer_sink
+    : public erhe::primitive::Buffer_sink
+{
+public:
+    auto allocate_vertex_buffer(const std::size_t vertex_count, const std::size_t vertex_element_size) -> erhe::primitive::Buffer_range override
+    {
+        return allocate(m_vertex_data, vertex_count, vertex_element_size);
+    }
+
+    auto allocate_index_buffer(const std::size_t index_count, const std::size_t index_element_size) -> erhe::primitive::Buffer_range override
+    {
+        return allocate(m_index_data, index_count, index_element_size);
+    }
+
+    void enqueue_index_data(const std::size_t offset, std::vector<uint8_t>&& data) const override
+    {
+        std::memcpy(m_index_data.data() + offset, data.data(), data.size());
+    }
+
+    void enqueue_vertex_data(const std::size_t offset, std::vector<uint8_t>&& data) const override
+    {
+        std::memcpy(m_vertex_data.data() + offset, data.data(), data.size());
+    }
+
+    void buffer_ready(erhe::primitive::Vertex_buffer_writer& writer) const override
+    {
+        std::memcpy(m_vertex_data.data() + writer.start_offset(), writer.vertex_data.data(), writer.vertex_data.size());
+    }
+
+    void buffer_ready(erhe::primitive::Index_buffer_writer& writer) const override
+    {
+        std::memcpy(m_index_data.data() + writer.start_offset(), writer.index_data.data(), writer.index_data.size());
+    }
+
+    void reset()
+    {
+        m_vertex_data.clear();
+        m_index_data.clear();
+    }
+
+private:
+    [[nodiscard]] static auto allocate(
+        std::vector<uint8_t>& data,
+        const std::size_t     count,
+        const std::size_t     element_size
+    ) -> erhe::primitive::Buffer_range
+    {
+        const std::size_t byte_offset = data.size();
+        data.resize(byte_offset + count * element_size);
+        return erhe::primitive::Buffer_range{
+            .count        = count,
+            .element_size = element_size,
+            .byte_offset  = byte_offset
+        };
+    }
+
+    mutable std::vector<uint8_t> m_vertex_data;
+    mutable std::vector<uint8_t> m_index_data;
+};
+
+// Newell polygon normals summed over the geometry, same loop structure as
+// compute_polygon_normals(). With type_erased, callbacks are passed as
+// std::function, which is what every caller did before the template
+// overloads were added.
+template <bool type_erased>
+[[nodiscard]] auto sum_polygon_normals(const Geometry& geometry) -> glm::vec3
+{
+    using Polygon_function = std::function<void(Geometry::Polygon_context_const&)>;
+    using Corner_function  = std::function<void(Polygon::Polygon_corner_neighborhood_context_const&)>;
+
+    const auto* const point_locations = geometry.point_attributes().find<glm::vec3>(erhe::geometry::c_point_locations);
+    glm::vec3 sum{0.0f};
+    const auto polygon_callback = [&](auto& i) {
+        glm::vec3 normal{0.0f};
+        const auto corner_callback = [&](auto& j) {
+            const glm::vec3 a = point_locations->get(j.corner.point_id);
+            const glm::vec3 b = point_locations->get(j.next_corner.point_id);
+            normal += glm::vec3{(a.y - b.y) * (a.z + b.z), (a.z - b.z) * (a.x + b.x), (a.x - b.x) * (a.y + b.y)};
+        };
+        if constexpr (type_erased) {
+            i.polygon.for_each_corner_neighborhood_const(geometry, Corner_function{corner_callback});
+        } else {
+            i.polygon.for_each_corner_neighborhood_const(geometry, corner_callback);
+        }
+        sum += normal;
+    };
+    if constexpr (type_erased) {
+        geometry.for_each_polygon_const(Polygon_function{polygon_callback});
+    } else {
+        geometry.for_each_polygon_const(polygon_callback);
+    }
+    return sum;
+}
+
+} // anonymous namespace
+
+// Geometry loops through the std::function overloads and through the
+// template overloads, and the internal loops that were migrated to the
+// template overloads
+void run_geometry_iteration_benchmark()
+{
+    print_header(fmt::format("Geometry iteration: {} x {} quad grid", c_grid_size, c_grid_size));
+
+    Geometry  geometry = make_grid_geometry(c_grid_size);
+    glm::vec3 sum{0.0f};
+    print_timing(
+        "polygon normal loop, std::function overloads",
+        measure(c_repeat_count, [&]() { sum += sum_polygon_normals<true>(geometry); })
+    );
+    print_timing(
+        "polygon normal loop, template overloads",
+        measure(c_repeat_count, [&]() { sum += sum_polygon_normals<false>(geometry); })
+    );
+    keep(static_cast<uint64_t>(sum.x + sum.y + sum.z));
+
+    print_timing(
+        "build_edges()",
+        measure_with_setup(
+            c_repeat_count,
+            []() { return make_grid_geometry(c_grid_size); },
+            [](Geometry& fresh_geometry) { fresh_geometry.build_edges(); }
+        )
+    );
+    print_timing(
+        "compute_polygon_normals()",
+        measure_with_setup(
+            c_repeat_count,
+            []() { return make_grid_geometry(c_grid_size); },
+            [](Geometry& fresh_geometry) { fresh_geometry.compute_polygon_normals(); }
+        )
+    );
+
+    geometry.compute_point_normals(erhe::geometry::c_point_normals);
+    const erhe::graphics::Vertex_format vertex_format{
+        erhe::graphics::Vertex_attribute::position_float3 (),
+        erhe::graphics::Vertex_attribute::normal0_float3  (),
+        erhe::graphics::Vertex_attribute::texcoord0_float2()
+    };
+    Cpu_buffer_sink buffer_sink;
+    const erhe::primitive::Build_info build_info{
+        .primitive_types = { .fill_triangles = true },
+        .buffer_info     = {
+            .index_type    = gl::Draw_elements_type::unsigned_int,
+            .vertex_format = vertex_format,
+            .buffer_sink   = buffer_sink
+        }
+    };
+    print_timing(
+        "make_geometry_mesh(), fill triangles",
+        measure(c_repeat_count, [&]() {
+            buffer_sink.reset();
+            const erhe::primitive::Geometry_mesh geometry_mesh = erhe::primitive::make_geometry_mesh(geometry, build_info);
+            keep(geometry_mesh.triangle_fill_indices.index_count);
+        })
+    );
+}
+
+} // namespace benchmark
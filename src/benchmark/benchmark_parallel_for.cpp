@@ -0,0 +1,88 @@
+#include "benchmark.hpp"
+
+#include "erhe_concurrency/parallel_for.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
+
+#include <fmt/format.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace benchmark {
+
+namespace {
+
+using erhe::concurrency::Thread_pool;
+
+constexpr int         c_repeat_count  = 9;
+constexpr std::size_t c_element_count = 4 * 1024 * 1024;
+
+[[nodiscard]] auto transform(const float value) -> float
+{
+    return std::sqrt(value * value + 1.0f) * 0.5f;
+}
+
+} // anonymous namespace
+
+// Scaling of parallel_for() and parallel_reduce() from one thread up to
+// hardware concurrency, compared to a plain serial loop
+void run_parallel_for_benchmark()
+{
+    print_header(fmt::format("parallel_for / parallel_reduce: {} elements", c_element_count));
+
+    std::vector<float> input(c_element_count);
+    std::vector<float> output(c_element_count);
+    for (std::size_t i = 0; i < c_element_count; ++i) {
+        input[i] = static_cast<float>(i % 1024);
+    }
+
+    print_timing(
+        "for    serial loop",
+        measure(c_repeat_count, [&]() {
+            for (std::size_t i = 0; i < c_element_count; ++i) {
+                output[i] = transform(input[i]);
+            }
+        })
+    );
+    double serial_sum = 0.0;
+    print_timing(
+        "reduce serial loop",
+        measure(c_repeat_count, [&]() {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < c_element_count; ++i) {
+                sum += static_cast<double>(transform(input[i]));
+            }
+            serial_sum = sum;
+        })
+    );
+    keep(static_cast<uint64_t>(serial_sum));
+
+    for (const std::size_t thread_count : get_thread_counts()) {
+        Thread_pool pool{thread_count};
+        print_timing(
+            fmt::format("for    {:2} threads", thread_count),
+            measure(c_repeat_count, [&]() {
+                erhe::concurrency::parallel_for(
+                    pool, std::size_t{0}, c_element_count,
+                    [&](const std::size_t i) { output[i] = transform(input[i]); }
+                );
+            })
+        );
+        double sum = 0.0;
+        print_timing(
+            fmt::format("reduce {:2} threads", thread_count),
+            measure(c_repeat_count, [&]() {
+                sum = erhe::concurrency::parallel_reduce(
+                    pool, std::size_t{0}, c_element_count, 0.0,
+                    [&](const std::size_t i) { return static_cast<double>(transform(input[i])); },
+                    [](const double a, const double b) { return a + b; }
+                );
+            })
+        );
+        keep(static_cast<uint64_t>(sum));
+    }
+    keep(static_cast<uint64_t>(output[c_element_count / 2]));
+}
+
+} // namespace benchmark
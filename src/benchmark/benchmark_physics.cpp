@@ -0,0 +1,163 @@
+#include "benchmark.hpp"
+
+#include "erhe_concurrency/concurrent_queue.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
+#include "erhe_physics/icollision_shape.hpp"
+#include "erhe_physics/irigid_body.hpp"
+#include "erhe_physics/iworld.hpp"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace benchmark {
+
+namespace {
+
+using erhe::concurrency::Concurrent_queue;
+using erhe::concurrency::Priority;
+using erhe::concurrency::Thread_pool;
+
+constexpr int      c_box_grid_size     = 12;  // 12 x 12 x 12 falling boxes
+constexpr int      c_warmup_step_count = 30;
+constexpr int      c_step_count        = 120;
+constexpr double   c_time_step         = 1.0 / 60.0;
+constexpr uint32_t c_load_task_batch   = 256;
+constexpr uint32_t c_load_task_work    = 20'000;
+
+// Keeps a thread pool busy with unrelated tasks, like the editor does
+// while physics is stepping
+class Background_load
+{
+public:
+    explicit Background_load(Thread_pool& pool)
+        : m_queue {pool, "background load", Priority::LOW}
+        , m_thread{[this]() { run(); }}
+    {
+    }
+
+    ~Background_load() noexcept
+    {
+        m_stop = true;
+        m_thread.join();
+    }
+
+private:
+    void run()
+    {
+        while (!m_stop) {
+            for (uint32_t i = 0; i < c_load_task_batch; ++i) {
+                m_queue.enqueue([this, i]() {
+                    uint32_t seed = i;
+                    for (uint32_t j = 0; j < c_load_task_work; ++j) {
+                        seed = seed * 1664525u + 1013904223u;
+                    }
+                    m_sink.fetch_add(seed, std::memory_order_relaxed);
+                });
+            }
+            m_queue.wait();
+        }
+        keep(m_sink.load());
+    }
+
+    Concurrent_queue      m_queue;
+    std::atomic<bool>     m_stop{false};
+    std::atomic<uint32_t> m_sink{0};
+    std::thread           m_thread;
+};
+
+// Static floor and a grid of dynamic boxes falling onto it and each other
+void populate(
+    erhe::physics::IWorld&                                   world,
+    std::vector<std::shared_ptr<erhe::physics::IRigid_body>>& bodies
+)
+{
+    using namespace erhe::physics;
+
+    world.set_gravity(glm::vec3{0.0f, -9.81f, 0.0f});
+
+    IRigid_body_create_info floor_create_info{
+        .collision_shape = ICollision_shape::create_box_shape_shared(glm::vec3{100.0f, 1.0f, 100.0f}),
+        .debug_label     = "floor",
+        .motion_mode     = Motion_mode::e_static
+    };
+    bodies.push_back(world.create_rigid_body_shared(floor_create_info, glm::vec3{0.0f, -1.0f, 0.0f}));
+    world.add_rigid_body(bodies.back().get());
+
+    const auto box_shape = ICollision_shape::create_box_shape_shared(glm::vec3{0.5f});
+    for (int x = 0; x < c_box_grid_size; ++x) {
+        for (int y = 0; y < c_box_grid_size; ++y) {
+            for (int z = 0; z < c_box_grid_size; ++z) {
+                IRigid_body_create_info box_create_info{
+                    .collision_shape = box_shape,
+                    .density         = 1.0f,
+                    .debug_label     = "box"
+                };
+                const glm::vec3 position{
+                    1.1f * static_cast<float>(x - c_box_grid_size / 2),
+                    1.1f * static_cast<float>(y) + 1.0f,
+                    1.1f * static_cast<float>(z - c_box_grid_size / 2)
+                };
+                bodies.push_back(world.create_rigid_body_shared(box_create_info, position));
+                world.add_rigid_body(bodies.back().get());
+            }
+        }
+    }
+}
+
+[[nodiscard]] auto measure_steps(const erhe::physics::IWorld_create_info& create_info) -> Timing
+{
+    std::unique_ptr<erhe::physics::IWorld>                   world = erhe::physics::IWorld::create_unique(create_info);
+    std::vector<std::shared_ptr<erhe::physics::IRigid_body>> bodies;
+    populate(*world.get(), bodies);
+    for (int i = 0; i < c_warmup_step_count; ++i) {
+        world->update_fixed_step(c_time_step);
+    }
+    const Timing timing = measure(c_step_count, [&]() { world->update_fixed_step(c_time_step); });
+    for (const auto& body : bodies) {
+        world->remove_rigid_body(body.get());
+    }
+    return timing;
+}
+
+} // anonymous namespace
+
+// Physics step time with physics library private worker threads and with
+// jobs on a shared Thread_pool, with and without other work in the pool
+void run_physics_benchmark()
+{
+    const int box_count = c_box_grid_size * c_box_grid_size * c_box_grid_size;
+    print_header(fmt::format("Physics: {} boxes, {} steps of {:.4f} s", box_count, c_step_count, c_time_step));
+
+    const std::size_t hardware_concurrency = std::max(1u, std::thread::hardware_concurrency());
+    Thread_pool pool{hardware_concurrency};
+
+    // Private worker threads; background load runs in a separate pool,
+    // which oversubscribes cores like the editor did before
+    const erhe::physics::IWorld_create_info private_create_info{
+        .thread_pool  = nullptr,
+        .thread_count = static_cast<int>(hardware_concurrency)
+    };
+    print_timing("private job threads, idle",      measure_steps(private_create_info));
+    {
+        Background_load load{pool};
+        print_timing("private job threads, pool busy", measure_steps(private_create_info));
+    }
+
+    // Physics jobs in the shared pool, background load in the same pool at low priority
+    const erhe::physics::IWorld_create_info shared_create_info{
+        .thread_pool  = &pool,
+        .thread_count = 0
+    };
+    print_timing("shared Thread_pool,  idle",      measure_steps(shared_create_info));
+    {
+        Background_load load{pool};
+        print_timing("shared Thread_pool,  pool busy", measure_steps(shared_create_info));
+    }
+}
+
+} // namespace benchmark
@@ -0,0 +1,109 @@
+#include "benchmark.hpp"
+
+#include "erhe_concurrency/concurrent_queue.hpp"
+#include "erhe_concurrency/inline_task.hpp"
+#include "erhe_concurrency/serial_queue.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace benchmark {
+
+namespace {
+
+using erhe::concurrency::Concurrent_queue;
+using erhe::concurrency::Inline_task;
+using erhe::concurrency::Serial_queue;
+using erhe::concurrency::Thread_pool;
+
+constexpr uint32_t c_task_count = 100'000;
+
+void print_allocations(const std::string_view label, const uint64_t allocation_count, const Timing& timing)
+{
+    fmt::print(
+        "  {:<48} {:>6.3f} allocations / task  {:>8.1f} ns / task\n",
+        label,
+        static_cast<double>(allocation_count) / static_cast<double>(c_task_count),
+        timing.median_ms * 1'000'000.0 / static_cast<double>(c_task_count)
+    );
+}
+
+// Runs function once to warm up, then reports allocations of a second run
+template <typename Function>
+void report(const std::string_view label, Function&& function)
+{
+    function();
+    const uint64_t before = get_allocation_count();
+    const Timing   timing = measure(1, function);
+    const uint64_t after  = get_allocation_count();
+    print_allocations(label, after - before, timing);
+}
+
+} // anonymous namespace
+
+// Heap allocations per task for std::function, Inline_task and the
+// erhe_concurrency queues
+void run_task_allocations_benchmark()
+{
+    print_header(fmt::format("Task allocations: {} tasks", c_task_count));
+
+    std::atomic<uint64_t> sink{0};
+    std::array<uint64_t, 2> small_payload{1, 2};       // lambda capture: 24 bytes
+    std::array<uint64_t, 8> large_payload{1, 2, 3, 4}; // lambda capture: 72 bytes
+
+    report("std::function, 24 byte capture", [&]() {
+        for (uint32_t i = 0; i < c_task_count; ++i) {
+            std::function<void()> task{[&sink, small_payload]() { sink += small_payload[0]; }};
+            task();
+        }
+    });
+    report("Inline_task,   24 byte capture", [&]() {
+        for (uint32_t i = 0; i < c_task_count; ++i) {
+            Inline_task task{[&sink, small_payload]() { sink += small_payload[0]; }};
+            task();
+        }
+    });
+    report("std::function, 72 byte capture", [&]() {
+        for (uint32_t i = 0; i < c_task_count; ++i) {
+            std::function<void()> task{[&sink, large_payload]() { sink += large_payload[0]; }};
+            task();
+        }
+    });
+    report("Inline_task,   72 byte capture (heap fallback)", [&]() {
+        for (uint32_t i = 0; i < c_task_count; ++i) {
+            Inline_task task{[&sink, large_payload]() { sink += large_payload[0]; }};
+            task();
+        }
+    });
+
+    Thread_pool pool{1};
+    report("Concurrent_queue::enqueue(f)", [&]() {
+        Concurrent_queue queue{pool, "allocations"};
+        for (uint32_t i = 0; i < c_task_count; ++i) {
+            queue.enqueue([&sink, small_payload]() { sink += small_payload[0]; });
+        }
+        queue.wait();
+    });
+    report("Concurrent_queue::enqueue(f, arg)", [&]() {
+        Concurrent_queue queue{pool, "allocations"};
+        for (uint32_t i = 0; i < c_task_count; ++i) {
+            queue.enqueue([&sink](const uint32_t value) { sink += value; }, i);
+        }
+        queue.wait();
+    });
+    report("Serial_queue::enqueue(f)", [&]() {
+        Serial_queue queue{"allocations"};
+        for (uint32_t i = 0; i < c_task_count; ++i) {
+            queue.enqueue([&sink, small_payload]() { sink += small_payload[0]; });
+        }
+        queue.wait();
+    });
+    keep(sink.load());
+}
+
+} // namespace benchmark
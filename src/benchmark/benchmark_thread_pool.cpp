@@ -0,0 +1,98 @@
+#include "benchmark.hpp"
+
+#include "erhe_concurrency/concurrent_queue.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace benchmark {
+
+namespace {
+
+using erhe::concurrency::Concurrent_queue;
+using erhe::concurrency::Scheduling_mode;
+using erhe::concurrency::Thread_pool;
+
+constexpr int      c_repeat_count       = 9;
+constexpr uint32_t c_flat_task_count    = 100'000;
+constexpr uint32_t c_nested_root_count  = 64;
+constexpr uint32_t c_nested_child_count = 1'024;
+constexpr uint32_t c_task_work          = 256;
+
+// Small amount of work, roughly what a typical fine grained task does
+[[nodiscard]] auto do_work(uint32_t seed) -> uint32_t
+{
+    for (uint32_t i = 0; i < c_task_work; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+    }
+    return seed;
+}
+
+[[nodiscard]] auto get_mode_name(const Scheduling_mode mode) -> const char*
+{
+    switch (mode) {
+        case Scheduling_mode::global_queues: return "global_queues";
+        case Scheduling_mode::work_stealing: return "work_stealing";
+        default:                             return "?";
+    }
+}
+
+// Main thread enqueues all tasks and waits for them
+void run_flat_fan_out(Thread_pool& pool, std::atomic<uint32_t>& sink)
+{
+    Concurrent_queue queue{pool, "flat"};
+    for (uint32_t i = 0; i < c_flat_task_count; ++i) {
+        queue.enqueue([i, &sink]() { sink.fetch_add(do_work(i), std::memory_order_relaxed); });
+    }
+    queue.wait();
+}
+
+// Root tasks enqueue their children from worker threads, main thread waits for all
+void run_nested_fan_out(Thread_pool& pool, std::atomic<uint32_t>& sink)
+{
+    Concurrent_queue queue{pool, "nested"};
+    for (uint32_t root = 0; root < c_nested_root_count; ++root) {
+        queue.enqueue(
+            [root, &queue, &sink]() {
+                for (uint32_t child = 0; child < c_nested_child_count; ++child) {
+                    const uint32_t seed = root * c_nested_child_count + child;
+                    queue.enqueue([seed, &sink]() { sink.fetch_add(do_work(seed), std::memory_order_relaxed); });
+                }
+            }
+        );
+    }
+    queue.wait();
+}
+
+} // anonymous namespace
+
+// Compares Thread_pool scheduling modes on fan-out / fan-in workloads
+void run_thread_pool_benchmark()
+{
+    print_header(
+        fmt::format(
+            "Thread_pool: {} flat tasks, {} x {} nested tasks, {} work iterations per task",
+            c_flat_task_count, c_nested_root_count, c_nested_child_count, c_task_work
+        )
+    );
+    std::atomic<uint32_t> sink{0};
+    for (const std::size_t thread_count : get_thread_counts()) {
+        for (const Scheduling_mode mode : { Scheduling_mode::global_queues, Scheduling_mode::work_stealing }) {
+            Thread_pool pool{thread_count, mode};
+            print_timing(
+                fmt::format("flat   {:2} threads {}", thread_count, get_mode_name(mode)),
+                measure(c_repeat_count, [&]() { run_flat_fan_out(pool, sink); })
+            );
+            print_timing(
+                fmt::format("nested {:2} threads {}", thread_count, get_mode_name(mode)),
+                measure(c_repeat_count, [&]() { run_nested_fan_out(pool, sink); })
+            );
+        }
+    }
+    keep(sink.load());
+}
+
+} // namespace benchmark
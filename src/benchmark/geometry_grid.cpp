@@ -0,0 +1,39 @@
+#include "geometry_grid.hpp"
+
+#include <fmt/format.h>
+
+#include <cmath>
+
+namespace benchmark {
+
+auto make_grid_geometry(const uint32_t size) -> erhe::geometry::Geometry
+{
+    using erhe::geometry::Point_id;
+
+    erhe::geometry::Geometry geometry{fmt::format("grid {} x {}", size, size)};
+    const uint32_t point_row_size = size + 1;
+    geometry.reserve_points  (static_cast<std::size_t>(point_row_size) * point_row_size);
+    geometry.reserve_polygons(static_cast<std::size_t>(size) * size);
+
+    const float scale = 1.0f / static_cast<float>(size);
+    for (uint32_t y = 0; y < point_row_size; ++y) {
+        for (uint32_t x = 0; x < point_row_size; ++x) {
+            const float s = static_cast<float>(x) * scale;
+            const float t = static_cast<float>(y) * scale;
+            geometry.make_point(s, 0.1f * std::sin(8.0f * s) * std::cos(8.0f * t), t, s, t);
+        }
+    }
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            const Point_id p0 = y * point_row_size + x;
+            const Point_id p1 = p0 + 1;
+            const Point_id p2 = p1 + point_row_size;
+            const Point_id p3 = p0 + point_row_size;
+            geometry.make_polygon({p0, p3, p2, p1});
+        }
+    }
+    geometry.make_point_corners();
+    return geometry;
+}
+
+} // namespace benchmark
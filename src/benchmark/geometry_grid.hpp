@@ -0,0 +1,13 @@
+#pragma once
+
+#include "erhe_geometry/geometry.hpp"
+
+#include <cstdint>
+
+namespace benchmark {
+
+// Open size x size quad grid with a gentle height field, point locations and
+// point texture coordinates. Point corners are made, edges are not built.
+[[nodiscard]] auto make_grid_geometry(uint32_t size) -> erhe::geometry::Geometry;
+
+} // namespace benchmark
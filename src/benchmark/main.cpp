@@ -0,0 +1,60 @@
+#include "benchmark.hpp"
+
+#include "erhe_geometry/geometry_log.hpp"
+#include "erhe_log/log.hpp"
+#include "erhe_physics/physics_log.hpp"
+
+#include <fmt/format.h>
+
+#include <string_view>
+
+namespace {
+
+struct Benchmark_entry
+{
+    std::string_view name;
+    void           (*run)();
+};
+
+constexpr Benchmark_entry c_benchmarks[] = {
+    { "geometry_attributes", &benchmark::run_geometry_attributes_benchmark },
+    { "geometry_edges",      &benchmark::run_geometry_edges_benchmark      },
+    { "geometry_iteration",  &benchmark::run_geometry_iteration_benchmark  },
+    { "parallel_for",        &benchmark::run_parallel_for_benchmark        },
+    { "physics",             &benchmark::run_physics_benchmark             },
+    { "task_allocations",    &benchmark::run_task_allocations_benchmark    },
+    { "thread_pool",         &benchmark::run_thread_pool_benchmark         }
+};
+
+} // anonymous namespace
+
+// Usage: benchmark [name...]
+// Without arguments all benchmarks are run.
+auto main(int argc, char** argv) -> int
+{
+    erhe::log::initialize_log_sinks();
+    erhe::geometry::initialize_logging();
+    erhe::physics::initialize_logging();
+
+    bool found = (argc <= 1);
+    for (const Benchmark_entry& entry : c_benchmarks) {
+        bool selected = (argc <= 1);
+        for (int i = 1; i < argc; ++i) {
+            if (entry.name == argv[i]) {
+                selected = true;
+            }
+        }
+        if (selected) {
+            entry.run();
+            found = true;
+        }
+    }
+    if (!found) {
+        fmt::print("Available benchmarks:\n");
+        for (const Benchmark_entry& entry : c_benchmarks) {
+            fmt::print("  {}\n", entry.name);
+        }
+        return 1;
+    }
+    return 0;
+}
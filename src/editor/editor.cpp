@@ -45,6 +45,7 @@
 #include "windows/rendergraph_window.hpp"
 #include "windows/selection_window.hpp"
 #include "windows/settings_window.hpp"
+#include "windows/thread_pool_window.hpp"
 #include "windows/tool_properties_window.hpp"
 #include "windows/viewport_config_window.hpp"
 
@@ -57,6 +58,8 @@
 
 #include "erhe_commands/commands.hpp"
 #include "erhe_commands/commands_log.hpp"
+#include "erhe_concurrency/main_thread_executor.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
 #include "erhe_configuration/configuration.hpp"
 #include "erhe_file/file_log.hpp"
 #include "erhe_geometry/geometry_log.hpp"
@@ -144,13 +147,43 @@ public:
         return erhe::window::Context_window{configuration};
     }
 
+    [[nodiscard]] static auto get_thread_count() -> std::size_t
+    {
+        std::size_t thread_count{0};
+        auto ini = erhe::configuration::get_ini("erhe.ini", "threading");
+        ini->get("thread_count", thread_count);
+        if (thread_count == 0) {
+            const unsigned int hardware_concurrency = std::thread::hardware_concurrency();
+            thread_count = (hardware_concurrency > 1) ? (hardware_concurrency - 1) : 1;
+        }
+        return thread_count;
+    }
+
+    [[nodiscard]] static auto get_scheduling_mode() -> erhe::concurrency::Scheduling_mode
+    {
+        bool work_stealing{false};
+        auto ini = erhe::configuration::get_ini("erhe.ini", "threading");
+        ini->get("work_stealing", work_stealing);
+        return work_stealing
+            ? erhe::concurrency::Scheduling_mode::work_stealing
+            : erhe::concurrency::Scheduling_mode::global_queues;
+    }
+
     Editor()
         : m_commands          {}
+        , m_thread_pool       {get_thread_count(), get_scheduling_mode()}
+        , m_main_thread_executor{}
         , m_scene_message_bus {}
         , m_editor_message_bus{}
         , m_input_state       {}
         , m_time              {}
-        , m_editor_context    {}
+        , m_editor_context{
+            // Needed by scene roots created during construction
+            .commands             = &m_commands,
+            .thread_pool          = &m_thread_pool,
+            .main_thread_executor = &m_main_thread_executor,
+            .editor_settings      = &m_editor_settings
+        }
 
         , m_clipboard             {m_commands, m_editor_context}
         , m_context_window        {create_window()}
@@ -163,10 +196,10 @@ public:
         , m_rendergraph           {m_graphics_instance}
         , m_text_renderer         {m_graphics_instance}
 
+        , m_mesh_memory           {m_graphics_instance, m_program_interface}
         , m_programs              {m_graphics_instance, m_program_interface}
         , m_forward_renderer      {m_graphics_instance, m_program_interface}
         , m_shadow_renderer       {m_graphics_instance, m_program_interface}
-        , m_mesh_memory           {m_graphics_instance, m_program_interface}
 
         , m_imgui_windows         {m_imgui_renderer,    &m_context_window,   m_rendergraph}
         , m_editor_scenes         {m_editor_context,    m_time}
@@ -191,6 +224,7 @@ public:
         , m_post_processing_window{m_imgui_renderer, m_imgui_windows, m_editor_context}
         , m_properties            {m_imgui_renderer, m_imgui_windows, m_editor_context}
         , m_rendergraph_window    {m_imgui_renderer, m_imgui_windows, m_editor_context}
+        , m_thread_pool_window    {m_imgui_renderer, m_imgui_windows, m_editor_context}
         , m_tool_properties_window{m_imgui_renderer, m_imgui_windows, m_editor_context}
         , m_viewport_config_window{m_imgui_renderer, m_imgui_windows, m_editor_context}
         , m_logs                  {m_commands, m_imgui_renderer}
@@ -286,11 +320,11 @@ public:
 
         fill_editor_context();
 
-        auto ini = erhe::configuration::get_ini("erhe.ini", "physics");
-        ini->get("static_enable",  m_editor_settings.physics.static_enable);
-        ini->get("dynamic_enable", m_editor_settings.physics.dynamic_enable);
-        if (!m_editor_settings.physics.static_enable) {
-            m_editor_settings.physics.dynamic_enable = false;
+        {
+            bool instrumentation{false};
+            auto ini = erhe::configuration::get_ini("erhe.ini", "threading");
+            ini->get("instrumentation", instrumentation);
+            m_thread_pool.set_instrumentation_enabled(instrumentation);
         }
 
         m_hotbar.get_all_tools();
@@ -335,6 +369,8 @@ public:
     void fill_editor_context()
     {
         m_editor_context.commands               = &m_commands              ;
+        m_editor_context.thread_pool            = &m_thread_pool           ;
+        m_editor_context.main_thread_executor   = &m_main_thread_executor  ;
         m_editor_context.graphics_instance      = &m_graphics_instance     ;
         m_editor_context.imgui_renderer         = &m_imgui_renderer        ;
         m_editor_context.imgui_windows          = &m_imgui_windows         ;
@@ -402,13 +438,10 @@ public:
         m_editor_message_bus.update(); // Flushes queued messages
         m_graphics_instance.shader_monitor.update_once_per_frame();
         m_mesh_memory.gl_buffer_transfer_queue.flush();
-
-        m_editor_scenes.before_physics_simulation_steps();
+        m_main_thread_executor.drain(); // Resumes coroutines waiting for main thread
 
         m_time.update();
-
-        m_editor_scenes.after_physics_simulation_steps();
-        m_editor_scenes.update_node_transforms();
+        m_editor_scenes.update_frame_phases();
 
         m_editor_rendering.begin_frame();
         m_imgui_windows.imgui_windows();
@@ -436,11 +469,13 @@ public:
     bool m_openxr         {false};
 
     // No dependencies (constructors)
-    erhe::commands::Commands       m_commands;
-    erhe::scene::Scene_message_bus m_scene_message_bus;
-    Editor_message_bus             m_editor_message_bus;
-    Input_state                    m_input_state;
-    Time                           m_time;
+    erhe::commands::Commands                m_commands;
+    erhe::concurrency::Thread_pool          m_thread_pool;
+    erhe::concurrency::Main_thread_executor m_main_thread_executor;
+    erhe::scene::Scene_message_bus          m_scene_message_bus;
+    Editor_message_bus                      m_editor_message_bus;
+    Input_state                             m_input_state;
+    Time                                    m_time;
     Editor_context                 m_editor_context;
 
     Clipboard                               m_clipboard;
@@ -454,10 +489,10 @@ public:
     erhe::rendergraph::Rendergraph          m_rendergraph;
     erhe::renderer::Text_renderer           m_text_renderer;
 
+    Mesh_memory                             m_mesh_memory; // before programs, which decode its vertex format
     Programs                                m_programs;
     erhe::scene_renderer::Forward_renderer  m_forward_renderer;
     erhe::scene_renderer::Shadow_renderer   m_shadow_renderer;
-    Mesh_memory                             m_mesh_memory;
 
     erhe::imgui::Imgui_windows              m_imgui_windows;
     Editor_scenes                           m_editor_scenes;
@@ -483,6 +518,7 @@ public:
     Post_processing_window                  m_post_processing_window;
     Properties                              m_properties;
     Rendergraph_window                      m_rendergraph_window;
+    Thread_pool_window                      m_thread_pool_window;
     Tool_properties_window                  m_tool_properties_window;
     Viewport_config_window                  m_viewport_config_window;
     erhe::imgui::Logs                       m_logs;
@@ -7,6 +7,7 @@
 #include "scene/scene_root.hpp"
 
 #include "erhe_physics/iworld.hpp"
+#include "erhe_profile/profile.hpp"
 #include "erhe_scene/scene.hpp"
 
 #include <imgui/imgui.h>
@@ -20,6 +21,7 @@ Editor_scenes::Editor_scenes(
 )
     : Update_time_base{time}
     , m_context       {editor_context}
+    , m_frame_phases  {*editor_context.thread_pool}
 {
 }
 
@@ -58,61 +60,76 @@ void Editor_scenes::imgui()
     }
 }
 
-void Editor_scenes::update_physics_simulation_fixed_step(const Time_context& time_context)
+auto Editor_scenes::is_physics_enabled() const -> bool
 {
-    if (
-        !m_context.editor_settings->physics.static_enable ||
-        !m_context.editor_settings->physics.dynamic_enable
-    ) {
-        return;
-    }
-
-    for (const auto& scene_root : m_scene_roots) {
-        scene_root->update_physics_simulation_fixed_step(time_context.dt);
-    }
+    return
+        m_context.editor_settings->physics.static_enable &&
+        m_context.editor_settings->physics.dynamic_enable;
 }
 
-void Editor_scenes::before_physics_simulation_steps()
+void Editor_scenes::update_fixed_step(const Time_context& time_context)
 {
-    if (
-        !m_context.editor_settings->physics.static_enable ||
-        !m_context.editor_settings->physics.dynamic_enable
-    ) {
-        return;
-    }
-
-    for (const auto& scene_root : m_scene_roots) {
-        scene_root->before_physics_simulation_steps();
-    }
+    // Physics steps are executed in update_frame_phases()
+    m_pending_fixed_steps.push_back(time_context.dt);
 }
 
-void Editor_scenes::update_node_transforms()
+void Editor_scenes::update_frame_phases()
 {
-    for (const auto& scene_root : m_scene_roots) {
-        scene_root->get_scene().update_node_transforms();
+    ERHE_PROFILE_FUNCTION();
+
+    const bool physics_enabled = is_physics_enabled();
+
+    // Each Scene_root has its own scene, physics world and raytrace scene,
+    // so the stage chains of different Scene_roots are independent.
+    for (Scene_root* scene_root : m_scene_roots) {
+        const auto update_node_transforms = [scene_root]()
+        {
+            scene_root->get_scene().update_node_transforms();
+        };
+        if (!physics_enabled) {
+            m_frame_phases.add("node transforms", update_node_transforms);
+            continue;
+        }
+
+        const Frame_phases::Phase before_physics = m_frame_phases.add(
+            "before physics",
+            [scene_root]()
+            {
+                scene_root->before_physics_simulation_steps();
+            }
+        );
+        const Frame_phases::Phase physics_steps = m_frame_phases.add(
+            "physics steps",
+            [scene_root, this]()
+            {
+                for (const double dt : m_pending_fixed_steps) {
+                    scene_root->update_physics_simulation_fixed_step(dt);
+                }
+            },
+            {before_physics}
+        );
+        const Frame_phases::Phase after_physics = m_frame_phases.add(
+            "after physics",
+            [scene_root]()
+            {
+                scene_root->after_physics_simulation_steps();
+            },
+            {physics_steps}
+        );
+        m_frame_phases.add("node transforms", update_node_transforms, {after_physics});
     }
 
     // Not in m_scene_roots
-    m_context.tools->get_tool_scene_root()->get_hosted_scene()->update_node_transforms();
-}
-
-void Editor_scenes::update_fixed_step(const Time_context& time_context)
-{
-    update_physics_simulation_fixed_step(time_context);
-}
-
-void Editor_scenes::after_physics_simulation_steps()
-{
-    if (
-        !m_context.editor_settings->physics.static_enable ||
-        !m_context.editor_settings->physics.dynamic_enable
-    ) {
-        return;
-    }
+    m_frame_phases.add(
+        "tool node transforms",
+        [this]()
+        {
+            m_context.tools->get_tool_scene_root()->get_hosted_scene()->update_node_transforms();
+        }
+    );
 
-    for (const auto& scene_root : m_scene_roots) {
-        scene_root->after_physics_simulation_steps();
-    }
+    m_frame_phases.run();
+    m_pending_fixed_steps.clear();
 }
 
 [[nodiscard]] auto Editor_scenes::get_scene_roots() -> const std::vector<Scene_root*>&
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "frame_phases.hpp"
 #include "time.hpp"
 
 #include <memory>
@@ -26,10 +27,9 @@ public:
     void unregister_scene_root               (Scene_root* scene_root);
     void sanity_check                        ();
 
-    void before_physics_simulation_steps     ();
-    void update_physics_simulation_fixed_step(const Time_context& time);
-    void after_physics_simulation_steps      ();
-    void update_node_transforms              ();
+    // Runs physics steps accumulated by Time::update() and node transform
+    // updates for all scenes; independent scenes are updated in parallel.
+    void update_frame_phases();
 
     void update_fixed_step    (const Time_context&) override;
 
@@ -43,9 +43,13 @@ public:
     void imgui();
 
 private:
+    [[nodiscard]] auto is_physics_enabled() const -> bool;
+
     Editor_context&          m_context;
     std::mutex               m_mutex;
     std::vector<Scene_root*> m_scene_roots;
+    std::vector<double>      m_pending_fixed_steps;
+    Frame_phases             m_frame_phases;
 };
 
 } // namespace editor
@@ -16,6 +16,16 @@ Editor_settings::Editor_settings(
     graphics.get_limits();
     read();
     graphics.select_active_graphics_preset(editor_message_bus);
+
+    // Physics settings are read here so that they are available
+    // to scene roots created during editor construction.
+    auto ini = erhe::configuration::get_ini("erhe.ini", "physics");
+    ini->get("static_enable",  physics.static_enable);
+    ini->get("dynamic_enable", physics.dynamic_enable);
+    ini->get("thread_count",   physics.thread_count);
+    if (!physics.static_enable) {
+        physics.dynamic_enable = false;
+    }
 }
 
 auto Editor_settings::get_ui_scale() const -> float
@@ -26,6 +26,7 @@ public:
     // Physics
     bool static_enable {true};
     bool dynamic_enable{true};
+    int  thread_count  {0}; // thread pool workers used for physics jobs, 0 = all
 };
 
 class Graphics_preset
@@ -0,0 +1,122 @@
+#include "frame_phases.hpp"
+
+#include "erhe_concurrency/thread_pool.hpp"
+#include "erhe_profile/profile.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <algorithm>
+
+namespace editor {
+
+Frame_phases::Frame_phases(erhe::concurrency::Thread_pool& thread_pool)
+    : m_task_graph{thread_pool, "frame phases", erhe::concurrency::Priority::HIGH}
+{
+}
+
+auto Frame_phases::add(
+    const char*                      label,
+    erhe::concurrency::Inline_task&& work,
+    std::initializer_list<Phase>     dependencies
+) -> Phase
+{
+    const Phase phase = m_phases.size();
+    for (const Phase dependency : dependencies) {
+        ERHE_VERIFY(dependency < phase);
+    }
+    m_phases.push_back(
+        Phase_entry{
+            .label        = label,
+            .work         = std::move(work),
+            .dependencies = dependencies
+        }
+    );
+    return phase;
+}
+
+void Frame_phases::run()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    if (m_phases.empty()) {
+        return;
+    }
+
+    // Tasks capture phase index; m_phases is not modified while running
+    std::vector<erhe::concurrency::Task_handle> predecessors;
+    for (Phase phase = 0, end = m_phases.size(); phase < end; ++phase) {
+        predecessors.clear();
+        for (const Phase dependency : m_phases[phase].dependencies) {
+            predecessors.push_back(m_phases[dependency].task);
+        }
+        m_phases[phase].task = m_task_graph.join(
+            predecessors,
+            [this, phase]()
+            {
+                Phase_entry& entry = m_phases[phase];
+                entry.start_time = std::chrono::steady_clock::now();
+                entry.work();
+                entry.end_time = std::chrono::steady_clock::now();
+            }
+        );
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+    m_task_graph.run();
+    m_task_graph.wait_for_completion(); // not wait(), which could run unrelated pool tasks on the main thread
+    m_wall_timer.set(start_time, std::chrono::steady_clock::now());
+
+    update_timers(start_time);
+
+    m_task_graph.clear();
+    m_phases.clear();
+}
+
+void Frame_phases::update_timers(const std::chrono::steady_clock::time_point start_time)
+{
+    using Duration = std::chrono::steady_clock::duration;
+
+    // Phases are in topological order, so a single forward pass finds the
+    // longest (critical) dependency chain.
+    const std::size_t     count = m_phases.size();
+    std::vector<Duration> path_duration(count);
+    std::vector<Phase>    path_previous(count);
+    Duration              total_work{};
+    Phase                 critical_end{0};
+    for (Phase phase = 0; phase < count; ++phase) {
+        const Phase_entry& entry    = m_phases[phase];
+        const Duration     duration = entry.end_time - entry.start_time;
+        Duration longest_predecessor{};
+        path_previous[phase] = phase;
+        for (const Phase dependency : entry.dependencies) {
+            if (path_duration[dependency] > longest_predecessor) {
+                longest_predecessor  = path_duration[dependency];
+                path_previous[phase] = dependency;
+            }
+        }
+        path_duration[phase] = longest_predecessor + duration;
+        total_work += duration;
+        if (path_duration[phase] > path_duration[critical_end]) {
+            critical_end = phase;
+        }
+    }
+
+    m_critical_path.clear();
+    for (Phase phase = critical_end;;) {
+        m_critical_path.push_back(m_phases[phase].label);
+        if (path_previous[phase] == phase) {
+            break;
+        }
+        phase = path_previous[phase];
+    }
+    std::reverse(m_critical_path.begin(), m_critical_path.end());
+
+    m_critical_path_timer.set(start_time, start_time + path_duration[critical_end]);
+    m_work_timer         .set(start_time, start_time + total_work);
+}
+
+auto Frame_phases::get_critical_path() const -> const std::vector<const char*>&
+{
+    return m_critical_path;
+}
+
+} // namespace editor
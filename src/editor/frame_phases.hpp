@@ -0,0 +1,69 @@
+#pragma once
+
+#include "erhe_concurrency/inline_task.hpp"
+#include "erhe_concurrency/task_graph.hpp"
+#include "erhe_time/timer.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+namespace erhe::concurrency {
+    class Thread_pool;
+}
+
+namespace editor {
+
+/*
+    Frame_phases runs per frame update stages as a Task_graph. Each stage
+    lists the stages it depends on; stages without a dependency path between
+    them (for example stages of different Scene_roots) run in parallel.
+
+    Stage timings are recorded and the longest dependency chain (critical
+    path) is reported through erhe::time::Timer, visible in Performance
+    window, along with wall clock time and total work time.
+*/
+class Frame_phases
+{
+public:
+    using Phase = std::size_t;
+
+    explicit Frame_phases(erhe::concurrency::Thread_pool& thread_pool);
+
+    // Phases must be added in dependency order; dependencies must refer to
+    // already added phases of the current frame.
+    auto add(
+        const char*                         label,
+        erhe::concurrency::Inline_task&&    work,
+        std::initializer_list<Phase>        dependencies = {}
+    ) -> Phase;
+
+    // Executes all added phases, waits for completion and removes them
+    void run();
+
+    [[nodiscard]] auto get_critical_path() const -> const std::vector<const char*>&;
+
+private:
+    class Phase_entry
+    {
+    public:
+        const char*                           label{nullptr};
+        erhe::concurrency::Inline_task        work;
+        std::vector<Phase>                    dependencies;
+        erhe::concurrency::Task_handle        task;
+        std::chrono::steady_clock::time_point start_time;
+        std::chrono::steady_clock::time_point end_time;
+    };
+
+    void update_timers(std::chrono::steady_clock::time_point start_time);
+
+    erhe::concurrency::Task_graph m_task_graph;
+    std::vector<Phase_entry>      m_phases;
+    std::vector<const char*>      m_critical_path;
+    erhe::time::Timer             m_wall_timer         {"Frame phases"};
+    erhe::time::Timer             m_critical_path_timer{"Frame phases critical path"};
+    erhe::time::Timer             m_work_timer         {"Frame phases total work"};
+};
+
+} // namespace editor
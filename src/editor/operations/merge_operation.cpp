@@ -171,7 +171,7 @@ Merge_operation::Merge_operation(Parameters&& parameters)
     }
 
     std::shared_ptr<erhe::geometry::Geometry> welded_render_geometry = std::make_shared<erhe::geometry::Geometry>(
-        erhe::geometry::operation::weld(combined_render_geometry)
+        erhe::geometry::operation::weld(combined_render_geometry, parameters.context.thread_pool)
     );
 
     m_first_mesh_primitives_after.push_back(
@@ -170,6 +170,20 @@ void Mesh_operation::make_entries(
     scene.sanity_check();
 }
 
+void Mesh_operation::make_entries(
+    const std::function<
+        erhe::geometry::Geometry(erhe::geometry::Geometry&, erhe::concurrency::Thread_pool*)
+    > operation
+)
+{
+    erhe::concurrency::Thread_pool* const thread_pool = m_parameters.context.thread_pool;
+    make_entries(
+        [&operation, thread_pool](erhe::geometry::Geometry& geometry) {
+            return operation(geometry, thread_pool);
+        }
+    );
+}
+
 void Mesh_operation::add_entry(Entry&& entry)
 {
     m_entries.emplace_back(entry);
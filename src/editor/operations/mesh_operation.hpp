@@ -8,6 +8,9 @@
 #include <functional>
 #include <vector>
 
+namespace erhe::concurrency {
+    class Thread_pool;
+}
 namespace erhe::geometry {
     class Geometry;
 }
@@ -62,6 +65,11 @@ protected:
         const std::function<erhe::geometry::Geometry(erhe::geometry::Geometry&)> operation
     );
 
+    // For geometry operations which can use editor thread pool
+    void make_entries(
+        const std::function<erhe::geometry::Geometry(erhe::geometry::Geometry&, erhe::concurrency::Thread_pool*)> operation
+    );
+
 protected:
     Parameters         m_parameters;
     std::vector<Entry> m_entries;
@@ -12,8 +12,6 @@
 #   include <imgui/imgui.h>
 #endif
 
-#include <taskflow/taskflow.hpp>
-
 namespace editor
 {
 
@@ -71,43 +69,53 @@ Operation_stack::Operation_stack(
     , m_context     {editor_context}
     , m_undo_command{commands, editor_context}
     , m_redo_command{commands, editor_context}
+    , m_task_graph  {*editor_context.thread_pool, "operation_stack"}
 {
     commands.register_command(&m_undo_command);
     commands.register_command(&m_redo_command);
     commands.bind_command_to_key(&m_undo_command, erhe::window::Key_z, true, erhe::window::Key_modifier_bit_ctrl);
     commands.bind_command_to_key(&m_redo_command, erhe::window::Key_y, true, erhe::window::Key_modifier_bit_ctrl);
 
-    m_executor = std::make_unique<tf::Executor>();
+    // Tasks are released as soon as they are added
+    m_task_graph.run();
 
     m_undo_command.set_host(this);
     m_redo_command.set_host(this);
 }
 
-Operation_stack::~Operation_stack() = default;
+Operation_stack::~Operation_stack()
+{
+    m_task_graph.wait_for_completion();
+}
 
-auto Operation_stack::get_executor() -> tf::Executor&
+auto Operation_stack::get_task_graph() -> erhe::concurrency::Task_graph&
 {
-    return *m_executor.get();
+    return m_task_graph;
 }
 
 void Operation_stack::queue(
     const std::shared_ptr<IOperation>& operation
 )
 {
+    std::lock_guard<std::mutex> lock{m_queued_mutex};
     m_queued.push_back(operation);
 }
 
 void Operation_stack::update()
 {
-    if (m_queued.empty()) {
+    std::vector<std::shared_ptr<IOperation>> queued;
+    {
+        std::lock_guard<std::mutex> lock{m_queued_mutex};
+        queued.swap(m_queued);
+    }
+    if (queued.empty()) {
         return;
     }
 
-    for (const auto& operation : m_queued) {
+    for (const auto& operation : queued) {
         operation->execute(m_context);
         m_executed.push_back(operation);
     }
-    m_queued.clear();
     m_undone.clear();
 }
 
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "erhe_commands/command.hpp"
+#include "erhe_concurrency/task_graph.hpp"
 #include "erhe_imgui/imgui_window.hpp"
 
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace erhe::commands {
@@ -12,9 +14,6 @@ namespace erhe::commands {
 namespace erhe::imgui {
     class Imgui_windows;
 }
-namespace tf {
-    class Executor;
-}
 
 namespace editor
 {
@@ -69,7 +68,7 @@ public:
 
     [[nodiscard]] auto can_undo() const -> bool;
     [[nodiscard]] auto can_redo() const -> bool;
-    void queue(const std::shared_ptr<IOperation>& operation);
+    void queue(const std::shared_ptr<IOperation>& operation); // thread safe
     void undo();
     void redo();
 
@@ -78,7 +77,8 @@ public:
     // Implements Window
     void imgui() override;
 
-    [[nodiscard]] auto get_executor() -> tf::Executor&;
+    // Background tasks for operations; they may queue() operations when done
+    [[nodiscard]] auto get_task_graph() -> erhe::concurrency::Task_graph&;
 
 private:
     void imgui(
@@ -91,10 +91,11 @@ private:
     Undo_command m_undo_command;
     Redo_command m_redo_command;
 
-    std::unique_ptr<tf::Executor> m_executor;
+    erhe::concurrency::Task_graph m_task_graph;
 
     std::vector<std::shared_ptr<IOperation>> m_executed;
     std::vector<std::shared_ptr<IOperation>> m_undone;
+    std::mutex                               m_queued_mutex;
     std::vector<std::shared_ptr<IOperation>> m_queued;
 };
 
@@ -9,6 +9,7 @@
 #include "erhe_geometry/geometry.hpp"
 #include "erhe_gltf/gltf.hpp"
 #include "erhe_gltf/image_transfer.hpp"
+#include "erhe_primitive/primitive.hpp"
 #include "erhe_primitive/primitive_builder.hpp"
 #include "erhe_scene/camera.hpp"
 #include "erhe_scene/light.hpp"
@@ -65,10 +66,11 @@ void color_graph(
 }
 
 void import_gltf(
-    erhe::graphics::Instance&    graphics_instance,
-    erhe::primitive::Build_info  build_info,
-    Scene_root&                  scene_root,
-    const std::filesystem::path& path
+    erhe::graphics::Instance&       graphics_instance,
+    erhe::primitive::Build_info     build_info,
+    Scene_root&                     scene_root,
+    const std::filesystem::path&    path,
+    erhe::concurrency::Thread_pool* thread_pool
 )
 {
     erhe::scene::Scene* scene = scene_root.get_hosted_scene();
@@ -89,12 +91,16 @@ void import_gltf(
         image_transfer,
         root_node,
         content_layer_id,
-        path
+        path,
+        thread_pool
     );
 
-    for (const auto& geometry_primitive : gltf_data.geometry_primitives) {
-        geometry_primitive->build_from_geometry(build_info, erhe::primitive::Normal_style::corner_normals);
-    }
+    erhe::primitive::build_from_geometry(
+        gltf_data.geometry_primitives,
+        build_info,
+        erhe::primitive::Normal_style::corner_normals,
+        thread_pool
+    );
 
     std::shared_ptr<Content_library> content_library = scene_root.content_library();
 
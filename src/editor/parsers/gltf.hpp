@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 
+namespace erhe::concurrency {
+    class Thread_pool;
+}
 namespace erhe::graphics {
     class Instance;
 }
@@ -20,10 +23,11 @@ class Materials;
 class Scene_root;
 
 void import_gltf(
-    erhe::graphics::Instance&    graphics_instance,
-    erhe::primitive::Build_info  build_info,
-    Scene_root&                  scene_root,
-    const std::filesystem::path& path
+    erhe::graphics::Instance&       graphics_instance,
+    erhe::primitive::Build_info     build_info,
+    Scene_root&                     scene_root,
+    const std::filesystem::path&    path,
+    erhe::concurrency::Thread_pool* thread_pool
 );
 
 [[nodiscard]] auto scan_gltf(const std::filesystem::path& path) -> std::vector<std::string>;
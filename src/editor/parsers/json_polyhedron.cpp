@@ -1,13 +1,18 @@
 #include "parsers/json_polyhedron.hpp"
 
 #include "erhe_geometry/geometry.hpp"
+#include "erhe_geometry/geometry_cache.hpp"
 #include "erhe_file/file.hpp"
 #include "erhe_profile/profile.hpp"
 
+#include <span>
 #include <string>
 
 namespace editor {
 
+// Increment when geometry made by Json_library::parse_geometry() changes
+constexpr uint32_t c_json_geometry_cache_version = 1;
+
 Json_library::Json_library()
 {
 }
@@ -22,6 +27,7 @@ Json_library::Json_library(const std::filesystem::path& path)
     }
 
     const std::string& text = opt_text.value();
+    m_content_hash = erhe::geometry::make_geometry_cache_key("Json_library", c_json_geometry_cache_version, std::as_bytes(std::span{text}));
 
     {
         ERHE_PROFILE_SCOPE("parse");
@@ -56,6 +62,24 @@ Json_library::Json_library(const std::filesystem::path& path)
 }
 
 auto Json_library::make_geometry(
+    const std::string&                    key_name,
+    const erhe::geometry::Geometry_cache* geometry_cache
+) const -> erhe::geometry::Geometry
+{
+    ERHE_PROFILE_FUNCTION();
+
+    if (geometry_cache == nullptr) {
+        return parse_geometry(key_name);
+    }
+    return geometry_cache->get_or_make(
+        erhe::geometry::make_geometry_cache_key("Json_library::make_geometry", m_content_hash, std::string_view{key_name}),
+        [this, &key_name]() {
+            return parse_geometry(key_name);
+        }
+    );
+}
+
+auto Json_library::parse_geometry(
     const std::string& key_name
 ) const -> erhe::geometry::Geometry
 {
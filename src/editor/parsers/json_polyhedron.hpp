@@ -4,10 +4,15 @@
 
 #include "rapidjson/document.h"
 
+#include <cstdint>
 #include <filesystem>
 #include <string>
 #include <vector>
 
+namespace erhe::geometry {
+    class Geometry_cache;
+}
+
 namespace editor {
 
 class Json_library
@@ -27,13 +32,20 @@ public:
     Json_library();
     explicit Json_library(const std::filesystem::path& path);
 
-    [[nodiscard]] auto make_geometry(const std::string& key_name) const -> erhe::geometry::Geometry;
+    // When geometry_cache is given, results are cached by library content hash and key name
+    [[nodiscard]] auto make_geometry(
+        const std::string&                    key_name,
+        const erhe::geometry::Geometry_cache* geometry_cache = nullptr
+    ) const -> erhe::geometry::Geometry;
 
     std::vector<std::string> names;       // all meshes
     std::vector<Category>    categories;  // categories
 
 private:
+    [[nodiscard]] auto parse_geometry(const std::string& key_name) const -> erhe::geometry::Geometry;
+
     rapidjson::Document m_json;
+    uint64_t            m_content_hash{0};
 };
 
 }
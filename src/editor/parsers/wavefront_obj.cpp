@@ -2,11 +2,13 @@
 #include "editor_log.hpp"
 
 #include "erhe_geometry/geometry.hpp"
+#include "erhe_geometry/geometry_cache.hpp"
 #include "erhe_file/file.hpp"
 #include "erhe_profile/profile.hpp"
 #include "erhe_verify/verify.hpp"
 
 #include <limits>
+#include <span>
 #include <string>
 
 namespace editor {
@@ -19,6 +21,9 @@ using erhe::geometry::c_point_colors;
 using erhe::geometry::c_corner_normals;
 using erhe::geometry::c_corner_texcoords;
 
+// Increment when geometry made by parse_obj_geometry() changes
+constexpr uint32_t c_obj_geometry_cache_version = 1;
+
 // http://paulbourke.net/dataformats/obj/
 // http://www.martinreddy.net/gfx/3d/OBJ.spec
 // https://www.marxentlabs.com/obj-files/
@@ -120,7 +125,8 @@ Command tokenize(const std::string& text)
 // f 1/1/1 2/2/2 3/3/3 4/4/4
 
 auto parse_obj_geometry(
-    const std::filesystem::path& path
+    const std::filesystem::path&          path,
+    const erhe::geometry::Geometry_cache* geometry_cache
 ) -> std::vector<std::shared_ptr<erhe::geometry::Geometry>>
 {
     ERHE_PROFILE_FUNCTION();
@@ -130,10 +136,19 @@ auto parse_obj_geometry(
     std::vector<std::shared_ptr<erhe::geometry::Geometry>> result;
     const auto opt_text = erhe::file::read("parse_obj_geometry", path);
 
+    const uint64_t cache_key = opt_text.has_value()
+        ? erhe::geometry::make_geometry_cache_key("parse_obj_geometry", c_obj_geometry_cache_version, std::as_bytes(std::span{opt_text.value()}))
+        : 0;
+    if (opt_text.has_value() && (geometry_cache != nullptr)) {
+        for (auto& geometry : geometry_cache->load(cache_key)) {
+            result.push_back(std::make_shared<erhe::geometry::Geometry>(std::move(geometry)));
+        }
+    }
+
     // I dislike this big scope, I'd prefer just to
     // return {} but unfortunately having more than
     // one return kills named return value optimization.
-    if (opt_text.has_value()) {
+    if (opt_text.has_value() && result.empty()) {
         const std::string& text = opt_text.value();
 
         std::shared_ptr<erhe::geometry::Geometry> geometry{};
@@ -454,6 +469,14 @@ auto parse_obj_geometry(
             g->generate_polygon_texture_coordinates();
             g->compute_tangents();
         }
+
+        if ((geometry_cache != nullptr) && !result.empty()) {
+            std::vector<const erhe::geometry::Geometry*> geometries;
+            for (const auto& g : result) {
+                geometries.push_back(g.get());
+            }
+            geometry_cache->store(cache_key, geometries);
+        }
     }
 
     return result;
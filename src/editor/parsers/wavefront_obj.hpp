@@ -2,6 +2,7 @@
 
 namespace erhe::geometry {
     class Geometry;
+    class Geometry_cache;
 }
 
 #include <filesystem>
@@ -10,8 +11,10 @@ namespace erhe::geometry {
 
 namespace editor {
 
+// When geometry_cache is given, results are cached by file content hash
 [[nodiscard]] auto parse_obj_geometry(
-    const std::filesystem::path& path
+    const std::filesystem::path&          path,
+    const erhe::geometry::Geometry_cache* geometry_cache = nullptr
 ) -> std::vector<std::shared_ptr<erhe::geometry::Geometry>>;
 
 }
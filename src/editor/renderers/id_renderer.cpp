@@ -265,31 +265,34 @@ void Id_renderer::render(
         .color_source = erhe::scene_renderer::Primitive_color_source::id_offset
     };
 
-    const auto primitive_range            = m_primitive_buffers.update(meshes, id_filter, settings, true);
-    const auto draw_indirect_buffer_range = m_draw_indirect_buffers.update(
-        meshes,
-        erhe::primitive::Primitive_mode::polygon_fill,
-        id_filter
-    );
-    if (draw_indirect_buffer_range.draw_indirect_count == 0) {
-        return;
-    }
+    for (const gl::Draw_elements_type index_type : erhe::renderer::c_draw_elements_types) {
+        const auto draw_indirect_buffer_range = m_draw_indirect_buffers.update(
+            meshes,
+            erhe::primitive::Primitive_mode::polygon_fill,
+            id_filter,
+            index_type
+        );
+        if (draw_indirect_buffer_range.draw_indirect_count == 0) {
+            continue;
+        }
+        const auto primitive_range = m_primitive_buffers.update(meshes, id_filter, settings, index_type, true);
 
-    m_primitive_buffers    .bind(primitive_range);
-    m_draw_indirect_buffers.bind(draw_indirect_buffer_range.range);
+        m_primitive_buffers    .bind(primitive_range);
+        m_draw_indirect_buffers.bind(draw_indirect_buffer_range.range);
 
-    {
-        static constexpr std::string_view c_draw{"draw"};
-
-        ERHE_PROFILE_SCOPE("mdi");
-        //ERHE_PROFILE_GPU_SCOPE(c_draw)
-        gl::multi_draw_elements_indirect(
-            m_pipeline.data.input_assembly.primitive_topology,
-            m_mesh_memory.buffer_info.index_type,
-            reinterpret_cast<const void*>(draw_indirect_buffer_range.range.first_byte_offset),
-            static_cast<GLsizei>(draw_indirect_buffer_range.draw_indirect_count),
-            static_cast<GLsizei>(sizeof(gl::Draw_elements_indirect_command))
-        );
+        {
+            static constexpr std::string_view c_draw{"draw"};
+
+            ERHE_PROFILE_SCOPE("mdi");
+            //ERHE_PROFILE_GPU_SCOPE(c_draw)
+            gl::multi_draw_elements_indirect(
+                m_pipeline.data.input_assembly.primitive_topology,
+                index_type,
+                reinterpret_cast<const void*>(draw_indirect_buffer_range.range.first_byte_offset),
+                static_cast<GLsizei>(draw_indirect_buffer_range.draw_indirect_count),
+                static_cast<GLsizei>(sizeof(gl::Draw_elements_indirect_command))
+            );
+        }
     }
 }
 
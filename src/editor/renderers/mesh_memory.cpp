@@ -1,11 +1,86 @@
 #include "renderers/mesh_memory.hpp"
 
 #include "erhe_configuration/configuration.hpp"
+#include "erhe_gl/enum_bit_mask_operators.hpp"
+#include "erhe_graphics/instance.hpp"
 #include "erhe_scene_renderer/program_interface.hpp"
 
 namespace editor {
 
-static constexpr gl::Buffer_storage_mask storage_mask{gl::Buffer_storage_mask::map_write_bit};
+// With persistent mapping, primitive builder writes directly to mapped
+// buffers, and only written ranges are flushed
+static constexpr gl::Buffer_storage_mask storage_mask_persistent{
+    gl::Buffer_storage_mask::map_persistent_bit |
+    gl::Buffer_storage_mask::map_write_bit
+};
+static constexpr gl::Buffer_storage_mask storage_mask_not_persistent{
+    gl::Buffer_storage_mask::map_write_bit
+};
+static constexpr gl::Map_buffer_access_mask access_mask_persistent{
+    gl::Map_buffer_access_mask::map_flush_explicit_bit |
+    gl::Map_buffer_access_mask::map_persistent_bit     |
+    gl::Map_buffer_access_mask::map_write_bit
+};
+static constexpr gl::Map_buffer_access_mask access_mask_not_persistent{
+    gl::Map_buffer_access_mask::map_write_bit
+};
+
+auto Mesh_memory::use_persistent_mapping() const -> bool
+{
+    bool persistent_mapping{true};
+    const auto ini = erhe::configuration::get_ini("erhe.ini", "mesh_memory");
+    ini->get("persistent_mapping", persistent_mapping);
+    return persistent_mapping && graphics_instance.info.use_persistent_buffers;
+}
+
+auto Mesh_memory::get_storage_mask() const -> gl::Buffer_storage_mask
+{
+    return use_persistent_mapping()
+        ? storage_mask_persistent
+        : storage_mask_not_persistent;
+}
+
+auto Mesh_memory::get_access_mask() const -> gl::Map_buffer_access_mask
+{
+    return use_persistent_mapping()
+        ? access_mask_persistent
+        : access_mask_not_persistent;
+}
+
+auto Mesh_memory::get_vertex_format() const -> erhe::graphics::Vertex_format
+{
+    bool compressed_vertex_format{false};
+    const auto ini = erhe::configuration::get_ini("erhe.ini", "mesh_memory");
+    ini->get("compressed_vertex_format", compressed_vertex_format);
+
+    using erhe::graphics::Vertex_attribute;
+    if (compressed_vertex_format) {
+        // Octahedral normals and tangents, half float texture coordinates
+        // and unorm8 weights: 46 bytes per vertex instead of 86.
+        return erhe::graphics::Vertex_format{
+            Vertex_attribute::position_float3(),
+            Vertex_attribute::normal0_oct_short2(),
+            Vertex_attribute::normal1_oct_short2(), // editor wireframe bias requires smooth normal attribute
+            Vertex_attribute::tangent_oct_short4(),
+            Vertex_attribute::texcoord0_half2(),
+            Vertex_attribute::color_ubyte4(),
+            Vertex_attribute::joint_indices0_ubyte4(),
+            Vertex_attribute::joint_weights0_ubyte4(),
+            Vertex_attribute::aniso_control_ubyte2()
+        };
+    }
+    return erhe::graphics::Vertex_format{
+        Vertex_attribute::position_float3(),
+        Vertex_attribute::normal0_float3(),
+        Vertex_attribute::normal1_float3(), // editor wireframe bias requires smooth normal attribute
+        Vertex_attribute::tangent_float4(),
+        Vertex_attribute::texcoord0_float2(),
+        Vertex_attribute::color_ubyte4(),
+        Vertex_attribute::aniso_control_ubyte2(),
+        Vertex_attribute::joint_indices0_ubyte4(),
+        Vertex_attribute::joint_weights0_float4()
+    };
+}
 
 auto Mesh_memory::get_vertex_buffer_size() const -> std::size_t
 {
@@ -28,28 +103,20 @@ Mesh_memory::Mesh_memory(
     erhe::scene_renderer::Program_interface& program_interface
 )
     : graphics_instance{graphics_instance}
-    , vertex_format{
-        erhe::graphics::Vertex_attribute::position_float3(),
-        erhe::graphics::Vertex_attribute::normal0_float3(),
-        erhe::graphics::Vertex_attribute::normal1_float3(), // editor wireframe bias requires smooth normal attribute
-        erhe::graphics::Vertex_attribute::tangent_float4(),
-        erhe::graphics::Vertex_attribute::texcoord0_float2(),
-        erhe::graphics::Vertex_attribute::color_ubyte4(),
-        erhe::graphics::Vertex_attribute::aniso_control_ubyte2(),
-        erhe::graphics::Vertex_attribute::joint_indices0_ubyte4(),
-        erhe::graphics::Vertex_attribute::joint_weights0_float4()
-    }
+    , vertex_format{get_vertex_format()}
     , gl_vertex_buffer{
         graphics_instance,
         gl::Buffer_target::array_buffer,
         get_vertex_buffer_size(),
-        storage_mask
+        get_storage_mask(),
+        get_access_mask()
     }
     , gl_index_buffer{
         graphics_instance,
         gl::Buffer_target::element_array_buffer,
         get_index_buffer_size(),
-        storage_mask
+        get_storage_mask(),
+        get_access_mask()
     }
     , gl_buffer_sink{
         gl_buffer_transfer_queue,
@@ -87,6 +154,18 @@ Mesh_memory::Mesh_memory(
 {
     gl_vertex_buffer.set_debug_label("Mesh Memory Vertex");
     gl_index_buffer .set_debug_label("Mesh Memory Index");
+
+    // Programs declare and decode encoded attributes of this vertex format
+    program_interface.vertex_format = &vertex_format;
+
+    const auto ini = erhe::configuration::get_ini("erhe.ini", "mesh_memory");
+    ini->get("lod_level_count",       lod_info.level_count);
+    ini->get("lod_triangle_ratio",    lod_info.triangle_ratio);
+    ini->get("lod_screen_size",       lod_info.screen_size);
+    ini->get("lod_screen_size_ratio", lod_info.screen_size_ratio);
+    ini->get("weld_vertices",         weld_vertices);
+    ini->get("optimize_vertex_cache", optimize_vertex_cache);
+    ini->get("narrow_index_type",     buffer_info.narrow_index_type);
 }
 
 } // namespace editor
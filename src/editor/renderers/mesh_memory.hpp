@@ -40,14 +40,21 @@ public:
     erhe::graphics::Buffer                gl_index_buffer;
     erhe::primitive::Gl_buffer_sink       gl_buffer_sink;
     erhe::primitive::Buffer_info          buffer_info;
+    erhe::primitive::Lod_info             lod_info;    // for imported content
+    bool                                  weld_vertices        {true}; // for imported content
+    bool                                  optimize_vertex_cache{true}; // for imported content
     //erhe::primitive::Build_info           build_info;
     erhe::graphics::Vertex_input_state    vertex_input;
     //erhe::graphics::Shader_resource       vertex_data_in;   // For SSBO read
     //erhe::graphics::Shader_resource       vertex_data_out;  // For SSBO write
 
 private:
+    [[nodiscard]] auto get_vertex_format     () const -> erhe::graphics::Vertex_format;
     [[nodiscard]] auto get_vertex_buffer_size() const -> std::size_t;
     [[nodiscard]] auto get_index_buffer_size() const -> std::size_t;
+    [[nodiscard]] auto use_persistent_mapping() const -> bool;
+    [[nodiscard]] auto get_storage_mask      () const -> gl::Buffer_storage_mask;
+    [[nodiscard]] auto get_access_mask       () const -> gl::Map_buffer_access_mask;
 };
 
 } // namespace editor
@@ -166,8 +166,6 @@ void Renderpass::render(const Render_context& context) const
 
         context.editor_context.forward_renderer->render(
             erhe::scene_renderer::Forward_renderer::Render_parameters{
-                .index_type             = context.editor_context.mesh_memory->buffer_info.index_type,
-
                 .ambient_light          = layers.light()->ambient_light,
                 .camera                 = &context.camera,
                 .light_projections      = context.scene_view.get_light_projections(),
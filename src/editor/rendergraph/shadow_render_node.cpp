@@ -133,7 +133,6 @@ void Shadow_render_node::execute_rendergraph_node()
     m_context.shadow_renderer->render(
         erhe::scene_renderer::Shadow_renderer::Render_parameters{
             .vertex_input_state    = &m_context.mesh_memory->vertex_input,
-            .index_type            = m_context.mesh_memory->buffer_info.index_type,
 
             .view_camera           = camera.get(),
             .view_camera_viewport  = {},
@@ -88,10 +88,14 @@ void Scene_open_operation::execute(Editor_context& context)
                     .corner_points   = true,
                     .centroid_points = true
                 },
-                .buffer_info = context.mesh_memory->buffer_info
+                .buffer_info           = context.mesh_memory->buffer_info,
+                .lod                   = context.mesh_memory->lod_info,
+                .weld_vertices         = context.mesh_memory->weld_vertices,
+                .optimize_vertex_cache = context.mesh_memory->optimize_vertex_cache
             },
             *m_scene_root.get(),
-            m_path
+            m_path,
+            context.thread_pool
         );
     } else {
         // Re-register
@@ -313,10 +317,14 @@ auto Asset_browser::item_callback(const std::shared_ptr<erhe::Item_base>& item)
                                 .corner_points   = true,
                                 .centroid_points = true
                             },
-                            .buffer_info = m_context.mesh_memory->buffer_info
+                            .buffer_info           = m_context.mesh_memory->buffer_info,
+                            .lod                   = m_context.mesh_memory->lod_info,
+                            .weld_vertices         = m_context.mesh_memory->weld_vertices,
+                            .optimize_vertex_cache = m_context.mesh_memory->optimize_vertex_cache
                         },
                         *m_context.scene_builder->get_scene_root().get(),
-                        gltf->get_source_path()
+                        gltf->get_source_path(),
+                        m_context.thread_pool
                     );
 
                     m_popup_node = nullptr;
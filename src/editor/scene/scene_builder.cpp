@@ -1,5 +1,6 @@
 #include "scene/scene_builder.hpp"
 
+#include "editor_context.hpp"
 #include "editor_rendering.hpp"
 #include "editor_scenes.hpp"
 #include "editor_settings.hpp"
@@ -23,6 +24,7 @@
 #include "erhe_imgui/imgui_windows.hpp"
 #include "erhe_imgui/imgui_windows.hpp"
 #include "erhe_rendergraph/rendergraph.hpp"
+#include "erhe_geometry/geometry_cache.hpp"
 #include "erhe_geometry/shapes/box.hpp"
 #include "erhe_geometry/shapes/cone.hpp"
 #include "erhe_geometry/shapes/sphere.hpp"
@@ -57,6 +59,7 @@
 namespace editor
 {
 
+using erhe::geometry::make_geometry_cache_key;
 using erhe::geometry::shapes::make_dodecahedron;
 using erhe::geometry::shapes::make_icosahedron;
 using erhe::geometry::shapes::make_octahedron;
@@ -110,6 +113,8 @@ Scene_builder::Config::Config()
     ini->get("cone",                        cone);
     ini->get("platonic_solids",             platonic_solids);
     ini->get("johnson_solids",              johnson_solids);
+    ini->get("geometry_cache",              geometry_cache);
+    ini->get("geometry_cache_path",         geometry_cache_path);
 }
 
 Scene_builder::Scene_builder(
@@ -130,6 +135,10 @@ Scene_builder::Scene_builder(
 )
     : m_context{editor_context}
 {
+    if (config.geometry_cache) {
+        m_geometry_cache = std::make_unique<erhe::geometry::Geometry_cache>(config.geometry_cache_path);
+    }
+
     auto content_library = std::make_shared<Content_library>();
     add_default_materials(*content_library.get());
 
@@ -163,6 +172,8 @@ Scene_builder::Scene_builder(
     add_room       ();
 }
 
+Scene_builder::~Scene_builder() noexcept = default;
+
 void Scene_builder::add_rendertarget_viewports(int count)
 {
     static_cast<void>(count);
@@ -428,6 +439,23 @@ auto Scene_builder::make_brush(
     );
 }
 
+auto Scene_builder::make_cached_geometry(
+    const uint64_t                                   key,
+    const std::function<erhe::geometry::Geometry()>& make
+) -> erhe::geometry::Geometry
+{
+    // Increment when the post-processing done by make() callbacks in this file changes
+    constexpr uint32_t c_scene_geometry_cache_version = 1;
+
+    if (!m_geometry_cache) {
+        return make();
+    }
+    return m_geometry_cache->get_or_make(
+        erhe::geometry::make_geometry_cache_key("Scene_builder", c_scene_geometry_cache_version, key),
+        make
+    );
+}
+
 void Scene_builder::make_brushes(
     erhe::graphics::Instance& graphics_instance, 
     Editor_settings&          editor_settings,
@@ -463,10 +491,16 @@ void Scene_builder::make_brushes(
                 ERHE_PROFILE_SCOPE("Floor brush");
 
                 auto floor_geometry = std::make_shared<erhe::geometry::Geometry>(
-                    make_box(config.floor_size, 1.0f, config.floor_size)
+                    make_cached_geometry(
+                        make_geometry_cache_key("floor", config.floor_size),
+                        [this]() {
+                            auto geometry = make_box(config.floor_size, 1.0f, config.floor_size);
+                            geometry.name = "floor";
+                            geometry.build_edges();
+                            return geometry;
+                        }
+                    )
                 );
-                floor_geometry->name = "floor";
-                floor_geometry->build_edges();
 
                 m_floor_brush = std::make_unique<Brush>(
                     Brush_data{
@@ -493,11 +527,16 @@ void Scene_builder::make_brushes(
             {
                 ERHE_PROFILE_SCOPE("parse gltf files");
 
+                erhe::primitive::Build_info gltf_build_info = build_info(mesh_memory);
+                gltf_build_info.lod                   = mesh_memory.lod_info;
+                gltf_build_info.weld_vertices         = mesh_memory.weld_vertices;
+                gltf_build_info.optimize_vertex_cache = mesh_memory.optimize_vertex_cache;
                 import_gltf(
                     graphics_instance,
-                    build_info(mesh_memory),
+                    gltf_build_info,
                     *m_scene_root.get(),
-                    "res/assets/sample_models/SimpleSkin.gltf"
+                    "res/assets/sample_models/SimpleSkin.gltf",
+                    m_context.thread_pool
                 );
             }
         //);
@@ -518,7 +557,7 @@ void Scene_builder::make_brushes(
                     //"res/models/spoon.obj"
                 };
                 for (auto* path : obj_files_names) {
-                    auto geometries = parse_obj_geometry(path);
+                    auto geometries = parse_obj_geometry(path, m_geometry_cache.get());
 
                     for (auto& geometry : geometries) {
                         geometry->compute_polygon_normals();
@@ -554,18 +593,26 @@ void Scene_builder::make_brushes(
                 constexpr bool instantiate = global_instantiate;
                 const auto scale = config.object_scale;
 
-                make_brush(editor_settings, mesh_memory, make_dodecahedron (scale), instantiate);
-                make_brush(editor_settings, mesh_memory, make_icosahedron  (scale), instantiate);
-                make_brush(editor_settings, mesh_memory, make_octahedron   (scale), instantiate);
-                make_brush(editor_settings, mesh_memory, make_tetrahedron  (scale), instantiate);
-                make_brush(editor_settings, mesh_memory, make_cuboctahedron(scale), instantiate);
+                using Make_function = erhe::geometry::Geometry (*)(double);
+                const auto cached = [this, scale](const std::string_view name, const Make_function make) {
+                    return make_cached_geometry(
+                        make_geometry_cache_key(name, scale),
+                        [make, scale]() { return make(scale); }
+                    );
+                };
+
+                make_brush(editor_settings, mesh_memory, cached("dodecahedron",  make_dodecahedron ), instantiate);
+                make_brush(editor_settings, mesh_memory, cached("icosahedron",   make_icosahedron  ), instantiate);
+                make_brush(editor_settings, mesh_memory, cached("octahedron",    make_octahedron   ), instantiate);
+                make_brush(editor_settings, mesh_memory, cached("tetrahedron",   make_tetrahedron  ), instantiate);
+                make_brush(editor_settings, mesh_memory, cached("cuboctahedron", make_cuboctahedron), instantiate);
                 make_brush(
                     Brush_data{
                         .context         = m_context,
                         .editor_settings = editor_settings,
                         .build_info      = build_info(mesh_memory),
                         .normal_style    = Normal_style::polygon_normals,
-                        .geometry        = std::make_shared<erhe::geometry::Geometry>(make_cube(scale)),
+                        .geometry        = std::make_shared<erhe::geometry::Geometry>(cached("cube", make_cube)),
                         .density         = config.mass_scale,
                         .collision_shape = erhe::physics::ICollision_shape::create_box_shape_shared(
                             vec3{scale * 0.5f}
@@ -590,10 +637,15 @@ void Scene_builder::make_brushes(
                         .build_info      = build_info(mesh_memory),
                         .normal_style    = Normal_style::corner_normals,
                         .geometry        = std::make_shared<erhe::geometry::Geometry>(
-                            make_sphere(
-                                config.object_scale,
-                                8 * std::max(1, config.detail), // slice count
-                                6 * std::max(1, config.detail)  // stack count
+                            make_cached_geometry(
+                                make_geometry_cache_key("sphere", config.object_scale, config.detail),
+                                [this]() {
+                                    return make_sphere(
+                                        config.object_scale,
+                                        8 * std::max(1, config.detail), // slice count
+                                        6 * std::max(1, config.detail)  // stack count
+                                    );
+                                }
                             )
                         ),
                         .density         = config.mass_scale,
@@ -667,11 +719,16 @@ void Scene_builder::make_brushes(
                     return erhe::physics::ICollision_shape::create_compound_shape_shared(torus_shape_create_info);
                 };
                 const auto torus_geometry = std::make_shared<erhe::geometry::Geometry>(
-                    make_torus(
-                        major_radius,
-                        minor_radius,
-                        10 * std::max(1, config.detail),
-                        8 * std::max(1, config.detail)
+                    make_cached_geometry(
+                        make_geometry_cache_key("torus", major_radius, minor_radius, config.detail),
+                        [this, major_radius, minor_radius]() {
+                            return make_torus(
+                                major_radius,
+                                minor_radius,
+                                10 * std::max(1, config.detail),
+                                8 * std::max(1, config.detail)
+                            );
+                        }
                     )
                 );
                 make_brush(
@@ -699,16 +756,22 @@ void Scene_builder::make_brushes(
 
                 constexpr bool instantiate = global_instantiate;
                 const float scale = config.object_scale;
-                auto cylinder_geometry = make_cylinder(
-                    -1.0f * scale,
-                     1.0f * scale,
-                     1.0f * scale,
-                    true,
-                    true,
-                    9 * std::max(1, config.detail),
-                    std::max(1, config.detail)
-                ); // always axis = x
-                cylinder_geometry.transform(erhe::math::mat4_swap_xy);
+                auto cylinder_geometry = make_cached_geometry(
+                    make_geometry_cache_key("cylinder", scale, config.detail),
+                    [this, scale]() {
+                        auto geometry = make_cylinder(
+                            -1.0f * scale,
+                             1.0f * scale,
+                             1.0f * scale,
+                            true,
+                            true,
+                            9 * std::max(1, config.detail),
+                            std::max(1, config.detail)
+                        ); // always axis = x
+                        geometry.transform(erhe::math::mat4_swap_xy);
+                        return geometry;
+                    }
+                );
 
                 make_brush(
                     Brush_data{
@@ -737,15 +800,21 @@ void Scene_builder::make_brushes(
                 ERHE_PROFILE_SCOPE("Cone");
 
                 constexpr bool instantiate = global_instantiate;
-                auto cone_geometry = make_cone( // always axis = x
-                    -config.object_scale,             // min x
-                    config.object_scale,              // max x
-                    config.object_scale,              // bottom radius
-                    true,                             // use bottm
-                    10 * std::max(1, config.detail),  // slice count
-                     5 * std::max(1, config.detail)   // stack count
+                auto cone_geometry = make_cached_geometry(
+                    make_geometry_cache_key("cone", config.object_scale, config.detail),
+                    [this]() {
+                        auto geometry = make_cone( // always axis = x
+                            -config.object_scale,             // min x
+                            config.object_scale,              // max x
+                            config.object_scale,              // bottom radius
+                            true,                             // use bottm
+                            10 * std::max(1, config.detail),  // slice count
+                             5 * std::max(1, config.detail)   // stack count
+                        );
+                        geometry.transform(erhe::math::mat4_swap_xy); // convert to axis = y
+                        return geometry;
+                    }
                 );
-                cone_geometry.transform(erhe::math::mat4_swap_xy); // convert to axis = y
 
                 make_brush(
                     Brush_data{
@@ -832,7 +901,7 @@ void Scene_builder::make_brushes(
         for (const auto& key_name : library.names) {
             execution_queue->enqueue(
                 [this, &editor_settings, &mesh_memory, &library, &key_name]() {
-                    auto geometry = library.make_geometry(key_name);
+                    auto geometry = library.make_geometry(key_name, m_geometry_cache.get());
                     if (geometry.get_polygon_count() == 0) {
                         return;
                     }
@@ -4,8 +4,11 @@
 #include "scene/collision_generator.hpp"
 #include "scene/frame_controller.hpp"
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -13,6 +16,7 @@ class btCollisionShape;
 
 namespace erhe::geometry {
     class Geometry;
+    class Geometry_cache;
 }
 namespace erhe::graphics {
     class Buffer_transfer_queue;
@@ -85,6 +89,10 @@ public:
         bool  cone                       {false};
         bool  platonic_solids            {true};
         bool  johnson_solids             {false};
+        bool  geometry_cache             {true};
+        // Generated and imported geometries are cached here. Clear after
+        // changing shape generators or parsers.
+        std::string geometry_cache_path  {"cache/geometry"};
     };
     Config config;
 
@@ -104,6 +112,7 @@ public:
         Viewport_config_window&         viewport_config_window,
         Viewport_windows&               viewport_windows
     );
+    ~Scene_builder() noexcept;
 
     // Public API
     void add_rendertarget_viewports(int count);
@@ -159,6 +168,13 @@ private:
 
     [[nodiscard]] auto build_info(Mesh_memory& mesh_memory) -> erhe::primitive::Build_info;
 
+    // Returns geometry from the geometry cache, or makes and caches it.
+    // key is from erhe::geometry::make_geometry_cache_key().
+    [[nodiscard]] auto make_cached_geometry(
+        uint64_t                                         key,
+        const std::function<erhe::geometry::Geometry()>& make
+    ) -> erhe::geometry::Geometry;
+
     void setup_cameras(
         erhe::graphics::Instance&       graphics_instance,
         erhe::imgui::Imgui_renderer&    imgui_renderer,
@@ -192,6 +208,8 @@ private:
 
     std::vector<std::shared_ptr<erhe::physics::ICollision_shape>> m_collision_shapes;
 
+    std::unique_ptr<erhe::geometry::Geometry_cache> m_geometry_cache;
+
     // Output
     std::shared_ptr<Viewport_window> m_primary_viewport_window;
     std::shared_ptr<Scene_root>      m_scene_root;
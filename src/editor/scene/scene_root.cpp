@@ -120,7 +120,14 @@ Scene_root::Scene_root(
 
     //m_scene->enable_flag_bits(erhe::Item_flags::show_in_ui);
     m_scene->get_root_node()->enable_flag_bits(erhe::Item_flags::invisible_parent);
-    m_physics_world  = erhe::physics::IWorld::create_unique();
+    erhe::physics::IWorld_create_info physics_world_create_info{};
+    if (editor_context != nullptr) {
+        physics_world_create_info.thread_pool = editor_context->thread_pool;
+        if (editor_context->editor_settings != nullptr) {
+            physics_world_create_info.thread_count = editor_context->editor_settings->physics.thread_count;
+        }
+    }
+    m_physics_world  = erhe::physics::IWorld::create_unique(physics_world_create_info);
     m_physics_world->set_on_body_activated(
         [this](erhe::physics::IRigid_body* rigid_body) {
             ERHE_VERIFY(rigid_body != nullptr);
@@ -112,7 +112,6 @@ void Brdf_slice_rendergraph_node::execute_rendergraph_node()
 
     m_forward_renderer.render_fullscreen(
         erhe::scene_renderer::Forward_renderer::Render_parameters{
-            .index_type         = gl::Draw_elements_type::unsigned_int, // Note: This indices are not used by render_fullscreen()
             .light_projections  = &light_projections,
             .lights             = {},
             .materials          = gsl::span<const std::shared_ptr<erhe::primitive::Material>>(&m_material, 1),
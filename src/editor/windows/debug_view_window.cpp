@@ -182,7 +182,6 @@ void Depth_to_color_rendergraph_node::execute_rendergraph_node()
 
     m_forward_renderer.render_fullscreen(
         erhe::scene_renderer::Forward_renderer::Render_parameters{
-            .index_type         = m_mesh_memory.buffer_info.index_type,
             .light_projections  = &light_projections,
             .lights             = layers.light()->lights,
             .materials          = {},
@@ -18,8 +18,6 @@
 #   include <imgui/imgui.h>
 #endif
 
-#include <taskflow/taskflow.hpp>  // Taskflow is header-only
-
 namespace editor
 {
 
@@ -162,9 +160,8 @@ void Operations::imgui()
     }
 
     if (make_button("Catmull-Clark", has_selection_mode, button_size)) {
-        tf::Executor& executor = m_context.operation_stack->get_executor();
-        executor.silent_async([this, mesh_context](){
-        m_context.operation_stack->queue(
+        m_context.operation_stack->get_task_graph().emplace([this, mesh_context](){
+            m_context.operation_stack->queue(
                 std::make_shared<Catmull_clark_subdivision_operation>(
                     mesh_context()
                 )
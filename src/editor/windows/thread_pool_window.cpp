@@ -0,0 +1,165 @@
+#include "windows/thread_pool_window.hpp"
+
+#include "editor_context.hpp"
+
+#include "erhe_concurrency/thread_pool.hpp"
+#include "erhe_imgui/imgui_windows.hpp"
+#include "erhe_profile/profile.hpp"
+
+#if defined(ERHE_GUI_LIBRARY_IMGUI)
+#   include <imgui/imgui.h>
+#endif
+
+#include <fmt/format.h>
+
+#include <array>
+
+namespace editor
+{
+
+Thread_pool_window::Thread_pool_window(
+    erhe::imgui::Imgui_renderer& imgui_renderer,
+    erhe::imgui::Imgui_windows&  imgui_windows,
+    Editor_context&              editor_context
+)
+    : erhe::imgui::Imgui_window{imgui_renderer, imgui_windows, "Thread Pool", "thread_pool"}
+    , m_context                {editor_context}
+{
+}
+
+#if defined(ERHE_GUI_LIBRARY_IMGUI)
+namespace {
+
+auto format_duration(const uint64_t ns) -> std::string
+{
+    if (ns < 1000) {
+        return fmt::format("{} ns", ns);
+    }
+    if (ns < 1000000) {
+        return fmt::format("{:.1f} us", static_cast<double>(ns) / 1000.0);
+    }
+    return fmt::format("{:.2f} ms", static_cast<double>(ns) / 1000000.0);
+}
+
+void histogram_imgui(const char* label, const erhe::concurrency::Histogram_snapshot& histogram)
+{
+    std::array<float, erhe::concurrency::c_histogram_bucket_count> values{};
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(histogram.buckets[i]);
+    }
+    ImGui::PlotHistogram(
+        label,
+        values.data(),
+        static_cast<int>(values.size()),
+        0,
+        nullptr,
+        0.0f,
+        FLT_MAX,
+        ImVec2{0.0f, 60.0f}
+    );
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Bucket i: < 2^i us, log2 scale");
+    }
+}
+
+} // anonymous namespace
+#endif
+
+void Thread_pool_window::imgui()
+{
+#if defined(ERHE_GUI_LIBRARY_IMGUI)
+    ERHE_PROFILE_FUNCTION();
+
+    erhe::concurrency::Thread_pool* thread_pool = m_context.thread_pool;
+    if (thread_pool == nullptr) {
+        return;
+    }
+
+    ImGui::Text(
+        "%d threads, %s",
+        thread_pool->size(),
+        (thread_pool->get_scheduling_mode() == erhe::concurrency::Scheduling_mode::work_stealing)
+            ? "work stealing"
+            : "global queues"
+    );
+
+    bool instrumentation_enabled = thread_pool->is_instrumentation_enabled();
+    if (ImGui::Checkbox("Instrumentation", &instrumentation_enabled)) {
+        thread_pool->set_instrumentation_enabled(instrumentation_enabled);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Reset")) {
+        thread_pool->reset_statistics();
+    }
+
+    const erhe::concurrency::Thread_pool_statistics statistics = thread_pool->get_statistics();
+    if (!statistics.instrumentation_enabled) {
+        ImGui::TextUnformatted("Enable instrumentation to collect statistics");
+    }
+
+    ImGui::Text(
+        "Queue depth: high %d, normal %d, low %d",
+        statistics.queue_depth[0],
+        statistics.queue_depth[1],
+        statistics.queue_depth[2]
+    );
+
+    if (ImGui::CollapsingHeader("Workers", ImGuiTreeNodeFlags_DefaultOpen)) {
+        int worker_index = 0;
+        for (const auto& worker : statistics.workers) {
+            const float busy_ratio = worker.get_busy_ratio();
+            ImGui::ProgressBar(
+                busy_ratio,
+                ImVec2{120.0f, 0.0f},
+                fmt::format("{:.0f}% busy", 100.0f * busy_ratio).c_str()
+            );
+            ImGui::SameLine();
+            ImGui::Text(
+                "#%d idle %.0f%% sleep %.0f%% tasks %llu stolen %llu",
+                worker_index++,
+                100.0f * worker.get_idle_ratio(),
+                100.0f * worker.get_sleep_ratio(),
+                static_cast<unsigned long long>(worker.tasks_executed),
+                static_cast<unsigned long long>(worker.tasks_stolen)
+            );
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Queues", ImGuiTreeNodeFlags_DefaultOpen)) {
+        for (const auto& queue : statistics.queues) {
+            const std::string label = fmt::format(
+                "{} - pending {} - latency mean {} p99 {} - execution mean {}###{}",
+                queue.name,
+                queue.pending_tasks,
+                format_duration(queue.latency.get_mean_ns()),
+                format_duration(queue.latency.get_percentile_ns(0.99f)),
+                format_duration(queue.execution.get_mean_ns()),
+                queue.name
+            );
+            if (!ImGui::TreeNodeEx(label.c_str(), ImGuiTreeNodeFlags_None)) {
+                continue;
+            }
+            ImGui::Text("Priority %d, %llu tasks", queue.priority, static_cast<unsigned long long>(queue.latency.count));
+            ImGui::Text(
+                "Latency   p50 %s p90 %s p99 %s max %s",
+                format_duration(queue.latency.get_percentile_ns(0.50f)).c_str(),
+                format_duration(queue.latency.get_percentile_ns(0.90f)).c_str(),
+                format_duration(queue.latency.get_percentile_ns(0.99f)).c_str(),
+                format_duration(queue.latency.max_ns).c_str()
+            );
+            histogram_imgui("Latency", queue.latency);
+            ImGui::Text(
+                "Execution p50 %s p90 %s p99 %s max %s",
+                format_duration(queue.execution.get_percentile_ns(0.50f)).c_str(),
+                format_duration(queue.execution.get_percentile_ns(0.90f)).c_str(),
+                format_duration(queue.execution.get_percentile_ns(0.99f)).c_str(),
+                format_duration(queue.execution.max_ns).c_str()
+            );
+            histogram_imgui("Execution", queue.execution);
+            ImGui::TreePop();
+        }
+    }
+#endif
+}
+
+} // namespace editor
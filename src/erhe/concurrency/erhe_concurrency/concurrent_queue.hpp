@@ -2,6 +2,7 @@
 
 #include "erhe_concurrency/thread_pool.hpp"
 
+#include <functional>
 #include <string_view>
 
 namespace erhe::concurrency {
@@ -51,13 +52,19 @@ public:
     template <class F, class... Args>
     void enqueue(F&& f, Args&&... args)
     {
-        m_pool.enqueue(
-            &m_queue,
-            std::bind(
-                std::forward<F>(f),
-                std::forward<Args>(args)...
-            )
-        );
+        if constexpr (sizeof...(Args) == 0) {
+            m_pool.enqueue(&m_queue, Inline_task{std::forward<F>(f)});
+        } else {
+            m_pool.enqueue(
+                &m_queue,
+                Inline_task{
+                    [f = std::forward<F>(f), ...args = std::forward<Args>(args)]() mutable
+                    {
+                        std::invoke(f, args...);
+                    }
+                }
+            );
+        }
     }
 
     void steal ();
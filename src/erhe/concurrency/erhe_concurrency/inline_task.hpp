@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace erhe::concurrency {
+
+/*
+    Inline_task is a move-only replacement for std::function<void()> used for
+    tasks submitted to Thread_pool, Serial_queue and Task_graph.
+
+    Callables up to c_capacity bytes with nothrow move constructor are stored
+    inline, without heap allocation. Larger callables fall back to heap
+    storage.
+*/
+class Inline_task
+{
+public:
+    static constexpr std::size_t c_capacity  = 48;
+    static constexpr std::size_t c_alignment = alignof(std::max_align_t);
+
+    Inline_task() noexcept = default;
+
+    template <
+        typename F,
+        typename = std::enable_if_t<
+            !std::is_same_v<std::decay_t<F>, Inline_task> &&
+            std::is_invocable_v<std::decay_t<F>&>
+        >
+    >
+    Inline_task(F&& f)
+    {
+        using Function = std::decay_t<F>;
+        if constexpr (is_stored_inline<Function>()) {
+            ::new (static_cast<void*>(m_storage)) Function(std::forward<F>(f));
+            m_operations = &s_inline_operations<Function>;
+        } else {
+            *reinterpret_cast<Function**>(m_storage) = new Function(std::forward<F>(f));
+            m_operations = &s_heap_operations<Function>;
+        }
+    }
+
+    Inline_task(Inline_task&& other) noexcept
+        : m_operations{other.m_operations}
+    {
+        if (m_operations != nullptr) {
+            m_operations->move(m_storage, other.m_storage);
+            other.m_operations = nullptr;
+        }
+    }
+
+    auto operator=(Inline_task&& other) noexcept -> Inline_task&
+    {
+        if (this != &other) {
+            reset();
+            m_operations = other.m_operations;
+            if (m_operations != nullptr) {
+                m_operations->move(m_storage, other.m_storage);
+                other.m_operations = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    Inline_task(const Inline_task&) = delete;
+    auto operator=(const Inline_task&) -> Inline_task& = delete;
+
+    ~Inline_task() noexcept
+    {
+        reset();
+    }
+
+    void operator()()
+    {
+        m_operations->invoke(m_storage);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_operations != nullptr;
+    }
+
+    void reset() noexcept
+    {
+        if (m_operations != nullptr) {
+            m_operations->destroy(m_storage);
+            m_operations = nullptr;
+        }
+    }
+
+    [[nodiscard]] auto is_heap_allocated() const noexcept -> bool
+    {
+        return (m_operations != nullptr) && m_operations->heap_allocated;
+    }
+
+    template <typename F>
+    [[nodiscard]] static constexpr auto is_stored_inline() -> bool
+    {
+        return
+            (sizeof(F) <= c_capacity) &&
+            (alignof(F) <= c_alignment) &&
+            std::is_nothrow_move_constructible_v<F>;
+    }
+
+private:
+    struct Operations
+    {
+        void (*invoke )(void* storage);
+        void (*move   )(void* destination, void* source) noexcept;
+        void (*destroy)(void* storage) noexcept;
+        bool heap_allocated;
+    };
+
+    template <typename F>
+    static constexpr Operations s_inline_operations{
+        [](void* storage)
+        {
+            (*static_cast<F*>(storage))();
+        },
+        [](void* destination, void* source) noexcept
+        {
+            F* const f = static_cast<F*>(source);
+            ::new (destination) F(std::move(*f));
+            f->~F();
+        },
+        [](void* storage) noexcept
+        {
+            static_cast<F*>(storage)->~F();
+        },
+        false
+    };
+
+    template <typename F>
+    static constexpr Operations s_heap_operations{
+        [](void* storage)
+        {
+            (**static_cast<F**>(storage))();
+        },
+        [](void* destination, void* source) noexcept
+        {
+            *static_cast<F**>(destination) = *static_cast<F**>(source);
+        },
+        [](void* storage) noexcept
+        {
+            delete *static_cast<F**>(storage);
+        },
+        true
+    };
+
+    alignas(c_alignment) unsigned char m_storage[c_capacity];
+    const Operations*                  m_operations{nullptr};
+};
+
+} // namespace erhe::concurrency
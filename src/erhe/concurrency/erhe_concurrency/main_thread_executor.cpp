@@ -0,0 +1,51 @@
+#include "erhe_concurrency/main_thread_executor.hpp"
+
+namespace erhe::concurrency {
+
+Main_thread_executor::Main_thread_executor()
+    : m_main_thread_id{std::this_thread::get_id()}
+{
+}
+
+void Main_thread_executor::Awaiter::await_suspend(const std::coroutine_handle<> handle)
+{
+    m_executor.enqueue(
+        [handle]()
+        {
+            handle.resume();
+        }
+    );
+}
+
+void Main_thread_executor::enqueue(Inline_task&& task)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_tasks.push_back(std::move(task));
+}
+
+auto Main_thread_executor::schedule() -> Awaiter
+{
+    return Awaiter{*this};
+}
+
+auto Main_thread_executor::drain() -> std::size_t
+{
+    // Tasks enqueued while draining are executed on next drain()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        std::swap(m_tasks, m_executing);
+    }
+    const std::size_t count = m_executing.size();
+    for (Inline_task& task : m_executing) {
+        task();
+    }
+    m_executing.clear();
+    return count;
+}
+
+auto Main_thread_executor::is_main_thread() const -> bool
+{
+    return std::this_thread::get_id() == m_main_thread_id;
+}
+
+} // namespace erhe::concurrency
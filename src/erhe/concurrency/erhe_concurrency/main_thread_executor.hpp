@@ -0,0 +1,63 @@
+#pragma once
+
+#include "erhe_concurrency/inline_task.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace erhe::concurrency {
+
+/*
+    Main_thread_executor collects tasks and coroutines that must run on the
+    main thread, for example code making OpenGL calls. The main thread calls
+    drain() once per frame to execute them.
+
+    From a coroutine:
+
+    co_await main_thread_executor.schedule(); // continue on the main thread
+*/
+class Main_thread_executor
+{
+public:
+    // The constructing thread is considered the main thread
+    Main_thread_executor();
+
+    class Awaiter
+    {
+    public:
+        explicit Awaiter(Main_thread_executor& executor) noexcept
+            : m_executor{executor}
+        {
+        }
+
+        auto await_ready() const noexcept -> bool
+        {
+            return m_executor.is_main_thread();
+        }
+
+        void await_suspend(std::coroutine_handle<> handle);
+
+        void await_resume() const noexcept
+        {
+        }
+
+    private:
+        Main_thread_executor& m_executor;
+    };
+
+    void enqueue       (Inline_task&& task);
+    auto schedule      () -> Awaiter;
+    auto drain         () -> std::size_t; // Returns number of tasks executed
+    auto is_main_thread() const -> bool;
+
+private:
+    std::thread::id          m_main_thread_id;
+    std::mutex               m_mutex;
+    std::vector<Inline_task> m_tasks;
+    std::vector<Inline_task> m_executing; // only accessed by main thread
+};
+
+} // namespace erhe::concurrency
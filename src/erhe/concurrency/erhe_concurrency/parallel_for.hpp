@@ -0,0 +1,243 @@
+#pragma once
+
+#include "erhe_concurrency/concurrent_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace erhe::concurrency {
+
+/*
+    parallel_for() and parallel_reduce() split an index range into chunks and
+    process the chunks in the Thread_pool. The calling thread participates
+    in the work and returns when all chunks have been processed.
+
+    Ranges smaller than c_parallel_serial_threshold elements, or pools without
+    worker threads, are processed serially on the calling thread. Grain size
+    zero selects adaptive chunking: the range is split into a few chunks per
+    worker, and chunks are claimed dynamically so that faster workers take
+    more chunks.
+
+    Usage example:
+
+    parallel_for(pool, 0u, count, [&](uint32_t i) { out[i] = f(in[i]); });
+
+    const float sum = parallel_reduce(
+        pool, 0u, count, 0.0f,
+        [&](uint32_t i) { return values[i]; },
+        [](float a, float b) { return a + b; }
+    );
+*/
+
+inline constexpr std::size_t c_parallel_serial_threshold  = 1024;
+inline constexpr std::size_t c_parallel_min_grain_size    = 64;
+inline constexpr std::size_t c_parallel_chunks_per_worker = 8;
+
+namespace detail {
+
+[[nodiscard]] inline auto get_grain_size(
+    const Thread_pool& pool,
+    const std::size_t  count,
+    const std::size_t  grain_size
+) -> std::size_t
+{
+    if (grain_size > 0) {
+        return grain_size;
+    }
+    const std::size_t worker_count = static_cast<std::size_t>(pool.size()) + 1; // + calling thread
+    const std::size_t target_chunk_count = worker_count * c_parallel_chunks_per_worker;
+    return std::max(c_parallel_min_grain_size, (count + target_chunk_count - 1) / target_chunk_count);
+}
+
+// Calls chunk_function(chunk_index, chunk_begin, chunk_end) for each chunk
+template <typename Index, typename Chunk_function>
+void for_each_chunk(
+    Thread_pool&      pool,
+    const Index       begin,
+    const Index       end,
+    const std::size_t grain_size,
+    const std::size_t chunk_count,
+    Chunk_function&   chunk_function
+)
+{
+    std::atomic<std::size_t> next_chunk{0};
+    auto worker = [&]()
+    {
+        for (;;) {
+            const std::size_t chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunk_count) {
+                return;
+            }
+            const Index chunk_begin = static_cast<Index>(begin + chunk * grain_size);
+            const Index chunk_end   = static_cast<Index>(
+                std::min<std::size_t>(static_cast<std::size_t>(end - begin), (chunk + 1) * grain_size) + begin
+            );
+            chunk_function(chunk, chunk_begin, chunk_end);
+        }
+    };
+
+    const std::size_t helper_count = std::min<std::size_t>(
+        static_cast<std::size_t>(pool.size()),
+        chunk_count - 1
+    );
+    Concurrent_queue queue{pool, "parallel_for"};
+    for (std::size_t i = 0; i < helper_count; ++i) {
+        queue.enqueue(
+            [&worker]()
+            {
+                worker();
+            }
+        );
+    }
+    worker();
+    queue.wait();
+}
+
+} // namespace detail
+
+// Calls function(chunk_begin, chunk_end) for disjoint subranges of [begin, end)
+template <typename Index, typename Function>
+void parallel_for_range(
+    Thread_pool&      pool,
+    const Index       begin,
+    const Index       end,
+    Function&&        function,
+    const std::size_t grain_size = 0
+)
+{
+    static_assert(std::is_integral_v<Index>, "parallel_for_range() requires integral index type");
+    if (end <= begin) {
+        return;
+    }
+    const std::size_t count = static_cast<std::size_t>(end - begin);
+    if ((count < c_parallel_serial_threshold) || (pool.size() == 0)) {
+        function(begin, end);
+        return;
+    }
+
+    const std::size_t grain       = detail::get_grain_size(pool, count, grain_size);
+    const std::size_t chunk_count = (count + grain - 1) / grain;
+    if (chunk_count <= 1) {
+        function(begin, end);
+        return;
+    }
+
+    auto chunk_function = [&function](std::size_t, const Index chunk_begin, const Index chunk_end)
+    {
+        function(chunk_begin, chunk_end);
+    };
+    detail::for_each_chunk(pool, begin, end, grain, chunk_count, chunk_function);
+}
+
+// Calls function(i) for each i in [begin, end)
+template <typename Index, typename Function>
+void parallel_for(
+    Thread_pool&      pool,
+    const Index       begin,
+    const Index       end,
+    Function&&        function,
+    const std::size_t grain_size = 0
+)
+{
+    parallel_for_range(
+        pool,
+        begin,
+        end,
+        [&function](const Index chunk_begin, const Index chunk_end)
+        {
+            for (Index i = chunk_begin; i < chunk_end; ++i) {
+                function(i);
+            }
+        },
+        grain_size
+    );
+}
+
+// Calls function(i) for each i in [begin, end), each index claimed separately.
+// Unlike parallel_for(), there is no serial threshold: this is meant for few
+// items with a lot of work each, such as building meshes for many geometries.
+template <typename Index, typename Function>
+void parallel_for_each_task(
+    Thread_pool& pool,
+    const Index  begin,
+    const Index  end,
+    Function&&   function
+)
+{
+    static_assert(std::is_integral_v<Index>, "parallel_for_each_task() requires integral index type");
+    if (end <= begin) {
+        return;
+    }
+    const std::size_t count = static_cast<std::size_t>(end - begin);
+    if ((count == 1) || (pool.size() == 0)) {
+        for (Index i = begin; i < end; ++i) {
+            function(i);
+        }
+        return;
+    }
+
+    auto chunk_function = [&function](std::size_t, const Index chunk_begin, const Index)
+    {
+        function(chunk_begin);
+    };
+    detail::for_each_chunk(pool, begin, end, 1, count, chunk_function);
+}
+
+// Returns reduce(... reduce(reduce(identity, map(begin)), map(begin + 1)) ..., map(end - 1)).
+// Partial results are combined in chunk order, so the result is deterministic
+// for a given grain size, even when reduce is not associative in floating point.
+template <typename T, typename Index, typename Map, typename Reduce>
+[[nodiscard]] auto parallel_reduce(
+    Thread_pool&      pool,
+    const Index       begin,
+    const Index       end,
+    const T&          identity,
+    Map&&             map,
+    Reduce&&          reduce,
+    const std::size_t grain_size = 0
+) -> T
+{
+    static_assert(std::is_integral_v<Index>, "parallel_reduce() requires integral index type");
+    if (end <= begin) {
+        return identity;
+    }
+
+    auto reduce_range = [&map, &reduce, &identity](const Index range_begin, const Index range_end) -> T
+    {
+        T result = identity;
+        for (Index i = range_begin; i < range_end; ++i) {
+            result = reduce(std::move(result), map(i));
+        }
+        return result;
+    };
+
+    const std::size_t count = static_cast<std::size_t>(end - begin);
+    if ((count < c_parallel_serial_threshold) || (pool.size() == 0)) {
+        return reduce_range(begin, end);
+    }
+
+    const std::size_t grain       = detail::get_grain_size(pool, count, grain_size);
+    const std::size_t chunk_count = (count + grain - 1) / grain;
+    if (chunk_count <= 1) {
+        return reduce_range(begin, end);
+    }
+
+    std::vector<T> partial_results(chunk_count, identity);
+    auto chunk_function = [&](const std::size_t chunk, const Index chunk_begin, const Index chunk_end)
+    {
+        partial_results[chunk] = reduce_range(chunk_begin, chunk_end);
+    };
+    detail::for_each_chunk(pool, begin, end, grain, chunk_count, chunk_function);
+
+    T result = identity;
+    for (T& partial_result : partial_results) {
+        result = reduce(std::move(result), std::move(partial_result));
+    }
+    return result;
+}
+
+} // namespace erhe::concurrency
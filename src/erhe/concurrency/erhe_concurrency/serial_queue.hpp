@@ -1,5 +1,7 @@
 #pragma once
 
+#include "erhe_concurrency/inline_task.hpp"
+
 #include <atomic>
 #include <condition_variable>
 #include <deque>
@@ -42,7 +44,7 @@ namespace erhe::concurrency {
 class Serial_queue
 {
 protected:
-    using Task = std::function<void()>;
+    using Task = Inline_task;
 
     std::string m_name;
     std::thread m_thread;
@@ -75,7 +77,16 @@ public:
     {
         std::unique_lock<std::mutex> lock{m_queue_mutex};
 
-        m_task_queue.emplace_back(f, (args)...);
+        if constexpr (sizeof...(Args) == 0) {
+            m_task_queue.emplace_back(std::forward<F>(f));
+        } else {
+            m_task_queue.emplace_back(
+                [f = std::forward<F>(f), ...args = std::forward<Args>(args)]() mutable
+                {
+                    std::invoke(f, args...);
+                }
+            );
+        }
         ++m_task_counter;
         m_task_condition.notify_one();
     }
@@ -0,0 +1,393 @@
+#pragma once
+
+#include "erhe_concurrency/serial_queue.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace erhe::concurrency {
+
+/*
+    Task<T> is a lazily started coroutine returning T. A Task starts when it
+    is awaited, and the awaiting coroutine is resumed when the Task completes,
+    on whichever thread completed it.
+
+    Awaiting schedule_on(thread_pool), schedule_on(serial_queue), or the
+    pool / queue directly, resumes the coroutine in that pool or queue.
+    Main_thread_executor::schedule() resumes it on the main thread.
+
+    Usage example:
+
+    auto import(Thread_pool& pool, Main_thread_executor& main) -> Task<void>
+    {
+        co_await pool;           // continue in thread pool
+        auto data = parse();     // CPU work off the main thread
+        co_await main.schedule();// hop back to main thread
+        upload(data);            // GL calls
+    }
+
+    spawn(import(pool, main));   // start without waiting
+*/
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+class Task_promise_base
+{
+public:
+    class Final_awaiter
+    {
+    public:
+        auto await_ready() const noexcept -> bool
+        {
+            return false;
+        }
+
+        template <typename Promise>
+        auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> std::coroutine_handle<>
+        {
+            const std::coroutine_handle<> continuation = handle.promise().m_continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() noexcept
+        {
+        }
+    };
+
+    auto initial_suspend() noexcept -> std::suspend_always
+    {
+        return {};
+    }
+
+    auto final_suspend() noexcept -> Final_awaiter
+    {
+        return {};
+    }
+
+    void unhandled_exception() noexcept
+    {
+        m_exception = std::current_exception();
+    }
+
+    void set_continuation(const std::coroutine_handle<> continuation) noexcept
+    {
+        m_continuation = continuation;
+    }
+
+protected:
+    void rethrow_if_exception()
+    {
+        if (m_exception) {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+private:
+    std::coroutine_handle<> m_continuation;
+    std::exception_ptr      m_exception;
+};
+
+template <typename T>
+class Task_promise
+    : public Task_promise_base
+{
+public:
+    auto get_return_object() noexcept -> Task<T>;
+
+    template <typename U>
+    void return_value(U&& value)
+    {
+        m_value.emplace(std::forward<U>(value));
+    }
+
+    auto result() -> T
+    {
+        rethrow_if_exception();
+        return std::move(m_value.value());
+    }
+
+private:
+    std::optional<T> m_value;
+};
+
+template <>
+class Task_promise<void>
+    : public Task_promise_base
+{
+public:
+    auto get_return_object() noexcept -> Task<void>;
+
+    void return_void() noexcept
+    {
+    }
+
+    void result()
+    {
+        rethrow_if_exception();
+    }
+};
+
+// Eagerly started coroutine which destroys itself when complete
+class Detached_task
+{
+public:
+    class promise_type
+    {
+    public:
+        auto get_return_object  () noexcept -> Detached_task       { return {}; }
+        auto initial_suspend    () noexcept -> std::suspend_never  { return {}; }
+        auto final_suspend      () noexcept -> std::suspend_never  { return {}; }
+        void return_void        () noexcept                        {}
+        void unhandled_exception() noexcept                        { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+template <typename T>
+class Task
+{
+public:
+    using promise_type = detail::Task_promise<T>;
+    using Handle       = std::coroutine_handle<promise_type>;
+
+    Task() noexcept = default;
+
+    explicit Task(const Handle handle) noexcept
+        : m_handle{handle}
+    {
+    }
+
+    Task(Task&& other) noexcept
+        : m_handle{std::exchange(other.m_handle, {})}
+    {
+    }
+
+    auto operator=(Task&& other) noexcept -> Task&
+    {
+        if (this != &other) {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    auto operator=(const Task&) -> Task& = delete;
+
+    ~Task() noexcept
+    {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    [[nodiscard]] auto is_valid() const noexcept -> bool
+    {
+        return static_cast<bool>(m_handle);
+    }
+
+    [[nodiscard]] auto is_done() const noexcept -> bool
+    {
+        return !m_handle || m_handle.done();
+    }
+
+    auto operator co_await() && noexcept
+    {
+        class Awaiter
+        {
+        public:
+            explicit Awaiter(const Handle handle) noexcept
+                : m_handle{handle}
+            {
+            }
+
+            auto await_ready() const noexcept -> bool
+            {
+                return !m_handle || m_handle.done();
+            }
+
+            auto await_suspend(const std::coroutine_handle<> continuation) noexcept -> std::coroutine_handle<>
+            {
+                m_handle.promise().set_continuation(continuation);
+                return m_handle;
+            }
+
+            auto await_resume() -> T
+            {
+                return m_handle.promise().result();
+            }
+
+        private:
+            Handle m_handle;
+        };
+        return Awaiter{m_handle};
+    }
+
+private:
+    Handle m_handle;
+};
+
+namespace detail {
+
+template <typename T>
+inline auto Task_promise<T>::get_return_object() noexcept -> Task<T>
+{
+    return Task<T>{std::coroutine_handle<Task_promise<T>>::from_promise(*this)};
+}
+
+inline auto Task_promise<void>::get_return_object() noexcept -> Task<void>
+{
+    return Task<void>{std::coroutine_handle<Task_promise<void>>::from_promise(*this)};
+}
+
+inline auto run_detached(Task<void> task) -> Detached_task
+{
+    co_await std::move(task);
+}
+
+} // namespace detail
+
+// Starts task without waiting for it. Task must not throw.
+inline void spawn(Task<void>&& task)
+{
+    detail::run_detached(std::move(task));
+}
+
+// Starts task and blocks the calling thread until it completes.
+// Do not call from a thread the task depends on (for example
+// main thread, when the task awaits Main_thread_executor).
+template <typename T>
+auto sync_wait(Task<T>&& task) -> T
+{
+    std::mutex              mutex;
+    std::condition_variable condition;
+    bool                    done{false};
+    std::exception_ptr      exception;
+    std::conditional_t<std::is_void_v<T>, bool, std::optional<T>> result{};
+
+    auto body = [&]() -> detail::Detached_task
+    {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(task);
+            } else {
+                result.emplace(co_await std::move(task));
+            }
+        } catch (...) {
+            exception = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock{mutex};
+        done = true;
+        condition.notify_one();
+    };
+    body();
+
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        condition.wait(lock, [&done]{ return done; });
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(result.value());
+    }
+}
+
+// Awaitable which resumes the awaiting coroutine in the Thread_pool
+class Thread_pool_awaiter
+{
+public:
+    explicit Thread_pool_awaiter(Thread_pool& thread_pool) noexcept
+        : m_thread_pool{thread_pool}
+    {
+    }
+
+    auto await_ready() const noexcept -> bool
+    {
+        return false;
+    }
+
+    void await_suspend(const std::coroutine_handle<> handle)
+    {
+        m_thread_pool.enqueue(
+            [handle]()
+            {
+                handle.resume();
+            }
+        );
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+private:
+    Thread_pool& m_thread_pool;
+};
+
+// Awaitable which resumes the awaiting coroutine in the Serial_queue thread
+class Serial_queue_awaiter
+{
+public:
+    explicit Serial_queue_awaiter(Serial_queue& serial_queue) noexcept
+        : m_serial_queue{serial_queue}
+    {
+    }
+
+    auto await_ready() const noexcept -> bool
+    {
+        return false;
+    }
+
+    void await_suspend(const std::coroutine_handle<> handle)
+    {
+        m_serial_queue.enqueue(
+            [handle]()
+            {
+                handle.resume();
+            }
+        );
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+private:
+    Serial_queue& m_serial_queue;
+};
+
+[[nodiscard]] inline auto schedule_on(Thread_pool& thread_pool) -> Thread_pool_awaiter
+{
+    return Thread_pool_awaiter{thread_pool};
+}
+
+[[nodiscard]] inline auto schedule_on(Serial_queue& serial_queue) -> Serial_queue_awaiter
+{
+    return Serial_queue_awaiter{serial_queue};
+}
+
+[[nodiscard]] inline auto operator co_await(Thread_pool& thread_pool) -> Thread_pool_awaiter
+{
+    return Thread_pool_awaiter{thread_pool};
+}
+
+[[nodiscard]] inline auto operator co_await(Serial_queue& serial_queue) -> Serial_queue_awaiter
+{
+    return Serial_queue_awaiter{serial_queue};
+}
+
+} // namespace erhe::concurrency
@@ -0,0 +1,268 @@
+#include "erhe_concurrency/task_graph.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <thread>
+
+namespace erhe::concurrency {
+
+struct Task_handle::Node
+{
+    explicit Node(Inline_task&& func)
+        : func{std::move(func)}
+    {
+    }
+
+    Inline_task        func;
+    std::vector<Node*> successors;         // protected by Task_graph::m_mutex
+    std::atomic<int>   join_counter{1};    // unfinished predecessors + 1 until released
+    std::atomic<bool>  completed   {false};
+    bool               released    {false}; // protected by Task_graph::m_mutex
+};
+
+Task_handle::Task_handle(Task_graph* graph, Node* node)
+    : m_graph{graph}
+    , m_node {node}
+{
+}
+
+auto Task_handle::then(Inline_task&& func) -> Task_handle
+{
+    if (m_graph == nullptr) {
+        return Task_handle{};
+    }
+    return m_graph->join({*this}, std::move(func));
+}
+
+void Task_handle::precede(const Task_handle successor)
+{
+    if (m_graph == nullptr) {
+        return;
+    }
+    m_graph->add_dependency(*this, successor);
+}
+
+void Task_handle::succeed(const Task_handle predecessor)
+{
+    if (m_graph == nullptr) {
+        return;
+    }
+    m_graph->add_dependency(predecessor, *this);
+}
+
+auto Task_handle::is_valid() const -> bool
+{
+    return m_node != nullptr;
+}
+
+auto Task_handle::is_completed() const -> bool
+{
+    return (m_node != nullptr) && m_node->completed.load(std::memory_order_acquire);
+}
+
+// ------------------------------------------------------------
+// Task_graph
+// ------------------------------------------------------------
+
+Task_graph::Task_graph(Thread_pool& thread_pool)
+    : m_pool {thread_pool}
+    , m_queue{&m_pool, int(Priority::NORMAL), "task_graph.default"}
+{
+}
+
+Task_graph::Task_graph(
+    Thread_pool&           thread_pool,
+    const std::string_view name,
+    Priority               priority
+)
+    : m_pool {thread_pool}
+    , m_queue{&m_pool, static_cast<int>(priority), name}
+{
+}
+
+Task_graph::~Task_graph() noexcept
+{
+    wait();
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    ERHE_VERIFY(m_incomplete_count == 0); // Tasks were added but run() was never called
+}
+
+auto Task_graph::make_node(
+    Inline_task&&                   func,
+    const std::vector<Task_handle>& predecessors
+) -> Task_handle::Node*
+{
+    Task_handle::Node* node{nullptr};
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        node = m_nodes.emplace_back(std::make_unique<Task_handle::Node>(std::move(func))).get();
+        ++m_incomplete_count;
+        for (const Task_handle& predecessor : predecessors) {
+            if (predecessor.is_valid()) {
+                add_edge(predecessor.m_node, node);
+            }
+        }
+        if (!m_running) {
+            return node; // released by run()
+        }
+        node->released = true;
+    }
+    release(node);
+    return node;
+}
+
+void Task_graph::add_edge(Task_handle::Node* predecessor, Task_handle::Node* successor)
+{
+    // m_mutex must be held by caller
+    if (predecessor->completed.load(std::memory_order_relaxed)) {
+        return;
+    }
+    successor->join_counter.fetch_add(1, std::memory_order_relaxed);
+    predecessor->successors.push_back(successor);
+}
+
+void Task_graph::release(Task_handle::Node* node)
+{
+    if (node->join_counter.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        m_pool.enqueue(
+            &m_queue,
+            [this, node]()
+            {
+                execute(node);
+            }
+        );
+    }
+}
+
+void Task_graph::execute(Task_handle::Node* node)
+{
+    if (node->func) {
+        node->func();
+    }
+
+    std::vector<Task_handle::Node*> successors;
+    bool                            all_completed{false};
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        node->completed.store(true, std::memory_order_release);
+        successors.swap(node->successors);
+        all_completed = (--m_incomplete_count == 0);
+    }
+    if (all_completed) {
+        m_completion_condition.notify_all();
+    }
+
+    // Successors are enqueued before this task is retired from m_queue,
+    // so Thread_pool::wait() cannot observe a false idle state.
+    for (Task_handle::Node* successor : successors) {
+        release(successor);
+    }
+}
+
+auto Task_graph::emplace(Inline_task&& func) -> Task_handle
+{
+    return Task_handle{this, make_node(std::move(func), {})};
+}
+
+auto Task_graph::join(
+    const std::initializer_list<Task_handle> predecessors,
+    Inline_task&&                            func
+) -> Task_handle
+{
+    return join(std::vector<Task_handle>{predecessors}, std::move(func));
+}
+
+auto Task_graph::join(
+    const std::vector<Task_handle>& predecessors,
+    Inline_task&&                   func
+) -> Task_handle
+{
+    return Task_handle{this, make_node(std::move(func), predecessors)};
+}
+
+void Task_graph::add_dependency(const Task_handle predecessor, const Task_handle successor)
+{
+    if (!predecessor.is_valid() || !successor.is_valid()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock{m_mutex};
+    add_edge(predecessor.m_node, successor.m_node);
+}
+
+void Task_graph::run()
+{
+    std::vector<Task_handle::Node*> nodes;
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_running) {
+            return;
+        }
+        m_running = true;
+        nodes.reserve(m_nodes.size());
+        for (const auto& node : m_nodes) {
+            if (!node->released) {
+                node->released = true;
+                nodes.push_back(node.get());
+            }
+        }
+    }
+    for (Task_handle::Node* node : nodes) {
+        release(node);
+    }
+}
+
+void Task_graph::wait()
+{
+    m_pool.wait(&m_queue);
+}
+
+void Task_graph::wait(const Task_handle task)
+{
+    if (!task.is_valid()) {
+        return;
+    }
+    ERHE_VERIFY(is_running()); // Tasks are not released before run(), waiting would never return
+    while (!task.is_completed()) {
+        if (!m_pool.dequeue_and_process()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void Task_graph::wait_for_completion()
+{
+    if (m_pool.size() == 0) {
+        wait();
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        ERHE_VERIFY(m_running || (m_incomplete_count == 0)); // Tasks are not released before run()
+        m_completion_condition.wait(lock, [this]{ return m_incomplete_count == 0; });
+    }
+
+    // Pool tasks of completed nodes may still be returning; they are retired
+    // from m_queue shortly, no need to help the pool for that.
+    while (m_queue.task_counter.load() > 0) {
+        std::this_thread::yield();
+    }
+}
+
+void Task_graph::clear()
+{
+    wait();
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    ERHE_VERIFY(m_incomplete_count == 0); // Tasks were added but run() was never called
+    m_nodes.clear();
+    m_running = false;
+}
+
+auto Task_graph::is_running() const -> bool
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_running;
+}
+
+} // namespace erhe::concurrency
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "erhe_concurrency/inline_task.hpp"
+#include "erhe_concurrency/thread_pool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace erhe::concurrency {
+
+class Task_graph;
+
+/*
+    Task_handle refers to a task in a Task_graph. Handles are cheap to copy
+    and remain valid until Task_graph::clear() is called or the graph is
+    destroyed.
+*/
+class Task_handle
+{
+public:
+    Task_handle() = default;
+
+    // Adds a task that runs after this task has completed. Returns invalid
+    // handle, and adds no task, when called on an invalid handle.
+    auto then   (Inline_task&& func) -> Task_handle;
+
+    // Makes this task run before / after other task. No-op for invalid handles.
+    void precede(Task_handle successor);
+    void succeed(Task_handle predecessor);
+
+    [[nodiscard]] auto is_valid    () const -> bool;
+    [[nodiscard]] auto is_completed() const -> bool;
+
+private:
+    friend class Task_graph;
+
+    struct Node;
+
+    Task_handle(Task_graph* graph, Node* node);
+
+    Task_graph* m_graph{nullptr};
+    Node*       m_node {nullptr};
+};
+
+/*
+    Task_graph is API to submit tasks with dependencies into the Thread_pool.
+    Each task has a join counter of unfinished predecessors; a task is
+    enqueued to the Thread_pool when its join counter reaches zero. Tasks
+    can be added before or during run(), continuations added to already
+    completed tasks are scheduled immediately.
+
+    Usage example:
+
+    Task_graph graph{thread_pool, "import"};
+
+    auto parse    = graph.emplace([]{ parse(); });
+    auto geometry = parse.then([]{ build_geometry(); });
+    auto material = parse.then([]{ build_materials(); });
+    auto upload   = graph.join({geometry, material}, []{ upload(); });
+
+    graph.run();
+    graph.wait(geometry); // cooperative, waits for parse and geometry
+    graph.wait();         // cooperative, waits for all tasks
+
+    wait() helps the pool and may run any pool task, not only tasks of this
+    graph. wait_for_completion() blocks on a completion event instead, for
+    callers such as the frame loop where running unrelated tasks would cause
+    hitches.
+*/
+class Task_graph
+{
+public:
+    explicit Task_graph(Thread_pool& thread_pool);
+    Task_graph(
+        Thread_pool&           thread_pool,
+        const std::string_view name,
+        Priority               priority = Priority::NORMAL
+    );
+    ~Task_graph() noexcept;
+
+    Task_graph(const Task_graph&) = delete;
+    auto operator=(const Task_graph&) -> Task_graph = delete;
+
+    // Adds a task without dependencies
+    auto emplace(Inline_task&& func) -> Task_handle;
+
+    // Adds a task that runs after all predecessors have completed
+    auto join(
+        std::initializer_list<Task_handle> predecessors,
+        Inline_task&&                      func
+    ) -> Task_handle;
+    auto join(
+        const std::vector<Task_handle>& predecessors,
+        Inline_task&&                   func
+    ) -> Task_handle;
+
+    // Adds dependency edge predecessor -> successor. Must be called before
+    // successor has been released, that is before run() or, for tasks added
+    // while running, use then() or join() instead.
+    void add_dependency(Task_handle predecessor, Task_handle successor);
+
+    // Releases tasks to the Thread_pool. Tasks added after run() are
+    // released as soon as they are added.
+    void run();
+
+    // Cooperative, blocking (helps pool until tasks are complete)
+    void wait();
+    void wait(Task_handle task); // waits for task and all its predecessors, run() must have been called
+
+    // Blocking, does not run tasks; waits for completion of all tasks.
+    // Falls back to wait() when the pool has no worker threads.
+    void wait_for_completion();
+
+    // Waits for all tasks and removes them; invalidates all handles.
+    // Tasks must have been released with run(), as with the destructor.
+    void clear();
+
+    [[nodiscard]] auto is_running() const -> bool;
+
+private:
+    friend class Task_handle;
+
+    auto make_node(
+        Inline_task&&                   func,
+        const std::vector<Task_handle>& predecessors
+    ) -> Task_handle::Node*;
+    void add_edge (Task_handle::Node* predecessor, Task_handle::Node* successor);
+    void release  (Task_handle::Node* node);
+    void execute  (Task_handle::Node* node);
+
+    Thread_pool&                                    m_pool;
+    Thread_pool::Queue                              m_queue;
+    mutable std::mutex                              m_mutex;
+    std::condition_variable                         m_completion_condition;
+    std::vector<std::unique_ptr<Task_handle::Node>> m_nodes;
+    std::size_t                                     m_incomplete_count{0}; // protected by m_mutex
+    bool                                            m_running{false};
+};
+
+} // namespace erhe::concurrency
@@ -2,7 +2,9 @@
 
 #include <concurrentqueue.h>
 
+#include <algorithm>
 #include <chrono>
+#include <deque>
 
 namespace erhe::concurrency {
 
@@ -10,6 +12,29 @@ using std::chrono::high_resolution_clock;
 using std::chrono::duration_cast;
 using std::chrono::microseconds;
 using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+namespace {
+
+// Identifies the pool and the worker the calling thread belongs to, if any.
+thread_local const Thread_pool* t_pool        {nullptr};
+thread_local size_t             t_worker_index{0};
+
+auto next_random() -> uint32_t
+{
+    thread_local uint32_t state = static_cast<uint32_t>(
+        std::hash<std::thread::id>{}(std::this_thread::get_id())
+    ) | 1u;
+
+    // xorshift32
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+} // anonymous namespace
 
 // ------------------------------------------------------------
 // Thread_pool
@@ -23,12 +48,50 @@ struct Thread_pool::Task_queue
     moodycamel::ConcurrentQueue<Task> tasks;
 };
 
-Thread_pool::Thread_pool(size_t size)
-    : m_queues      {nullptr}
-    , m_static_queue{this, int(Priority::NORMAL), "static"}
-    , m_threads     {size}
+#if defined(_MSC_VER)
+#   pragma warning(push)
+#   pragma warning(disable : 4324)  // structure was padded due to alignment specifier
+#endif
+// Per-worker state used by Scheduling_mode::work_stealing.
+// The owning worker pushes and pops at the back of its deques (LIFO),
+// other threads steal from the front (FIFO).
+struct alignas(64) Thread_pool::Worker
+{
+    std::mutex              deque_mutex;
+    std::deque<Task>        deques[3];
+
+    std::mutex              sleep_mutex;
+    std::condition_variable sleep_condition;
+    bool                    wake_signal{false};
+    std::atomic<bool>       sleeping   {false};
+};
+
+// Per-worker counters used by instrumentation
+struct alignas(64) Thread_pool::Worker_statistics
+{
+    std::atomic<uint64_t> busy_ns       {0};
+    std::atomic<uint64_t> idle_ns       {0};
+    std::atomic<uint64_t> sleep_ns      {0};
+    std::atomic<uint64_t> tasks_executed{0};
+    std::atomic<uint64_t> tasks_stolen  {0};
+};
+#if defined(_MSC_VER)
+#   pragma warning(pop)
+#endif
+
+Thread_pool::Thread_pool(size_t size, Scheduling_mode scheduling_mode)
+    : m_queues           {nullptr}
+    , m_scheduling_mode  {scheduling_mode}
+    , m_worker_statistics{std::make_unique<Worker_statistics[]>(size)}
+    , m_static_queue     {this, int(Priority::NORMAL), "static"}
+    , m_threads          {size}
 {
+    // Global queues are used in both modes; in work stealing mode they
+    // receive tasks enqueued from threads that are not workers of this pool.
     m_queues = new Task_queue[3];
+    if (m_scheduling_mode == Scheduling_mode::work_stealing) {
+        m_workers = new Worker[size];
+    }
 
     // NOTE: let OS scheduler shuffle tasks as it sees fit
     //       this gives better performance overall UNTIL we have some practical
@@ -66,11 +129,22 @@ Thread_pool::~Thread_pool() noexcept
 {
     m_stop = true;
     m_condition.notify_all();
+    if (m_workers != nullptr) {
+        for (size_t i = 0, end = m_threads.size(); i < end; ++i) {
+            Worker& worker = m_workers[i];
+            {
+                std::lock_guard<std::mutex> lock{worker.sleep_mutex};
+                worker.wake_signal = true;
+            }
+            worker.sleep_condition.notify_one();
+        }
+    }
 
     for (auto& thread : m_threads) {
         thread.join();
     }
 
+    delete[] m_workers;
     delete[] m_queues;
 }
 
@@ -83,60 +157,355 @@ int Thread_pool::size() const
     return int(m_threads.size());
 }
 
+auto Thread_pool::get_scheduling_mode() const -> Scheduling_mode
+{
+    return m_scheduling_mode;
+}
+
+auto Thread_pool::current_worker() const -> Worker*
+{
+    return ((m_workers != nullptr) && (t_pool == this))
+        ? &m_workers[t_worker_index]
+        : nullptr;
+}
+
+void Thread_pool::set_instrumentation_enabled(const bool enabled)
+{
+    m_instrumentation_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+auto Thread_pool::is_instrumentation_enabled() const -> bool
+{
+    return m_instrumentation_enabled.load(std::memory_order_relaxed);
+}
+
+void Thread_pool::register_queue(Queue* queue)
+{
+    std::lock_guard<std::mutex> lock{m_registry_mutex};
+    m_registered_queues.push_back(queue);
+}
+
+void Thread_pool::unregister_queue(Queue* queue)
+{
+    std::lock_guard<std::mutex> lock{m_registry_mutex};
+    const auto i = std::find(m_registered_queues.begin(), m_registered_queues.end(), queue);
+    if (i != m_registered_queues.end()) {
+        m_registered_queues.erase(i);
+    }
+}
+
+auto Thread_pool::get_statistics() const -> Thread_pool_statistics
+{
+    Thread_pool_statistics statistics;
+    statistics.instrumentation_enabled = is_instrumentation_enabled();
+    for (size_t priority = 0; priority < 3; ++priority) {
+        statistics.queue_depth[priority] = m_queue_depth[priority].load(std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock{m_registry_mutex};
+        statistics.queues.reserve(m_registered_queues.size());
+        for (const Queue* queue : m_registered_queues) {
+            statistics.queues.push_back(
+                Queue_statistics_snapshot{
+                    .name          = queue->name,
+                    .priority      = queue->priority,
+                    .pending_tasks = queue->task_counter.load(std::memory_order_relaxed),
+                    .latency       = queue->latency.get_snapshot(),
+                    .execution     = queue->execution.get_snapshot()
+                }
+            );
+        }
+    }
+    statistics.workers.reserve(m_threads.size());
+    for (size_t i = 0, end = m_threads.size(); i < end; ++i) {
+        const Worker_statistics& worker = m_worker_statistics[i];
+        statistics.workers.push_back(
+            Worker_statistics_snapshot{
+                .busy_ns        = worker.busy_ns       .load(std::memory_order_relaxed),
+                .idle_ns        = worker.idle_ns       .load(std::memory_order_relaxed),
+                .sleep_ns       = worker.sleep_ns      .load(std::memory_order_relaxed),
+                .tasks_executed = worker.tasks_executed.load(std::memory_order_relaxed),
+                .tasks_stolen   = worker.tasks_stolen  .load(std::memory_order_relaxed)
+            }
+        );
+    }
+    return statistics;
+}
+
+void Thread_pool::reset_statistics()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_registry_mutex};
+        for (Queue* queue : m_registered_queues) {
+            queue->latency.reset();
+            queue->execution.reset();
+        }
+    }
+    for (size_t i = 0, end = m_threads.size(); i < end; ++i) {
+        Worker_statistics& worker = m_worker_statistics[i];
+        worker.busy_ns       .store(0, std::memory_order_relaxed);
+        worker.idle_ns       .store(0, std::memory_order_relaxed);
+        worker.sleep_ns      .store(0, std::memory_order_relaxed);
+        worker.tasks_executed.store(0, std::memory_order_relaxed);
+        worker.tasks_stolen  .store(0, std::memory_order_relaxed);
+    }
+}
+
 void Thread_pool::thread(size_t threadID)
 {
-    static_cast<void>(threadID);
+    t_pool         = this;
+    t_worker_index = threadID;
+
+    Worker_statistics& statistics = m_worker_statistics[threadID];
 
     auto time0 = high_resolution_clock::now();
+    auto iteration_start = time0;
 
     while (!m_stop.load(std::memory_order_relaxed)) {
+        const bool instrument = m_instrumentation_enabled.load(std::memory_order_relaxed);
         if (dequeue_and_process()) {
             // remember the last time we processed a task
             time0 = high_resolution_clock::now();
+            if (instrument) {
+                statistics.busy_ns += duration_cast<nanoseconds>(time0 - iteration_start).count();
+                ++statistics.tasks_executed;
+            }
+            iteration_start = time0;
         } else {
             const auto time1   = high_resolution_clock::now();
             const auto elapsed = time1 - time0;
+            bool slept = false;
             if (elapsed >= microseconds(1200)) {
-                std::unique_lock<std::mutex> lock{m_queue_mutex};
-
-                m_condition.wait_for(lock, milliseconds(120));
+                if (m_workers != nullptr) {
+                    sleep(m_workers[threadID]);
+                } else {
+                    std::unique_lock<std::mutex> lock{m_queue_mutex};
+
+                    m_condition.wait_for(lock, milliseconds(120));
+                }
+                slept = true;
             } else { // if (elapsed >= microseconds(2))
                 std::this_thread::yield();
             }
             //else {
             //    pause();
             //}
+            if (instrument) {
+                const auto time2 = high_resolution_clock::now();
+                statistics.idle_ns += duration_cast<nanoseconds>(time1 - iteration_start).count();
+                if (slept) {
+                    statistics.sleep_ns += duration_cast<nanoseconds>(time2 - time1).count();
+                } else {
+                    statistics.idle_ns += duration_cast<nanoseconds>(time2 - time1).count();
+                }
+                iteration_start = time2;
+            } else {
+                iteration_start = high_resolution_clock::now();
+            }
         }
     }
 }
 
-void Thread_pool::enqueue(Queue* queue, std::function<void()>&& func)
+void Thread_pool::enqueue(Queue* queue, Inline_task&& func)
 {
     Task task;
     task.queue = queue;
     task.func = std::move(func);
+    if (m_instrumentation_enabled.load(std::memory_order_relaxed)) {
+        task.enqueue_time = steady_clock::now();
+        m_queue_depth[queue->priority].fetch_add(1, std::memory_order_relaxed);
+    }
 
     ++queue->task_counter;
-    m_queues[queue->priority].tasks.enqueue(std::move(task));
 
-    m_condition.notify_one();
+    if (m_workers == nullptr) {
+        m_queues[queue->priority].tasks.enqueue(std::move(task));
+        m_condition.notify_one();
+        return;
+    }
+
+    // Tasks spawned from a worker go to its own deque, others are injected
+    // through the global queues.
+    Worker* const self = current_worker();
+    if (self != nullptr) {
+        std::lock_guard<std::mutex> lock{self->deque_mutex};
+        self->deques[queue->priority].push_back(std::move(task));
+    } else {
+        m_queues[queue->priority].tasks.enqueue(std::move(task));
+    }
+    wake_one();
 }
 
-bool Thread_pool::dequeue_and_process()
+void Thread_pool::process(Task& task)
+{
+    Queue* const queue = task.queue;
+
+    // Only tasks enqueued with instrumentation enabled have enqueue_time set
+    const bool instrument = (task.enqueue_time != steady_clock::time_point{});
+    steady_clock::time_point start_time;
+    if (instrument) {
+        m_queue_depth[queue->priority].fetch_sub(1, std::memory_order_relaxed);
+        start_time = steady_clock::now();
+        queue->latency.add(duration_cast<nanoseconds>(start_time - task.enqueue_time));
+    }
+
+    // check if the task is cancelled
+    if (!queue->cancelled) {
+        // process task
+        task.func();
+    }
+
+    if (instrument) {
+        queue->execution.add(duration_cast<nanoseconds>(steady_clock::now() - start_time));
+    }
+
+    --queue->task_counter;
+}
+
+bool Thread_pool::try_pop(Worker* self, size_t priority, Task& task)
+{
+    if (self == nullptr) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock{self->deque_mutex};
+    auto& deque = self->deques[priority];
+    if (deque.empty()) {
+        return false;
+    }
+    task = std::move(deque.back());
+    deque.pop_back();
+    return true;
+}
+
+bool Thread_pool::try_steal(Worker* self, size_t priority, Task& task)
+{
+    const size_t worker_count = m_threads.size();
+    if (worker_count == 0) {
+        return false;
+    }
+
+    // Visit victims starting from a random worker to spread contention
+    const size_t start = next_random() % worker_count;
+    for (size_t i = 0; i < worker_count; ++i) {
+        Worker& victim = m_workers[(start + i) % worker_count];
+        if (&victim == self) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock{victim.deque_mutex};
+        auto& deque = victim.deques[priority];
+        if (!deque.empty()) {
+            task = std::move(deque.front());
+            deque.pop_front();
+            if ((self != nullptr) && m_instrumentation_enabled.load(std::memory_order_relaxed)) {
+                ++m_worker_statistics[t_worker_index].tasks_stolen;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Thread_pool::has_pending_tasks() const
 {
-    // scan task queues in priority order
     for (size_t priority = 0; priority < 3; ++priority) {
-        Task task;
-        if (m_queues[priority].tasks.try_dequeue(task)) {
-            Queue* const queue = task.queue;
+        if (m_queues[priority].tasks.size_approx() > 0) {
+            return true;
+        }
+    }
+    if (m_workers != nullptr) {
+        for (size_t i = 0, end = m_threads.size(); i < end; ++i) {
+            Worker& worker = m_workers[i];
+            std::lock_guard<std::mutex> lock{worker.deque_mutex};
+            for (const auto& deque : worker.deques) {
+                if (!deque.empty()) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
 
-            // check if the task is cancelled
-            if (!queue->cancelled) {
-                // process task
-                task.func();
+void Thread_pool::wake_one()
+{
+    // Pairs with the fence in sleep(): either the sleeper sees the new task,
+    // or we see the sleeper.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping_workers.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    // Wake exactly one sleeping worker instead of broadcasting
+    const size_t worker_count = m_threads.size();
+    const size_t start        = next_random() % worker_count;
+    for (size_t i = 0; i < worker_count; ++i) {
+        Worker& worker   = m_workers[(start + i) % worker_count];
+        bool    expected = true;
+        if (worker.sleeping.compare_exchange_strong(expected, false)) {
+            --m_sleeping_workers;
+            {
+                std::lock_guard<std::mutex> lock{worker.sleep_mutex};
+                worker.wake_signal = true;
             }
+            worker.sleep_condition.notify_one();
+            return;
+        }
+    }
+}
 
-            --queue->task_counter;
+void Thread_pool::sleep(Worker& worker)
+{
+    worker.sleeping.store(true);
+    ++m_sleeping_workers;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Re-check after publishing sleeping state so that a concurrent
+    // enqueue cannot be missed.
+    if (!has_pending_tasks() && !m_stop.load(std::memory_order_relaxed)) {
+        std::unique_lock<std::mutex> lock{worker.sleep_mutex};
+        worker.sleep_condition.wait_for(
+            lock,
+            milliseconds(120),
+            [this, &worker]
+            {
+                return worker.wake_signal || m_stop.load(std::memory_order_relaxed);
+            }
+        );
+        worker.wake_signal = false;
+    }
+
+    // Deregister unless a waker already did it for us
+    bool expected = true;
+    if (worker.sleeping.compare_exchange_strong(expected, false)) {
+        --m_sleeping_workers;
+    }
+}
+
+bool Thread_pool::dequeue_and_process()
+{
+    if (m_workers == nullptr) {
+        // scan task queues in priority order
+        for (size_t priority = 0; priority < 3; ++priority) {
+            Task task;
+            if (m_queues[priority].tasks.try_dequeue(task)) {
+                process(task);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Work stealing: for each priority, try own deque (newest first),
+    // then the global injection queue, then steal from other workers.
+    Worker* const self = current_worker();
+    for (size_t priority = 0; priority < 3; ++priority) {
+        Task task;
+        if (
+            try_pop(self, priority, task) ||
+            m_queues[priority].tasks.try_dequeue(task) ||
+            try_steal(self, priority, task)
+        ) {
+            process(task);
             return true;
         }
     }
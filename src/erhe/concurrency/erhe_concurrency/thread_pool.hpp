@@ -1,8 +1,12 @@
 #pragma once
 
+#include "erhe_concurrency/inline_task.hpp"
+#include "erhe_concurrency/thread_pool_statistics.hpp"
+
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
-#include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
@@ -11,6 +15,11 @@
 
 namespace erhe::concurrency {
 
+enum class Scheduling_mode : unsigned int {
+    global_queues = 0, // all tasks go through shared per-priority queues
+    work_stealing      // per-worker deques, LIFO local pops, randomized stealing
+};
+
 class Thread_pool
 {
 private:
@@ -18,6 +27,7 @@ private:
     auto operator=(const Thread_pool&) -> Thread_pool = delete;
 
     friend class Concurrent_queue;
+    friend class Task_graph;
 
     struct Queue
     {
@@ -35,6 +45,10 @@ private:
 #   pragma warning(pop)
 #endif
 
+        // Only updated when instrumentation is enabled
+        Histogram latency;
+        Histogram execution;
+
         Queue(
             Thread_pool*           pool,
             const int              priority,
@@ -44,46 +58,87 @@ private:
             , priority{priority}
             , name    {name}
         {
+            pool->register_queue(this);
+        }
+
+        ~Queue() noexcept
+        {
+            pool->unregister_queue(this);
         }
     };
 
     struct Task
     {
-        Queue*                queue;
-        std::function<void()> func;
+        Queue*                                queue;
+        Inline_task                           func;
+        std::chrono::steady_clock::time_point enqueue_time{}; // set only when instrumented
     };
 
 public:
-    explicit Thread_pool(std::size_t size);
+    explicit Thread_pool(
+        std::size_t     size,
+        Scheduling_mode scheduling_mode = Scheduling_mode::global_queues
+    );
     ~Thread_pool() noexcept;
 
-    int size() const;
+    int  size               () const;
+    auto get_scheduling_mode() const -> Scheduling_mode;
+
+    // Opt-in instrumentation: queue latency and execution time histograms,
+    // queue depths and worker busy / idle / sleep times.
+    void set_instrumentation_enabled(bool enabled);
+    auto is_instrumentation_enabled () const -> bool;
+    auto get_statistics             () const -> Thread_pool_statistics;
+    void reset_statistics           ();
 
-    void enqueue(std::function<void()>&& func)
+    void enqueue(Inline_task&& func)
     {
         enqueue(&m_static_queue, std::move(func));
     }
 
 protected:
     void thread             (size_t threadID);
-    void enqueue            (Queue* queue, std::function<void()>&& func);
+    void enqueue            (Queue* queue, Inline_task&& func);
     bool dequeue_and_process();
     void cancel             (Queue* queue);
     void wait               (Queue* queue);
 
 private:
     struct Task_queue;
+    struct Worker;
+    struct Worker_statistics;
+
+    void register_queue     (Queue* queue);
+    void unregister_queue   (Queue* queue);
+
+    void process            (Task& task);
+    auto current_worker     () const -> Worker*;
+    bool try_pop            (Worker* self, size_t priority, Task& task);
+    bool try_steal          (Worker* self, size_t priority, Task& task);
+    bool has_pending_tasks  () const;
+    void wake_one           ();
+    void sleep              (Worker& worker);
+
     alignas(64) Task_queue* m_queues;
+    Worker*                 m_workers{nullptr};
+    Scheduling_mode         m_scheduling_mode;
 
 #if defined(_MSC_VER)
 #   pragma warning(push)
 #   pragma warning(disable : 4324)  // structure was padded due to alignment specifier
 #endif
-    alignas(64) std::atomic<bool> m_stop { false };
+    alignas(64) std::atomic<bool> m_stop                   { false };
+    alignas(64) std::atomic<int>  m_sleeping_workers       { 0 };
+    alignas(64) std::atomic<bool> m_instrumentation_enabled{ false };
+    std::array<std::atomic<int>, 3> m_queue_depth{};
 #if defined(_MSC_VER)
 #   pragma warning(pop)
 #endif
 
+    std::unique_ptr<Worker_statistics[]> m_worker_statistics;
+    mutable std::mutex                   m_registry_mutex;
+    std::vector<Queue*>                  m_registered_queues;
+
     std::mutex               m_queue_mutex;
     std::condition_variable  m_condition;
     Queue                    m_static_queue;
@@ -0,0 +1,96 @@
+#include "erhe_concurrency/thread_pool_statistics.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace erhe::concurrency {
+
+auto Histogram_snapshot::get_bucket_upper_bound_ns(const std::size_t bucket) -> uint64_t
+{
+    return uint64_t{1000} << bucket;
+}
+
+auto Histogram_snapshot::get_mean_ns() const -> uint64_t
+{
+    return (count > 0) ? (total_ns / count) : 0;
+}
+
+auto Histogram_snapshot::get_percentile_ns(const float fraction) const -> uint64_t
+{
+    if (count == 0) {
+        return 0;
+    }
+    const uint64_t target = static_cast<uint64_t>(std::clamp(fraction, 0.0f, 1.0f) * static_cast<float>(count));
+    uint64_t accumulated = 0;
+    for (std::size_t i = 0; i < c_histogram_bucket_count; ++i) {
+        accumulated += buckets[i];
+        if (accumulated >= target) {
+            return std::min(get_bucket_upper_bound_ns(i), max_ns);
+        }
+    }
+    return max_ns;
+}
+
+void Histogram::add(const std::chrono::nanoseconds duration)
+{
+    const uint64_t ns = static_cast<uint64_t>(std::max(duration.count(), std::chrono::nanoseconds::rep{0}));
+    const uint64_t us = ns / 1000;
+    const std::size_t bucket = std::min<std::size_t>(
+        static_cast<std::size_t>(std::bit_width(us)),
+        c_histogram_bucket_count - 1
+    );
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count          .fetch_add(1, std::memory_order_relaxed);
+    m_total_ns       .fetch_add(ns, std::memory_order_relaxed);
+
+    uint64_t max_ns = m_max_ns.load(std::memory_order_relaxed);
+    while ((ns > max_ns) && !m_max_ns.compare_exchange_weak(max_ns, ns, std::memory_order_relaxed)) {
+    }
+}
+
+void Histogram::reset()
+{
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count   .store(0, std::memory_order_relaxed);
+    m_total_ns.store(0, std::memory_order_relaxed);
+    m_max_ns  .store(0, std::memory_order_relaxed);
+}
+
+auto Histogram::get_snapshot() const -> Histogram_snapshot
+{
+    Histogram_snapshot snapshot;
+    for (std::size_t i = 0; i < c_histogram_bucket_count; ++i) {
+        snapshot.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+    }
+    snapshot.count    = m_count   .load(std::memory_order_relaxed);
+    snapshot.total_ns = m_total_ns.load(std::memory_order_relaxed);
+    snapshot.max_ns   = m_max_ns  .load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+auto Worker_statistics_snapshot::get_total_ns() const -> uint64_t
+{
+    return busy_ns + idle_ns + sleep_ns;
+}
+
+auto Worker_statistics_snapshot::get_busy_ratio() const -> float
+{
+    const uint64_t total = get_total_ns();
+    return (total > 0) ? static_cast<float>(busy_ns) / static_cast<float>(total) : 0.0f;
+}
+
+auto Worker_statistics_snapshot::get_idle_ratio() const -> float
+{
+    const uint64_t total = get_total_ns();
+    return (total > 0) ? static_cast<float>(idle_ns) / static_cast<float>(total) : 0.0f;
+}
+
+auto Worker_statistics_snapshot::get_sleep_ratio() const -> float
+{
+    const uint64_t total = get_total_ns();
+    return (total > 0) ? static_cast<float>(sleep_ns) / static_cast<float>(total) : 0.0f;
+}
+
+} // namespace erhe::concurrency
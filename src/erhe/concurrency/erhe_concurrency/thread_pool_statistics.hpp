@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace erhe::concurrency {
+
+inline constexpr std::size_t c_histogram_bucket_count = 24;
+
+// Bucket 0 counts durations below 1 microsecond, bucket i > 0 counts
+// durations in [2^(i - 1), 2^i) microseconds. The last bucket also counts
+// all longer durations.
+class Histogram_snapshot
+{
+public:
+    [[nodiscard]] static auto get_bucket_upper_bound_ns(std::size_t bucket) -> uint64_t;
+
+    [[nodiscard]] auto get_mean_ns      () const -> uint64_t;
+    [[nodiscard]] auto get_percentile_ns(float fraction) const -> uint64_t; // bucket upper bound
+
+    std::array<uint64_t, c_histogram_bucket_count> buckets {};
+    uint64_t                                       count   {0};
+    uint64_t                                       total_ns{0};
+    uint64_t                                       max_ns  {0};
+};
+
+class Histogram
+{
+public:
+    void add         (std::chrono::nanoseconds duration);
+    void reset       ();
+    auto get_snapshot() const -> Histogram_snapshot;
+
+private:
+    std::array<std::atomic<uint64_t>, c_histogram_bucket_count> m_buckets {};
+    std::atomic<uint64_t>                                       m_count   {0};
+    std::atomic<uint64_t>                                       m_total_ns{0};
+    std::atomic<uint64_t>                                       m_max_ns  {0};
+};
+
+class Queue_statistics_snapshot
+{
+public:
+    std::string        name;
+    int                priority     {0};
+    int                pending_tasks{0};
+    Histogram_snapshot latency;   // enqueue to start of execution
+    Histogram_snapshot execution; // start to end of execution
+};
+
+class Worker_statistics_snapshot
+{
+public:
+    [[nodiscard]] auto get_total_ns   () const -> uint64_t;
+    [[nodiscard]] auto get_busy_ratio () const -> float;
+    [[nodiscard]] auto get_idle_ratio () const -> float;
+    [[nodiscard]] auto get_sleep_ratio() const -> float;
+
+    uint64_t busy_ns       {0}; // processing tasks
+    uint64_t idle_ns       {0}; // looking for work, yielding
+    uint64_t sleep_ns      {0}; // blocked waiting for wake up
+    uint64_t tasks_executed{0};
+    uint64_t tasks_stolen  {0};
+};
+
+class Thread_pool_statistics
+{
+public:
+    bool                                    instrumentation_enabled{false};
+    std::array<int, 3>                      queue_depth{};   // per priority, tasks enqueued but not yet started
+    std::vector<Queue_statistics_snapshot>  queues;
+    std::vector<Worker_statistics_snapshot> workers;
+};
+
+} // namespace erhe::concurrency
@@ -5,8 +5,17 @@
 #if defined(ERHE_OS_WINDOWS)
 #   include <Windows.h>
 #   include <shobjidl.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
 #endif
 
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
 namespace erhe::file
 {
 
@@ -117,6 +126,161 @@ auto read(
     return std::optional<std::string>(result);
 }
 
+auto write(
+    const std::string_view           description,
+    const std::filesystem::path&     path,
+    const std::span<const std::byte> data
+) -> bool
+{
+    std::error_code error_code;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), error_code);
+        if (error_code) {
+            log_file->warn(
+                "{}: std::filesystem::create_directories('{}') returned error code {}: {}",
+                description,
+                to_string(path.parent_path()),
+                error_code.value(),
+                error_code.message()
+            );
+            return false;
+        }
+    }
+
+    // Unique temporary name, so that concurrent writers do not collide
+    static std::atomic<uint64_t> s_serial{0};
+    std::filesystem::path temp_path = path;
+    temp_path += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    temp_path += "." + std::to_string(s_serial.fetch_add(1)) + ".tmp";
+
+    std::FILE* file =
+#if defined(_WIN32) // _MSC_VER
+        _wfopen(temp_path.c_str(), L"wb");
+#else
+        std::fopen(temp_path.c_str(), "wb");
+#endif
+    if (file == nullptr) {
+        log_file->error("{}: Could not open file '{}' for writing", description, to_string(temp_path));
+        return false;
+    }
+
+    const std::size_t write_byte_count = std::fwrite(data.data(), 1, data.size(), file);
+    const bool        close_ok         = (std::fclose(file) == 0);
+    if ((write_byte_count != data.size()) || !close_ok) {
+        log_file->error("{}: Error writing file '{}'", description, to_string(temp_path));
+        std::filesystem::remove(temp_path, error_code);
+        return false;
+    }
+
+    std::filesystem::rename(temp_path, path, error_code);
+    if (error_code) {
+        log_file->warn(
+            "{}: std::filesystem::rename('{}', '{}') returned error code {}: {}",
+            description,
+            to_string(temp_path),
+            to_string(path),
+            error_code.value(),
+            error_code.message()
+        );
+        std::filesystem::remove(temp_path, error_code);
+        return false;
+    }
+    return true;
+}
+
+#if defined(ERHE_OS_WINDOWS)
+Mapped_file::Mapped_file(const std::string_view description, const std::filesystem::path& path)
+{
+    const bool file_is_ok = check_is_existing_non_empty_regular_file(description, path, true);
+    if (!file_is_ok) {
+        return;
+    }
+
+    HANDLE file_handle = CreateFileW(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+    );
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        log_file->error("{}: Could not open file '{}' for mapping", description, to_string(path));
+        return;
+    }
+    m_file_handle = file_handle;
+
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file_handle, &file_size) || (file_size.QuadPart == 0)) {
+        return;
+    }
+
+    HANDLE mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle == nullptr) {
+        log_file->error("{}: Could not map file '{}'", description, to_string(path));
+        return;
+    }
+    m_mapping_handle = mapping_handle;
+
+    const void* view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        log_file->error("{}: Could not map view of file '{}'", description, to_string(path));
+        return;
+    }
+    m_data = static_cast<const std::byte*>(view);
+    m_size = static_cast<std::size_t>(file_size.QuadPart);
+}
+
+Mapped_file::~Mapped_file() noexcept
+{
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping_handle != nullptr) {
+        CloseHandle(m_mapping_handle);
+    }
+    if (m_file_handle != nullptr) {
+        CloseHandle(m_file_handle);
+    }
+}
+#else
+Mapped_file::Mapped_file(const std::string_view description, const std::filesystem::path& path)
+{
+    const bool file_is_ok = check_is_existing_non_empty_regular_file(description, path, true);
+    if (!file_is_ok) {
+        return;
+    }
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        log_file->error("{}: Could not open file '{}' for mapping", description, to_string(path));
+        return;
+    }
+    ERHE_DEFER( ::close(fd); ); // Mapping stays valid after close
+
+    struct stat file_stat{};
+    if ((::fstat(fd, &file_stat) != 0) || (file_stat.st_size <= 0)) {
+        return;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(file_stat.st_size);
+    void* const       view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        log_file->error("{}: Could not map file '{}'", description, to_string(path));
+        return;
+    }
+    m_data = static_cast<const std::byte*>(view);
+    m_size = size;
+}
+
+Mapped_file::~Mapped_file() noexcept
+{
+    if (m_data != nullptr) {
+        ::munmap(const_cast<std::byte*>(m_data), m_size);
+    }
+}
+#endif
+
+auto Mapped_file::data() const -> std::span<const std::byte>
+{
+    return std::span<const std::byte>{m_data, m_size};
+}
+
 #if defined(ERHE_OS_WINDOWS)
 auto select_file() -> std::optional<std::filesystem::path>
 {
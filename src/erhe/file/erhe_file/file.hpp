@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
 #include <optional>
+#include <span>
 #include <string>
 
 namespace erhe::file
@@ -17,6 +19,38 @@ auto from_string(const std::string& path) -> std::filesystem::path;
     const std::filesystem::path& path
 ) -> std::optional<std::string>;
 
+// Writes data to a temporary file next to path, and then renames it to
+// path, so that concurrent readers never see a partially written file.
+// Missing parent directories are created.
+auto write(
+    const std::string_view           description,
+    const std::filesystem::path&     path,
+    const std::span<const std::byte> data
+) -> bool;
+
+// Read-only memory mapping of a whole file.
+// data() is empty if the file does not exist, is empty, or mapping fails.
+class Mapped_file
+{
+public:
+    Mapped_file(const std::string_view description, const std::filesystem::path& path);
+    ~Mapped_file() noexcept;
+    Mapped_file   (const Mapped_file&) = delete;
+    void operator=(const Mapped_file&) = delete;
+    Mapped_file   (Mapped_file&&)      = delete;
+    void operator=(Mapped_file&&)      = delete;
+
+    [[nodiscard]] auto data() const -> std::span<const std::byte>;
+
+private:
+    const std::byte* m_data{nullptr};
+    std::size_t      m_size{0};
+#if defined(ERHE_OS_WINDOWS)
+    void*            m_file_handle   {nullptr};
+    void*            m_mapping_handle{nullptr};
+#endif
+};
+
 // TODO open, save, ...
 auto select_file() -> std::optional<std::filesystem::path>;
 
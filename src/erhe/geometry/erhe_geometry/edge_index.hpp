@@ -0,0 +1,124 @@
+#pragma once
+
+#include "erhe_geometry/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace erhe::geometry
+{
+
+// Maps unordered point pair to Edge_id.
+// Flat open addressing hash table with linear probing, keyed by
+// (min, max) point ids packed to 64 bits. Entries are never removed
+// individually; clear() is used when edges are rebuilt.
+class Edge_index
+{
+public:
+    void clear()
+    {
+        m_keys  .clear();
+        m_values.clear();
+        m_size = 0;
+        m_mask = 0;
+    }
+
+    void reserve(const std::size_t edge_count)
+    {
+        std::size_t capacity = 16;
+        while (capacity < edge_count * 2) {
+            capacity *= 2;
+        }
+        if (capacity > m_keys.size()) {
+            rehash(capacity);
+        }
+    }
+
+    // Returns false if edge for point pair already exists; existing entry is kept
+    auto insert(const Point_id a, const Point_id b, const Edge_id edge_id) -> bool
+    {
+        if ((m_size + 1) * 2 > m_keys.size()) {
+            rehash(m_keys.empty() ? 16 : m_keys.size() * 2);
+        }
+        const uint64_t key = make_key(a, b);
+        for (std::size_t slot = hash(key) & m_mask;; slot = (slot + 1) & m_mask) {
+            if (m_keys[slot] == c_empty) {
+                m_keys  [slot] = key;
+                m_values[slot] = edge_id;
+                ++m_size;
+                return true;
+            }
+            if (m_keys[slot] == key) {
+                return false;
+            }
+        }
+    }
+
+    [[nodiscard]] auto find(const Point_id a, const Point_id b) const -> std::optional<Edge_id>
+    {
+        if (m_size == 0) {
+            return {};
+        }
+        const uint64_t key = make_key(a, b);
+        for (std::size_t slot = hash(key) & m_mask;; slot = (slot + 1) & m_mask) {
+            if (m_keys[slot] == key) {
+                return m_values[slot];
+            }
+            if (m_keys[slot] == c_empty) {
+                return {};
+            }
+        }
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        return m_size;
+    }
+
+private:
+    // a == b is never a valid edge, so all bits set can not be a valid key
+    static constexpr uint64_t c_empty = ~uint64_t{0};
+
+    [[nodiscard]] static auto make_key(Point_id a, Point_id b) -> uint64_t
+    {
+        if (b < a) {
+            std::swap(a, b);
+        }
+        return (static_cast<uint64_t>(a) << 32u) | static_cast<uint64_t>(b);
+    }
+
+    [[nodiscard]] static auto hash(const uint64_t key) -> std::size_t
+    {
+        // Fibonacci hashing; upper bits are best mixed
+        return static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ull) >> 32u);
+    }
+
+    void rehash(const std::size_t capacity)
+    {
+        std::vector<uint64_t> old_keys   = std::exchange(m_keys,   std::vector<uint64_t>(capacity, c_empty));
+        std::vector<Edge_id>  old_values = std::exchange(m_values, std::vector<Edge_id>(capacity));
+        m_mask = capacity - 1;
+        for (std::size_t i = 0, end = old_keys.size(); i < end; ++i) {
+            const uint64_t key = old_keys[i];
+            if (key == c_empty) {
+                continue;
+            }
+            std::size_t slot = hash(key) & m_mask;
+            while (m_keys[slot] != c_empty) {
+                slot = (slot + 1) & m_mask;
+            }
+            m_keys  [slot] = key;
+            m_values[slot] = old_values[i];
+        }
+    }
+
+    std::vector<uint64_t> m_keys;
+    std::vector<Edge_id>  m_values;
+    std::size_t           m_size{0};
+    std::size_t           m_mask{0};
+};
+
+} // namespace erhe::geometry
@@ -1,3 +1,4 @@
+#include "erhe_concurrency/parallel_for.hpp"
 #include "erhe_geometry/geometry.hpp"
 #include "erhe_geometry/geometry_log.hpp"
 #include "erhe_log/log_glm.hpp"
@@ -10,7 +11,11 @@
 #   include <Mathematics/PolyhedralMassProperties.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <optional>
+#include <span>
 #include <sstream>
 
 namespace erhe::geometry
@@ -22,6 +27,55 @@ using glm::vec4;
 using glm::mat3;
 using glm::mat4;
 
+namespace {
+
+// Evaluates compute(polygon_id) -> std::optional<vec3> for all polygons in
+// parallel, then puts the results to the property map in polygon order.
+// Property_map::put() is not thread safe.
+template <typename Compute>
+void compute_polygon_attribute_parallel(
+    erhe::concurrency::Thread_pool& thread_pool,
+    const Polygon_id                polygon_count,
+    Property_map<Polygon_id, vec3>& property_map,
+    Compute&&                       compute
+)
+{
+    std::vector<vec3>    values (polygon_count);
+    std::vector<uint8_t> present(polygon_count, 0);
+    erhe::concurrency::parallel_for(
+        thread_pool,
+        Polygon_id{0},
+        polygon_count,
+        [&](const Polygon_id polygon_id) {
+            const std::optional<vec3> value = compute(polygon_id);
+            if (value.has_value()) {
+                values [polygon_id] = value.value();
+                present[polygon_id] = 1;
+            }
+        }
+    );
+    for (Polygon_id polygon_id = 0; polygon_id < polygon_count; ++polygon_id) {
+        if (present[polygon_id] != 0) {
+            property_map.put(polygon_id, values[polygon_id]);
+        }
+    }
+}
+
+} // anonymous namespace
+
+auto get_builtin_property_map_id(const char* const name) -> Property_map_id
+{
+    if (name == nullptr) {
+        return c_property_map_id_user;
+    }
+    for (const Property_map_descriptor* descriptor : c_builtin_property_maps) {
+        if (std::strcmp(descriptor->name, name) == 0) {
+            return descriptor->id;
+        }
+    }
+    return c_property_map_id_user;
+}
+
 Geometry::Geometry() = default;
 
 Geometry::Geometry(
@@ -62,6 +116,7 @@ Geometry::Geometry(Geometry&& other) noexcept
     , m_next_point_corner_reserve         {other.m_next_point_corner_reserve}
     , m_next_polygon_corner_id            {other.m_next_polygon_corner_id   }
     , m_next_edge_polygon_id              {other.m_next_edge_polygon_id     }
+    , m_edge_index                        {std::move(other.m_edge_index)    }
     , m_polygon_corner_polygon            {other.m_polygon_corner_polygon   }
     , m_edge_polygon_edge                 {other.m_edge_polygon_edge        }
     , m_point_property_map_collection     {std::move(other.m_point_property_map_collection)}
@@ -84,6 +139,8 @@ Geometry::Geometry(Geometry&& other) noexcept
     , m_serial_corner_tangents            {other.m_serial_corner_tangents            }
     , m_serial_corner_bitangents          {other.m_serial_corner_bitangents          }
     , m_serial_corner_texture_coordinates {other.m_serial_corner_texture_coordinates }
+    , m_dirty_polygons                    {std::move(other.m_dirty_polygons)}
+    , m_dirty_cursors                     {other.m_dirty_cursors            }
 {
 }
 
@@ -151,7 +208,7 @@ auto Geometry::has_polygon_normals() const -> bool
 {
     ERHE_PROFILE_FUNCTION();
 
-    if (m_serial_polygon_normals == m_serial) {
+    if ((m_serial_polygon_normals == m_serial) && !is_dirty_pending(Dirty_consumer::polygon_normals)) {
         return true;
     }
 
@@ -162,7 +219,7 @@ auto Geometry::has_polygon_normals() const -> bool
 }
 
 // Requires point locations
-auto Geometry::compute_polygon_normals() -> bool
+auto Geometry::compute_polygon_normals(erhe::concurrency::Thread_pool* thread_pool) -> bool
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -184,18 +241,42 @@ auto Geometry::compute_polygon_normals() -> bool
         return false;
     }
 
-    for_each_polygon([&](auto& i) {
-        i.polygon.compute_normal(i.polygon_id, *this, *polygon_normals, *point_locations);
-    });
+    if (m_serial_polygon_normals == m_serial) {
+        // Only polygons marked dirty have changed
+        for (const Polygon_id polygon_id : take_dirty_polygons(Dirty_consumer::polygon_normals)) {
+            polygons[polygon_id].compute_normal(polygon_id, *this, *polygon_normals, *point_locations);
+        }
+        return true;
+    }
+
+    if ((thread_pool != nullptr) && (m_next_polygon_id >= erhe::concurrency::c_parallel_serial_threshold)) {
+        compute_polygon_attribute_parallel(
+            *thread_pool,
+            m_next_polygon_id,
+            *polygon_normals,
+            [&](const Polygon_id polygon_id) -> std::optional<vec3> {
+                const Polygon& polygon = polygons[polygon_id];
+                if (polygon.corner_count < 3) {
+                    return {};
+                }
+                return polygon.compute_normal(*this, *point_locations);
+            }
+        );
+    } else {
+        for_each_polygon([&](auto& i) {
+            i.polygon.compute_normal(i.polygon_id, *this, *polygon_normals, *point_locations);
+        });
+    }
 
     m_serial_polygon_normals = m_serial;
+    mark_dirty_consumed(Dirty_consumer::polygon_normals);
 
     return true;
 }
 
 auto Geometry::has_polygon_centroids() const -> bool
 {
-    if (m_serial_polygon_centroids == m_serial) {
+    if ((m_serial_polygon_centroids == m_serial) && !is_dirty_pending(Dirty_consumer::polygon_centroids)) {
         return true;
     }
 
@@ -206,7 +287,7 @@ auto Geometry::has_polygon_centroids() const -> bool
     return false;
 }
 
-auto Geometry::compute_polygon_centroids() -> bool
+auto Geometry::compute_polygon_centroids(erhe::concurrency::Thread_pool* thread_pool) -> bool
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -224,11 +305,35 @@ auto Geometry::compute_polygon_centroids() -> bool
         return false;
     }
 
-    for_each_polygon([&](auto& i) {
-        i.polygon.compute_centroid(i.polygon_id, *this, *polygon_centroids, *point_locations);
-    });
+    if (m_serial_polygon_centroids == m_serial) {
+        // Only polygons marked dirty have changed
+        for (const Polygon_id polygon_id : take_dirty_polygons(Dirty_consumer::polygon_centroids)) {
+            polygons[polygon_id].compute_centroid(polygon_id, *this, *polygon_centroids, *point_locations);
+        }
+        return true;
+    }
+
+    if ((thread_pool != nullptr) && (m_next_polygon_id >= erhe::concurrency::c_parallel_serial_threshold)) {
+        compute_polygon_attribute_parallel(
+            *thread_pool,
+            m_next_polygon_id,
+            *polygon_centroids,
+            [&](const Polygon_id polygon_id) -> std::optional<vec3> {
+                const Polygon& polygon = polygons[polygon_id];
+                if (polygon.corner_count < 1) {
+                    return {};
+                }
+                return polygon.compute_centroid(*this, *point_locations);
+            }
+        );
+    } else {
+        for_each_polygon([&](auto& i) {
+            i.polygon.compute_centroid(i.polygon_id, *this, *polygon_centroids, *point_locations);
+        });
+    }
 
     m_serial_polygon_centroids = m_serial;
+    mark_dirty_consumed(Dirty_consumer::polygon_centroids);
 
     return true;
 }
@@ -245,7 +350,7 @@ auto Geometry::has_edges() const -> bool
     return false;
 }
 
-void Geometry::build_edges(bool is_manifold)
+void Geometry::build_edges(const bool is_manifold, erhe::concurrency::Thread_pool* thread_pool)
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -255,6 +360,8 @@ void Geometry::build_edges(bool is_manifold)
 
     edges.clear();
     m_next_edge_id = 0;
+    m_edge_index.clear();
+    m_edge_index.reserve(m_next_corner_id / 2);
 
     log_build_edges->trace("{} build_edges() : {} polygons", name, m_next_polygon_id);
 
@@ -263,7 +370,9 @@ void Geometry::build_edges(bool is_manifold)
 
     std::size_t polygon_edge_count = 0;
     // First pass - shared edges
-    {
+    if ((thread_pool != nullptr) && (m_next_corner_id >= erhe::concurrency::c_parallel_serial_threshold)) {
+        polygon_edge_count = build_edges_first_pass_parallel(*thread_pool);
+    } else {
         ERHE_PROFILE_SCOPE("first pass");
 
         for_each_polygon([&](auto& i) {
@@ -342,6 +451,142 @@ void Geometry::build_edges(bool is_manifold)
     m_serial_edges = m_serial;
 }
 
+namespace {
+
+// Calls callback for each polygon which has edge b -> a, where a is the
+// point and b is the previous point in polygon winding.
+template <typename Callback>
+void for_each_opposite_polygon(
+    const Geometry& geometry,
+    const Point_id  a,
+    const Point_id  b,
+    Callback&&      callback
+)
+{
+    const Point& pa = geometry.points[a];
+    ERHE_VERIFY(pa.corner_count > 0);
+    for (uint32_t i = 0; i < pa.corner_count; ++i) {
+        const Corner_id  corner_id      = geometry.point_corners[pa.first_point_corner_id + i];
+        const Polygon_id polygon_id     = geometry.corners[corner_id].polygon_id;
+        const Polygon&   polygon        = geometry.polygons[polygon_id];
+        const Corner_id  prev_corner_id = polygon.prev_corner(geometry, corner_id);
+        if (geometry.corners[prev_corner_id].point_id == b) {
+            callback(polygon_id);
+        }
+    }
+}
+
+} // anonymous namespace
+
+// Parallel version of the first build_edges() pass. Edge and edge polygon
+// counts are computed per polygon, converted to offsets with a prefix sum
+// and then filled in parallel. Edge ids and edge polygon order are the
+// same as in the serial pass, which visits polygons in order.
+auto Geometry::build_edges_first_pass_parallel(erhe::concurrency::Thread_pool& thread_pool) -> std::size_t
+{
+    ERHE_PROFILE_FUNCTION();
+
+    std::vector<Edge_id>         polygon_first_edge        (static_cast<std::size_t>(m_next_polygon_id) + 1);
+    std::vector<Edge_polygon_id> polygon_first_edge_polygon(static_cast<std::size_t>(m_next_polygon_id) + 1);
+
+    // Counting pass
+    erhe::concurrency::parallel_for(
+        thread_pool,
+        Polygon_id{0},
+        m_next_polygon_id,
+        [&](const Polygon_id polygon_id) {
+            const Polygon& polygon            = polygons[polygon_id];
+            uint32_t       edge_count         = 0;
+            uint32_t       edge_polygon_count = 0;
+            for (uint32_t i = 0; i < polygon.corner_count; ++i) {
+                const Polygon_corner_id prev_polygon_corner_id = polygon.first_polygon_corner_id + (polygon.corner_count + i - 1) % polygon.corner_count;
+                const Point_id          a = corners[polygon_corners[prev_polygon_corner_id]].point_id;
+                const Point_id          b = corners[polygon_corners[polygon.first_polygon_corner_id + i]].point_id;
+                if (a < b) {
+                    ++edge_count;
+                    ++edge_polygon_count;
+                    for_each_opposite_polygon(*this, a, b, [&](Polygon_id) { ++edge_polygon_count; });
+                }
+            }
+            polygon_first_edge        [polygon_id] = edge_count;
+            polygon_first_edge_polygon[polygon_id] = edge_polygon_count;
+        }
+    );
+
+    // Exclusive prefix sums; last entry is the total
+    std::size_t polygon_edge_count{0};
+    {
+        Edge_id         next_edge        {0};
+        Edge_polygon_id next_edge_polygon{m_next_edge_polygon_id}; // not reset by build_edges()
+        for (Polygon_id polygon_id = 0; polygon_id <= m_next_polygon_id; ++polygon_id) {
+            const Edge_id         edge_count         = polygon_first_edge        [polygon_id];
+            const Edge_polygon_id edge_polygon_count = polygon_first_edge_polygon[polygon_id];
+            polygon_first_edge        [polygon_id] = next_edge;
+            polygon_first_edge_polygon[polygon_id] = next_edge_polygon;
+            next_edge         += edge_count;
+            next_edge_polygon += edge_polygon_count;
+            if (polygon_id < m_next_polygon_id) {
+                polygon_edge_count += polygons[polygon_id].corner_count;
+            }
+        }
+    }
+    const Edge_id         edge_count         = polygon_first_edge        [m_next_polygon_id];
+    const Edge_polygon_id edge_polygon_end   = polygon_first_edge_polygon[m_next_polygon_id];
+    if (edges.size() < edge_count) {
+        edges.resize(edge_count);
+    }
+    if (edge_polygons.size() < edge_polygon_end) {
+        edge_polygons.resize(edge_polygon_end);
+    }
+
+    // Fill pass
+    erhe::concurrency::parallel_for(
+        thread_pool,
+        Polygon_id{0},
+        m_next_polygon_id,
+        [&](const Polygon_id polygon_id) {
+            const Polygon&  polygon           = polygons[polygon_id];
+            Edge_id         edge_id           = polygon_first_edge        [polygon_id];
+            Edge_polygon_id edge_polygon_id   = polygon_first_edge_polygon[polygon_id];
+            for (uint32_t i = 0; i < polygon.corner_count; ++i) {
+                const Polygon_corner_id prev_polygon_corner_id = polygon.first_polygon_corner_id + (polygon.corner_count + i - 1) % polygon.corner_count;
+                const Point_id          a = corners[polygon_corners[prev_polygon_corner_id]].point_id;
+                const Point_id          b = corners[polygon_corners[polygon.first_polygon_corner_id + i]].point_id;
+                if (a == b) {
+                    log_build_edges->warn("Bad edge {} - {}", a, b);
+                    continue;
+                }
+                if (a < b) {
+                    Edge& edge = edges[edge_id++];
+                    edge.a                     = a;
+                    edge.b                     = b;
+                    edge.first_edge_polygon_id = edge_polygon_id;
+                    edge.polygon_count         = 1;
+                    edge_polygons[edge_polygon_id++] = polygon_id;
+                    for_each_opposite_polygon(*this, a, b, [&](const Polygon_id polygon_id_in_point) {
+                        edge_polygons[edge_polygon_id++] = polygon_id_in_point;
+                        ++edge.polygon_count;
+                    });
+                }
+            }
+        }
+    );
+
+    // Serial; keeps the first edge for duplicate point pairs like make_edge()
+    m_edge_index.reserve(edge_count);
+    for (Edge_id edge_id = 0; edge_id < edge_count; ++edge_id) {
+        m_edge_index.insert(edges[edge_id].a, edges[edge_id].b, edge_id);
+    }
+
+    ++m_serial;
+    m_next_edge_id         = edge_count;
+    m_next_edge_polygon_id = edge_polygon_end;
+    if (edge_count > 0) {
+        m_edge_polygon_edge = edge_count - 1;
+    }
+    return polygon_edge_count;
+}
+
 void Geometry::debug_trace() const
 {
     ERHE_PROFILE_FUNCTION();
@@ -461,10 +706,13 @@ auto Geometry::compute_point_normal(const Point_id point_id) -> vec3
 
 auto Geometry::has_point_normals() const -> bool
 {
-    return m_serial_point_normals == m_serial;
+    return (m_serial_point_normals == m_serial) && !is_dirty_pending(Dirty_consumer::point_normals);
 }
 
-auto Geometry::compute_point_normals(const Property_map_descriptor& descriptor) -> bool
+auto Geometry::compute_point_normals(
+    const Property_map_descriptor&        descriptor,
+    erhe::concurrency::Thread_pool* const thread_pool
+) -> bool
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -477,27 +725,81 @@ auto Geometry::compute_point_normals(const Property_map_descriptor& descriptor)
     auto* const point_normals   = point_attributes().find_or_create<vec3>(descriptor);
     const auto* polygon_normals = polygon_attributes().find<vec3>(c_polygon_normals);
     if (polygon_normals == nullptr) {
-        const bool polygon_normals_ok = compute_polygon_normals();
+        const bool polygon_normals_ok = compute_polygon_normals(thread_pool);
         if (!polygon_normals_ok) {
             return false;
         }
         polygon_normals = polygon_attributes().find<vec3>(c_polygon_normals);
     }
 
+    if ((m_serial_point_normals == m_serial) && !point_normals->empty()) {
+        // Points of dirty polygons have changed; their polygon normals must be updated first
+        const std::vector<Polygon_id> dirty_polygons = take_dirty_polygons(Dirty_consumer::point_normals);
+        if (!compute_polygon_normals(thread_pool)) {
+            return false;
+        }
+        std::vector<Point_id> dirty_points;
+        for (const Polygon_id polygon_id : dirty_polygons) {
+            const Polygon& polygon = polygons[polygon_id];
+            for (uint32_t i = 0; i < polygon.corner_count; ++i) {
+                dirty_points.push_back(corners[polygon_corners[polygon.first_polygon_corner_id + i]].point_id);
+            }
+        }
+        std::sort(dirty_points.begin(), dirty_points.end());
+        dirty_points.erase(std::unique(dirty_points.begin(), dirty_points.end()), dirty_points.end());
+        for (const Point_id point_id : dirty_points) {
+            vec3 normal_sum{0.0f};
+            points[point_id].for_each_corner_const(*this, [&](auto& j) {
+                if (polygon_normals->has(j.corner.polygon_id)) {
+                    normal_sum += polygon_normals->get(j.corner.polygon_id);
+                }
+            });
+            point_normals->put(point_id, normalize(normal_sum));
+        }
+        return true;
+    }
+
     point_normals->clear();
 
-    for_each_point([&](auto& i) {
-        vec3 normal_sum{0.0f};
-        i.point.for_each_corner(*this, [&](auto& j) {
-            if (polygon_normals->has(j.corner.polygon_id)) {
-                normal_sum += polygon_normals->get(j.corner.polygon_id);
+    // Each point writes only its own normal, so points can be processed in parallel
+    const auto for_each_point_id = [&](auto&& function) {
+        if (thread_pool != nullptr) {
+            erhe::concurrency::parallel_for(*thread_pool, Point_id{0}, m_next_point_id, function);
+        } else {
+            for (Point_id point_id = 0; point_id < m_next_point_id; ++point_id) {
+                function(point_id);
             }
-            // TODO else
+        }
+    };
+
+    // Dense path: all polygon normals present, read and write contiguous values
+    const std::span<vec3> point_normal_values = point_normals->assign_span(m_next_point_id);
+    if (polygon_normals->is_fully_populated(m_next_polygon_id)) {
+        const std::span<const vec3> polygon_normal_values = polygon_normals->get_span(m_next_polygon_id);
+        for_each_point_id([&](const Point_id point_id) {
+            const Point& point = points[point_id];
+            vec3 normal_sum{0.0f};
+            for (uint32_t i = 0; i < point.corner_count; ++i) {
+                const Corner_id corner_id = point_corners[point.first_point_corner_id + i];
+                normal_sum += polygon_normal_values[corners[corner_id].polygon_id];
+            }
+            point_normal_values[point_id] = normalize(normal_sum);
         });
-        point_normals->put(i.point_id, normalize(normal_sum));
-    });
+    } else {
+        for_each_point_id([&](const Point_id point_id) {
+            vec3 normal_sum{0.0f};
+            points[point_id].for_each_corner_const(*this, [&](auto& j) {
+                if (polygon_normals->has(j.corner.polygon_id)) {
+                    normal_sum += polygon_normals->get(j.corner.polygon_id);
+                }
+                // TODO else
+            });
+            point_normal_values[point_id] = normalize(normal_sum);
+        });
+    }
 
     m_serial_point_normals = m_serial;
+    mark_dirty_consumed(Dirty_consumer::point_normals);
     return true;
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "erhe_geometry/edge_index.hpp"
 #include "erhe_geometry/property_map.hpp"
 #include "erhe_geometry/property_map_collection.hpp"
 #include "erhe_geometry/types.hpp"
@@ -7,11 +8,16 @@
 #include <glm/glm.hpp>
 #include <gsl/assert>
 
+#include <array>
 #include <functional>
 #include <optional>
+#include <span>
 #include <string_view>
 #include <vector>
 
+namespace erhe::concurrency {
+    class Thread_pool;
+}
 namespace spdlog {
     class logger;
 }
@@ -19,31 +25,72 @@ namespace spdlog {
 namespace erhe::geometry
 {
 
-inline constexpr Property_map_descriptor c_point_locations      { "point_locations"      , Transform_mode::position            , Interpolation_mode::linear };
-inline constexpr Property_map_descriptor c_point_normals        { "point_normals"        , Transform_mode::direction           , Interpolation_mode::none/*Interpolation_mode::normalized*/ };
-inline constexpr Property_map_descriptor c_point_normals_smooth { "point_normals_smooth" , Transform_mode::direction           , Interpolation_mode::linear };
-inline constexpr Property_map_descriptor c_point_texcoords      { "point_texcoords"      , Transform_mode::none                , Interpolation_mode::linear };
-inline constexpr Property_map_descriptor c_point_tangents       { "point_tangents"       , Transform_mode::direction_vec3_float, Interpolation_mode::normalized_vec3_float };
-inline constexpr Property_map_descriptor c_point_bitangents     { "point_bitangents"     , Transform_mode::direction_vec3_float, Interpolation_mode::normalized_vec3_float };
-inline constexpr Property_map_descriptor c_point_colors         { "point_colors"         , Transform_mode::none                , Interpolation_mode::linear };
-inline constexpr Property_map_descriptor c_point_joint_indices  { "point_joint_indices"  , Transform_mode::none                , Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_point_joint_weights  { "point_joint_weights"  , Transform_mode::none                , Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_point_aniso_control  { "point_aniso_control"  , Transform_mode::none                , Interpolation_mode::linear };
-inline constexpr Property_map_descriptor c_corner_normals       { "corner_normals"       , Transform_mode::direction           , Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_corner_texcoords     { "corner_texcoords"     , Transform_mode::none                , Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_corner_tangents      { "corner_tangents"      , Transform_mode::direction_vec3_float, Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_corner_bitangents    { "corner_bitangents"    , Transform_mode::direction_vec3_float, Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_corner_colors        { "corner_colors"        , Transform_mode::none                , Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_corner_aniso_control { "corner_aniso_control" , Transform_mode::none                , Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_corner_indices       { "corner_indices"       , Transform_mode::none                , Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_polygon_centroids    { "polygon_centroids"    , Transform_mode::position            , Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_polygon_normals      { "polygon_normals"      , Transform_mode::direction           , Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_polygon_tangents     { "polygon_tangents"     , Transform_mode::direction_vec3_float, Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_polygon_bitangents   { "polygon_bitangents"   , Transform_mode::direction_vec3_float, Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_polygon_colors       { "polygon_colors"       , Transform_mode::none                , Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_polygon_aniso_control{ "polygon_aniso_control", Transform_mode::none                , Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_polygon_ids_vec3     { "polygon_ids_vec"      , Transform_mode::none                , Interpolation_mode::none };
-inline constexpr Property_map_descriptor c_polygon_ids_uint     { "polygon_ids_uint"     , Transform_mode::none                , Interpolation_mode::none };
+inline constexpr Property_map_descriptor c_point_locations      { "point_locations"      , Transform_mode::position            , Interpolation_mode::linear,  0 };
+inline constexpr Property_map_descriptor c_point_normals        { "point_normals"        , Transform_mode::direction           , Interpolation_mode::none/*Interpolation_mode::normalized*/,  1 };
+inline constexpr Property_map_descriptor c_point_normals_smooth { "point_normals_smooth" , Transform_mode::direction           , Interpolation_mode::linear,  2 };
+inline constexpr Property_map_descriptor c_point_texcoords      { "point_texcoords"      , Transform_mode::none                , Interpolation_mode::linear,  3 };
+inline constexpr Property_map_descriptor c_point_tangents       { "point_tangents"       , Transform_mode::direction_vec3_float, Interpolation_mode::normalized_vec3_float,  4 };
+inline constexpr Property_map_descriptor c_point_bitangents     { "point_bitangents"     , Transform_mode::direction_vec3_float, Interpolation_mode::normalized_vec3_float,  5 };
+inline constexpr Property_map_descriptor c_point_colors         { "point_colors"         , Transform_mode::none                , Interpolation_mode::linear,  6 };
+inline constexpr Property_map_descriptor c_point_joint_indices  { "point_joint_indices"  , Transform_mode::none                , Interpolation_mode::none,  7 };
+inline constexpr Property_map_descriptor c_point_joint_weights  { "point_joint_weights"  , Transform_mode::none                , Interpolation_mode::none,  8 };
+inline constexpr Property_map_descriptor c_point_aniso_control  { "point_aniso_control"  , Transform_mode::none                , Interpolation_mode::linear,  9 };
+inline constexpr Property_map_descriptor c_corner_normals       { "corner_normals"       , Transform_mode::direction           , Interpolation_mode::none, 10 };
+inline constexpr Property_map_descriptor c_corner_texcoords     { "corner_texcoords"     , Transform_mode::none                , Interpolation_mode::none, 11 };
+inline constexpr Property_map_descriptor c_corner_tangents      { "corner_tangents"      , Transform_mode::direction_vec3_float, Interpolation_mode::none, 12 };
+inline constexpr Property_map_descriptor c_corner_bitangents    { "corner_bitangents"    , Transform_mode::direction_vec3_float, Interpolation_mode::none, 13 };
+inline constexpr Property_map_descriptor c_corner_colors        { "corner_colors"        , Transform_mode::none                , Interpolation_mode::none, 14 };
+inline constexpr Property_map_descriptor c_corner_aniso_control { "corner_aniso_control" , Transform_mode::none                , Interpolation_mode::none, 15 };
+inline constexpr Property_map_descriptor c_corner_indices       { "corner_indices"       , Transform_mode::none                , Interpolation_mode::none, 16 };
+inline constexpr Property_map_descriptor c_polygon_centroids    { "polygon_centroids"    , Transform_mode::position            , Interpolation_mode::none, 17 };
+inline constexpr Property_map_descriptor c_polygon_normals      { "polygon_normals"      , Transform_mode::direction           , Interpolation_mode::none, 18 };
+inline constexpr Property_map_descriptor c_polygon_tangents     { "polygon_tangents"     , Transform_mode::direction_vec3_float, Interpolation_mode::none, 19 };
+inline constexpr Property_map_descriptor c_polygon_bitangents   { "polygon_bitangents"   , Transform_mode::direction_vec3_float, Interpolation_mode::none, 20 };
+inline constexpr Property_map_descriptor c_polygon_colors       { "polygon_colors"       , Transform_mode::none                , Interpolation_mode::none, 21 };
+inline constexpr Property_map_descriptor c_polygon_aniso_control{ "polygon_aniso_control", Transform_mode::none                , Interpolation_mode::none, 22 };
+inline constexpr Property_map_descriptor c_polygon_ids_vec3     { "polygon_ids_vec"      , Transform_mode::none                , Interpolation_mode::none, 23 };
+inline constexpr Property_map_descriptor c_polygon_ids_uint     { "polygon_ids_uint"     , Transform_mode::none                , Interpolation_mode::none, 24 };
+
+inline constexpr std::array<const Property_map_descriptor*, 25> c_builtin_property_maps{
+    &c_point_locations,
+    &c_point_normals,
+    &c_point_normals_smooth,
+    &c_point_texcoords,
+    &c_point_tangents,
+    &c_point_bitangents,
+    &c_point_colors,
+    &c_point_joint_indices,
+    &c_point_joint_weights,
+    &c_point_aniso_control,
+    &c_corner_normals,
+    &c_corner_texcoords,
+    &c_corner_tangents,
+    &c_corner_bitangents,
+    &c_corner_colors,
+    &c_corner_aniso_control,
+    &c_corner_indices,
+    &c_polygon_centroids,
+    &c_polygon_normals,
+    &c_polygon_tangents,
+    &c_polygon_bitangents,
+    &c_polygon_colors,
+    &c_polygon_aniso_control,
+    &c_polygon_ids_vec3,
+    &c_polygon_ids_uint,
+};
+
+static_assert(c_builtin_property_maps.size() <= c_property_map_slot_count);
+static_assert(
+    []() {
+        for (std::size_t i = 0; i < c_builtin_property_maps.size(); ++i) {
+            if (c_builtin_property_maps[i]->id != i) {
+                return false;
+            }
+        }
+        return true;
+    }(),
+    "Built-in property map ids must match their index in c_builtin_property_maps"
+);
 
 class Point;
 class Polygon;
@@ -100,6 +147,12 @@ public:
         std::function<void(Point_corner_context& context)> callback
     );
 
+    template <typename Callback>
+    void for_each_corner(
+        Geometry&  geometry,
+        Callback&& callback
+    );
+
     class Point_corner_context_const
     {
     public:
@@ -120,6 +173,12 @@ public:
         std::function<void(Point_corner_context_const& context)> callback
     ) const;
 
+    template <typename Callback>
+    void for_each_corner_const(
+        const Geometry& geometry,
+        Callback&&      callback
+    ) const;
+
     class Point_corner_neighborhood_context
     {
     public:
@@ -167,11 +226,23 @@ public:
         std::function<void(Point_corner_neighborhood_context& context)> callback
     );
 
+    template <typename Callback>
+    void for_each_corner_neighborhood(
+        Geometry&  geometry,
+        Callback&& callback
+    );
+
     void for_each_corner_neighborhood_const(
         const Geometry&                                                       geometry,
         std::function<void(Point_corner_neighborhood_context_const& context)> callback
     ) const;
 
+    template <typename Callback>
+    void for_each_corner_neighborhood_const(
+        const Geometry& geometry,
+        Callback&&      callback
+    ) const;
+
     Point_corner_id first_point_corner_id{0};
     uint32_t        corner_count{0};
     uint32_t        reserved_corner_count{0};
@@ -305,11 +376,23 @@ public:
         std::function<void(Polygon_corner_context& context)> callback
     );
 
+    template <typename Callback>
+    void for_each_corner(
+        Geometry&  geometry,
+        Callback&& callback
+    );
+
     void for_each_corner_const(
         const Geometry&                                            geometry,
         std::function<void(Polygon_corner_context_const& context)> callback
     ) const;
 
+    template <typename Callback>
+    void for_each_corner_const(
+        const Geometry& geometry,
+        Callback&&      callback
+    ) const;
+
     class Polygon_corner_neighborhood_context
     {
     public:
@@ -357,10 +440,22 @@ public:
         std::function<void(Polygon_corner_neighborhood_context& context)> callback
     );
 
+    template <typename Callback>
+    void for_each_corner_neighborhood(
+        Geometry&  geometry,
+        Callback&& callback
+    );
+
     void for_each_corner_neighborhood_const(
         const Geometry&                                                         geometry,
         std::function<void(Polygon_corner_neighborhood_context_const& context)> callback
     ) const;
+
+    template <typename Callback>
+    void for_each_corner_neighborhood_const(
+        const Geometry& geometry,
+        Callback&&      callback
+    ) const;
 };
 
 class Edge
@@ -406,10 +501,22 @@ public:
         std::function<void(Edge_polygon_context& context)> callback
     );
 
+    template <typename Callback>
+    void for_each_polygon(
+        Geometry&  geometry,
+        Callback&& callback
+    );
+
     void for_each_polygon_const(
         const Geometry&                                          geometry,
         std::function<void(Edge_polygon_context_const& context)> callback
     ) const;
+
+    template <typename Callback>
+    void for_each_polygon_const(
+        const Geometry& geometry,
+        Callback&&      callback
+    ) const;
 };
 
 class Mesh_info
@@ -437,9 +544,32 @@ public:
     glm::mat3 inertial;
 };
 
+// First ids allocated by Geometry::make_polygons()
+class Polygon_allocation
+{
+public:
+    Polygon_id        first_polygon_id       {0};
+    Corner_id         first_corner_id        {0};
+    Polygon_corner_id first_polygon_corner_id{0};
+};
+
+// Outputs and behavior of Geometry::compute_tangents()
+class Tangent_options
+{
+public:
+    bool corner_tangents   {true};
+    bool corner_bitangents {true};
+    bool polygon_tangents  {false};
+    bool polygon_bitangents{false};
+    bool make_polygons_flat{true};
+    bool override_existing {false};
+};
+
 class Geometry
 {
 public:
+    friend class Geometry_serialization;
+
     using Point_property_map_collection   = Property_map_collection<Point_id>;
     using Corner_property_map_collection  = Property_map_collection<Corner_id>;
     using Polygon_property_map_collection = Property_map_collection<Polygon_id>;
@@ -467,16 +597,19 @@ public:
     {
         m_serial_point_normals  = m_serial;
         m_serial_corner_normals = m_serial;
+        mark_dirty_consumed(Dirty_consumer::point_normals);
     }
 
     void promise_has_polygon_normals()
     {
         m_serial_polygon_normals = m_serial;
+        mark_dirty_consumed(Dirty_consumer::polygon_normals);
     }
 
     void promise_has_polygon_centroids()
     {
         m_serial_polygon_centroids = m_serial;
+        mark_dirty_consumed(Dirty_consumer::polygon_centroids);
     }
 
     void promise_has_tangents()
@@ -484,6 +617,7 @@ public:
         m_serial_polygon_tangents = m_serial;
         m_serial_point_tangents   = m_serial;
         m_serial_corner_tangents  = m_serial;
+        mark_dirty_consumed(Dirty_consumer::tangents);
     }
 
     void promise_has_bitangents()
@@ -491,6 +625,7 @@ public:
         m_serial_polygon_bitangents = m_serial;
         m_serial_point_bitangents   = m_serial;
         m_serial_corner_bitangents  = m_serial;
+        mark_dirty_consumed(Dirty_consumer::tangents);
     }
 
     void promise_has_texture_coordinates()
@@ -506,17 +641,13 @@ public:
     auto get_polygon_corner_count() const -> uint32_t { return m_next_polygon_corner_id; }
     auto get_edge_count          () const -> uint32_t { return m_next_edge_id; }
 
-    [[nodiscard]] auto find_edge(Point_id a, Point_id b) -> std::optional<Edge>
+    [[nodiscard]] auto find_edge(const Point_id a, const Point_id b) const -> std::optional<Edge>
     {
-        if (b < a) {
-            std::swap(a, b);
-        }
-        for (const auto& edge : edges) {
-            if (edge.a == a && edge.b == b) {
-                return edge;
-            }
+        const std::optional<Edge_id> edge_id = m_edge_index.find(a, b);
+        if (!edge_id.has_value()) {
+            return {};
         }
-        return {};
+        return edges[edge_id.value()];
     }
 
     // Allocates new Corner / Corner_id
@@ -556,6 +687,25 @@ public:
     // - Point must be already allocated.
     auto make_polygon_corner(Polygon_id polygon_id, Point_id point_id) -> Corner_id;
 
+    // Allocates point_count new points with consecutive ids.
+    // Returns first new point id.
+    auto make_points(uint32_t point_count) -> Point_id;
+
+    // Allocates new polygons, corners and polygon corners, each with
+    // consecutive ids, so that they can be filled in parallel.
+    // - Caller must set polygon first polygon corner and corner count,
+    //   corners and polygon corners in the allocated ranges.
+    // - Caller must then call reserve_point_corners() for the new corners.
+    auto make_polygons(uint32_t polygon_count, uint32_t corner_count) -> Polygon_allocation;
+
+    // Reserves point corners for corners [corner_begin, corner_end),
+    // like calling reserve_point_corner() for each corner.
+    void reserve_point_corners(
+        Corner_id                       corner_begin,
+        Corner_id                       corner_end,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
+
     // Calculates the number of triangles as if all faces were triangulated
     [[nodiscard]] auto count_polygon_triangles() const -> std::size_t;
 
@@ -622,14 +772,14 @@ public:
     // Requires point locations.
     // Returns false if point locations are not available.
     // Returns true on success.
-    auto compute_polygon_normals() -> bool;
+    auto compute_polygon_normals(erhe::concurrency::Thread_pool* thread_pool = nullptr) -> bool;
 
     [[nodiscard]] auto has_polygon_normals() const -> bool;
 
     // Requires point locations.
     // Returns false if point locations are not available.
     // Returns true on success.
-    auto compute_polygon_centroids() -> bool;
+    auto compute_polygon_centroids(erhe::concurrency::Thread_pool* thread_pool = nullptr) -> bool;
 
     [[nodiscard]] auto has_polygon_centroids() const -> bool;
 
@@ -644,20 +794,22 @@ public:
     // also updates polygon normals.
     // Returns false if unable to calculate polygon normals
     // (due to missing point locations).
-    auto compute_point_normals(const Property_map_descriptor& descriptor) -> bool;
+    auto compute_point_normals(
+        const Property_map_descriptor&  descriptor,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    ) -> bool;
 
     [[nodiscard]] auto has_polygon_tangents  () const -> bool;
     [[nodiscard]] auto has_polygon_bitangents() const -> bool;
     [[nodiscard]] auto has_corner_tangents   () const -> bool;
     [[nodiscard]] auto has_corner_bitangents () const -> bool;
 
+    // When thread_pool is given, large geometries are split to spatially
+    // coherent chunks that are processed in parallel. Results are identical
+    // to the serial path.
     auto compute_tangents(
-        const bool corner_tangents    = true,
-        const bool corner_bitangents  = true,
-        const bool polygon_tangents   = false,
-        const bool polygon_bitangents = false,
-        const bool make_polygons_flat = true,
-        const bool override_existing  = false
+        const Tangent_options&          options     = {},
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
     ) -> bool;
 
     auto generate_polygon_texture_coordinates(bool overwrite_existing_texture_coordinates = false) -> bool;
@@ -683,11 +835,26 @@ public:
         const Property_map<Polygon_id, glm::vec3>& point_normals
     ) const;
 
-    void sort_point_corners();
+    // Marks normals, centroids and tangents of a polygon, or of all polygons
+    // using a point, out of date. Use after point locations, texture
+    // coordinates or polygon corners were modified in place, without adding
+    // or removing elements. Following compute_*() calls then update only the
+    // dirty polygons and their one-ring, instead of the whole geometry.
+    // Point corners must be built for the one-ring to be found.
+    void mark_polygon_dirty(Polygon_id polygon_id);
+    void mark_point_dirty  (Point_id point_id);
 
-    void make_point_corners();
+    // Polygons sharing a point with any of the given polygons, including
+    // the given polygons. Sorted, without duplicates.
+    [[nodiscard]] auto get_one_ring_polygons(std::span<const Polygon_id> polygon_ids) const -> std::vector<Polygon_id>;
 
-    void build_edges(bool is_manifold = true);
+    // When thread_pool is given, large geometries are processed in
+    // parallel. Results are identical to the serial path.
+    void sort_point_corners(erhe::concurrency::Thread_pool* thread_pool = nullptr);
+
+    void make_point_corners(erhe::concurrency::Thread_pool* thread_pool = nullptr);
+
+    void build_edges(bool is_manifold = true, erhe::concurrency::Thread_pool* thread_pool = nullptr);
 
     [[nodiscard]] auto has_edges() const -> bool;
 
@@ -823,6 +990,36 @@ public:
     void for_each_edge         (std::function<void(Edge_context&         )> callback);
     void for_each_edge_const   (std::function<void(Edge_context_const&   )> callback) const;
 
+    template <typename Callback> void for_each_corner       (Callback&& callback);
+    template <typename Callback> void for_each_corner_const (Callback&& callback) const;
+    template <typename Callback> void for_each_point        (Callback&& callback);
+    template <typename Callback> void for_each_point_const  (Callback&& callback) const;
+    template <typename Callback> void for_each_polygon      (Callback&& callback);
+    template <typename Callback> void for_each_polygon_const(Callback&& callback) const;
+    template <typename Callback> void for_each_edge         (Callback&& callback);
+    template <typename Callback> void for_each_edge_const   (Callback&& callback) const;
+
+    // Derived data updated incrementally from the dirty polygon log
+    enum class Dirty_consumer : unsigned int {
+        polygon_normals = 0,
+        polygon_centroids,
+        point_normals,
+        tangents,
+        count
+    };
+
+    [[nodiscard]] auto is_dirty_consumer_valid(Dirty_consumer consumer) const -> bool;
+    [[nodiscard]] auto is_dirty_pending       (Dirty_consumer consumer) const -> bool;
+
+    // Returns polygons logged dirty since the consumer was last updated,
+    // sorted and without duplicates, and marks them consumed.
+    auto take_dirty_polygons(Dirty_consumer consumer) -> std::vector<Polygon_id>;
+    void mark_dirty_consumed(Dirty_consumer consumer);
+    void trim_dirty_polygons();
+
+    void make_point_corners_parallel    (erhe::concurrency::Thread_pool& thread_pool);
+    auto build_edges_first_pass_parallel(erhe::concurrency::Thread_pool& thread_pool) -> std::size_t;
+
     constexpr static std::size_t s_grow = 4096;
     Corner_id                       m_next_corner_id           {0};
     Point_id                        m_next_point_id            {0};
@@ -831,6 +1028,7 @@ public:
     Point_corner_id                 m_next_point_corner_reserve{0};
     Polygon_corner_id               m_next_polygon_corner_id   {0};
     Edge_polygon_id                 m_next_edge_polygon_id     {0};
+    Edge_index                      m_edge_index;
     Polygon_id                      m_polygon_corner_polygon   {0};
     Edge_id                         m_edge_polygon_edge        {0};
     Point_property_map_collection   m_point_property_map_collection;
@@ -853,10 +1051,13 @@ public:
     uint64_t                        m_serial_corner_tangents            {0};
     uint64_t                        m_serial_corner_bitangents          {0};
     uint64_t                        m_serial_corner_texture_coordinates {0};
+    std::vector<Polygon_id>         m_dirty_polygons;
+    std::array<std::size_t, static_cast<std::size_t>(Dirty_consumer::count)> m_dirty_cursors{};
 };
 
 } // namespace erhe::geometry
 
+#include "geometry_iterators.inl"
 #include "corner.inl"
 #include "polygon.inl"
 #include "geometry.inl"
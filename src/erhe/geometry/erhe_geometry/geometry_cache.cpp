@@ -0,0 +1,85 @@
+#include "erhe_geometry/geometry_cache.hpp"
+#include "erhe_geometry/geometry.hpp"
+#include "erhe_geometry/geometry_log.hpp"
+#include "erhe_geometry/geometry_serialization.hpp"
+#include "erhe_file/file.hpp"
+#include "erhe_hash/hash.hpp"
+#include "erhe_profile/profile.hpp"
+
+#include <fmt/format.h>
+
+namespace erhe::geometry
+{
+
+namespace detail {
+
+auto hash_cache_key_bytes(const void* data, const std::size_t byte_count, const uint64_t seed) -> uint64_t
+{
+    return erhe::hash::hash(data, byte_count, seed);
+}
+
+} // namespace detail
+
+Geometry_cache::Geometry_cache(const std::filesystem::path& directory)
+    : m_directory{directory}
+{
+}
+
+auto Geometry_cache::get_directory() const -> const std::filesystem::path&
+{
+    return m_directory;
+}
+
+auto Geometry_cache::get_path(const uint64_t key) const -> std::filesystem::path
+{
+    return m_directory / fmt::format("{:016x}.geometry", key);
+}
+
+auto Geometry_cache::load(const uint64_t key) const -> std::vector<Geometry>
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const std::filesystem::path      path = get_path(key);
+    const erhe::file::Mapped_file    file{"Geometry_cache::load", path};
+    const std::span<const std::byte> data = file.data();
+    if (data.empty()) {
+        return {};
+    }
+
+    std::optional<std::vector<Geometry>> geometries = deserialize_geometries(data);
+    if (!geometries.has_value()) {
+        log_serialization->info("Geometry cache entry '{}' is not usable, ignored", erhe::file::to_string(path));
+        return {};
+    }
+    return std::move(geometries.value());
+}
+
+auto Geometry_cache::store(const uint64_t key, const std::span<const Geometry* const> geometries) const -> bool
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const std::vector<std::byte> data = serialize_geometries(geometries);
+    return erhe::file::write("Geometry_cache::store", get_path(key), data);
+}
+
+auto Geometry_cache::store(const uint64_t key, const Geometry& geometry) const -> bool
+{
+    const Geometry* geometries[] = { &geometry };
+    return store(key, geometries);
+}
+
+auto Geometry_cache::get_or_make(const uint64_t key, const std::function<Geometry()>& make) const -> Geometry
+{
+    ERHE_PROFILE_FUNCTION();
+
+    std::vector<Geometry> cached = load(key);
+    if (cached.size() == 1) {
+        return std::move(cached.front());
+    }
+
+    Geometry geometry = make();
+    store(key, geometry);
+    return geometry;
+}
+
+} // namespace erhe::geometry
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "erhe_geometry/geometry_serialization.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <bit>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace erhe::geometry
+{
+
+class Geometry;
+
+// Increment when shape generators, geometry operations, or generated
+// normals, texture coordinates or tangents change their output.
+inline constexpr uint32_t c_geometry_cache_version = 1;
+
+// On-disk cache of serialized geometries, see geometry_serialization.hpp.
+//
+// Entries are keyed by a content hash: for generated geometry the hash of
+// the generator name and its parameters, and for imported geometry the hash
+// of the source file contents. Keys also include c_geometry_file_version and
+// c_geometry_cache_version, and callers mix in their own post-processing
+// version, so entries made by older code are never served. Each entry is a
+// single file in the cache directory, written atomically, so the cache can
+// be shared by concurrent tasks. Files from older format versions, and
+// files which fail the payload checksum, are treated as misses and
+// replaced.
+class Geometry_cache
+{
+public:
+    explicit Geometry_cache(const std::filesystem::path& directory);
+
+    [[nodiscard]] auto get_directory() const -> const std::filesystem::path&;
+
+    // Returns empty vector on cache miss
+    [[nodiscard]] auto load(uint64_t key) const -> std::vector<Geometry>;
+
+    auto store(uint64_t key, std::span<const Geometry* const> geometries) const -> bool;
+    auto store(uint64_t key, const Geometry& geometry) const -> bool;
+
+    // Loads single geometry for key, or calls make() and stores the result
+    [[nodiscard]] auto get_or_make(uint64_t key, const std::function<Geometry()>& make) const -> Geometry;
+
+private:
+    [[nodiscard]] auto get_path(uint64_t key) const -> std::filesystem::path;
+
+    std::filesystem::path m_directory;
+};
+
+namespace detail {
+
+[[nodiscard]] auto hash_cache_key_bytes(const void* data, std::size_t byte_count, uint64_t seed) -> uint64_t;
+
+[[nodiscard]] inline auto hash_cache_key_part(const std::string_view text, const uint64_t seed) -> uint64_t
+{
+    const uint64_t size = text.size();
+    return hash_cache_key_bytes(text.data(), text.size(), hash_cache_key_bytes(&size, sizeof(size), seed));
+}
+
+[[nodiscard]] inline auto hash_cache_key_part(const std::span<const std::byte> content, const uint64_t seed) -> uint64_t
+{
+    const uint64_t size = content.size();
+    return hash_cache_key_bytes(content.data(), content.size(), hash_cache_key_bytes(&size, sizeof(size), seed));
+}
+
+// Floating point values are hashed by bit pattern, with -0 hashed as 0 so
+// that equal parameters give equal keys
+[[nodiscard]] inline auto hash_cache_key_part(const float value, const uint64_t seed) -> uint64_t
+{
+    const uint32_t bits = std::bit_cast<uint32_t>((value == 0.0f) ? 0.0f : value);
+    return hash_cache_key_bytes(&bits, sizeof(bits), seed);
+}
+
+[[nodiscard]] inline auto hash_cache_key_part(const double value, const uint64_t seed) -> uint64_t
+{
+    const uint64_t bits = std::bit_cast<uint64_t>((value == 0.0) ? 0.0 : value);
+    return hash_cache_key_bytes(&bits, sizeof(bits), seed);
+}
+
+// Other values are hashed by their bytes. Types with padding bytes are
+// rejected, as padding could make equal values hash differently; hash
+// their fields instead.
+template <typename T>
+    requires (std::has_unique_object_representations_v<T> && !std::is_pointer_v<T>)
+[[nodiscard]] inline auto hash_cache_key_part(const T& value, const uint64_t seed) -> uint64_t
+{
+    return hash_cache_key_bytes(&value, sizeof(T), seed);
+}
+
+} // namespace detail
+
+// Cache key from a generator or source name and its parameters. Parameters
+// are hashed by value, strings and byte spans by content. Callers which
+// post-process geometry should pass a version of that processing as one of
+// the parameters.
+template <typename... Args>
+[[nodiscard]] auto make_geometry_cache_key(const std::string_view name, const Args&... args) -> uint64_t
+{
+    uint64_t key = 0xcbf29ce484222325;
+    key = detail::hash_cache_key_part(c_geometry_file_version, key);
+    key = detail::hash_cache_key_part(c_geometry_cache_version, key);
+    key = detail::hash_cache_key_part(name, key);
+    ((key = detail::hash_cache_key_part(args, key)), ...);
+    return key;
+}
+
+} // namespace erhe::geometry
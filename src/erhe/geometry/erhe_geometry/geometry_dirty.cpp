@@ -0,0 +1,133 @@
+#include "erhe_geometry/geometry.hpp"
+#include "erhe_profile/profile.hpp"
+
+#include <algorithm>
+
+namespace erhe::geometry
+{
+
+// Dirty polygons are appended to a single log. Each consumer (polygon
+// normals, centroids, point normals, tangents) keeps a cursor to the first
+// log entry it has not yet processed. The log is only used while the
+// consumer serial matches m_serial; any topology change invalidates the
+// derived data as a whole and the log is ignored.
+
+void Geometry::mark_polygon_dirty(const Polygon_id polygon_id)
+{
+    Expects(polygon_id < m_next_polygon_id);
+
+    if (
+        !is_dirty_consumer_valid(Dirty_consumer::polygon_normals  ) &&
+        !is_dirty_consumer_valid(Dirty_consumer::polygon_centroids) &&
+        !is_dirty_consumer_valid(Dirty_consumer::point_normals    ) &&
+        !is_dirty_consumer_valid(Dirty_consumer::tangents         )
+    ) {
+        return; // Nothing to update incrementally
+    }
+    m_dirty_polygons.push_back(polygon_id);
+}
+
+void Geometry::mark_point_dirty(const Point_id point_id)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    Expects(point_id < m_next_point_id);
+
+    // Moving a point changes every polygon using it
+    const Point& point = points[point_id];
+    if (point.corner_count > 0) {
+        for (uint32_t i = 0; i < point.corner_count; ++i) {
+            const Corner_id corner_id = point_corners[point.first_point_corner_id + i];
+            mark_polygon_dirty(corners[corner_id].polygon_id);
+        }
+        return;
+    }
+
+    // Point corners have not been built; scan all corners
+    for (Corner_id corner_id = 0; corner_id < m_next_corner_id; ++corner_id) {
+        const Corner& corner = corners[corner_id];
+        if (corner.point_id == point_id) {
+            mark_polygon_dirty(corner.polygon_id);
+        }
+    }
+}
+
+auto Geometry::get_one_ring_polygons(const std::span<const Polygon_id> polygon_ids) const -> std::vector<Polygon_id>
+{
+    ERHE_PROFILE_FUNCTION();
+
+    std::vector<Polygon_id> result{polygon_ids.begin(), polygon_ids.end()};
+    for (const Polygon_id polygon_id : polygon_ids) {
+        const Polygon& polygon = polygons[polygon_id];
+        for (uint32_t i = 0; i < polygon.corner_count; ++i) {
+            const Corner_id corner_id = polygon_corners[polygon.first_polygon_corner_id + i];
+            const Point&    point     = points[corners[corner_id].point_id];
+            for (uint32_t j = 0; j < point.corner_count; ++j) {
+                const Corner_id point_corner_id = point_corners[point.first_point_corner_id + j];
+                result.push_back(corners[point_corner_id].polygon_id);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+auto Geometry::is_dirty_consumer_valid(const Dirty_consumer consumer) const -> bool
+{
+    switch (consumer) {
+        case Dirty_consumer::polygon_normals:   return m_serial_polygon_normals   == m_serial;
+        case Dirty_consumer::polygon_centroids: return m_serial_polygon_centroids == m_serial;
+        case Dirty_consumer::point_normals:     return m_serial_point_normals     == m_serial;
+        case Dirty_consumer::tangents: {
+            return
+                (m_serial_polygon_tangents   == m_serial) ||
+                (m_serial_polygon_bitangents == m_serial) ||
+                (m_serial_corner_tangents    == m_serial) ||
+                (m_serial_corner_bitangents  == m_serial);
+        }
+        default: return false;
+    }
+}
+
+auto Geometry::is_dirty_pending(const Dirty_consumer consumer) const -> bool
+{
+    return
+        is_dirty_consumer_valid(consumer) &&
+        (m_dirty_cursors[static_cast<std::size_t>(consumer)] < m_dirty_polygons.size());
+}
+
+auto Geometry::take_dirty_polygons(const Dirty_consumer consumer) -> std::vector<Polygon_id>
+{
+    std::size_t& cursor = m_dirty_cursors[static_cast<std::size_t>(consumer)];
+    std::vector<Polygon_id> result{
+        m_dirty_polygons.begin() + static_cast<std::ptrdiff_t>(std::min(cursor, m_dirty_polygons.size())),
+        m_dirty_polygons.end()
+    };
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    cursor = m_dirty_polygons.size();
+    trim_dirty_polygons();
+    return result;
+}
+
+void Geometry::mark_dirty_consumed(const Dirty_consumer consumer)
+{
+    m_dirty_cursors[static_cast<std::size_t>(consumer)] = m_dirty_polygons.size();
+    trim_dirty_polygons();
+}
+
+void Geometry::trim_dirty_polygons()
+{
+    // Log can be cleared once every consumer that still uses it is done
+    for (std::size_t i = 0; i < m_dirty_cursors.size(); ++i) {
+        const Dirty_consumer consumer = static_cast<Dirty_consumer>(i);
+        if (is_dirty_consumer_valid(consumer) && (m_dirty_cursors[i] < m_dirty_polygons.size())) {
+            return;
+        }
+    }
+    m_dirty_polygons.clear();
+    m_dirty_cursors.fill(0);
+}
+
+} // namespace erhe::geometry
@@ -19,6 +19,7 @@ std::shared_ptr<spdlog::logger> log_subdivide        ;
 std::shared_ptr<spdlog::logger> log_attribute_maps   ;
 std::shared_ptr<spdlog::logger> log_merge            ;
 std::shared_ptr<spdlog::logger> log_weld             ;
+std::shared_ptr<spdlog::logger> log_serialization    ;
 
 void initialize_logging()
 {
@@ -38,6 +39,7 @@ void initialize_logging()
     log_attribute_maps    = make_logger("erhe.geometry.attribute_maps"   );
     log_merge             = make_logger("erhe.geometry.merge"            );
     log_weld              = make_logger("erhe.geometry.weld"             );
+    log_serialization     = make_logger("erhe.geometry.serialization"    );
 }
 
 } // namespace erhe::geometry
@@ -22,6 +22,7 @@ extern std::shared_ptr<spdlog::logger> log_subdivide;
 extern std::shared_ptr<spdlog::logger> log_attribute_maps;
 extern std::shared_ptr<spdlog::logger> log_merge;
 extern std::shared_ptr<spdlog::logger> log_weld;
+extern std::shared_ptr<spdlog::logger> log_serialization;
 
 void initialize_logging();
 
@@ -1,5 +1,6 @@
 #include <spdlog/spdlog.h>
 
+#include "erhe_concurrency/parallel_for.hpp"
 #include "erhe_geometry/geometry.hpp"
 #include "erhe_geometry/geometry_log.hpp"
 #include "erhe_profile/profile.hpp"
@@ -7,6 +8,8 @@
 
 #include <glm/glm.hpp>
 
+#include <atomic>
+
 namespace erhe::geometry
 {
 
@@ -99,6 +102,7 @@ auto Geometry::make_edge(const Point_id a, const Point_id b) -> Edge_id
     edge.b = b;
     edge.first_edge_polygon_id = m_next_edge_polygon_id;
     edge.polygon_count = 0;
+    m_edge_index.insert(a, b, edge_id); // Keeps first edge if duplicate
     SPDLOG_LOGGER_TRACE(log, "\tmake_edge(a = {}, b = {}) edge_id = {}", a, b, edge_id);
     return edge_id;
 }
@@ -120,7 +124,117 @@ void Geometry::reserve_point_corner(const Point_id point_id, const Corner_id cor
     point.reserved_corner_count++;
 }
 
-void Geometry::make_point_corners()
+namespace {
+
+class Point_corner_info
+{
+public:
+    Point_corner_id point_corner_id{0};
+    Corner_id       corner_id      {0};
+    Point_id        prev_point_id  {0};
+    Point_id        next_point_id  {0};
+    bool            used           {false};
+};
+
+// Orders point corners of a single point so that consecutive corners
+// share an edge. Returns false if the corners could not be sorted.
+auto sort_corners_of_point(
+    Geometry&                       geometry,
+    const Point_id                  point_id,
+    std::vector<Point_corner_info>& point_corner_infos
+) -> bool
+{
+    Point& point = geometry.points[point_id];
+    if (point.corner_count < 3) {
+        return true;
+    }
+
+    bool success{true};
+    point_corner_infos.clear();
+    point.for_each_corner(geometry, [&](auto& j) {
+        const Corner_id          middle_corner_id = j.corner_id; //point_corners[j.point_corner_id];
+        std::optional<Corner_id> next_corner_id   = 0;
+        const Corner&            middle_corner = j.corner; // corners[middle_corner_id];
+        const Polygon_id         polygon_id    = middle_corner.polygon_id;
+        const Polygon&           polygon       = geometry.polygons[polygon_id];
+        polygon.for_each_corner_neighborhood_const(geometry, [&](auto& k) {
+            if (k.corner_id == middle_corner_id) {
+                const Corner& prev_corner = geometry.corners[k.prev_corner_id];
+                const Corner& next_corner = geometry.corners[k.next_corner_id];
+
+                point_corner_infos.push_back(
+                    {
+                        .point_corner_id = j.point_corner_id,
+                        .corner_id       = middle_corner_id,
+                        .prev_point_id   = prev_corner.point_id,
+                        .next_point_id   = next_corner.point_id,
+                        .used            = false
+                    }
+                );
+                k.break_iteration();
+            }
+        });
+    });
+
+#if 0
+    log_geometry->info("sort: point_id = {}, corner_count = {}", point_id, point.corner_count);
+#endif
+    for (uint32_t j = 0, end = static_cast<uint32_t>(point_corner_infos.size()); j < end; ++j) {
+        const uint32_t     next_j = (j + 1) % end;
+        Point_corner_info& head   = point_corner_infos[j];
+        Point_corner_info& next   = point_corner_infos[next_j];
+        bool found{false};
+#if 0
+        log_geometry->info(
+            "    j = {}, next_j = {}, head.point_corner_id = {}, head.prev_point_id = {}, head.next_point_id = {}",
+            j,
+            next_j,
+            head.point_corner_id,
+            head.prev_point_id,
+            head.next_point_id
+        );
+#endif
+        for (uint32_t k = 0; k < end; ++k) {
+            Point_corner_info& node = point_corner_infos[k];
+#if 0
+            log_geometry->info(
+                "    k = {}, node.point_corner_id = {}, node.next_point_id = {}, prev_point_id = {}, used = {}",
+                k,
+                node.point_corner_id,
+                node.next_point_id,
+                node.prev_point_id,
+                node.used
+            );
+#endif
+            if (node.used) {
+                continue;
+            }
+            if (node.next_point_id == head.prev_point_id) {
+                found = true;
+                node.used = true;
+                if (k != next_j) {
+                    std::swap(next, node);
+                }
+                break;
+            }
+        }
+        if (!found) {
+            log_geometry->warn(
+                "Could not sort point corners for point_id = {} head.prev_point_id = {}",
+                point_id,
+                head.prev_point_id
+            );
+            success = false;
+        }
+        const Point_corner_id point_corner_id = point.first_point_corner_id + j;
+        geometry.point_corners[point_corner_id] = head.corner_id;
+    }
+    return success;
+}
+
+} // anonymous namespace
+
+void Geometry::make_point_corners(erhe::concurrency::Thread_pool* thread_pool)
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -134,127 +248,116 @@ void Geometry::make_point_corners()
     });
     m_next_point_corner_reserve = next_point_corner;
     point_corners.resize(static_cast<size_t>(m_next_point_corner_reserve));
-    for_each_polygon([&](auto& i) {
-        i.polygon.for_each_corner(*this, [&](auto& j) {
-            //ERHE_VERIFY(j.corner_id != std::numeric_limits<Corner_id>::max());
-            //ERHE_VERIFY(j.corner_id < m_next_corner_id);
-            const Point_id  point_id        = j.corner.point_id;
-            //ERHE_VERIFY(point_id != std::numeric_limits<Point_id>::max());
-            //ERHE_VERIFY(point_id < m_next_point_id);
-            Point&          point           = j.geometry.points[point_id];
-            Point_corner_id point_corner_id = point.first_point_corner_id + point.corner_count++;
-            //ERHE_VERIFY(point_corner_id < point_corners.size());
-            point_corners[point_corner_id] = j.corner_id;
+
+    if ((thread_pool != nullptr) && (m_next_corner_id >= erhe::concurrency::c_parallel_serial_threshold)) {
+        make_point_corners_parallel(*thread_pool);
+    } else {
+        for_each_polygon([&](auto& i) {
+            i.polygon.for_each_corner(*this, [&](auto& j) {
+                //ERHE_VERIFY(j.corner_id != std::numeric_limits<Corner_id>::max());
+                //ERHE_VERIFY(j.corner_id < m_next_corner_id);
+                const Point_id  point_id        = j.corner.point_id;
+                //ERHE_VERIFY(point_id != std::numeric_limits<Point_id>::max());
+                //ERHE_VERIFY(point_id < m_next_point_id);
+                Point&          point           = j.geometry.points[point_id];
+                Point_corner_id point_corner_id = point.first_point_corner_id + point.corner_count++;
+                //ERHE_VERIFY(point_corner_id < point_corners.size());
+                point_corners[point_corner_id] = j.corner_id;
+            });
         });
-    });
+    }
 
     // Point corners have been added above in some non-specific order.
-    sort_point_corners();
+    sort_point_corners(thread_pool);
 }
 
-void Geometry::sort_point_corners()
+void Geometry::make_point_corners_parallel(erhe::concurrency::Thread_pool& thread_pool)
 {
     ERHE_PROFILE_FUNCTION();
 
-    class Point_corner_info
-    {
-    public:
-        Point_corner_id point_corner_id{0};
-        Corner_id       corner_id      {0};
-        Point_id        prev_point_id  {0};
-        Point_id        next_point_id  {0};
-        bool            used           {false};
-    };
+    // Corners are scattered to their points using atomic cursors, which
+    // leaves corners of each point in nondeterministic order. Each point
+    // corner is tagged with (polygon id, polygon corner index) and corners
+    // of each point are then sorted by that key, which reproduces the
+    // order of the serial polygon traversal.
+    std::vector<std::atomic<uint32_t>> point_cursors(m_next_point_id);
+    std::vector<uint64_t>              point_corner_keys(m_next_point_corner_reserve);
+
+    erhe::concurrency::parallel_for(
+        thread_pool,
+        Polygon_id{0},
+        m_next_polygon_id,
+        [&](const Polygon_id polygon_id) {
+            const Polygon& polygon = polygons[polygon_id];
+            for (uint32_t i = 0; i < polygon.corner_count; ++i) {
+                const Corner_id       corner_id       = polygon_corners[polygon.first_polygon_corner_id + i];
+                const Point_id        point_id        = corners[corner_id].point_id;
+                const uint32_t        slot            = point_cursors[point_id].fetch_add(1, std::memory_order_relaxed);
+                const Point_corner_id point_corner_id = points[point_id].first_point_corner_id + slot;
+                point_corner_keys[point_corner_id] = (static_cast<uint64_t>(polygon_id) << 32u) | i;
+                point_corners    [point_corner_id] = corner_id;
+            }
+        }
+    );
 
-    std::vector<Point_corner_info> point_corner_infos;
-    point_corner_infos.reserve(20);
+    erhe::concurrency::parallel_for(
+        thread_pool,
+        Point_id{0},
+        m_next_point_id,
+        [&](const Point_id point_id) {
+            Point&                point = points[point_id];
+            const Point_corner_id first = point.first_point_corner_id;
+            point.corner_count = point_cursors[point_id].load(std::memory_order_relaxed);
+
+            // Insertion sort; points have few corners
+            for (uint32_t i = 1; i < point.corner_count; ++i) {
+                const uint64_t  key       = point_corner_keys[first + i];
+                const Corner_id corner_id = point_corners    [first + i];
+                uint32_t j = i;
+                for (; (j > 0) && (point_corner_keys[first + j - 1] > key); --j) {
+                    point_corner_keys[first + j] = point_corner_keys[first + j - 1];
+                    point_corners    [first + j] = point_corners    [first + j - 1];
+                }
+                point_corner_keys[first + j] = key;
+                point_corners    [first + j] = corner_id;
+            }
+        }
+    );
+}
 
-    bool failures{false};
+void Geometry::sort_point_corners(erhe::concurrency::Thread_pool* thread_pool)
+{
+    ERHE_PROFILE_FUNCTION();
 
-    for_each_point([&](auto& i) {
-        if (i.point.corner_count < 3) {
-            return;
-        }
-        point_corner_infos.clear();
-        i.point.for_each_corner(*this, [&](auto& j) {
-            const Corner_id          middle_corner_id = j.corner_id; //point_corners[j.point_corner_id];
-            std::optional<Corner_id> next_corner_id   = 0;
-            const Corner&            middle_corner = j.corner; // corners[middle_corner_id];
-            const Polygon_id         polygon_id    = middle_corner.polygon_id;
-            const Polygon&           polygon       = polygons[polygon_id];
-            polygon.for_each_corner_neighborhood_const(*this, [&](auto& k) {
-                if (k.corner_id == middle_corner_id) {
-                    const Corner& prev_corner = corners[k.prev_corner_id];
-                    const Corner& next_corner = corners[k.next_corner_id];
-
-                    point_corner_infos.push_back(
-                        {
-                            .point_corner_id = j.point_corner_id,
-                            .corner_id       = middle_corner_id,
-                            .prev_point_id   = prev_corner.point_id,
-                            .next_point_id   = next_corner.point_id,
-                            .used            = false
-                        }
-                    );
-                    k.break_iteration();
-                }
-            });
-        });
+    bool failures{false};
 
-#if 0
-        log_geometry->info("sort: point_id = {}, corner_count = {}", i.point_id, i.point.corner_count);
-#endif
-        for (uint32_t j = 0, end = static_cast<uint32_t>(point_corner_infos.size()); j < end; ++j) {
-            const uint32_t     next_j = (j + 1) % end;
-            Point_corner_info& head   = point_corner_infos[j];
-            Point_corner_info& next   = point_corner_infos[next_j];
-            bool found{false};
-#if 0
-            log_geometry->info(
-                "    j = {}, next_j = {}, head.point_corner_id = {}, head.prev_point_id = {}, head.next_point_id = {}",
-                j,
-                next_j,
-                head.point_corner_id,
-                head.prev_point_id,
-                head.next_point_id
-            );
-#endif
-            for (uint32_t k = 0; k < end; ++k) {
-                Point_corner_info& node = point_corner_infos[k];
-#if 0
-                log_geometry->info(
-                    "    k = {}, node.point_corner_id = {}, node.next_point_id = {}, prev_point_id = {}, used = {}",
-                    k,
-                    node.point_corner_id,
-                    node.next_point_id,
-                    node.prev_point_id,
-                    node.used
-                );
-#endif
-                if (node.used) {
-                    continue;
-                }
-                if (node.next_point_id == head.prev_point_id) {
-                    found = true;
-                    node.used = true;
-                    if (k != next_j) {
-                        std::swap(next, node);
+    if ((thread_pool != nullptr) && (m_next_point_id >= erhe::concurrency::c_parallel_serial_threshold)) {
+        // Points are independent, each point only writes its own point corners
+        std::atomic<bool> parallel_failures{false};
+        erhe::concurrency::parallel_for_range(
+            *thread_pool,
+            Point_id{0},
+            m_next_point_id,
+            [&](const Point_id begin, const Point_id end) {
+                std::vector<Point_corner_info> point_corner_infos;
+                point_corner_infos.reserve(20);
+                for (Point_id point_id = begin; point_id < end; ++point_id) {
+                    if (!sort_corners_of_point(*this, point_id, point_corner_infos)) {
+                        parallel_failures.store(true, std::memory_order_relaxed);
                     }
-                    break;
                 }
             }
-            if (!found) {
-                log_geometry->warn(
-                    "Could not sort point corners for point_id = {} head.prev_point_id = {}",
-                    i.point_id,
-                    head.prev_point_id
-                );
+        );
+        failures = parallel_failures.load();
+    } else {
+        std::vector<Point_corner_info> point_corner_infos;
+        point_corner_infos.reserve(20);
+        for (Point_id point_id = 0; point_id < m_next_point_id; ++point_id) {
+            if (!sort_corners_of_point(*this, point_id, point_corner_infos)) {
                 failures = true;
             }
-            const Point_corner_id point_corner_id = i.point.first_point_corner_id + j;
-            point_corners[point_corner_id] = head.corner_id;
         }
-    });
+    }
 
     ///// TODO
     if (failures) {
@@ -368,6 +471,98 @@ auto Geometry::make_polygon_corner(
     return corner_id;
 }
 
+// Allocates new Points / Point_ids with consecutive ids
+auto Geometry::make_points(const uint32_t point_count) -> Point_id
+{
+    ERHE_PROFILE_FUNCTION();
+
+    ++m_serial;
+
+    const Point_id first_point_id = m_next_point_id;
+    m_next_point_id += point_count;
+
+    if (m_next_point_id > points.size()) {
+        points.resize(static_cast<size_t>(m_next_point_id) + s_grow);
+    }
+
+    for (Point_id point_id = first_point_id; point_id < m_next_point_id; ++point_id) {
+        points[point_id].corner_count = 0;
+    }
+    return first_point_id;
+}
+
+// Allocates new Polygons, Corners and polygon corners with consecutive ids
+auto Geometry::make_polygons(
+    const uint32_t polygon_count,
+    const uint32_t corner_count
+) -> Polygon_allocation
+{
+    ERHE_PROFILE_FUNCTION();
+
+    ++m_serial;
+
+    const Polygon_allocation allocation{
+        .first_polygon_id        = m_next_polygon_id,
+        .first_corner_id         = m_next_corner_id,
+        .first_polygon_corner_id = m_next_polygon_corner_id
+    };
+    m_next_polygon_id        += polygon_count;
+    m_next_corner_id         += corner_count;
+    m_next_polygon_corner_id += corner_count;
+
+    if (m_next_polygon_id > polygons.size()) {
+        polygons.resize(static_cast<size_t>(m_next_polygon_id) + s_grow);
+    }
+    if (m_next_corner_id > corners.size()) {
+        corners.resize(static_cast<size_t>(m_next_corner_id) + s_grow);
+    }
+    if (m_next_polygon_corner_id > polygon_corners.size()) {
+        polygon_corners.resize(static_cast<size_t>(m_next_polygon_corner_id) + s_grow);
+    }
+    return allocation;
+}
+
+void Geometry::reserve_point_corners(
+    const Corner_id                       corner_begin,
+    const Corner_id                       corner_end,
+    erhe::concurrency::Thread_pool* const thread_pool
+)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    Expects(corner_begin <= corner_end);
+    Expects(corner_end <= m_next_corner_id);
+
+    ++m_serial;
+
+    m_next_point_corner_reserve += corner_end - corner_begin;
+
+    if ((thread_pool == nullptr) || (corner_end - corner_begin < erhe::concurrency::c_parallel_serial_threshold)) {
+        for (Corner_id corner_id = corner_begin; corner_id < corner_end; ++corner_id) {
+            points[corners[corner_id].point_id].reserved_corner_count++;
+        }
+        return;
+    }
+
+    std::vector<std::atomic<uint32_t>> point_corner_counts(m_next_point_id);
+    erhe::concurrency::parallel_for(
+        *thread_pool,
+        corner_begin,
+        corner_end,
+        [&](const Corner_id corner_id) {
+            point_corner_counts[corners[corner_id].point_id].fetch_add(1, std::memory_order_relaxed);
+        }
+    );
+    erhe::concurrency::parallel_for(
+        *thread_pool,
+        Point_id{0},
+        m_next_point_id,
+        [&](const Point_id point_id) {
+            points[point_id].reserved_corner_count += point_corner_counts[point_id].load(std::memory_order_relaxed);
+        }
+    );
+}
+
 auto Geometry::make_point(
     const float x,
     const float y,
@@ -0,0 +1,716 @@
+#include "erhe_geometry/geometry_serialization.hpp"
+#include "erhe_geometry/geometry.hpp"
+#include "erhe_geometry/geometry_log.hpp"
+#include "erhe_hash/hash.hpp"
+#include "erhe_profile/profile.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <string>
+#include <type_traits>
+
+namespace erhe::geometry
+{
+
+namespace {
+
+enum class Section_kind : uint32_t {
+    corners = 0,
+    points,
+    polygons,
+    edges,
+    point_corners,
+    polygon_corners,
+    edge_polygons,
+    point_property_map,
+    corner_property_map,
+    polygon_property_map,
+    edge_property_map,
+    count
+};
+
+enum class Value_kind : uint32_t {
+    none = 0,
+    float_,
+    vec2,
+    vec3,
+    vec4,
+    uint32,
+    uvec4
+};
+
+// Records are plain data without implicit padding. Offsets are relative to
+// the start of the file.
+class File_header
+{
+public:
+    uint32_t magic         {0};
+    uint32_t version       {0};
+    uint32_t geometry_count{0};
+    uint32_t section_count {0};
+    uint64_t file_size     {0};
+    uint64_t checksum      {0}; // hash of file contents following the header
+};
+
+class Geometry_record
+{
+public:
+    uint64_t name_offset           {0};
+    uint32_t name_size             {0};
+    uint32_t first_section         {0};
+    uint32_t section_count         {0};
+    uint32_t next_corner_id        {0};
+    uint32_t next_point_id         {0};
+    uint32_t next_polygon_id       {0};
+    uint32_t next_edge_id          {0};
+    uint32_t next_point_corner     {0}; // Geometry::m_next_point_corner_reserve
+    uint32_t next_polygon_corner_id{0};
+    uint32_t next_edge_polygon_id  {0};
+    uint32_t polygon_corner_polygon{0};
+    uint32_t edge_polygon_edge     {0};
+    uint32_t valid_flags           {0}; // bit per entry in Geometry_serialization::c_serials
+    uint32_t reserved              {0};
+};
+
+class Section_record
+{
+public:
+    uint64_t data_offset       {0};
+    uint64_t data_size         {0};
+    uint64_t present_offset    {0};
+    uint64_t present_size      {0};
+    uint64_t name_offset       {0};
+    uint32_t name_size         {0};
+    uint32_t kind              {0}; // Section_kind
+    uint32_t value_kind        {0}; // Value_kind, property maps only
+    uint32_t element_count     {0};
+    uint32_t transform_mode    {0};
+    uint32_t interpolation_mode{0};
+    uint32_t property_map_id   {0};
+    uint32_t reserved          {0};
+};
+
+static_assert(sizeof(File_header    ) == 32);
+static_assert(sizeof(Geometry_record) == 64);
+static_assert(sizeof(Section_record ) == 72);
+static_assert(std::is_trivially_copyable_v<Corner >);
+static_assert(std::is_trivially_copyable_v<Point  >);
+static_assert(std::is_trivially_copyable_v<Polygon>);
+static_assert(std::is_trivially_copyable_v<Edge   >);
+
+template <typename T> constexpr Value_kind c_value_kind                = Value_kind::none;
+template <>           constexpr Value_kind c_value_kind<float>         = Value_kind::float_;
+template <>           constexpr Value_kind c_value_kind<glm::vec2>     = Value_kind::vec2;
+template <>           constexpr Value_kind c_value_kind<glm::vec3>     = Value_kind::vec3;
+template <>           constexpr Value_kind c_value_kind<glm::vec4>     = Value_kind::vec4;
+template <>           constexpr Value_kind c_value_kind<uint32_t>      = Value_kind::uint32;
+template <>           constexpr Value_kind c_value_kind<glm::uvec4>    = Value_kind::uvec4;
+
+// Calls callback(Property_map<Key_type, Value_type>&) with the concrete type
+// of the property map. Returns false for unsupported value types.
+template <typename Key_type, typename Callback>
+auto visit_property_map(Property_map_base<Key_type>* base, Callback&& callback) -> bool
+{
+    if (auto* p = dynamic_cast<Property_map<Key_type, float     >*>(base)) { callback(*p); return true; }
+    if (auto* p = dynamic_cast<Property_map<Key_type, glm::vec2 >*>(base)) { callback(*p); return true; }
+    if (auto* p = dynamic_cast<Property_map<Key_type, glm::vec3 >*>(base)) { callback(*p); return true; }
+    if (auto* p = dynamic_cast<Property_map<Key_type, glm::vec4 >*>(base)) { callback(*p); return true; }
+    if (auto* p = dynamic_cast<Property_map<Key_type, uint32_t  >*>(base)) { callback(*p); return true; }
+    if (auto* p = dynamic_cast<Property_map<Key_type, glm::uvec4>*>(base)) { callback(*p); return true; }
+    return false;
+}
+
+// Calls callback(Value_type{}) for the given value kind.
+template <typename Callback>
+auto visit_value_kind(const Value_kind value_kind, Callback&& callback) -> bool
+{
+    switch (value_kind) {
+        case Value_kind::float_: callback(float     {}); return true;
+        case Value_kind::vec2:   callback(glm::vec2 {}); return true;
+        case Value_kind::vec3:   callback(glm::vec3 {}); return true;
+        case Value_kind::vec4:   callback(glm::vec4 {}); return true;
+        case Value_kind::uint32: callback(uint32_t  {}); return true;
+        case Value_kind::uvec4:  callback(glm::uvec4{}); return true;
+        default: return false;
+    }
+}
+
+// Property_map_descriptor::name is not owned by the descriptor. Names of
+// user defined property maps read from files are kept here for the
+// lifetime of the process.
+auto intern_property_map_name(const std::string& name) -> const char*
+{
+    static std::mutex            s_mutex;
+    static std::set<std::string> s_names;
+    const std::lock_guard<std::mutex> lock{s_mutex};
+    return s_names.insert(name).first->c_str();
+}
+
+// FNV-1a over 64-bit words of the contents following the file header, with
+// remaining bytes hashed one at a time. Word steps keep this fast enough to
+// run on every cache load.
+[[nodiscard]] auto get_checksum(const std::span<const std::byte> data) -> uint64_t
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const std::span<const std::byte> contents   = data.subspan(sizeof(File_header));
+    const std::size_t                word_count = contents.size_bytes() / sizeof(uint64_t);
+    uint64_t checksum = erhe::hash::c_seed;
+    for (std::size_t i = 0; i < word_count; ++i) {
+        uint64_t word;
+        std::memcpy(&word, contents.data() + i * sizeof(uint64_t), sizeof(uint64_t));
+        checksum = (checksum ^ word) * erhe::hash::c_prime;
+    }
+    const std::size_t tail_offset = word_count * sizeof(uint64_t);
+    return erhe::hash::hash(contents.data() + tail_offset, contents.size_bytes() - tail_offset, checksum);
+}
+
+[[nodiscard]] auto align_up(const std::size_t offset) -> std::size_t
+{
+    return (offset + c_geometry_file_alignment - 1) & ~(c_geometry_file_alignment - 1);
+}
+
+class Payload_writer
+{
+public:
+    auto append(const void* data, const std::size_t byte_count) -> uint64_t
+    {
+        const std::size_t offset = align_up(m_bytes.size());
+        m_bytes.resize(offset + byte_count);
+        if (byte_count > 0) {
+            std::memcpy(m_bytes.data() + offset, data, byte_count);
+        }
+        return offset;
+    }
+
+    template <typename T>
+    auto append(const std::span<const T> values) -> uint64_t
+    {
+        return append(values.data(), values.size_bytes());
+    }
+
+    [[nodiscard]] auto bytes() const -> const std::vector<std::byte>&
+    {
+        return m_bytes;
+    }
+
+private:
+    std::vector<std::byte> m_bytes;
+};
+
+} // anonymous namespace
+
+class Geometry_serialization
+{
+public:
+    // Derived data serials. Each is stored as a single valid bit.
+    static constexpr std::array<uint64_t Geometry::*, 15> c_serials{
+        &Geometry::m_serial_edges,
+        &Geometry::m_serial_polygon_normals,
+        &Geometry::m_serial_polygon_centroids,
+        &Geometry::m_serial_polygon_tangents,
+        &Geometry::m_serial_polygon_bitangents,
+        &Geometry::m_serial_polygon_texture_coordinates,
+        &Geometry::m_serial_point_normals,
+        &Geometry::m_serial_point_tangents,
+        &Geometry::m_serial_point_bitangents,
+        &Geometry::m_serial_point_texture_coordinates,
+        &Geometry::m_serial_smooth_point_normals,
+        &Geometry::m_serial_corner_normals,
+        &Geometry::m_serial_corner_tangents,
+        &Geometry::m_serial_corner_bitangents,
+        &Geometry::m_serial_corner_texture_coordinates
+    };
+
+    static void write(
+        const Geometry&              geometry,
+        Geometry_record&             record,
+        std::vector<Section_record>& sections,
+        Payload_writer&              payload
+    );
+
+    [[nodiscard]] static auto read(
+        const std::span<const std::byte>      data,
+        const Geometry_record&                record,
+        const std::span<const Section_record> sections,
+        Geometry&                             geometry
+    ) -> bool;
+
+private:
+    [[nodiscard]] static auto is_valid(const Geometry& geometry, uint64_t Geometry::* serial) -> bool;
+
+    template <typename Key_type>
+    static void write_property_maps(
+        const Property_map_collection<Key_type>& collection,
+        Section_kind                             kind,
+        std::vector<Section_record>&             sections,
+        Payload_writer&                          payload
+    );
+
+    template <typename Key_type>
+    [[nodiscard]] static auto read_property_map(
+        const std::span<const std::byte> data,
+        const Section_record&            section,
+        Property_map_collection<Key_type>& collection
+    ) -> bool;
+};
+
+auto Geometry_serialization::is_valid(const Geometry& geometry, uint64_t Geometry::* const serial) -> bool
+{
+    if (geometry.*serial != geometry.m_serial) {
+        return false;
+    }
+
+    // Data with pending dirty polygons is out of date; it will be
+    // recomputed after load.
+    using Dirty_consumer = Geometry::Dirty_consumer;
+    if ((serial == &Geometry::m_serial_polygon_normals) && geometry.is_dirty_pending(Dirty_consumer::polygon_normals)) {
+        return false;
+    }
+    if ((serial == &Geometry::m_serial_polygon_centroids) && geometry.is_dirty_pending(Dirty_consumer::polygon_centroids)) {
+        return false;
+    }
+    if (
+        ((serial == &Geometry::m_serial_point_normals) || (serial == &Geometry::m_serial_corner_normals)) &&
+        geometry.is_dirty_pending(Dirty_consumer::point_normals)
+    ) {
+        return false;
+    }
+    if (
+        (
+            (serial == &Geometry::m_serial_polygon_tangents  ) ||
+            (serial == &Geometry::m_serial_polygon_bitangents) ||
+            (serial == &Geometry::m_serial_point_tangents    ) ||
+            (serial == &Geometry::m_serial_point_bitangents  ) ||
+            (serial == &Geometry::m_serial_corner_tangents   ) ||
+            (serial == &Geometry::m_serial_corner_bitangents )
+        ) &&
+        geometry.is_dirty_pending(Dirty_consumer::tangents)
+    ) {
+        return false;
+    }
+    return true;
+}
+
+template <typename Key_type>
+void Geometry_serialization::write_property_maps(
+    const Property_map_collection<Key_type>& collection,
+    const Section_kind                       kind,
+    std::vector<Section_record>&             sections,
+    Payload_writer&                          payload
+)
+{
+    collection.for_each(
+        [&](Property_map_base<Key_type>* base) {
+            const Property_map_descriptor descriptor = base->descriptor();
+            const bool supported = visit_property_map(
+                base,
+                [&](const auto& property_map) {
+                    using Value_type = typename std::decay_t<decltype(property_map.values)>::value_type;
+                    const std::span<const Value_type> values       {property_map.values.data(), property_map.values.size()};
+                    const std::span<const uint64_t>   present_words{property_map.get_present_words()};
+                    const std::size_t                 name_size    {std::strlen(descriptor.name)};
+                    Section_record section{
+                        .data_offset        = payload.append(values),
+                        .data_size          = values.size_bytes(),
+                        .present_offset     = payload.append(present_words),
+                        .present_size       = present_words.size_bytes(),
+                        .name_offset        = payload.append(descriptor.name, name_size),
+                        .name_size          = static_cast<uint32_t>(name_size),
+                        .kind               = static_cast<uint32_t>(kind),
+                        .value_kind         = static_cast<uint32_t>(c_value_kind<Value_type>),
+                        .element_count      = static_cast<uint32_t>(values.size()),
+                        .transform_mode     = static_cast<uint32_t>(descriptor.transform_mode),
+                        .interpolation_mode = static_cast<uint32_t>(descriptor.interpolation_mode),
+                        .property_map_id    = descriptor.id
+                    };
+                    sections.push_back(section);
+                }
+            );
+            if (!supported) {
+                log_serialization->warn("Property map {} has unsupported value type, not serialized", descriptor.name);
+            }
+        }
+    );
+}
+
+void Geometry_serialization::write(
+    const Geometry&              geometry,
+    Geometry_record&             record,
+    std::vector<Section_record>& sections,
+    Payload_writer&              payload
+)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    record.name_offset            = payload.append(geometry.name.data(), geometry.name.size());
+    record.name_size              = static_cast<uint32_t>(geometry.name.size());
+    record.first_section          = static_cast<uint32_t>(sections.size());
+    record.next_corner_id         = geometry.m_next_corner_id;
+    record.next_point_id          = geometry.m_next_point_id;
+    record.next_polygon_id        = geometry.m_next_polygon_id;
+    record.next_edge_id           = geometry.m_next_edge_id;
+    record.next_point_corner      = geometry.m_next_point_corner_reserve;
+    record.next_polygon_corner_id = geometry.m_next_polygon_corner_id;
+    record.next_edge_polygon_id   = geometry.m_next_edge_polygon_id;
+    record.polygon_corner_polygon = geometry.m_polygon_corner_polygon;
+    record.edge_polygon_edge      = geometry.m_edge_polygon_edge;
+    record.valid_flags            = 0;
+    for (std::size_t i = 0; i < c_serials.size(); ++i) {
+        if (is_valid(geometry, c_serials[i])) {
+            record.valid_flags |= (1u << i);
+        }
+    }
+
+    // Topology arrays grow in steps; unused tail is not stored
+    const auto add_topology = [&](const Section_kind kind, const auto& vector, const uint32_t next_id) {
+        const std::size_t count = std::min(vector.size(), static_cast<std::size_t>(next_id));
+        const std::size_t size  = count * sizeof(vector[0]);
+        sections.push_back(
+            Section_record{
+                .data_offset   = payload.append(vector.data(), size),
+                .data_size     = size,
+                .kind          = static_cast<uint32_t>(kind),
+                .element_count = static_cast<uint32_t>(count)
+            }
+        );
+    };
+    add_topology(Section_kind::corners,         geometry.corners,         record.next_corner_id);
+    add_topology(Section_kind::points,          geometry.points,          record.next_point_id);
+    add_topology(Section_kind::polygons,        geometry.polygons,        record.next_polygon_id);
+    add_topology(Section_kind::edges,           geometry.edges,           record.next_edge_id);
+    add_topology(Section_kind::point_corners,   geometry.point_corners,   record.next_point_corner);
+    add_topology(Section_kind::polygon_corners, geometry.polygon_corners, record.next_polygon_corner_id);
+    add_topology(Section_kind::edge_polygons,   geometry.edge_polygons,   record.next_edge_polygon_id);
+
+    write_property_maps(geometry.m_point_property_map_collection,   Section_kind::point_property_map,   sections, payload);
+    write_property_maps(geometry.m_corner_property_map_collection,  Section_kind::corner_property_map,  sections, payload);
+    write_property_maps(geometry.m_polygon_property_map_collection, Section_kind::polygon_property_map, sections, payload);
+    write_property_maps(geometry.m_edge_property_map_collection,    Section_kind::edge_property_map,    sections, payload);
+
+    record.section_count = static_cast<uint32_t>(sections.size()) - record.first_section;
+}
+
+namespace {
+
+[[nodiscard]] auto is_in_range(
+    const std::span<const std::byte> data,
+    const uint64_t                   offset,
+    const uint64_t                   size
+) -> bool
+{
+    return (offset <= data.size()) && (size <= data.size() - offset);
+}
+
+// Payloads are aligned in the file. When the file data is aligned too (for
+// example page aligned memory mapping), values are used in place.
+template <typename T>
+[[nodiscard]] auto get_section_values(
+    const std::span<const std::byte> data,
+    const uint64_t                   offset,
+    const uint64_t                   size
+) -> std::optional<std::span<const T>>
+{
+    if (!is_in_range(data, offset, size) || ((size % sizeof(T)) != 0)) {
+        return {};
+    }
+    const std::byte* const begin = data.data() + offset;
+    if ((reinterpret_cast<std::uintptr_t>(begin) % alignof(T)) != 0) {
+        return {};
+    }
+    return std::span<const T>{reinterpret_cast<const T*>(begin), static_cast<std::size_t>(size / sizeof(T))};
+}
+
+template <typename T>
+[[nodiscard]] auto read_topology(
+    const std::span<const std::byte> data,
+    const Section_record&            section,
+    std::vector<T>&                  destination
+) -> bool
+{
+    const std::optional<std::span<const T>> values = get_section_values<T>(data, section.data_offset, section.data_size);
+    if (!values.has_value() || (values->size() != section.element_count)) {
+        return false;
+    }
+    destination.assign(values->begin(), values->end());
+    return true;
+}
+
+} // anonymous namespace
+
+template <typename Key_type>
+auto Geometry_serialization::read_property_map(
+    const std::span<const std::byte>   data,
+    const Section_record&              section,
+    Property_map_collection<Key_type>& collection
+) -> bool
+{
+    if (!is_in_range(data, section.name_offset, section.name_size)) {
+        return false;
+    }
+    const std::string name{reinterpret_cast<const char*>(data.data() + section.name_offset), section.name_size};
+
+    // Built-in property maps use the built-in descriptor, so that slot lookup works
+    Property_map_descriptor descriptor{
+        .name               = nullptr,
+        .transform_mode     = static_cast<Transform_mode>(section.transform_mode),
+        .interpolation_mode = static_cast<Interpolation_mode>(section.interpolation_mode),
+        .id                 = c_property_map_id_user
+    };
+    if (
+        (section.property_map_id < c_builtin_property_maps.size()) &&
+        (name == c_builtin_property_maps[section.property_map_id]->name)
+    ) {
+        descriptor = *c_builtin_property_maps[section.property_map_id];
+    } else {
+        descriptor.name = intern_property_map_name(name);
+    }
+
+    bool ok = false;
+    const bool known_value_kind = visit_value_kind(
+        static_cast<Value_kind>(section.value_kind),
+        [&](const auto value) {
+            using Value_type = std::remove_cv_t<decltype(value)>;
+            const auto values        = get_section_values<Value_type>(data, section.data_offset,    section.data_size);
+            const auto present_words = get_section_values<uint64_t  >(data, section.present_offset, section.present_size);
+            if (
+                !values.has_value() ||
+                !present_words.has_value() ||
+                (values->size() != section.element_count) ||
+                (present_words->size() != (values->size() + c_property_map_key_alignment - 1) / c_property_map_key_alignment)
+            ) {
+                return;
+            }
+            Property_map<Key_type, Value_type>* property_map = collection.template create<Value_type>(descriptor);
+            property_map->assign_raw(values.value(), present_words.value());
+            ok = true;
+        }
+    );
+    return known_value_kind && ok;
+}
+
+auto Geometry_serialization::read(
+    const std::span<const std::byte>      data,
+    const Geometry_record&                record,
+    const std::span<const Section_record> sections,
+    Geometry&                             geometry
+) -> bool
+{
+    ERHE_PROFILE_FUNCTION();
+
+    if (!is_in_range(data, record.name_offset, record.name_size)) {
+        return false;
+    }
+    geometry.name.assign(reinterpret_cast<const char*>(data.data() + record.name_offset), record.name_size);
+
+    for (const Section_record& section : sections) {
+        bool ok = false;
+        switch (static_cast<Section_kind>(section.kind)) {
+            case Section_kind::corners:              ok = read_topology(data, section, geometry.corners        ); break;
+            case Section_kind::points:               ok = read_topology(data, section, geometry.points         ); break;
+            case Section_kind::polygons:             ok = read_topology(data, section, geometry.polygons       ); break;
+            case Section_kind::edges:                ok = read_topology(data, section, geometry.edges          ); break;
+            case Section_kind::point_corners:        ok = read_topology(data, section, geometry.point_corners  ); break;
+            case Section_kind::polygon_corners:      ok = read_topology(data, section, geometry.polygon_corners); break;
+            case Section_kind::edge_polygons:        ok = read_topology(data, section, geometry.edge_polygons  ); break;
+            case Section_kind::point_property_map:   ok = read_property_map(data, section, geometry.m_point_property_map_collection  ); break;
+            case Section_kind::corner_property_map:  ok = read_property_map(data, section, geometry.m_corner_property_map_collection ); break;
+            case Section_kind::polygon_property_map: ok = read_property_map(data, section, geometry.m_polygon_property_map_collection); break;
+            case Section_kind::edge_property_map:    ok = read_property_map(data, section, geometry.m_edge_property_map_collection   ); break;
+            default: break;
+        }
+        if (!ok) {
+            log_serialization->warn("Geometry {}: invalid section (kind = {})", geometry.name, section.kind);
+            return false;
+        }
+    }
+
+    geometry.m_next_corner_id            = record.next_corner_id;
+    geometry.m_next_point_id             = record.next_point_id;
+    geometry.m_next_polygon_id           = record.next_polygon_id;
+    geometry.m_next_edge_id              = record.next_edge_id;
+    geometry.m_next_point_corner_reserve = record.next_point_corner;
+    geometry.m_next_polygon_corner_id    = record.next_polygon_corner_id;
+    geometry.m_next_edge_polygon_id      = record.next_edge_polygon_id;
+    geometry.m_polygon_corner_polygon    = record.polygon_corner_polygon;
+    geometry.m_edge_polygon_edge         = record.edge_polygon_edge;
+
+    // Ids stored in topology arrays must be in range
+    const std::size_t corner_count         = geometry.corners        .size();
+    const std::size_t point_count          = geometry.points         .size();
+    const std::size_t polygon_count        = geometry.polygons       .size();
+    const std::size_t point_corner_count   = geometry.point_corners  .size();
+    const std::size_t polygon_corner_count = geometry.polygon_corners.size();
+    const std::size_t edge_polygon_count   = geometry.edge_polygons  .size();
+    if (
+        (corner_count  != record.next_corner_id ) ||
+        (point_count   != record.next_point_id  ) ||
+        (polygon_count != record.next_polygon_id) ||
+        (geometry.edges.size() != record.next_edge_id)
+    ) {
+        return false;
+    }
+    for (const Corner& corner : geometry.corners) {
+        if ((corner.point_id >= point_count) || (corner.polygon_id >= polygon_count)) {
+            return false;
+        }
+    }
+    for (const Corner_id corner_id : geometry.point_corners) {
+        if (corner_id >= corner_count) {
+            return false;
+        }
+    }
+    for (const Corner_id corner_id : geometry.polygon_corners) {
+        if (corner_id >= corner_count) {
+            return false;
+        }
+    }
+    for (const Polygon_id polygon_id : geometry.edge_polygons) {
+        if (polygon_id >= polygon_count) {
+            return false;
+        }
+    }
+    for (const Point& point : geometry.points) {
+        if (std::size_t{point.first_point_corner_id} + point.corner_count > point_corner_count) {
+            return false;
+        }
+    }
+    for (const Polygon& polygon : geometry.polygons) {
+        if (std::size_t{polygon.first_polygon_corner_id} + polygon.corner_count > polygon_corner_count) {
+            return false;
+        }
+    }
+    for (const Edge& edge : geometry.edges) {
+        if (
+            (edge.a >= point_count) ||
+            (edge.b >= point_count) ||
+            (std::size_t{edge.first_edge_polygon_id} + edge.polygon_count > edge_polygon_count)
+        ) {
+            return false;
+        }
+    }
+
+    geometry.m_edge_index.clear();
+    geometry.m_edge_index.reserve(record.next_edge_id);
+    for (Edge_id edge_id = 0; edge_id < record.next_edge_id; ++edge_id) {
+        geometry.m_edge_index.insert(geometry.edges[edge_id].a, geometry.edges[edge_id].b, edge_id);
+    }
+
+    geometry.m_serial = 1;
+    for (std::size_t i = 0; i < c_serials.size(); ++i) {
+        geometry.*c_serials[i] = ((record.valid_flags & (1u << i)) != 0) ? geometry.m_serial : 0;
+    }
+    return true;
+}
+
+auto serialize_geometries(const std::span<const Geometry* const> geometries) -> std::vector<std::byte>
+{
+    ERHE_PROFILE_FUNCTION();
+
+    std::vector<Geometry_record> records{geometries.size()};
+    std::vector<Section_record>  sections;
+    Payload_writer               payload;
+    for (std::size_t i = 0, end = geometries.size(); i < end; ++i) {
+        ERHE_VERIFY(geometries[i] != nullptr);
+        Geometry_serialization::write(*geometries[i], records[i], sections, payload);
+    }
+
+    const std::size_t records_offset  = sizeof(File_header);
+    const std::size_t sections_offset = records_offset + records.size() * sizeof(Geometry_record);
+    const std::size_t payload_offset  = align_up(sections_offset + sections.size() * sizeof(Section_record));
+    const std::size_t file_size       = payload_offset + payload.bytes().size();
+
+    for (Geometry_record& record : records) {
+        record.name_offset += payload_offset;
+    }
+    for (Section_record& section : sections) {
+        section.data_offset    += payload_offset;
+        section.present_offset += payload_offset;
+        section.name_offset    += payload_offset;
+    }
+
+    std::vector<std::byte> result(file_size);
+    if (!records.empty()) {
+        std::memcpy(result.data() + records_offset, records.data(), records.size() * sizeof(Geometry_record));
+    }
+    if (!sections.empty()) {
+        std::memcpy(result.data() + sections_offset, sections.data(), sections.size() * sizeof(Section_record));
+    }
+    if (!payload.bytes().empty()) {
+        std::memcpy(result.data() + payload_offset, payload.bytes().data(), payload.bytes().size());
+    }
+
+    const File_header header{
+        .magic          = c_geometry_file_magic,
+        .version        = c_geometry_file_version,
+        .geometry_count = static_cast<uint32_t>(records.size()),
+        .section_count  = static_cast<uint32_t>(sections.size()),
+        .file_size      = file_size,
+        .checksum       = get_checksum(result)
+    };
+    std::memcpy(result.data(), &header, sizeof(header));
+    return result;
+}
+
+auto deserialize_geometries(const std::span<const std::byte> data) -> std::optional<std::vector<Geometry>>
+{
+    ERHE_PROFILE_FUNCTION();
+
+    if (data.size() < sizeof(File_header)) {
+        return {};
+    }
+    File_header header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != c_geometry_file_magic) {
+        log_serialization->warn("Not a geometry file (magic = {:08x})", header.magic);
+        return {};
+    }
+    if (header.version != c_geometry_file_version) {
+        log_serialization->info("Geometry file version {} does not match current version {}", header.version, c_geometry_file_version);
+        return {};
+    }
+    if (header.file_size != data.size()) {
+        log_serialization->warn("Geometry file size {} does not match data size {}", header.file_size, data.size());
+        return {};
+    }
+    if (header.checksum != get_checksum(data)) {
+        log_serialization->warn("Geometry file checksum does not match");
+        return {};
+    }
+
+    const std::size_t records_offset  = sizeof(File_header);
+    const std::size_t sections_offset = records_offset + std::size_t{header.geometry_count} * sizeof(Geometry_record);
+    const auto records  = get_section_values<Geometry_record>(data, records_offset,  sections_offset - records_offset);
+    const auto sections = get_section_values<Section_record >(data, sections_offset, std::size_t{header.section_count} * sizeof(Section_record));
+    if (!records.has_value() || !sections.has_value()) {
+        return {};
+    }
+
+    std::vector<Geometry> result;
+    result.reserve(header.geometry_count);
+    for (const Geometry_record& record : records.value()) {
+        if (uint64_t{record.first_section} + record.section_count > sections->size()) {
+            return {};
+        }
+        Geometry& geometry = result.emplace_back();
+        const bool ok = Geometry_serialization::read(
+            data,
+            record,
+            sections->subspan(record.first_section, record.section_count),
+            geometry
+        );
+        if (!ok) {
+            log_serialization->warn("Invalid geometry in geometry file");
+            return {};
+        }
+    }
+    return result;
+}
+
+} // namespace erhe::geometry
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace erhe::geometry
+{
+
+class Geometry;
+
+// Versioned binary file format for one or more geometries.
+//
+// Layout:
+// - File header: magic, version, geometry and section counts, file size,
+//   checksum of everything following the header
+// - Geometry records: name, element counts, which derived data is valid
+// - Section records: one per topology array and per property map
+// - Section payloads, each starting at a multiple of c_geometry_file_alignment
+//
+// Section payloads are the in-memory representation (native endianness),
+// so loading a memory mapped file is a single bulk copy per section.
+// Property maps are stored with their descriptor, value type, values and
+// presence bits. Supported value types are float, vec2, vec3, vec4,
+// uint32_t and uvec4; property maps with other value types are skipped.
+//
+// c_geometry_file_version must be incremented whenever the layout of the
+// records, or of Corner, Point, Polygon or Edge changes.
+
+inline constexpr uint32_t    c_geometry_file_magic     = 0x4f454745; // "EGEO"
+inline constexpr uint32_t    c_geometry_file_version   = 2;
+inline constexpr std::size_t c_geometry_file_alignment = 64;
+
+[[nodiscard]] auto serialize_geometries(std::span<const Geometry* const> geometries) -> std::vector<std::byte>;
+
+// Returns empty optional if data is not a valid geometry file of the current
+// version, or if the checksum does not match
+[[nodiscard]] auto deserialize_geometries(std::span<const std::byte> data) -> std::optional<std::vector<Geometry>>;
+
+} // namespace erhe::geometry
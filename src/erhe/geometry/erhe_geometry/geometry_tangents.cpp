@@ -1,5 +1,6 @@
 // #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
 
+#include "erhe_concurrency/parallel_for.hpp"
 #include "erhe_geometry/geometry.hpp"
 #include "erhe_geometry/geometry_log.hpp"
 #include "erhe_log/log_glm.hpp"
@@ -9,6 +10,11 @@
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <span>
+
 namespace erhe::geometry
 {
 
@@ -17,37 +23,100 @@ using glm::vec2;
 using glm::vec3;
 using glm::vec4;
 
+namespace {
+
+// Polygons per tangent generation chunk when a thread pool is used
+constexpr uint32_t c_tangent_chunk_polygon_count = 4096;
+
+[[nodiscard]] auto spread_bits_3(uint32_t x) -> uint32_t
+{
+    x &= 0x3ffu;
+    x = (x | (x << 16)) & 0x030000ffu;
+    x = (x | (x <<  8)) & 0x0300f00fu;
+    x = (x | (x <<  4)) & 0x030c30c3u;
+    x = (x | (x <<  2)) & 0x09249249u;
+    return x;
+}
+
+// Returns polygon ids ordered by 30-bit Morton code of polygon centroid,
+// so that consecutive polygons are spatially close
+[[nodiscard]] auto sort_polygons_spatially(
+    const Geometry&                       geometry,
+    const Property_map<Polygon_id, vec3>& polygon_centroids
+) -> std::vector<Polygon_id>
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const Polygon_id polygon_count = geometry.get_polygon_count();
+    vec3 min_corner{std::numeric_limits<float>::max()};
+    vec3 max_corner{std::numeric_limits<float>::lowest()};
+    for (Polygon_id polygon_id = 0; polygon_id < polygon_count; ++polygon_id) {
+        if (polygon_centroids.has(polygon_id)) {
+            const vec3 centroid = polygon_centroids.get(polygon_id);
+            min_corner = glm::min(min_corner, centroid);
+            max_corner = glm::max(max_corner, centroid);
+        }
+    }
+    const vec3 extent = glm::max(max_corner - min_corner, vec3{std::numeric_limits<float>::min()});
+    const vec3 scale  = vec3{1023.0f} / extent;
+
+    std::vector<uint64_t> keys(polygon_count);
+    for (Polygon_id polygon_id = 0; polygon_id < polygon_count; ++polygon_id) {
+        uint32_t code = 0;
+        if (polygon_centroids.has(polygon_id)) {
+            const vec3 q = (polygon_centroids.get(polygon_id) - min_corner) * scale;
+            code =
+                (spread_bits_3(static_cast<uint32_t>(q.x))     ) |
+                (spread_bits_3(static_cast<uint32_t>(q.y)) << 1) |
+                (spread_bits_3(static_cast<uint32_t>(q.z)) << 2);
+        }
+        keys[polygon_id] = (static_cast<uint64_t>(code) << 32) | polygon_id;
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<Polygon_id> result(polygon_count);
+    for (Polygon_id i = 0; i < polygon_count; ++i) {
+        result[i] = static_cast<Polygon_id>(keys[i] & 0xffffffffu);
+    }
+    return result;
+}
+
+} // anonymous namespace
+
 auto Geometry::has_polygon_tangents() const -> bool
 {
-    return m_serial_polygon_tangents == m_serial;
+    return (m_serial_polygon_tangents == m_serial) && !is_dirty_pending(Dirty_consumer::tangents);
 }
 
 auto Geometry::has_polygon_bitangents() const -> bool
 {
-    return m_serial_polygon_bitangents == m_serial;
+    return (m_serial_polygon_bitangents == m_serial) && !is_dirty_pending(Dirty_consumer::tangents);
 }
 
 auto Geometry::has_corner_tangents() const -> bool
 {
-    return m_serial_corner_tangents == m_serial;
+    return (m_serial_corner_tangents == m_serial) && !is_dirty_pending(Dirty_consumer::tangents);
 }
 
 auto Geometry::has_corner_bitangents() const -> bool
 {
-    return m_serial_corner_bitangents == m_serial;
+    return (m_serial_corner_bitangents == m_serial) && !is_dirty_pending(Dirty_consumer::tangents);
 }
 
 auto Geometry::compute_tangents(
-    const bool corner_tangents,
-    const bool corner_bitangents,
-    const bool polygon_tangents,
-    const bool polygon_bitangents,
-    const bool make_polygons_flat,
-    const bool override_existing
+    const Tangent_options&                options,
+    erhe::concurrency::Thread_pool* const thread_pool
 ) -> bool
 {
     ERHE_PROFILE_FUNCTION();
 
+    const bool corner_tangents    = options.corner_tangents;
+    const bool corner_bitangents  = options.corner_bitangents;
+    const bool polygon_tangents   = options.polygon_tangents;
+    const bool polygon_bitangents = options.polygon_bitangents;
+    const bool make_polygons_flat = options.make_polygons_flat;
+    const bool override_existing  = options.override_existing;
+
     if (
         (!polygon_tangents   || has_polygon_tangents  ()) &&
         (!polygon_bitangents || has_polygon_bitangents()) &&
@@ -72,6 +141,37 @@ auto Geometry::compute_tangents(
     //    return false;
     //}
 
+    // Incremental update: when all requested outputs were complete before
+    // polygons were marked dirty, only dirty polygons and their one-ring are
+    // written. MikkTSpace is given one more ring around them, so that
+    // vertices on the border of the written region see the same neighbors
+    // as in a full pass.
+    std::vector<Polygon_id> written_polygons;
+    std::vector<Polygon_id> context_polygons;
+    if (is_dirty_pending(Dirty_consumer::tangents)) {
+        // Outputs not requested now would be left out of date in the dirty region
+        if (!polygon_tangents  ) { m_serial_polygon_tangents   = 0; }
+        if (!polygon_bitangents) { m_serial_polygon_bitangents = 0; }
+        if (!corner_tangents   ) { m_serial_corner_tangents    = 0; }
+        if (!corner_bitangents ) { m_serial_corner_bitangents  = 0; }
+        const std::vector<Polygon_id> dirty_polygons = take_dirty_polygons(Dirty_consumer::tangents);
+        written_polygons = get_one_ring_polygons(dirty_polygons);
+    }
+    const bool incremental =
+        !written_polygons.empty() &&
+        (!polygon_tangents   || (m_serial_polygon_tangents   == m_serial)) &&
+        (!polygon_bitangents || (m_serial_polygon_bitangents == m_serial)) &&
+        (!corner_tangents    || (m_serial_corner_tangents    == m_serial)) &&
+        (!corner_bitangents  || (m_serial_corner_bitangents  == m_serial));
+    if (incremental) {
+        context_polygons = get_one_ring_polygons(written_polygons);
+    } else {
+        context_polygons.resize(m_next_polygon_id);
+        for (Polygon_id polygon_id = 0; polygon_id < m_next_polygon_id; ++polygon_id) {
+            context_polygons[polygon_id] = polygon_id;
+        }
+    }
+
     class Geometry_context
     {
     public:
@@ -79,6 +179,56 @@ auto Geometry::compute_tangents(
         int       triangle_count   {0};
         bool      override_existing{false};
 
+        // When set, only polygons with rank in [write_begin, write_end) are written
+        const std::vector<uint32_t>* polygon_ranks{nullptr};
+        uint32_t                     write_begin  {0};
+        uint32_t                     write_end    {0};
+
+        [[nodiscard]] auto is_written(const Polygon_id polygon_id) const -> bool
+        {
+            if (polygon_ranks == nullptr) {
+                return true;
+            }
+            const uint32_t rank = (*polygon_ranks)[polygon_id];
+            return (rank >= write_begin) && (rank < write_end);
+        }
+
+        // When set, results are appended here instead of put to property
+        // maps. Used by concurrent chunks; applied later in chunk order.
+        class Output
+        {
+        public:
+            enum class Kind : uint32_t {
+                polygon_tangent = 0,
+                polygon_bitangent,
+                corner_tangent,
+                corner_bitangent
+            };
+            Kind     kind;
+            uint32_t id;
+            vec4     value;
+        };
+        std::vector<Output>* outputs{nullptr};
+
+        void apply(const Output& output)
+        {
+            switch (output.kind) {
+                case Output::Kind::polygon_tangent:   put_first(polygon_tangents,   output.id, output.value); break;
+                case Output::Kind::polygon_bitangent: put_first(polygon_bitangents, output.id, output.value); break;
+                case Output::Kind::corner_tangent:    put_first(corner_tangents,    output.id, output.value); break;
+                case Output::Kind::corner_bitangent:  put_first(corner_bitangents,  output.id, output.value); break;
+                default: break;
+            }
+        }
+
+        // Polygon_id and Corner_id are both uint32_t
+        void put_first(Property_map<uint32_t, vec4>* map, const uint32_t key, const vec4 value)
+        {
+            if (override_existing || !map->has(key)) {
+                map->put(key, value);
+            }
+        }
+
         Property_map<Polygon_id, vec3>* polygon_normals     {nullptr};
         Property_map<Polygon_id, vec3>* polygon_centroids   {nullptr};
         Property_map<Polygon_id, vec4>* polygon_tangents    {nullptr};
@@ -277,6 +427,14 @@ auto Geometry::compute_tangents(
             }
             const Polygon_id polygon_id = get_polygon_id(iFace);
             const Corner_id  corner_id  = get_corner_id(iFace, iVert);
+            if (!is_written(polygon_id)) {
+                return;
+            }
+            if (outputs != nullptr) {
+                if (polygon_tangents) { outputs->push_back({Output::Kind::polygon_tangent, polygon_id, vec4{tangent, sign}}); }
+                if (corner_tangents ) { outputs->push_back({Output::Kind::corner_tangent,  corner_id,  vec4{tangent, sign}}); }
+                return;
+            }
 
             if (polygon_tangents && (override_existing || !polygon_tangents->has(polygon_id))) {
                 SPDLOG_LOGGER_TRACE(log_tangent_gen, "put polygon_id {}, tangent = {}, sign = {}", polygon_id, tangent, sign);
@@ -301,6 +459,14 @@ auto Geometry::compute_tangents(
             }
             const Polygon_id polygon_id = get_polygon_id(iFace);
             const Corner_id  corner_id  = get_corner_id(iFace, iVert);
+            if (!is_written(polygon_id)) {
+                return;
+            }
+            if (outputs != nullptr) {
+                if (polygon_bitangents) { outputs->push_back({Output::Kind::polygon_bitangent, polygon_id, vec4{bitangent, sign}}); }
+                if (corner_bitangents ) { outputs->push_back({Output::Kind::corner_bitangent,  corner_id,  vec4{bitangent, sign}}); }
+                return;
+            }
 
             if (polygon_bitangents && (override_existing || !polygon_bitangents->has(polygon_id))) {
                 SPDLOG_LOGGER_TRACE(log_tangent_gen, "put polygon_id {}, bitangent = {}, sign = {}", polygon_id, bitangent, sign);
@@ -336,22 +502,46 @@ auto Geometry::compute_tangents(
         return false;
     }
 
+    // Previous values of dirty polygons are out of date. They are removed,
+    // so that first write wins for shared corners just like in a full pass.
+    std::vector<uint32_t> polygon_ranks;
+    if (!written_polygons.empty()) {
+        for (const Polygon_id polygon_id : written_polygons) {
+            if (g.polygon_tangents   != nullptr) { g.polygon_tangents  ->erase(polygon_id); }
+            if (g.polygon_bitangents != nullptr) { g.polygon_bitangents->erase(polygon_id); }
+            const Polygon& polygon = polygons[polygon_id];
+            for (uint32_t i = 0; i < polygon.corner_count; ++i) {
+                const Corner_id corner_id = polygon_corners[polygon.first_polygon_corner_id + i];
+                if (g.corner_tangents   != nullptr) { g.corner_tangents  ->erase(corner_id); }
+                if (g.corner_bitangents != nullptr) { g.corner_bitangents->erase(corner_id); }
+            }
+        }
+    }
+    if (incremental) {
+        polygon_ranks.resize(m_next_polygon_id, ~uint32_t{0});
+        for (const Polygon_id polygon_id : written_polygons) {
+            polygon_ranks[polygon_id] = 0;
+        }
+        g.polygon_ranks = &polygon_ranks;
+        g.write_begin   = 0;
+        g.write_end     = 1;
+    }
+
     // MikkTSpace can only handle triangles or quads.
     // We triangulate all non-triangles by adding a virtual polygon centroid
     // and presenting N virtual triangles to MikkTSpace.
-    int               face_index     = 0;
-    const std::size_t triangle_count = count_polygon_triangles();
-    g.triangle_count = static_cast<int>(triangle_count);
-    g.triangles.resize(triangle_count);
-    for (Polygon_id polygon_id = 0; polygon_id < m_next_polygon_id; ++polygon_id) {
-        const Polygon& polygon = polygons[polygon_id];
-        if (polygon.corner_count < 3) {
-            continue;
-        }
-        for (uint32_t i = 0; i < polygon.corner_count - 2; ++i) {
-            g.triangles[face_index++] = {polygon_id, i};
+    const auto add_triangles = [this](Geometry_context& context, const std::span<const Polygon_id> polygon_ids) {
+        for (const Polygon_id polygon_id : polygon_ids) {
+            const Polygon& polygon = polygons[polygon_id];
+            if (polygon.corner_count < 3) {
+                continue;
+            }
+            for (uint32_t i = 0; i < polygon.corner_count - 2; ++i) {
+                context.triangles.push_back({polygon_id, i});
+            }
         }
-    }
+        context.triangle_count = static_cast<int>(context.triangles.size());
+    };
 
     SMikkTSpaceInterface mikktspace{
         .m_getNumFaces = [](const SMikkTSpaceContext* pContext)
@@ -465,13 +655,20 @@ auto Geometry::compute_tangents(
         }
     };
 
-    SMikkTSpaceContext context
-    {
-        .m_pInterface = &mikktspace,
-        .m_pUserData  = &g
-    };
+    const bool parallel =
+        !incremental &&
+        (thread_pool != nullptr) &&
+        (thread_pool->size() > 0) &&
+        (m_next_polygon_id >= c_tangent_chunk_polygon_count * 2);
+    if (!parallel) {
+        add_triangles(g, context_polygons);
+
+        SMikkTSpaceContext context
+        {
+            .m_pInterface = &mikktspace,
+            .m_pUserData  = &g
+        };
 
-    {
         ERHE_PROFILE_SCOPE("genTangSpaceDefault");
 
         const auto res = genTangSpaceDefault(&context);
@@ -479,13 +676,74 @@ auto Geometry::compute_tangents(
             log_tangent_gen->trace("genTangSpaceDefault() returned 0");
             return false;
         }
+    } else {
+        ERHE_PROFILE_SCOPE("genTangSpaceDefault chunks");
+
+        // Chunks are ranges of polygons in Morton order of their centroids.
+        // Each chunk writes only its own polygons, but MikkTSpace also sees
+        // the one-ring around the chunk. Every polygon sharing a point with
+        // a written polygon is then included, and vertices on chunk borders
+        // get the same result as in a single pass.
+        const std::vector<Polygon_id> order = sort_polygons_spatially(*this, *g.polygon_centroids);
+        polygon_ranks.resize(m_next_polygon_id);
+        for (uint32_t rank = 0, end = static_cast<uint32_t>(order.size()); rank < end; ++rank) {
+            polygon_ranks[order[rank]] = rank;
+        }
+        const std::size_t chunk_count = (order.size() + c_tangent_chunk_polygon_count - 1) / c_tangent_chunk_polygon_count;
+        std::vector<std::vector<Geometry_context::Output>> chunk_outputs(chunk_count);
+        std::atomic<bool> ok{true};
+
+        erhe::concurrency::parallel_for_range(
+            *thread_pool,
+            uint32_t{0},
+            static_cast<uint32_t>(order.size()),
+            [&](const uint32_t rank_begin, const uint32_t rank_end) {
+                Geometry_context chunk = g;
+                chunk.polygon_ranks = &polygon_ranks;
+                chunk.write_begin   = rank_begin;
+                chunk.write_end     = rank_end;
+                chunk.outputs       = &chunk_outputs[rank_begin / c_tangent_chunk_polygon_count];
+                if ((rank_begin == 0) && (rank_end == order.size())) {
+                    add_triangles(chunk, context_polygons);
+                } else {
+                    const std::span<const Polygon_id> chunk_polygons{order.data() + rank_begin, rank_end - rank_begin};
+                    add_triangles(chunk, get_one_ring_polygons(chunk_polygons));
+                }
+
+                SMikkTSpaceContext context
+                {
+                    .m_pInterface = &mikktspace,
+                    .m_pUserData  = &chunk
+                };
+                if (genTangSpaceDefault(&context) == 0) {
+                    ok.store(false, std::memory_order_relaxed);
+                }
+            },
+            c_tangent_chunk_polygon_count
+        );
+        if (!ok.load()) {
+            log_tangent_gen->trace("genTangSpaceDefault() returned 0");
+            return false;
+        }
+
+        // Stitch: apply chunk results in chunk order. Each polygon and its
+        // corners are written by exactly one chunk, in the same order as in
+        // a single pass, so first write wins gives the same result.
+        for (const std::vector<Geometry_context::Output>& outputs : chunk_outputs) {
+            for (const Geometry_context::Output& output : outputs) {
+                g.apply(output);
+            }
+        }
     }
 
     // Post processing: Pick one tangent for polygon
     if (make_polygons_flat) {
         ERHE_PROFILE_SCOPE("make polygons flat");
 
-        for (Polygon_id polygon_id = 0; polygon_id < m_next_polygon_id; ++polygon_id) {
+        for (const Polygon_id polygon_id : context_polygons) {
+            if (!g.is_written(polygon_id)) {
+                continue;
+            }
             Polygon& polygon = polygons[polygon_id];
             if (polygon.corner_count < 3) {
                 continue;
@@ -615,6 +873,9 @@ auto Geometry::compute_tangents(
     if (corner_bitangents) {
         m_serial_corner_bitangents = m_serial;
     }
+    if (!incremental) {
+        mark_dirty_consumed(Dirty_consumer::tangents);
+    }
     return true;
 }
 
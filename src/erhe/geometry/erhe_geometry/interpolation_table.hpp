@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace erhe::geometry
+{
+
+// Weighted sources for new keys, used to interpolate property maps.
+//
+// Sources are appended in any order with add(). finalize() sorts them by
+// new key into compressed sparse row form: offsets[new_key] .. offsets[new_key + 1]
+// index into packed weights and old keys. Sources of each new key keep the
+// order in which they were added.
+template <typename Key_type>
+class Interpolation_table
+{
+public:
+    void clear()
+    {
+        m_pending .clear();
+        m_offsets .clear();
+        m_weights .clear();
+        m_old_keys.clear();
+        m_finalized = false;
+    }
+
+    void reserve(const std::size_t source_count)
+    {
+        m_pending.reserve(source_count);
+    }
+
+    void add(const Key_type new_key, const float weight, const Key_type old_key)
+    {
+        m_pending.push_back(Source{new_key, old_key, weight});
+        m_finalized = false;
+    }
+
+    // Appends sources from other after sources already added
+    void append(const Interpolation_table& other)
+    {
+        if (other.m_pending.empty()) {
+            return;
+        }
+        m_pending.insert(m_pending.end(), other.m_pending.begin(), other.m_pending.end());
+        m_finalized = false;
+    }
+
+    // Builds CSR for new keys [0, key_count). Sources for new keys
+    // at or past key_count are ignored.
+    void finalize(const std::size_t key_count)
+    {
+        m_offsets.assign(key_count + 1, 0);
+        for (const Source& source : m_pending) {
+            if (source.new_key < key_count) {
+                ++m_offsets[static_cast<std::size_t>(source.new_key) + 1];
+            }
+        }
+        for (std::size_t i = 0; i < key_count; ++i) {
+            m_offsets[i + 1] += m_offsets[i];
+        }
+
+        const std::size_t entry_count = m_offsets[key_count];
+        m_weights .resize(entry_count);
+        m_old_keys.resize(entry_count);
+
+        std::vector<uint32_t> cursors{m_offsets.begin(), m_offsets.end() - 1};
+        for (const Source& source : m_pending) {
+            if (source.new_key < key_count) {
+                const uint32_t slot = cursors[source.new_key]++;
+                m_weights [slot] = source.weight;
+                m_old_keys[slot] = source.old_key;
+            }
+        }
+        m_finalized = true;
+    }
+
+    [[nodiscard]] auto is_finalized() const -> bool
+    {
+        return m_finalized;
+    }
+
+    [[nodiscard]] auto key_count() const -> std::size_t
+    {
+        assert(m_finalized);
+        return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+    }
+
+    [[nodiscard]] auto get_offsets() const -> std::span<const uint32_t>
+    {
+        assert(m_finalized);
+        return m_offsets;
+    }
+
+    [[nodiscard]] auto get_weights() const -> std::span<const float>
+    {
+        assert(m_finalized);
+        return m_weights;
+    }
+
+    [[nodiscard]] auto get_old_keys() const -> std::span<const Key_type>
+    {
+        assert(m_finalized);
+        return m_old_keys;
+    }
+
+    [[nodiscard]] auto get_weights(const Key_type new_key) const -> std::span<const float>
+    {
+        assert(m_finalized);
+        return std::span<const float>{m_weights}.subspan(
+            m_offsets[new_key],
+            m_offsets[new_key + 1] - m_offsets[new_key]
+        );
+    }
+
+    [[nodiscard]] auto get_old_keys(const Key_type new_key) const -> std::span<const Key_type>
+    {
+        assert(m_finalized);
+        return std::span<const Key_type>{m_old_keys}.subspan(
+            m_offsets[new_key],
+            m_offsets[new_key + 1] - m_offsets[new_key]
+        );
+    }
+
+private:
+    class Source
+    {
+    public:
+        Key_type new_key;
+        Key_type old_key;
+        float    weight;
+    };
+
+    std::vector<Source>   m_pending;
+    std::vector<uint32_t> m_offsets;
+    std::vector<float>    m_weights;
+    std::vector<Key_type> m_old_keys;
+    bool                  m_finalized{false};
+};
+
+} // namespace erhe::geometry
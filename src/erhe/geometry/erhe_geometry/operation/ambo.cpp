@@ -8,8 +8,12 @@
 namespace erhe::geometry::operation
 {
 
-Ambo::Ambo(Geometry& source, Geometry& destination)
-    : Geometry_operation{source, destination}
+Ambo::Ambo(
+    Geometry&                             source,
+    Geometry&                             destination,
+    erhe::concurrency::Thread_pool* const thread_pool
+)
+    : Geometry_operation{source, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -19,16 +23,16 @@ Ambo::Ambo(Geometry& source, Geometry& destination)
     // New faces from old points, new face corner for each old point corner edge midpoint
     {
         ERHE_PROFILE_SCOPE("new faces from old points");
-        source.for_each_point_const([&](auto& i) {
-            Polygon_id new_polygon_id = destination.make_polygon();
+        emit(source.get_point_count(), [&](Emitter& emitter, const Point_id point_id) {
+            const Polygon_id new_polygon_id = emitter.make_polygon();
 
-            i.point.for_each_corner_const(source, [&](auto& j) {
+            source.points[point_id].for_each_corner_const(source, [&](auto& j) {
                 const Polygon_id src_polygon_id     = j.corner.polygon_id;
                 const Polygon&   src_polygon        = source.polygons[src_polygon_id];
                 const Corner_id  src_next_corner_id = src_polygon.next_corner(source, j.corner_id);
                 const Corner&    src_next_corner    = source.corners[src_next_corner_id];
                 const Point_id   edge_midpoint      = get_edge_new_point(j.corner.point_id, src_next_corner.point_id);
-                make_new_corner_from_point(new_polygon_id, edge_midpoint);
+                emitter.make_corner_from_point(new_polygon_id, edge_midpoint);
             });
         });
     }
@@ -36,11 +40,11 @@ Ambo::Ambo(Geometry& source, Geometry& destination)
     // New faces from old faces, new face corner for each old corner edge midpoint
     {
         ERHE_PROFILE_SCOPE("new faces from old faces");
-        source.for_each_polygon_const([&](auto& i) {
-            const Polygon_id new_polygon_id = destination.make_polygon();
-            i.polygon.for_each_corner_neighborhood_const(source, [&](auto& j) {
+        emit(source.get_polygon_count(), [&](Emitter& emitter, const Polygon_id polygon_id) {
+            const Polygon_id new_polygon_id = emitter.make_polygon();
+            source.polygons[polygon_id].for_each_corner_neighborhood_const(source, [&](auto& j) {
                 const Point_id edge_midpoint = get_edge_new_point(j.corner.point_id, j.next_corner.point_id);
-                make_new_corner_from_point(new_polygon_id, edge_midpoint);
+                emitter.make_corner_from_point(new_polygon_id, edge_midpoint);
             });
         });
     }
@@ -48,12 +52,12 @@ Ambo::Ambo(Geometry& source, Geometry& destination)
     post_processing();
 }
 
-auto ambo(Geometry& source) -> Geometry
+auto ambo(Geometry& source, erhe::concurrency::Thread_pool* const thread_pool) -> Geometry
 {
     return Geometry{
         fmt::format("ambo({})", source.name),
-        [&source](auto& result) {
-            Ambo operation{source, result};
+        [&source, thread_pool](auto& result) {
+            Ambo operation{source, result, thread_pool};
         }
     };
 }
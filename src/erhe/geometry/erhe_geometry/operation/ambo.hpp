@@ -10,11 +10,16 @@ class Ambo
     : public Geometry_operation
 {
 public:
-    Ambo(Geometry& source, Geometry& destination);
+    Ambo(
+        Geometry&                       source,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
 };
 
 [[nodiscard]] auto ambo(
-    erhe::geometry::Geometry& source
+    erhe::geometry::Geometry&       source,
+    erhe::concurrency::Thread_pool* thread_pool = nullptr
 ) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
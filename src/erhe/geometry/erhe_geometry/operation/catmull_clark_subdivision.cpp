@@ -23,10 +23,11 @@ namespace erhe::geometry::operation
 // For each corner in the old polygon, add one quad
 // (centroid, previous edge 'edge midpoint', corner, next edge 'edge midpoint')
 Catmull_clark_subdivision::Catmull_clark_subdivision(
-    Geometry& src,
-    Geometry& destination
+    Geometry&                             src,
+    Geometry&                             destination,
+    erhe::concurrency::Thread_pool* const thread_pool
 )
-    : Geometry_operation{src, destination}
+    : Geometry_operation{src, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -36,16 +37,17 @@ Catmull_clark_subdivision::Catmull_clark_subdivision(
     {
         ERHE_PROFILE_SCOPE("initial points");
 
-        source.for_each_point_const([&](auto& i) {
-            const auto n = static_cast<float>(i.point.corner_count);
-            if (i.point.corner_count >= 3) {
+        emit(source.get_point_count(), [&](Emitter& emitter, const Point_id point_id) {
+            const Point& point = source.points[point_id];
+            const auto   n     = static_cast<float>(point.corner_count);
+            if (point.corner_count >= 3) {
                 // n = 0   -> centroid points, safe to skip
                 // n = 1,2 -> ?
                 // n = 3   -> ?
                 const float weight = (n - 3.0f) / n;
-                make_new_point_from_point(weight, i.point_id);
+                emitter.make_point_from_point(weight, point_id);
             } else {
-                make_new_point_from_point(1.0f, i.point_id);
+                emitter.make_point_from_point(1.0f, point_id);
             }
         });
     }
@@ -91,24 +93,24 @@ Catmull_clark_subdivision::Catmull_clark_subdivision(
     {
         ERHE_PROFILE_SCOPE("face points");
 
-        source.for_each_polygon_const([&](auto& i) {
-            const Polygon& src_polygon = source.polygons[i.polygon_id];
+        emit(source.get_polygon_count(), [&](Emitter& emitter, const Polygon_id polygon_id) {
+            const Polygon& src_polygon = source.polygons[polygon_id];
 
-            make_new_point_from_polygon_centroid(i.polygon_id);
+            emitter.make_point_from_polygon_centroid(polygon_id);
 
             // Add polygon centroids (F) to all corners' point sources
             // F = average F of all n face points for faces touching P
             //  F    <- because F is average of all centroids, it adds extra /n
             // ---
             //  n
-            i.polygon.for_each_corner_const(source, [&](auto& j)
+            src_polygon.for_each_corner_const(source, [&](auto& j)
             {
                 const Point_id src_point_id = j.corner.point_id;
                 const Point&   src_point    = source.points[src_point_id];
                 const Point_id new_point_id = point_old_to_new[src_point_id];
                 const auto point_weight  = 1.0f / static_cast<float>(src_point.corner_count);
                 const auto corner_weight = 1.0f / static_cast<float>(src_polygon.corner_count);
-                add_polygon_centroid(new_point_id, point_weight * point_weight * corner_weight, i.polygon_id);
+                emitter.add_polygon_centroid(new_point_id, point_weight * point_weight * corner_weight, polygon_id);
             });
         });
     }
@@ -117,15 +119,15 @@ Catmull_clark_subdivision::Catmull_clark_subdivision(
     {
         ERHE_PROFILE_SCOPE("subdivide");
 
-        source.for_each_polygon_const([&](auto& i) {
-            i.polygon.for_each_corner_neighborhood_const(source, [&](auto& j) {
+        emit(source.get_polygon_count(), [&](Emitter& emitter, const Polygon_id polygon_id) {
+            source.polygons[polygon_id].for_each_corner_neighborhood_const(source, [&](auto& j) {
                 const Point_id   previous_edge_midpoint = get_edge_new_point(j.prev_corner.point_id, j.corner.point_id);
                 const Point_id   next_edge_midpoint     = get_edge_new_point(j.corner.point_id,      j.next_corner.point_id);
-                const Polygon_id new_polygon_id         = make_new_polygon_from_polygon(i.polygon_id);
-                make_new_corner_from_polygon_centroid(new_polygon_id, i.polygon_id);
-                make_new_corner_from_point           (new_polygon_id, previous_edge_midpoint);
-                make_new_corner_from_corner          (new_polygon_id, j.corner_id);
-                make_new_corner_from_point           (new_polygon_id, next_edge_midpoint);
+                const Polygon_id new_polygon_id         = emitter.make_polygon_from_polygon(polygon_id);
+                emitter.make_corner_from_polygon_centroid(new_polygon_id, polygon_id);
+                emitter.make_corner_from_point           (new_polygon_id, previous_edge_midpoint);
+                emitter.make_corner_from_corner          (new_polygon_id, j.corner_id);
+                emitter.make_corner_from_point           (new_polygon_id, next_edge_midpoint);
             });
         });
     }
@@ -135,12 +137,12 @@ Catmull_clark_subdivision::Catmull_clark_subdivision(
     log_catmull_clark->trace("Done");
 }
 
-auto catmull_clark_subdivision(Geometry& source) -> Geometry
+auto catmull_clark_subdivision(Geometry& source, erhe::concurrency::Thread_pool* const thread_pool) -> Geometry
 {
     return Geometry{
         fmt::format("catmull_clark({})", source.name),
-        [&source](auto& result) {
-            Catmull_clark_subdivision operation{source, result};
+        [&source, thread_pool](auto& result) {
+            Catmull_clark_subdivision operation{source, result, thread_pool};
         }
     };
 }
@@ -28,6 +28,7 @@ Clone::Clone(
     destination.m_next_point_corner_reserve          = source.m_next_point_corner_reserve;
     destination.m_next_polygon_corner_id             = source.m_next_polygon_corner_id;
     destination.m_next_edge_polygon_id               = source.m_next_edge_polygon_id;
+    destination.m_edge_index                         = source.m_edge_index;
     destination.m_polygon_corner_polygon             = source.m_polygon_corner_polygon;
     destination.m_edge_polygon_edge                  = source.m_edge_polygon_edge;
 
@@ -47,6 +48,8 @@ Clone::Clone(
     destination.m_serial_corner_tangents             = source.m_serial_corner_tangents            ;
     destination.m_serial_corner_bitangents           = source.m_serial_corner_bitangents          ;
     destination.m_serial_corner_texture_coordinates  = source.m_serial_corner_texture_coordinates ;
+    destination.m_dirty_polygons                     = source.m_dirty_polygons                    ;
+    destination.m_dirty_cursors                      = source.m_dirty_cursors                     ;
 
     destination.m_point_property_map_collection   = source.m_point_property_map_collection  .clone_with_transform(transform);
     destination.m_corner_property_map_collection  = source.m_corner_property_map_collection .clone_with_transform(transform);
@@ -8,19 +8,24 @@
 namespace erhe::geometry::operation
 {
 
-Dual::Dual(Geometry& source, Geometry& destination, bool post_process)
-    : Geometry_operation{source, destination}
+Dual::Dual(
+    Geometry&                             source,
+    Geometry&                             destination,
+    const bool                            post_process,
+    erhe::concurrency::Thread_pool* const thread_pool
+)
+    : Geometry_operation{source, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
     make_polygon_centroids();
 
     // New faces from old points, new face corner for each old point corner
-    source.for_each_point_const([&](auto& i) {
-        const Polygon_id new_polygon_id = destination.make_polygon();
+    emit(source.get_point_count(), [&](Emitter& emitter, const Point_id point_id) {
+        const Polygon_id new_polygon_id = emitter.make_polygon();
 
-        i.point.for_each_corner_const(source, [&](auto& j) {
-            make_new_corner_from_polygon_centroid(new_polygon_id, j.corner.polygon_id);
+        source.points[point_id].for_each_corner_const(source, [&](auto& j) {
+            emitter.make_corner_from_polygon_centroid(new_polygon_id, j.corner.polygon_id);
         });
     });
 
@@ -29,12 +34,12 @@ Dual::Dual(Geometry& source, Geometry& destination, bool post_process)
     }
 }
 
-auto dual(Geometry& source) -> Geometry
+auto dual(Geometry& source, erhe::concurrency::Thread_pool* const thread_pool) -> Geometry
 {
     return Geometry{
         fmt::format("dual({})", source.name),
-        [&source](auto& result) {
-            Dual operation{source, result};
+        [&source, thread_pool](auto& result) {
+            Dual operation{source, result, true, thread_pool};
         }
     };
 }
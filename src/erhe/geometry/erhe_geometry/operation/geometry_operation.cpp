@@ -1,4 +1,5 @@
 #include "erhe_geometry/operation/geometry_operation.hpp"
+#include "erhe_concurrency/parallel_for.hpp"
 #include "erhe_geometry/geometry.hpp"
 #include "erhe_geometry/geometry_log.hpp"
 #include "erhe_profile/profile.hpp"
@@ -6,20 +7,59 @@
 
 #include <gsl/assert>
 
+#include <algorithm>
+
 namespace erhe::geometry::operation
 {
 
+namespace {
+
+// Interpolates each property map with disjoint key ranges processed in
+// parallel. Each key is computed exactly as in the serial path.
+template <typename Key_type>
+void interpolate_property_maps(
+    erhe::concurrency::Thread_pool&      thread_pool,
+    Property_map_collection<Key_type>&   source,
+    Property_map_collection<Key_type>&   destination,
+    const Interpolation_table<Key_type>& key_new_to_olds
+)
+{
+    const std::size_t key_count    = key_new_to_olds.key_count();
+    const std::size_t worker_count = static_cast<std::size_t>(thread_pool.size()) + 1;
+    const std::size_t chunk_size   = key_count / (worker_count * erhe::concurrency::c_parallel_chunks_per_worker);
+    const std::size_t grain_size   = std::max(
+        c_property_map_key_alignment,
+        (chunk_size + c_property_map_key_alignment - 1) / c_property_map_key_alignment * c_property_map_key_alignment
+    );
+
+    for (const auto& [source_map, destination_map] : source.make_interpolation_targets(destination)) {
+        source_map->begin_interpolate(destination_map, key_count);
+        erhe::concurrency::parallel_for_range(
+            thread_pool,
+            std::size_t{0},
+            key_count,
+            [&](const std::size_t key_begin, const std::size_t key_end) {
+                source_map->interpolate_range(destination_map, key_new_to_olds, key_begin, key_end);
+            },
+            grain_size
+        );
+        source_map->end_interpolate(destination_map);
+    }
+}
+
+} // anonymous namespace
+
 void Geometry_operation::post_processing()
 {
     ERHE_PROFILE_FUNCTION();
 
-    destination.make_point_corners();
-    destination.build_edges();
+    destination.make_point_corners(thread_pool);
+    destination.build_edges(true, thread_pool);
     interpolate_all_property_maps();
-    destination.compute_point_normals(c_point_normals_smooth);
-    destination.compute_polygon_centroids();
+    destination.compute_point_normals(c_point_normals_smooth, thread_pool);
+    destination.compute_polygon_centroids(thread_pool);
     destination.generate_polygon_texture_coordinates();
-    destination.compute_tangents();
+    destination.compute_tangents({}, thread_pool);
 }
 
 void Geometry_operation::make_points_from_points()
@@ -27,8 +67,8 @@ void Geometry_operation::make_points_from_points()
     ERHE_PROFILE_FUNCTION();
 
     point_old_to_new.reserve(source.get_point_count());
-    source.for_each_point_const([&](auto& i) {
-        make_new_point_from_point(i.point_id);
+    emit(source.get_point_count(), [](Emitter& emitter, const Point_id point_id) {
+        emitter.make_point_from_point(1.0f, point_id);
     });
 }
 
@@ -37,11 +77,117 @@ void Geometry_operation::make_polygon_centroids()
     ERHE_PROFILE_FUNCTION();
 
     old_polygon_centroid_to_new_points.reserve(source.get_polygon_count());
-    source.for_each_polygon_const([&](auto& i) {
-        make_new_point_from_polygon_centroid(i.polygon_id);
+    emit(source.get_polygon_count(), [](Emitter& emitter, const Polygon_id polygon_id) {
+        emitter.make_point_from_polygon_centroid(polygon_id);
     });
 }
 
+auto Geometry_operation::use_parallel_emit(const uint32_t source_count) const -> bool
+{
+    return
+        (thread_pool != nullptr) &&
+        (thread_pool->size() > 0) &&
+        (source_count >= erhe::concurrency::c_parallel_serial_threshold);
+}
+
+void Geometry_operation::emit_chunks(
+    const uint32_t                                            source_count,
+    const std::function<void(Emitter&, uint32_t, uint32_t)>& generate_chunk
+)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    // Source elements are processed in contiguous chunks, so that ids
+    // follow source element order as in the serial path.
+    const std::size_t worker_count       = static_cast<std::size_t>(thread_pool->size()) + 1;
+    const std::size_t target_chunk_count = worker_count * erhe::concurrency::c_parallel_chunks_per_worker;
+    const uint32_t    chunk_size         = static_cast<uint32_t>(
+        std::max(erhe::concurrency::c_parallel_min_grain_size, (source_count + target_chunk_count - 1) / target_chunk_count)
+    );
+    const uint32_t    chunk_count        = (source_count + chunk_size - 1) / chunk_size;
+
+    // Counting pass
+    std::vector<Point_id  > chunk_first_point  (static_cast<std::size_t>(chunk_count) + 1, 0);
+    std::vector<Polygon_id> chunk_first_polygon(static_cast<std::size_t>(chunk_count) + 1, 0);
+    std::vector<Corner_id > chunk_first_corner (static_cast<std::size_t>(chunk_count) + 1, 0);
+    erhe::concurrency::parallel_for_each_task(
+        *thread_pool,
+        uint32_t{0},
+        chunk_count,
+        [&](const uint32_t chunk) {
+            Emitter emitter{*this, Emitter::Mode::count};
+            generate_chunk(emitter, chunk * chunk_size, std::min(source_count, (chunk + 1) * chunk_size));
+            chunk_first_point  [chunk + 1] = emitter.m_next_point_id;
+            chunk_first_polygon[chunk + 1] = emitter.m_next_polygon_id;
+            chunk_first_corner [chunk + 1] = emitter.m_next_corner_id;
+        }
+    );
+
+    // Prefix sums; entry for each chunk becomes its first id offset, last entry is the total
+    for (uint32_t chunk = 0; chunk < chunk_count; ++chunk) {
+        chunk_first_point  [chunk + 1] += chunk_first_point  [chunk];
+        chunk_first_polygon[chunk + 1] += chunk_first_polygon[chunk];
+        chunk_first_corner [chunk + 1] += chunk_first_corner [chunk];
+    }
+    const uint32_t point_count   = chunk_first_point  [chunk_count];
+    const uint32_t polygon_count = chunk_first_polygon[chunk_count];
+    const uint32_t corner_count  = chunk_first_corner [chunk_count];
+    ERHE_VERIFY((point_count == 0) || (polygon_count == 0));
+
+    const Point_id           first_point_id = (point_count > 0) ? destination.make_points(point_count) : destination.get_point_count();
+    const Polygon_allocation allocation     = (polygon_count > 0) ? destination.make_polygons(polygon_count, corner_count) : Polygon_allocation{};
+
+    // Old to new maps are written in parallel, by old id
+    if (point_old_to_new.size() < source.get_point_count()) {
+        point_old_to_new.resize(source.get_point_count());
+    }
+    if (polygon_old_to_new.size() < source.get_polygon_count()) {
+        polygon_old_to_new.resize(source.get_polygon_count());
+    }
+    if (old_polygon_centroid_to_new_points.size() < source.get_polygon_count()) {
+        old_polygon_centroid_to_new_points.resize(source.get_polygon_count());
+    }
+    if ((corner_count > 0) && !new_point_corner_sources.is_finalized()) {
+        new_point_corner_sources.finalize(destination.get_point_count());
+    }
+
+    std::vector<Emitter> emitters;
+    emitters.reserve(chunk_count);
+    for (uint32_t chunk = 0; chunk < chunk_count; ++chunk) {
+        Emitter& emitter = emitters.emplace_back(Emitter{*this, Emitter::Mode::write});
+        emitter.m_next_point_id          = first_point_id                     + chunk_first_point  [chunk];
+        emitter.m_next_polygon_id        = allocation.first_polygon_id        + chunk_first_polygon[chunk];
+        emitter.m_next_corner_id         = allocation.first_corner_id         + chunk_first_corner [chunk];
+        emitter.m_next_polygon_corner_id = allocation.first_polygon_corner_id + chunk_first_corner [chunk];
+    }
+
+    // Write pass
+    erhe::concurrency::parallel_for_each_task(
+        *thread_pool,
+        uint32_t{0},
+        chunk_count,
+        [&](const uint32_t chunk) {
+            Emitter& emitter = emitters[chunk];
+            generate_chunk(emitter, chunk * chunk_size, std::min(source_count, (chunk + 1) * chunk_size));
+            ERHE_VERIFY(emitter.m_next_point_id   == first_point_id              + chunk_first_point  [chunk + 1]);
+            ERHE_VERIFY(emitter.m_next_polygon_id == allocation.first_polygon_id + chunk_first_polygon[chunk + 1]);
+            ERHE_VERIFY(emitter.m_next_corner_id  == allocation.first_corner_id  + chunk_first_corner [chunk + 1]);
+        }
+    );
+
+    // Chunks are merged in order, which keeps the source order of each new key
+    for (const Emitter& emitter : emitters) {
+        new_point_sources       .append(emitter.m_point_sources);
+        new_point_corner_sources.append(emitter.m_point_corner_sources);
+        new_corner_sources      .append(emitter.m_corner_sources);
+        new_polygon_sources     .append(emitter.m_polygon_sources);
+    }
+
+    if (corner_count > 0) {
+        destination.reserve_point_corners(allocation.first_corner_id, allocation.first_corner_id + corner_count, thread_pool);
+    }
+}
+
 void Geometry_operation::reserve_edge_to_new_points()
 {
     const uint32_t point_count = source.get_point_count();
@@ -89,6 +235,9 @@ void Geometry_operation::make_edge_midpoints(const std::initializer_list<float>
 {
     ERHE_PROFILE_FUNCTION();
 
+    // Stays serial: new edge points are numbered in the order edges are
+    // first visited from polygon corners, and the edge slot lookup is
+    // shared between corners of neighboring polygons.
     const std::size_t split_count = relative_positions.size();
     reserve_edge_to_new_points();
 
@@ -397,11 +546,7 @@ void Geometry_operation::add_point_source(
     //     new_point_id, weight, old_point_id
     // );
     // const erhe::log::Indenter scope_indent;
-    const std::size_t i = static_cast<std::size_t>(new_point_id);
-    if (new_point_sources.size() <= i) {
-        new_point_sources.resize(i + s_grow_size);
-    }
-    new_point_sources[i].emplace_back(point_weight, old_point_id);
+    new_point_sources.add(new_point_id, point_weight, old_point_id);
 }
 
 void Geometry_operation::add_point_corner_source(
@@ -415,11 +560,7 @@ void Geometry_operation::add_point_corner_source(
     //     new_point_id, weight, old_corner_id
     // );
     // const erhe::log::Indenter scope_indent;
-    const std::size_t i = static_cast<std::size_t>(new_point_id);
-    if (new_point_corner_sources.size() <= i) {
-        new_point_corner_sources.resize(i + s_grow_size);
-    }
-    new_point_corner_sources[new_point_id].emplace_back(corner_weight, old_corner_id);
+    new_point_corner_sources.add(new_point_id, corner_weight, old_corner_id);
 }
 
 void Geometry_operation::add_corner_source(
@@ -433,11 +574,7 @@ void Geometry_operation::add_corner_source(
     //     new_corner_id, weight, old_corner_id
     // );
     // const erhe::log::Indenter scope_indent;
-    const std::size_t i = static_cast<std::size_t>(new_corner_id);
-    if (new_corner_sources.size() <= i) {
-        new_corner_sources.resize(i + s_grow_size);
-    }
-    new_corner_sources[i].emplace_back(corner_weight, old_corner_id);
+    new_corner_sources.add(new_corner_id, corner_weight, old_corner_id);
 }
 
 void Geometry_operation::distribute_corner_sources(
@@ -451,10 +588,16 @@ void Geometry_operation::distribute_corner_sources(
     //     new_corner_id, weight, new_point_id
     // );
     // const erhe::log::Indenter scope_indent;
-    const auto point_corner_sources = new_point_corner_sources[new_point_id];
-    for (const auto& point_corner_source : point_corner_sources) {
-        const float     corner_weight = point_weight * point_corner_source.first;
-        const Corner_id corner_id     = point_corner_source.second;
+    // Point corner sources are complete once corners are being made,
+    // so this is normally finalized only once per operation.
+    if (!new_point_corner_sources.is_finalized()) {
+        new_point_corner_sources.finalize(destination.get_point_count());
+    }
+    const auto weights    = new_point_corner_sources.get_weights (new_point_id);
+    const auto corner_ids = new_point_corner_sources.get_old_keys(new_point_id);
+    for (std::size_t j = 0, end = weights.size(); j < end; ++j) {
+        const float     corner_weight = point_weight * weights[j];
+        const Corner_id corner_id     = corner_ids[j];
         add_corner_source(new_corner_id, corner_weight, corner_id);
     }
 }
@@ -470,11 +613,7 @@ void Geometry_operation::add_polygon_source(
     //     new_polygon_id, weight, old_polygon_id
     // );
     // const erhe::log::Indenter scope_indent;
-    const std::size_t i = static_cast<std::size_t>(new_polygon_id);
-    if (new_polygon_sources.size() <= i) {
-        new_polygon_sources.resize(i + s_grow_size);
-    }
-    new_polygon_sources[i].emplace_back(polygon_weight, old_polygon_id);
+    new_polygon_sources.add(new_polygon_id, polygon_weight, old_polygon_id);
 }
 
 void Geometry_operation::add_edge_source(
@@ -488,11 +627,189 @@ void Geometry_operation::add_edge_source(
     //     new_edge_id, weight, old_edge_id
     // );
     // const erhe::log::Indenter scope_indent;
-    const std::size_t i = static_cast<std::size_t>(new_edge_id);
-    if (new_edge_sources.size() <= i) {
-        new_edge_sources.resize(i + s_grow_size);
+    new_edge_sources.add(new_edge_id, edge_weight, old_edge_id);
+}
+
+Emitter::Emitter(Geometry_operation& operation, const Mode mode)
+    : m_operation{operation}
+    , m_mode     {mode}
+{
+}
+
+auto Emitter::make_point_from_point(const float point_weight, const Point_id old_point) -> Point_id
+{
+    if (m_mode == Mode::serial) {
+        return m_operation.make_new_point_from_point(point_weight, old_point);
     }
-    new_edge_sources[i].emplace_back(edge_weight, old_edge_id);
+    const Point_id new_point = m_next_point_id++;
+    if (m_mode == Mode::write) {
+        m_point_sources.add(new_point, point_weight, old_point);
+        m_operation.point_old_to_new[old_point] = new_point;
+    }
+    return new_point;
+}
+
+auto Emitter::make_point_from_polygon_centroid(const Polygon_id old_polygon) -> Point_id
+{
+    if (m_mode == Mode::serial) {
+        return m_operation.make_new_point_from_polygon_centroid(old_polygon);
+    }
+    const Point_id new_point = m_next_point_id++;
+    if (m_mode == Mode::write) {
+        m_operation.old_polygon_centroid_to_new_points[old_polygon] = new_point;
+        add_polygon_centroid(new_point, 1.0f, old_polygon);
+    }
+    return new_point;
+}
+
+void Emitter::add_point_source(const Point_id new_point, const float point_weight, const Point_id old_point)
+{
+    switch (m_mode) {
+        case Mode::serial: m_operation.add_point_source(new_point, point_weight, old_point); break;
+        case Mode::count:  break;
+        case Mode::write:  m_point_sources.add(new_point, point_weight, old_point); break;
+    }
+}
+
+void Emitter::add_point_ring(const Point_id new_point, const float point_weight, const Point_id old_point)
+{
+    if (m_mode == Mode::serial) {
+        m_operation.add_point_ring(new_point, point_weight, old_point);
+        return;
+    }
+    if (m_mode == Mode::count) {
+        return;
+    }
+    const Geometry& source = m_operation.source;
+    source.points[old_point].for_each_corner_const(source, [&](auto& i) {
+        const Polygon&  ring_polygon        = source.polygons[i.corner.polygon_id];
+        const Corner_id next_ring_corner_id = ring_polygon.next_corner(source, i.corner_id);
+        m_point_sources.add(new_point, point_weight, source.corners[next_ring_corner_id].point_id);
+    });
+}
+
+void Emitter::add_polygon_centroid(const Point_id new_point, const float polygon_weight, const Polygon_id old_polygon)
+{
+    if (m_mode == Mode::serial) {
+        m_operation.add_polygon_centroid(new_point, polygon_weight, old_polygon);
+        return;
+    }
+    if (m_mode == Mode::count) {
+        return;
+    }
+    const Geometry& source = m_operation.source;
+    source.polygons[old_polygon].for_each_corner_const(source, [&](auto& i) {
+        m_point_corner_sources.add(new_point, polygon_weight, i.corner_id);
+        m_point_sources       .add(new_point, polygon_weight, i.corner.point_id);
+    });
+}
+
+auto Emitter::make_polygon() -> Polygon_id
+{
+    if (m_mode == Mode::serial) {
+        return m_operation.destination.make_polygon();
+    }
+    const Polygon_id new_polygon = m_next_polygon_id++;
+    if (m_mode == Mode::write) {
+        Polygon& polygon = m_operation.destination.polygons[new_polygon];
+        polygon.first_polygon_corner_id = m_next_polygon_corner_id;
+        polygon.corner_count            = 0;
+    }
+    return new_polygon;
+}
+
+auto Emitter::make_polygon_from_polygon(const Polygon_id old_polygon) -> Polygon_id
+{
+    if (m_mode == Mode::serial) {
+        return m_operation.make_new_polygon_from_polygon(old_polygon);
+    }
+    const Polygon_id new_polygon = make_polygon();
+    if (m_mode == Mode::write) {
+        m_polygon_sources.add(new_polygon, 1.0f, old_polygon);
+        m_operation.polygon_old_to_new[old_polygon] = new_polygon;
+    }
+    return new_polygon;
+}
+
+auto Emitter::make_corner(const Polygon_id new_polygon, const Point_id new_point) -> Corner_id
+{
+    const Corner_id new_corner = m_next_corner_id++;
+    if (m_mode == Mode::write) {
+        // Like Geometry::make_polygon_corner_(), corners of each polygon must be made consecutively
+        Geometry& destination = m_operation.destination;
+        Polygon&  polygon     = destination.polygons[new_polygon];
+        if (polygon.corner_count == 0) {
+            polygon.first_polygon_corner_id = m_next_polygon_corner_id;
+            m_polygon_id = new_polygon;
+        } else {
+            ERHE_VERIFY(m_polygon_id == new_polygon);
+        }
+        Corner& corner = destination.corners[new_corner];
+        corner.point_id   = new_point;
+        corner.polygon_id = new_polygon;
+        destination.polygon_corners[m_next_polygon_corner_id++] = new_corner;
+        ++polygon.corner_count;
+    }
+    return new_corner;
+}
+
+void Emitter::distribute_corner_sources(const Corner_id new_corner, const Point_id new_point)
+{
+    const auto weights    = m_operation.new_point_corner_sources.get_weights (new_point);
+    const auto corner_ids = m_operation.new_point_corner_sources.get_old_keys(new_point);
+    for (std::size_t j = 0, end = weights.size(); j < end; ++j) {
+        m_corner_sources.add(new_corner, weights[j], corner_ids[j]);
+    }
+}
+
+auto Emitter::make_corner_from_point(const Polygon_id new_polygon, const Point_id new_point) -> Corner_id
+{
+    if (m_mode == Mode::serial) {
+        return m_operation.make_new_corner_from_point(new_polygon, new_point);
+    }
+    const Corner_id new_corner = make_corner(new_polygon, new_point);
+    if (m_mode == Mode::write) {
+        distribute_corner_sources(new_corner, new_point);
+    }
+    return new_corner;
+}
+
+auto Emitter::make_corner_from_corner(const Polygon_id new_polygon, const Corner_id old_corner) -> Corner_id
+{
+    if (m_mode == Mode::serial) {
+        return m_operation.make_new_corner_from_corner(new_polygon, old_corner);
+    }
+    const Point_id  new_point  = m_operation.point_old_to_new[m_operation.source.corners[old_corner].point_id];
+    const Corner_id new_corner = make_corner(new_polygon, new_point);
+    if (m_mode == Mode::write) {
+        m_corner_sources.add(new_corner, 1.0f, old_corner);
+    }
+    return new_corner;
+}
+
+auto Emitter::make_corner_from_polygon_centroid(const Polygon_id new_polygon, const Polygon_id old_polygon) -> Corner_id
+{
+    if (m_mode == Mode::serial) {
+        return m_operation.make_new_corner_from_polygon_centroid(new_polygon, old_polygon);
+    }
+    const Point_id  new_point  = m_operation.old_polygon_centroid_to_new_points[old_polygon];
+    const Corner_id new_corner = make_corner(new_polygon, new_point);
+    if (m_mode == Mode::write) {
+        distribute_corner_sources(new_corner, new_point);
+    }
+    return new_corner;
+}
+
+void Emitter::add_polygon_corners(const Polygon_id new_polygon, const Polygon_id old_polygon)
+{
+    if (m_mode == Mode::serial) {
+        m_operation.add_polygon_corners(new_polygon, old_polygon);
+        return;
+    }
+    const Geometry& source = m_operation.source;
+    source.polygons[old_polygon].for_each_corner_const(source, [&](auto& i) {
+        make_corner_from_corner(new_polygon, i.corner_id);
+    });
 }
 
 void Geometry_operation::build_destination_edges_with_sourcing()
@@ -521,10 +838,18 @@ void Geometry_operation::interpolate_all_property_maps()
 {
     ERHE_PROFILE_FUNCTION();
 
-    new_point_sources  .resize(destination.get_point_count());
-    new_polygon_sources.resize(destination.get_polygon_count());
-    new_corner_sources .resize(destination.get_corner_count());
-    new_edge_sources   .resize(destination.get_edge_count());
+    new_point_sources  .finalize(destination.get_point_count());
+    new_polygon_sources.finalize(destination.get_polygon_count());
+    new_corner_sources .finalize(destination.get_corner_count());
+    new_edge_sources   .finalize(destination.get_edge_count());
+    if (thread_pool != nullptr) {
+        interpolate_property_maps(*thread_pool, source.point_attributes(),   destination.point_attributes(),   new_point_sources);
+        interpolate_property_maps(*thread_pool, source.polygon_attributes(), destination.polygon_attributes(), new_polygon_sources);
+        interpolate_property_maps(*thread_pool, source.corner_attributes(),  destination.corner_attributes(),  new_corner_sources);
+        interpolate_property_maps(*thread_pool, source.edge_attributes(),    destination.edge_attributes(),    new_edge_sources);
+        return;
+    }
+
     source.point_attributes()  .interpolate(destination.point_attributes(),   new_point_sources);
     source.polygon_attributes().interpolate(destination.polygon_attributes(), new_polygon_sources);
     source.corner_attributes() .interpolate(destination.corner_attributes(),  new_corner_sources);
@@ -1,10 +1,17 @@
 #pragma once
 
+#include "erhe_geometry/interpolation_table.hpp"
 #include "erhe_geometry/types.hpp"
 
+#include <functional>
 #include <set>
 #include <vector>
 
+namespace erhe::concurrency
+{
+    class Thread_pool;
+}
+
 namespace erhe::geometry
 {
     class Geometry;
@@ -13,31 +20,89 @@ namespace erhe::geometry
 namespace erhe::geometry::operation
 {
 
+class Geometry_operation;
+
+// Makes new points, polygons and corners for one source element in
+// Geometry_operation::emit(). Serially ids are allocated from destination
+// as elements are made. In parallel emit() the first pass only counts
+// elements, and the second pass assigns ids from ranges computed with a
+// prefix sum of the counts.
+class Emitter
+{
+public:
+    auto make_point_from_point           (float point_weight, Point_id old_point) -> Point_id;
+    auto make_point_from_polygon_centroid(Polygon_id old_polygon) -> Point_id;
+    void add_point_source                (Point_id new_point, float point_weight, Point_id old_point);
+    void add_point_ring                  (Point_id new_point, float point_weight, Point_id old_point);
+    void add_polygon_centroid            (Point_id new_point, float polygon_weight, Polygon_id old_polygon);
+
+    auto make_polygon                    () -> Polygon_id;
+    auto make_polygon_from_polygon       (Polygon_id old_polygon) -> Polygon_id;
+    auto make_corner_from_point          (Polygon_id new_polygon, Point_id new_point) -> Corner_id;
+    auto make_corner_from_corner         (Polygon_id new_polygon, Corner_id old_corner) -> Corner_id;
+    auto make_corner_from_polygon_centroid(Polygon_id new_polygon, Polygon_id old_polygon) -> Corner_id;
+    void add_polygon_corners             (Polygon_id new_polygon, Polygon_id old_polygon);
+
+private:
+    friend class Geometry_operation;
+
+    enum class Mode : unsigned int
+    {
+        serial = 0,
+        count,
+        write
+    };
+
+    Emitter(Geometry_operation& operation, Mode mode);
+
+    auto make_corner              (Polygon_id new_polygon, Point_id new_point) -> Corner_id;
+    void distribute_corner_sources(Corner_id new_corner, Point_id new_point);
+
+    Geometry_operation&             m_operation;
+    Mode                            m_mode;
+    Point_id                        m_next_point_id         {0};
+    Polygon_id                      m_next_polygon_id       {0};
+    Corner_id                       m_next_corner_id        {0};
+    Polygon_corner_id               m_next_polygon_corner_id{0};
+    Polygon_id                      m_polygon_id            {0};
+    Interpolation_table<Point_id  > m_point_sources;
+    Interpolation_table<Corner_id > m_point_corner_sources;
+    Interpolation_table<Corner_id > m_corner_sources;
+    Interpolation_table<Polygon_id> m_polygon_sources;
+};
+
 class Geometry_operation
 {
 public:
+    // When thread_pool is set, emit() makes new points and polygons in
+    // parallel, and post_processing() runs point corners, edges, property
+    // map interpolation and normals in parallel. Results are the same as
+    // without thread pool.
     Geometry_operation(
-        Geometry& source,
-        Geometry& destination
+        Geometry&                       source,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
     )
         : source     {source}
         , destination{destination}
+        , thread_pool{thread_pool}
     {
     }
 
     static constexpr std::size_t s_grow_size = 4096;
-    Geometry&                                              source;
-    Geometry&                                              destination;
-    std::vector<Point_id  >                                point_old_to_new;
-    std::vector<Polygon_id>                                polygon_old_to_new;
-    std::vector<Corner_id >                                corner_old_to_new;
-    std::vector<Edge_id   >                                edge_old_to_new;
-    std::vector<Point_id  >                                old_polygon_centroid_to_new_points;
-    std::vector<std::vector<std::pair<float, Point_id  >>> new_point_sources;
-    std::vector<std::vector<std::pair<float, Corner_id >>> new_point_corner_sources;
-    std::vector<std::vector<std::pair<float, Corner_id >>> new_corner_sources;
-    std::vector<std::vector<std::pair<float, Polygon_id>>> new_polygon_sources;
-    std::vector<std::vector<std::pair<float, Edge_id   >>> new_edge_sources;
+    Geometry&                       source;
+    Geometry&                       destination;
+    erhe::concurrency::Thread_pool* thread_pool;
+    std::vector<Point_id  >         point_old_to_new;
+    std::vector<Polygon_id>         polygon_old_to_new;
+    std::vector<Corner_id >         corner_old_to_new;
+    std::vector<Edge_id   >         edge_old_to_new;
+    std::vector<Point_id  >         old_polygon_centroid_to_new_points;
+    Interpolation_table<Point_id  > new_point_sources;
+    Interpolation_table<Corner_id > new_point_corner_sources;
+    Interpolation_table<Corner_id > new_corner_sources;
+    Interpolation_table<Polygon_id> new_polygon_sources;
+    Interpolation_table<Edge_id   > new_edge_sources;
 
 private:
     static constexpr std::size_t s_max_edge_point_slots = 300;
@@ -162,9 +227,47 @@ public:
         Edge_id old_edge
     );
 
+    // Calls generate(emitter, source_index) for each source_index in
+    // [0, source_count). With thread pool, generate() is called in parallel,
+    // twice for each source element: first to count new elements and then,
+    // after ids have been allocated with a prefix sum of the counts, to make
+    // them. Ids and interpolation sources are the same as when called
+    // serially.
+    // - generate() must make the same elements in both calls.
+    // - A single emit() can make either points or polygons, not both.
+    template <typename Generate>
+    void emit(const uint32_t source_count, Generate&& generate)
+    {
+        if (!use_parallel_emit(source_count)) {
+            Emitter emitter{*this, Emitter::Mode::serial};
+            for (uint32_t source_index = 0; source_index < source_count; ++source_index) {
+                generate(emitter, source_index);
+            }
+            return;
+        }
+        emit_chunks(
+            source_count,
+            [&generate](Emitter& emitter, const uint32_t source_begin, const uint32_t source_end) {
+                for (uint32_t source_index = source_begin; source_index < source_end; ++source_index) {
+                    generate(emitter, source_index);
+                }
+            }
+        );
+    }
+
     void build_destination_edges_with_sourcing();
 
     void interpolate_all_property_maps();
+
+private:
+    [[nodiscard]] auto use_parallel_emit(uint32_t source_count) const -> bool;
+
+    // Parallel part of emit(). Generate is only type erased per chunk of
+    // source elements, each call processes [source_begin, source_end).
+    void emit_chunks(
+        uint32_t                                                  source_count,
+        const std::function<void(Emitter&, uint32_t, uint32_t)>& generate_chunk
+    );
 };
 
 } // namespace namespace geometry
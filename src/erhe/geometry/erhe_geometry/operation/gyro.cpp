@@ -11,8 +11,12 @@
 namespace erhe::geometry::operation
 {
 
-Gyro::Gyro(Geometry& src, Geometry& destination)
-    : Geometry_operation{src, destination}
+Gyro::Gyro(
+    Geometry&                             src,
+    Geometry&                             destination,
+    erhe::concurrency::Thread_pool* const thread_pool
+)
+    : Geometry_operation{src, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -31,12 +35,12 @@ Gyro::Gyro(Geometry& src, Geometry& destination)
         }
     );
 
-    source.for_each_polygon_const([&](auto& i) {
-        i.polygon.for_each_corner_neighborhood_const(source, [&](auto& j) {
+    emit(source.get_polygon_count(), [&](Emitter& emitter, const Polygon_id polygon_id) {
+        source.polygons[polygon_id].for_each_corner_neighborhood_const(source, [&](auto& j) {
             const Point_id   a                        = j.prev_corner.point_id;
             const Point_id   b                        = j.corner     .point_id;
             const Point_id   c                        = j.next_corner.point_id;
-            const Polygon_id new_polygon_id           = make_new_polygon_from_polygon(i.polygon_id);
+            const Polygon_id new_polygon_id           = emitter.make_polygon_from_polygon(polygon_id);
             const Point_id   previous_edge_midpoint_0 = get_edge_new_point(a, b, 0, 2);
             const Point_id   previous_edge_midpoint_1 = get_edge_new_point(a, b, 1, 2);
             const Point_id   next_edge_midpoint_0     = get_edge_new_point(b, c, 0, 2);
@@ -52,11 +56,11 @@ Gyro::Gyro(Geometry& src, Geometry& destination)
                 log_subdivide->warn("midpoint for edge {} {} [0] not found", b, c);
                 return;
             }
-            make_new_corner_from_point           (new_polygon_id, previous_edge_midpoint_0);
-            make_new_corner_from_point           (new_polygon_id, previous_edge_midpoint_1);
-            make_new_corner_from_corner          (new_polygon_id, j.corner_id);
-            make_new_corner_from_point           (new_polygon_id, next_edge_midpoint_0);
-            make_new_corner_from_polygon_centroid(new_polygon_id, i.polygon_id);
+            emitter.make_corner_from_point           (new_polygon_id, previous_edge_midpoint_0);
+            emitter.make_corner_from_point           (new_polygon_id, previous_edge_midpoint_1);
+            emitter.make_corner_from_corner          (new_polygon_id, j.corner_id);
+            emitter.make_corner_from_point           (new_polygon_id, next_edge_midpoint_0);
+            emitter.make_corner_from_polygon_centroid(new_polygon_id, polygon_id);
             //log_subdivide.warn(
             //    "Polygon {} = {} {} {} {} {}\n",
             //    new_polygon_id,
@@ -72,12 +76,12 @@ Gyro::Gyro(Geometry& src, Geometry& destination)
     post_processing();
 }
 
-auto gyro(Geometry& source) -> Geometry
+auto gyro(Geometry& source, erhe::concurrency::Thread_pool* const thread_pool) -> Geometry
 {
     return Geometry{
         fmt::format("gyro({})", source.name),
-        [&source](auto& result) {
-            Gyro operation{source, result};
+        [&source, thread_pool](auto& result) {
+            Gyro operation{source, result, thread_pool};
         }
     };
 }
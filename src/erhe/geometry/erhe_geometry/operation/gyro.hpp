@@ -10,11 +10,16 @@ class Gyro
     : public Geometry_operation
 {
 public:
-    Gyro(Geometry& src, Geometry& destination);
+    Gyro(
+        Geometry&                       src,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
 };
 
 [[nodiscard]] auto gyro(
-    erhe::geometry::Geometry& source
+    erhe::geometry::Geometry&       source,
+    erhe::concurrency::Thread_pool* thread_pool = nullptr
 ) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
@@ -12,25 +12,30 @@
 namespace erhe::geometry::operation
 {
 
-Join::Join(Geometry& src, Geometry& destination)
-    : Geometry_operation{src, destination}
+Join::Join(
+    Geometry&                             src,
+    Geometry&                             destination,
+    erhe::concurrency::Thread_pool* const thread_pool
+)
+    : Geometry_operation{src, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
     make_points_from_points();
     make_polygon_centroids();
 
-    source.for_each_edge_const([&](const auto& i) {
-        if (i.edge.polygon_count != 2) {
+    emit(source.get_edge_count(), [&](Emitter& emitter, const Edge_id edge_id) {
+        const Edge& edge = source.edges[edge_id];
+        if (edge.polygon_count != 2) {
             return;
         }
-        const Polygon_id new_polygon_id = destination.make_polygon();
-        const Point_id   point_id_a     = i.edge.a;
-        const Point_id   point_id_b     = i.edge.b;
+        const Polygon_id new_polygon_id = emitter.make_polygon();
+        const Point_id   point_id_a     = edge.a;
+        const Point_id   point_id_b     = edge.b;
         //const Point&     point_a        = src.points[point_id_a];
         //const Point&     point_b        = src.points[point_id_b];
-        const Polygon_id polygon_id_l   = src.edge_polygons.at(i.edge.first_edge_polygon_id    );
-        const Polygon_id polygon_id_r   = src.edge_polygons.at(i.edge.first_edge_polygon_id + 1);
+        const Polygon_id polygon_id_l   = src.edge_polygons.at(edge.first_edge_polygon_id    );
+        const Polygon_id polygon_id_r   = src.edge_polygons.at(edge.first_edge_polygon_id + 1);
         const Polygon&   polygon_l      = src.polygons.at(polygon_id_l);
         const Polygon&   polygon_r      = src.polygons.at(polygon_id_r);
         bool l_forward {false}; // a, b
@@ -78,27 +83,27 @@ Join::Join(Geometry& src, Geometry& destination)
         ERHE_VERIFY(l_forward != r_forward);
 
         if (l_forward) {
-            make_new_corner_from_point           (new_polygon_id, point_id_a  );
-            make_new_corner_from_polygon_centroid(new_polygon_id, polygon_id_r);
-            make_new_corner_from_point           (new_polygon_id, point_id_b  );
-            make_new_corner_from_polygon_centroid(new_polygon_id, polygon_id_l);
+            emitter.make_corner_from_point           (new_polygon_id, point_id_a  );
+            emitter.make_corner_from_polygon_centroid(new_polygon_id, polygon_id_r);
+            emitter.make_corner_from_point           (new_polygon_id, point_id_b  );
+            emitter.make_corner_from_polygon_centroid(new_polygon_id, polygon_id_l);
         } else {
-            make_new_corner_from_point           (new_polygon_id, point_id_a  );
-            make_new_corner_from_polygon_centroid(new_polygon_id, polygon_id_l);
-            make_new_corner_from_point           (new_polygon_id, point_id_b  );
-            make_new_corner_from_polygon_centroid(new_polygon_id, polygon_id_r);
+            emitter.make_corner_from_point           (new_polygon_id, point_id_a  );
+            emitter.make_corner_from_polygon_centroid(new_polygon_id, polygon_id_l);
+            emitter.make_corner_from_point           (new_polygon_id, point_id_b  );
+            emitter.make_corner_from_polygon_centroid(new_polygon_id, polygon_id_r);
         }
     });
 
     post_processing();
 }
 
-auto join(Geometry& source) -> Geometry
+auto join(Geometry& source, erhe::concurrency::Thread_pool* const thread_pool) -> Geometry
 {
     return Geometry{
         fmt::format("join({})", source.name),
-        [&source](auto& result) {
-            Join operation{source, result};
+        [&source, thread_pool](auto& result) {
+            Join operation{source, result, thread_pool};
         }
     };
 }
@@ -9,11 +9,16 @@ class Join
     : public Geometry_operation
 {
 public:
-    Join(Geometry& src, Geometry& destination);
+    Join(
+        Geometry&                       src,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
 };
 
 [[nodiscard]] auto join(
-    erhe::geometry::Geometry& source
+    erhe::geometry::Geometry&       source,
+    erhe::concurrency::Thread_pool* thread_pool = nullptr
 ) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
@@ -8,32 +8,36 @@
 namespace erhe::geometry::operation
 {
 
-Kis::Kis(Geometry& src, Geometry& destination)
-    : Geometry_operation{src, destination}
+Kis::Kis(
+    Geometry&                             src,
+    Geometry&                             destination,
+    erhe::concurrency::Thread_pool* const thread_pool
+)
+    : Geometry_operation{src, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
     make_points_from_points();
     make_polygon_centroids();
 
-    source.for_each_polygon_const([&](auto& i) {
-        i.polygon.for_each_corner_neighborhood_const(source, [&](auto& j) {
-            const Polygon_id new_polygon_id = destination.make_polygon();
-            make_new_corner_from_polygon_centroid(new_polygon_id, i.polygon_id);
-            make_new_corner_from_corner          (new_polygon_id, j.corner_id);
-            make_new_corner_from_corner          (new_polygon_id, j.next_corner_id);
+    emit(source.get_polygon_count(), [&](Emitter& emitter, const Polygon_id polygon_id) {
+        source.polygons[polygon_id].for_each_corner_neighborhood_const(source, [&](auto& j) {
+            const Polygon_id new_polygon_id = emitter.make_polygon();
+            emitter.make_corner_from_polygon_centroid(new_polygon_id, polygon_id);
+            emitter.make_corner_from_corner          (new_polygon_id, j.corner_id);
+            emitter.make_corner_from_corner          (new_polygon_id, j.next_corner_id);
         });
     });
 
     post_processing();
 }
 
-auto kis(Geometry& source) -> Geometry
+auto kis(Geometry& source, erhe::concurrency::Thread_pool* const thread_pool) -> Geometry
 {
     return Geometry{
         fmt::format("kis({})", source.name),
-        [&source](auto& result) {
-            Kis operation{source, result};
+        [&source, thread_pool](auto& result) {
+            Kis operation{source, result, thread_pool};
         }
     };
 }
@@ -9,11 +9,16 @@ class Kis
     : public Geometry_operation
 {
 public:
-    Kis(Geometry& src, Geometry& destination);
+    Kis(
+        Geometry&                       src,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
 };
 
 [[nodiscard]] auto kis(
-    erhe::geometry::Geometry& source
+    erhe::geometry::Geometry&       source,
+    erhe::concurrency::Thread_pool* thread_pool = nullptr
 ) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
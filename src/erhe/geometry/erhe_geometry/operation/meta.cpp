@@ -11,8 +11,12 @@
 namespace erhe::geometry::operation
 {
 
-Meta::Meta(Geometry& src, Geometry& destination)
-    : Geometry_operation{src, destination}
+Meta::Meta(
+    Geometry&                             src,
+    Geometry&                             destination,
+    erhe::concurrency::Thread_pool* const thread_pool
+)
+    : Geometry_operation{src, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -25,13 +29,13 @@ Meta::Meta(Geometry& src, Geometry& destination)
     make_polygon_centroids();
     make_edge_midpoints();
 
-    source.for_each_polygon_const([&](auto& i) {
-        i.polygon.for_each_corner_neighborhood_const(source, [&](auto& j) {
+    emit(source.get_polygon_count(), [&](Emitter& emitter, const Polygon_id polygon_id) {
+        source.polygons[polygon_id].for_each_corner_neighborhood_const(source, [&](auto& j) {
             const Point_id   a                      = j.prev_corner.point_id;
             const Point_id   b                      = j.corner     .point_id;
             const Point_id   c                      = j.next_corner.point_id;
-            const Polygon_id new_polygon_id_a       = make_new_polygon_from_polygon(i.polygon_id);
-            const Polygon_id new_polygon_id_b       = make_new_polygon_from_polygon(i.polygon_id);
+            const Polygon_id new_polygon_id_a       = emitter.make_polygon_from_polygon(polygon_id);
+            const Polygon_id new_polygon_id_b       = emitter.make_polygon_from_polygon(polygon_id);
             const Point_id   previous_edge_midpoint = get_edge_new_point(a, b);
             const Point_id   next_edge_midpoint     = get_edge_new_point(b, c);
             if (previous_edge_midpoint == std::numeric_limits<uint32_t>::max()) {
@@ -42,25 +46,25 @@ Meta::Meta(Geometry& src, Geometry& destination)
                 log_subdivide->warn("midpoint for edge {} {} not found", std::min(b, c), std::max(b, c));
                 return;
             }
-            make_new_corner_from_polygon_centroid(new_polygon_id_a, i.polygon_id);
-            make_new_corner_from_point           (new_polygon_id_a, previous_edge_midpoint);
-            make_new_corner_from_corner          (new_polygon_id_a, j.corner_id);
+            emitter.make_corner_from_polygon_centroid(new_polygon_id_a, polygon_id);
+            emitter.make_corner_from_point           (new_polygon_id_a, previous_edge_midpoint);
+            emitter.make_corner_from_corner          (new_polygon_id_a, j.corner_id);
 
-            make_new_corner_from_polygon_centroid(new_polygon_id_b, i.polygon_id);
-            make_new_corner_from_corner          (new_polygon_id_b, j.corner_id);
-            make_new_corner_from_point           (new_polygon_id_b, next_edge_midpoint);
+            emitter.make_corner_from_polygon_centroid(new_polygon_id_b, polygon_id);
+            emitter.make_corner_from_corner          (new_polygon_id_b, j.corner_id);
+            emitter.make_corner_from_point           (new_polygon_id_b, next_edge_midpoint);
         });
     });
 
     post_processing();
 }
 
-auto meta(Geometry& source) -> Geometry
+auto meta(Geometry& source, erhe::concurrency::Thread_pool* const thread_pool) -> Geometry
 {
     return Geometry{
         fmt::format("meta({})", source.name),
-        [&source](auto& result) {
-            Meta operation{source, result};
+        [&source, thread_pool](auto& result) {
+            Meta operation{source, result, thread_pool};
         }
     };
 }
@@ -7,10 +7,11 @@ namespace erhe::geometry::operation
 {
 
 Normalize::Normalize(
-    Geometry& source,
-    Geometry& destination
+    Geometry&                             source,
+    Geometry&                             destination,
+    erhe::concurrency::Thread_pool* const thread_pool
 )
-    : Geometry_operation{source, destination}
+    : Geometry_operation{source, destination, thread_pool}
 {
     destination.points                               = source.points;
     destination.polygons                             = source.polygons;
@@ -27,6 +28,7 @@ Normalize::Normalize(
     destination.m_next_point_corner_reserve          = source.m_next_point_corner_reserve;
     destination.m_next_polygon_corner_id             = source.m_next_polygon_corner_id;
     destination.m_next_edge_polygon_id               = source.m_next_edge_polygon_id;
+    destination.m_edge_index                         = source.m_edge_index;
     destination.m_polygon_corner_polygon             = source.m_polygon_corner_polygon;
     destination.m_edge_polygon_edge                  = source.m_edge_polygon_edge;
 
@@ -46,6 +48,8 @@ Normalize::Normalize(
     destination.m_serial_corner_tangents             = source.m_serial_corner_tangents            ;
     destination.m_serial_corner_bitangents           = source.m_serial_corner_bitangents          ;
     destination.m_serial_corner_texture_coordinates  = source.m_serial_corner_texture_coordinates ;
+    destination.m_dirty_polygons                     = source.m_dirty_polygons                    ;
+    destination.m_dirty_cursors                      = source.m_dirty_cursors                     ;
 
     destination.m_point_property_map_collection   = source.m_point_property_map_collection  .clone();
     destination.m_corner_property_map_collection  = source.m_corner_property_map_collection .clone();
@@ -59,21 +63,22 @@ Normalize::Normalize(
             const glm::vec3 old_position = positions->get(i.point_id);
             const glm::vec3 new_position = glm::normalize(old_position);
             positions->put(i.point_id, new_position);
+            destination.mark_point_dirty(i.point_id);
         }
     });
 
-    destination.compute_point_normals(erhe::geometry::c_point_normals_smooth);
-    destination.compute_polygon_normals();
-    destination.compute_polygon_centroids();
-    destination.compute_tangents();
+    destination.compute_point_normals(erhe::geometry::c_point_normals_smooth, thread_pool);
+    destination.compute_polygon_normals(thread_pool);
+    destination.compute_polygon_centroids(thread_pool);
+    destination.compute_tangents({}, thread_pool);
 }
 
-auto normalize(Geometry& source) -> Geometry
+auto normalize(Geometry& source, erhe::concurrency::Thread_pool* const thread_pool) -> Geometry
 {
     return Geometry{
         fmt::format("normalize({})", source.name),
-        [&source](auto& result) {
-            Normalize operation{source, result};
+        [&source, thread_pool](auto& result) {
+            Normalize operation{source, result, thread_pool};
         }
     };
 }
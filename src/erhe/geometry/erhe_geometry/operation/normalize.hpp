@@ -11,11 +11,16 @@ class Normalize
     : public Geometry_operation
 {
 public:
-    Normalize(Geometry& source, Geometry& destination);
+    Normalize(
+        Geometry&                       source,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
 };
 
 [[nodiscard]] auto normalize(
-    erhe::geometry::Geometry& source
+    erhe::geometry::Geometry&       source,
+    erhe::concurrency::Thread_pool* thread_pool = nullptr
 ) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
@@ -40,8 +40,11 @@ Reverse::Reverse(
     destination.m_serial_corner_tangents             = source.m_serial_corner_tangents            ;
     destination.m_serial_corner_bitangents           = source.m_serial_corner_bitangents          ;
     destination.m_serial_corner_texture_coordinates  = source.m_serial_corner_texture_coordinates ;
+    destination.m_dirty_polygons                     = source.m_dirty_polygons                    ;
+    destination.m_dirty_cursors                      = source.m_dirty_cursors                     ;
 
     destination.m_next_edge_polygon_id            = source.m_next_edge_polygon_id;
+    destination.m_edge_index                      = source.m_edge_index;
     destination.m_point_property_map_collection   = source.m_point_property_map_collection  .clone();
     destination.m_corner_property_map_collection  = source.m_corner_property_map_collection .clone();
     destination.m_polygon_property_map_collection = source.m_polygon_property_map_collection.clone();
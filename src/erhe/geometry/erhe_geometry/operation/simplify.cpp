@@ -0,0 +1,598 @@
+#include "erhe_geometry/operation/simplify.hpp"
+#include "erhe_geometry/geometry.hpp"
+#include "erhe_geometry/geometry_log.hpp"
+#include "erhe_profile/profile.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <fmt/format.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+namespace erhe::geometry::operation
+{
+
+using vec2 = glm::vec2;
+using vec3 = glm::vec3;
+using vec4 = glm::vec4;
+
+namespace {
+
+// Attribute values closer than this are considered equal when looking for seams
+constexpr float c_seam_epsilon = 1.0e-5f;
+
+// Collapses which rotate any remaining triangle normal more than this
+// (cosine of the angle) away from its current or original direction are
+// rejected
+constexpr float c_min_normal_dot = 0.2f;
+
+// Collapses which leave a triangle with |cross(e1, e2)| below this fraction
+// of its longest squared edge length are rejected as degenerate. The bound
+// is relative, so it does not depend on the scale of the mesh.
+constexpr float c_min_triangle_quality = 1.0e-2f;
+
+template <typename Key_type, typename Value_type>
+auto equal_values(
+    const Property_map<Key_type, Value_type>* map,
+    const Key_type                            a,
+    const Key_type                            b
+) -> bool
+{
+    if ((map == nullptr) || (a == b)) {
+        return true;
+    }
+    Value_type value_a{};
+    Value_type value_b{};
+    const bool has_a = map->maybe_get(a, value_a);
+    const bool has_b = map->maybe_get(b, value_b);
+    if (has_a != has_b) {
+        return false;
+    }
+    if (!has_a) {
+        return true;
+    }
+    return glm::all(glm::lessThanEqual(glm::abs(value_a - value_b), Value_type{c_seam_epsilon}));
+}
+
+template <typename Value_type, typename Key_type>
+void copy_values(
+    const Property_map_collection<Key_type>& source,
+    Property_map_collection<Key_type>&       destination,
+    const Property_map_descriptor&           descriptor,
+    const std::vector<Key_type>&             key_new_to_old
+)
+{
+    const auto* source_map = source.template find<Value_type>(descriptor);
+    if (source_map == nullptr) {
+        return;
+    }
+    auto* destination_map = destination.template find_or_create<Value_type>(descriptor);
+    for (std::size_t new_key = 0, end = key_new_to_old.size(); new_key < end; ++new_key) {
+        Value_type value;
+        if (source_map->maybe_get(key_new_to_old[new_key], value)) {
+            destination_map->put(static_cast<Key_type>(new_key), value);
+        }
+    }
+}
+
+[[nodiscard]] auto edge_key(const Point_id a, const Point_id b) -> uint64_t
+{
+    return (static_cast<uint64_t>(std::min(a, b)) << 32) | static_cast<uint64_t>(std::max(a, b));
+}
+
+} // anonymous namespace
+
+void Simplify::Quadric::add_plane(const glm::dvec3 n, const double d, const double weight)
+{
+    m[0] += weight * n.x * n.x;
+    m[1] += weight * n.x * n.y;
+    m[2] += weight * n.x * n.z;
+    m[3] += weight * n.x * d;
+    m[4] += weight * n.y * n.y;
+    m[5] += weight * n.y * n.z;
+    m[6] += weight * n.y * d;
+    m[7] += weight * n.z * n.z;
+    m[8] += weight * n.z * d;
+    m[9] += weight * d   * d;
+}
+
+void Simplify::Quadric::add(const Quadric& other)
+{
+    for (std::size_t i = 0; i < m.size(); ++i) {
+        m[i] += other.m[i];
+    }
+}
+
+auto Simplify::Quadric::evaluate(const glm::dvec3 p) const -> double
+{
+    return
+        m[0] * p.x * p.x + 2.0 * m[1] * p.x * p.y + 2.0 * m[2] * p.x * p.z + 2.0 * m[3] * p.x +
+        m[4] * p.y * p.y + 2.0 * m[5] * p.y * p.z + 2.0 * m[6] * p.y +
+        m[7] * p.z * p.z + 2.0 * m[8] * p.z +
+        m[9];
+}
+
+Simplify::Simplify(
+    Geometry&                             source,
+    Geometry&                             destination,
+    const std::size_t                     target_triangle_count,
+    erhe::concurrency::Thread_pool* const thread_pool
+)
+    : Geometry_operation{source, destination, thread_pool}
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const auto& corner_attributes  = source.corner_attributes();
+    const auto& polygon_attributes = source.polygon_attributes();
+    m_corner_normals       = corner_attributes .find<vec3>(c_corner_normals      );
+    m_corner_texcoords     = corner_attributes .find<vec2>(c_corner_texcoords    );
+    m_corner_colors        = corner_attributes .find<vec4>(c_corner_colors       );
+    m_corner_aniso_control = corner_attributes .find<vec2>(c_corner_aniso_control);
+    m_polygon_colors       = polygon_attributes.find<vec4>(c_polygon_colors      );
+
+    make_triangles();
+    make_point_quadrics();
+    lock_seam_points();
+    const std::size_t source_triangle_count = m_triangle_count;
+    collapse_edges(target_triangle_count);
+    make_destination();
+
+    log_operation->trace(
+        "simplify({}): {} -> {} triangles, target {}",
+        source.name, source_triangle_count, m_triangle_count, target_triangle_count
+    );
+}
+
+void Simplify::make_triangles()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const uint32_t point_count   = source.get_point_count();
+    const uint32_t polygon_count = source.get_polygon_count();
+
+    m_triangles       .reserve(source.count_polygon_triangles());
+    m_triangle_polygon.reserve(source.count_polygon_triangles());
+    for (Polygon_id polygon_id = 0; polygon_id < polygon_count; ++polygon_id) {
+        const Polygon& polygon = source.polygons[polygon_id];
+        if (polygon.corner_count < 3) {
+            continue;
+        }
+        const Polygon_corner_id first      = polygon.first_polygon_corner_id;
+        const Corner_id         fan_corner = source.polygon_corners[first];
+        for (uint32_t i = 1; i + 1 < polygon.corner_count; ++i) {
+            m_triangles.push_back(
+                {
+                    fan_corner,
+                    source.polygon_corners[first + i],
+                    source.polygon_corners[first + i + 1]
+                }
+            );
+            m_triangle_polygon.push_back(polygon_id);
+        }
+    }
+    m_triangle_count = m_triangles.size();
+    m_triangle_removed.resize(m_triangle_count, false);
+
+    m_point_triangles.resize(point_count);
+    for (uint32_t triangle = 0, end = static_cast<uint32_t>(m_triangles.size()); triangle < end; ++triangle) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            m_point_triangles[triangle_point(triangle, i)].push_back(triangle);
+        }
+    }
+
+    m_point_locations.resize(point_count, vec3{0.0f});
+    m_point_locked   .resize(point_count, false);
+    m_point_removed  .resize(point_count, false);
+    m_point_version  .resize(point_count, 0);
+
+    const auto* point_locations = source.point_attributes().find<vec3>(c_point_locations);
+    for (Point_id point_id = 0; point_id < point_count; ++point_id) {
+        if ((point_locations == nullptr) || !point_locations->maybe_get(point_id, m_point_locations[point_id])) {
+            m_point_locked[point_id] = true;
+        }
+    }
+}
+
+void Simplify::make_point_quadrics()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    m_point_quadrics.resize(m_point_locations.size());
+    m_triangle_original_normals.resize(m_triangles.size(), vec3{0.0f});
+    for (uint32_t triangle = 0, end = static_cast<uint32_t>(m_triangles.size()); triangle < end; ++triangle) {
+        const Point_id   a      = triangle_point(triangle, 0);
+        const Point_id   b      = triangle_point(triangle, 1);
+        const Point_id   c      = triangle_point(triangle, 2);
+        const glm::dvec3 p0     = glm::dvec3{m_point_locations[a]};
+        const glm::dvec3 p1     = glm::dvec3{m_point_locations[b]};
+        const glm::dvec3 p2     = glm::dvec3{m_point_locations[c]};
+        const glm::dvec3 cross  = glm::cross(p1 - p0, p2 - p0);
+        const double     length = glm::length(cross);
+        if (length == 0.0) {
+            continue;
+        }
+        // Planes are weighted by triangle area
+        const glm::dvec3 normal = cross / length;
+        m_triangle_original_normals[triangle] = vec3{normal};
+        const double     d      = -glm::dot(normal, p0);
+        const double     weight = 0.5 * length;
+        m_point_quadrics[a].add_plane(normal, d, weight);
+        m_point_quadrics[b].add_plane(normal, d, weight);
+        m_point_quadrics[c].add_plane(normal, d, weight);
+    }
+}
+
+void Simplify::lock_seam_points()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    // Boundary and non-manifold edges
+    std::unordered_map<uint64_t, uint32_t> edge_triangle_counts;
+    edge_triangle_counts.reserve(m_triangles.size() * 2);
+    for (uint32_t triangle = 0, end = static_cast<uint32_t>(m_triangles.size()); triangle < end; ++triangle) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            ++edge_triangle_counts[edge_key(triangle_point(triangle, i), triangle_point(triangle, (i + 1) % 3))];
+        }
+    }
+    for (const auto& [key, count] : edge_triangle_counts) {
+        if (count != 2) {
+            m_point_locked[static_cast<Point_id>(key >> 32)]         = true;
+            m_point_locked[static_cast<Point_id>(key & 0xffffffffu)] = true;
+        }
+    }
+
+    // Attribute seams
+    for (Point_id point_id = 0, end = static_cast<Point_id>(m_point_triangles.size()); point_id < end; ++point_id) {
+        const auto& triangles = m_point_triangles[point_id];
+        if (m_point_locked[point_id] || triangles.empty()) {
+            continue;
+        }
+        Corner_id  first_corner {std::numeric_limits<Corner_id>::max()};
+        Polygon_id first_polygon{std::numeric_limits<Polygon_id>::max()};
+        for (const uint32_t triangle : triangles) {
+            for (const Corner_id corner_id : m_triangles[triangle]) {
+                if (source.corners[corner_id].point_id != point_id) {
+                    continue;
+                }
+                const Polygon_id polygon_id = m_triangle_polygon[triangle];
+                if (first_corner == std::numeric_limits<Corner_id>::max()) {
+                    first_corner  = corner_id;
+                    first_polygon = polygon_id;
+                } else if (
+                    !equal_corners(first_corner, corner_id) ||
+                    !equal_values(m_polygon_colors, first_polygon, polygon_id)
+                ) {
+                    m_point_locked[point_id] = true;
+                }
+            }
+        }
+    }
+}
+
+auto Simplify::triangle_point(const uint32_t triangle, const uint32_t i) const -> Point_id
+{
+    return source.corners[m_triangles[triangle][i]].point_id;
+}
+
+auto Simplify::equal_corners(const Corner_id a, const Corner_id b) const -> bool
+{
+    return
+        equal_values(m_corner_normals,       a, b) &&
+        equal_values(m_corner_texcoords,     a, b) &&
+        equal_values(m_corner_colors,        a, b) &&
+        equal_values(m_corner_aniso_control, a, b);
+}
+
+auto Simplify::make_collapse(const Point_id from, const Point_id to) const -> Collapse
+{
+    Quadric quadric = m_point_quadrics[from];
+    quadric.add(m_point_quadrics[to]);
+    return Collapse{
+        .cost         = static_cast<float>(std::max(0.0, quadric.evaluate(glm::dvec3{m_point_locations[to]}))),
+        .from         = from,
+        .to           = to,
+        .from_version = m_point_version[from],
+        .to_version   = m_point_version[to]
+    };
+}
+
+void Simplify::collect_neighbors(const Point_id point_id, std::vector<Point_id>& out) const
+{
+    out.clear();
+    for (const uint32_t triangle : m_point_triangles[point_id]) {
+        if (m_triangle_removed[triangle]) {
+            continue;
+        }
+        for (uint32_t i = 0; i < 3; ++i) {
+            const Point_id neighbor = triangle_point(triangle, i);
+            if (neighbor != point_id) {
+                out.push_back(neighbor);
+            }
+        }
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+auto Simplify::try_collapse(const Point_id from, const Point_id to) -> bool
+{
+    // Triangles sharing the collapsed edge; interior manifold edges have two
+    m_collapse_triangles.clear();
+    for (const uint32_t triangle : m_point_triangles[from]) {
+        if (m_triangle_removed[triangle]) {
+            continue;
+        }
+        for (uint32_t i = 0; i < 3; ++i) {
+            if (triangle_point(triangle, i) == to) {
+                m_collapse_triangles.push_back(triangle);
+                break;
+            }
+        }
+    }
+    if (m_collapse_triangles.size() != 2) {
+        return false;
+    }
+
+    // Link condition: the only common neighbors are the two opposite points
+    collect_neighbors(from, m_neighbors_a);
+    collect_neighbors(to,   m_neighbors_b);
+    std::size_t common_count = 0;
+    for (
+        auto i = m_neighbors_a.begin(), j = m_neighbors_b.begin();
+        (i != m_neighbors_a.end()) && (j != m_neighbors_b.end());
+    ) {
+        if (*i < *j) {
+            ++i;
+        } else if (*j < *i) {
+            ++j;
+        } else {
+            ++common_count;
+            ++i;
+            ++j;
+        }
+    }
+    if (common_count != 2) {
+        return false;
+    }
+
+    // Corners of the kept point on both sides of the collapsed edge must
+    // agree, as one of them replaces all corners of the removed point
+    Corner_id to_corners[2];
+    for (std::size_t k = 0; k < 2; ++k) {
+        for (const Corner_id corner_id : m_triangles[m_collapse_triangles[k]]) {
+            if (source.corners[corner_id].point_id == to) {
+                to_corners[k] = corner_id;
+            }
+        }
+    }
+    if (
+        !equal_corners(to_corners[0], to_corners[1]) ||
+        !equal_values(m_polygon_colors, m_triangle_polygon[m_collapse_triangles[0]], m_triangle_polygon[m_collapse_triangles[1]])
+    ) {
+        return false;
+    }
+
+    // Reject triangle flips and degenerate triangles
+    const vec3 to_location = m_point_locations[to];
+    for (const uint32_t triangle : m_point_triangles[from]) {
+        if (
+            m_triangle_removed[triangle] ||
+            (triangle == m_collapse_triangles[0]) ||
+            (triangle == m_collapse_triangles[1])
+        ) {
+            continue;
+        }
+        vec3 old_p[3];
+        vec3 new_p[3];
+        for (uint32_t i = 0; i < 3; ++i) {
+            const Point_id point_id = triangle_point(triangle, i);
+            old_p[i] = m_point_locations[point_id];
+            new_p[i] = (point_id == from) ? to_location : old_p[i];
+        }
+        const vec3  e0         = new_p[1] - new_p[0];
+        const vec3  e1         = new_p[2] - new_p[1];
+        const vec3  e2         = new_p[0] - new_p[2];
+        const vec3  old_normal = glm::cross(old_p[1] - old_p[0], old_p[2] - old_p[0]);
+        const vec3  new_normal = glm::cross(e0, -e2);
+        const float old_length = glm::length(old_normal);
+        const float new_length = glm::length(new_normal);
+        const float max_edge_length_squared = std::max({glm::dot(e0, e0), glm::dot(e1, e1), glm::dot(e2, e2)});
+        if (!(new_length > c_min_triangle_quality * max_edge_length_squared)) {
+            return false;
+        }
+        if (
+            (old_length > 0.0f) &&
+            (glm::dot(old_normal, new_normal) < c_min_normal_dot * old_length * new_length)
+        ) {
+            return false;
+        }
+        // Comparing only to the previous state lets a series of collapses
+        // fold a triangle over step by step
+        const vec3 original_normal = m_triangle_original_normals[triangle];
+        if (
+            (original_normal != vec3{0.0f}) &&
+            (glm::dot(original_normal, new_normal) < c_min_normal_dot * new_length)
+        ) {
+            return false;
+        }
+    }
+
+    // Apply
+    const Corner_id replacement_corner = to_corners[0];
+    for (const uint32_t triangle : m_collapse_triangles) {
+        m_triangle_removed[triangle] = true;
+    }
+    m_triangle_count -= 2;
+
+    for (const uint32_t triangle : m_point_triangles[from]) {
+        if (m_triangle_removed[triangle]) {
+            continue;
+        }
+        for (Corner_id& corner_id : m_triangles[triangle]) {
+            if (source.corners[corner_id].point_id == from) {
+                corner_id = replacement_corner;
+            }
+        }
+        m_point_triangles[to].push_back(triangle);
+    }
+    m_point_triangles[from].clear();
+
+    const auto is_removed = [this](const uint32_t triangle) { return m_triangle_removed[triangle]; };
+    std::erase_if(m_point_triangles[to], is_removed);
+    for (const Point_id neighbor : m_neighbors_a) {
+        std::erase_if(m_point_triangles[neighbor], is_removed);
+    }
+
+    m_point_quadrics[to].add(m_point_quadrics[from]);
+    m_point_removed[from] = true;
+    ++m_point_version[from];
+    ++m_point_version[to];
+    return true;
+}
+
+void Simplify::collapse_edges(const std::size_t target_triangle_count)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+
+    const auto push = [&](const Point_id a, const Point_id b) {
+        if (!m_point_locked[a]) {
+            queue.push(make_collapse(a, b));
+        }
+        if (!m_point_locked[b]) {
+            queue.push(make_collapse(b, a));
+        }
+    };
+
+    // Each interior edge is pushed once, from the triangle where it runs from lower to higher point
+    for (uint32_t triangle = 0, end = static_cast<uint32_t>(m_triangles.size()); triangle < end; ++triangle) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            const Point_id a = triangle_point(triangle, i);
+            const Point_id b = triangle_point(triangle, (i + 1) % 3);
+            if (a < b) {
+                push(a, b);
+            }
+        }
+    }
+
+    std::vector<Point_id> neighbors;
+    while ((m_triangle_count > target_triangle_count) && !queue.empty()) {
+        const Collapse collapse = queue.top();
+        queue.pop();
+        if (
+            m_point_removed[collapse.from] ||
+            m_point_removed[collapse.to] ||
+            (m_point_version[collapse.from] != collapse.from_version) ||
+            (m_point_version[collapse.to  ] != collapse.to_version)
+        ) {
+            continue;
+        }
+        if (!try_collapse(collapse.from, collapse.to)) {
+            continue;
+        }
+
+        collect_neighbors(collapse.to, neighbors);
+        for (const Point_id neighbor : neighbors) {
+            push(collapse.to, neighbor);
+        }
+    }
+}
+
+void Simplify::make_destination()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    std::vector<bool> point_used(m_point_locations.size(), false);
+    for (uint32_t triangle = 0, end = static_cast<uint32_t>(m_triangles.size()); triangle < end; ++triangle) {
+        if (m_triangle_removed[triangle]) {
+            continue;
+        }
+        for (uint32_t i = 0; i < 3; ++i) {
+            point_used[triangle_point(triangle, i)] = true;
+        }
+    }
+
+    const std::size_t new_point_count = static_cast<std::size_t>(std::count(point_used.begin(), point_used.end(), true));
+    destination.reserve_points  (new_point_count);
+    destination.reserve_polygons(m_triangle_count);
+    m_new_point_to_old.reserve(new_point_count);
+    for (Point_id point_id = 0, end = static_cast<Point_id>(point_used.size()); point_id < end; ++point_id) {
+        if (point_used[point_id]) {
+            const Point_id new_point_id = make_new_point_from_point(point_id);
+            ERHE_VERIFY(new_point_id == m_new_point_to_old.size());
+            m_new_point_to_old.push_back(point_id);
+        }
+    }
+
+    m_new_corner_to_old .reserve(m_triangle_count * 3);
+    m_new_polygon_to_old.reserve(m_triangle_count);
+    for (uint32_t triangle = 0, end = static_cast<uint32_t>(m_triangles.size()); triangle < end; ++triangle) {
+        if (m_triangle_removed[triangle]) {
+            continue;
+        }
+        const Polygon_id old_polygon_id = m_triangle_polygon[triangle];
+        const Polygon_id new_polygon_id = make_new_polygon_from_polygon(old_polygon_id);
+        ERHE_VERIFY(new_polygon_id == m_new_polygon_to_old.size());
+        m_new_polygon_to_old.push_back(old_polygon_id);
+        for (const Corner_id old_corner_id : m_triangles[triangle]) {
+            const Corner_id new_corner_id = make_new_corner_from_corner(new_polygon_id, old_corner_id);
+            ERHE_VERIFY(new_corner_id == m_new_corner_to_old.size());
+            m_new_corner_to_old.push_back(old_corner_id);
+        }
+    }
+
+    copy_attributes();
+    post_processing();
+}
+
+// Corner and polygon property maps, and point maps without interpolation
+// such as skinning, are not interpolated by Geometry_operation. Copy those
+// that the simplification preserves. Each kept point keeps its own values.
+// Tangents and anything else missing is regenerated by post_processing().
+void Simplify::copy_attributes()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const auto& source_points   = source.point_attributes();
+    const auto& source_corners  = source.corner_attributes();
+    const auto& source_polygons = source.polygon_attributes();
+    auto&       points          = destination.point_attributes();
+    auto&       corners         = destination.corner_attributes();
+    auto&       polygons        = destination.polygon_attributes();
+
+    copy_values<glm::uvec4>(source_points, points, c_point_joint_indices, m_new_point_to_old);
+    copy_values<vec4      >(source_points, points, c_point_joint_weights, m_new_point_to_old);
+
+    copy_values<vec3>(source_corners,  corners,  c_corner_normals,        m_new_corner_to_old );
+    copy_values<vec2>(source_corners,  corners,  c_corner_texcoords,      m_new_corner_to_old );
+    copy_values<vec4>(source_corners,  corners,  c_corner_colors,         m_new_corner_to_old );
+    copy_values<vec2>(source_corners,  corners,  c_corner_aniso_control,  m_new_corner_to_old );
+    copy_values<vec4>(source_polygons, polygons, c_polygon_colors,        m_new_polygon_to_old);
+    copy_values<vec2>(source_polygons, polygons, c_polygon_aniso_control, m_new_polygon_to_old);
+}
+
+auto simplify(
+    Geometry&                             source,
+    const float                           triangle_ratio,
+    erhe::concurrency::Thread_pool* const thread_pool
+) -> Geometry
+{
+    const std::size_t triangle_count        = source.count_polygon_triangles();
+    const std::size_t target_triangle_count = static_cast<std::size_t>(
+        std::max(0.0f, triangle_ratio) * static_cast<float>(triangle_count)
+    );
+    return Geometry{
+        fmt::format("simplify({})", source.name),
+        [&source, target_triangle_count, thread_pool](auto& result) {
+            Simplify operation{source, result, target_triangle_count, thread_pool};
+        }
+    };
+}
+
+} // namespace erhe::geometry::operation
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "erhe_geometry/operation/geometry_operation.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <vector>
+
+namespace erhe::geometry
+{
+    template <typename Key_type, typename Value_type>
+    class Property_map;
+}
+
+namespace erhe::geometry::operation
+{
+
+// Quadric error metric edge collapse simplification.
+//
+// Polygons are fan triangulated, and edges are collapsed in order of
+// increasing quadric error until the triangle count drops to the target.
+// Collapses move one endpoint onto the other (half-edge collapse), so no new
+// attribute values are created: surviving corners keep their original
+// attributes, and corners of the removed point take the attributes of the
+// kept point corner on the collapsed edge. Tangents are regenerated.
+//
+// Points on attribute seams (corners with differing normals, texture
+// coordinates or colors, or polygons with differing colors), on
+// boundaries and on non-manifold edges are never moved, so seams and
+// silhouettes of open meshes stay intact. Collapses that would flip a
+// triangle or make the mesh non-manifold are rejected.
+class Simplify
+    : public Geometry_operation
+{
+public:
+    Simplify(
+        Geometry&                       source,
+        Geometry&                       destination,
+        std::size_t                     target_triangle_count,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
+
+private:
+    class Quadric
+    {
+    public:
+        void add_plane(glm::dvec3 normal, double d, double weight);
+        void add      (const Quadric& other);
+        [[nodiscard]] auto evaluate(glm::dvec3 p) const -> double;
+
+        std::array<double, 10> m{};
+    };
+
+    class Collapse
+    {
+    public:
+        float    cost;
+        Point_id from;
+        Point_id to;
+        uint32_t from_version;
+        uint32_t to_version;
+
+        auto operator>(const Collapse& other) const -> bool { return cost > other.cost; }
+    };
+
+    void make_triangles          ();
+    void make_point_quadrics     ();
+    void lock_seam_points        ();
+    void collapse_edges          (std::size_t target_triangle_count);
+    void make_destination        ();
+    void copy_attributes         ();
+
+    [[nodiscard]] auto triangle_point     (uint32_t triangle, uint32_t i) const -> Point_id;
+    [[nodiscard]] auto equal_corners      (Corner_id a, Corner_id b) const -> bool;
+    [[nodiscard]] auto make_collapse      (Point_id from, Point_id to) const -> Collapse;
+    [[nodiscard]] auto try_collapse       (Point_id from, Point_id to) -> bool;
+    void collect_neighbors(Point_id point_id, std::vector<Point_id>& out) const;
+
+    const Property_map<Corner_id,  glm::vec3>* m_corner_normals       {nullptr};
+    const Property_map<Corner_id,  glm::vec2>* m_corner_texcoords     {nullptr};
+    const Property_map<Corner_id,  glm::vec4>* m_corner_colors        {nullptr};
+    const Property_map<Corner_id,  glm::vec2>* m_corner_aniso_control {nullptr};
+    const Property_map<Polygon_id, glm::vec4>* m_polygon_colors       {nullptr};
+
+    std::vector<std::array<Corner_id, 3>> m_triangles;
+    std::vector<Polygon_id>               m_triangle_polygon;
+    std::vector<bool>                     m_triangle_removed;
+    std::vector<glm::vec3>                m_triangle_original_normals;
+    std::vector<std::vector<uint32_t>>    m_point_triangles;
+    std::vector<glm::vec3>                m_point_locations;
+    std::vector<Quadric>                  m_point_quadrics;
+    std::vector<bool>                     m_point_locked;
+    std::vector<bool>                     m_point_removed;
+    std::vector<uint32_t>                 m_point_version;
+    std::vector<Point_id>                 m_neighbors_a;
+    std::vector<Point_id>                 m_neighbors_b;
+    std::vector<uint32_t>                 m_collapse_triangles;
+    std::vector<Point_id>                 m_new_point_to_old;
+    std::vector<Corner_id>                m_new_corner_to_old;
+    std::vector<Polygon_id>               m_new_polygon_to_old;
+    std::size_t                           m_triangle_count{0};
+};
+
+// Simplifies to approximately triangle_ratio times the triangle count of the
+// fan triangulated source.
+[[nodiscard]] auto simplify(
+    erhe::geometry::Geometry&       source,
+    float                           triangle_ratio,
+    erhe::concurrency::Thread_pool* thread_pool = nullptr
+) -> erhe::geometry::Geometry;
+
+} // namespace erhe::geometry::operation
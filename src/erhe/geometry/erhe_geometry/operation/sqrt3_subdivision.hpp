@@ -8,11 +8,16 @@ class Sqrt3_subdivision
     : public Geometry_operation
 {
 public:
-    Sqrt3_subdivision(Geometry& src, Geometry& destination);
+    Sqrt3_subdivision(
+        Geometry&                       src,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
 };
 
 [[nodiscard]] auto sqrt3_subdivision(
-    erhe::geometry::Geometry& source
+    erhe::geometry::Geometry&       source,
+    erhe::concurrency::Thread_pool* thread_pool = nullptr
 ) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
@@ -11,8 +11,12 @@
 namespace erhe::geometry::operation
 {
 
-Subdivide::Subdivide(Geometry& src, Geometry& destination)
-    : Geometry_operation{src, destination}
+Subdivide::Subdivide(
+    Geometry&                             src,
+    Geometry&                             destination,
+    erhe::concurrency::Thread_pool* const thread_pool
+)
+    : Geometry_operation{src, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -25,18 +29,18 @@ Subdivide::Subdivide(Geometry& src, Geometry& destination)
     make_polygon_centroids();
     make_edge_midpoints();
 
-    source.for_each_polygon_const([&](auto& i) {
+    emit(source.get_polygon_count(), [&](Emitter& emitter, const Polygon_id polygon_id) {
         //if (src_polygon.corner_count == 3)
         //{
         //    Polygon_id new_polygon_id = make_new_polygon_from_polygon(src_polygon_id);
         //    add_polygon_corners(new_polygon_id, src_polygon_id);
         //    continue;
         //}
-        i.polygon.for_each_corner_neighborhood_const(source, [&](auto& j) {
+        source.polygons[polygon_id].for_each_corner_neighborhood_const(source, [&](auto& j) {
             const Point_id   a                      = j.prev_corner.point_id;
             const Point_id   b                      = j.corner     .point_id;
             const Point_id   c                      = j.next_corner.point_id;
-            const Polygon_id new_polygon_id         = make_new_polygon_from_polygon(i.polygon_id);
+            const Polygon_id new_polygon_id         = emitter.make_polygon_from_polygon(polygon_id);
             const Point_id   previous_edge_midpoint = get_edge_new_point(a, b);
             const Point_id   next_edge_midpoint     = get_edge_new_point(b, c);
             if (previous_edge_midpoint == std::numeric_limits<uint32_t>::max()) {
@@ -47,10 +51,10 @@ Subdivide::Subdivide(Geometry& src, Geometry& destination)
                 log_subdivide->warn("midpoint for edge {} {} not found", std::min(b, c), std::max(b, c));
                 return;
             }
-            make_new_corner_from_point           (new_polygon_id, previous_edge_midpoint);
-            make_new_corner_from_corner          (new_polygon_id, j.corner_id);
-            make_new_corner_from_point           (new_polygon_id, next_edge_midpoint);
-            make_new_corner_from_polygon_centroid(new_polygon_id, i.polygon_id);
+            emitter.make_corner_from_point           (new_polygon_id, previous_edge_midpoint);
+            emitter.make_corner_from_corner          (new_polygon_id, j.corner_id);
+            emitter.make_corner_from_point           (new_polygon_id, next_edge_midpoint);
+            emitter.make_corner_from_polygon_centroid(new_polygon_id, polygon_id);
             //log_subdivide.warn(
             //    "Polygon {} = {} {} {} {}\n",
             //    new_polygon_id,
@@ -65,12 +69,12 @@ Subdivide::Subdivide(Geometry& src, Geometry& destination)
     post_processing();
 }
 
-auto subdivide(Geometry& source) -> Geometry
+auto subdivide(Geometry& source, erhe::concurrency::Thread_pool* const thread_pool) -> Geometry
 {
     return Geometry{
         fmt::format("subdivide({})", source.name),
-        [&source](auto& result) {
-            Subdivide operation{source, result};
+        [&source, thread_pool](auto& result) {
+            Subdivide operation{source, result, thread_pool};
         }
     };
 }
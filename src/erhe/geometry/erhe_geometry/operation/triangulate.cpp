@@ -8,38 +8,43 @@
 namespace erhe::geometry::operation
 {
 
-Triangulate::Triangulate(Geometry& src, Geometry& destination)
-    : Geometry_operation{src, destination}
+Triangulate::Triangulate(
+    Geometry&                             src,
+    Geometry&                             destination,
+    erhe::concurrency::Thread_pool* const thread_pool
+)
+    : Geometry_operation{src, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
     make_points_from_points();
     make_polygon_centroids();
 
-    source.for_each_polygon_const([&](auto& i) {
-        if (i.polygon.corner_count == 3) {
-            const Polygon_id new_polygon_id = make_new_polygon_from_polygon(i.polygon_id);
-            add_polygon_corners(new_polygon_id, i.polygon_id);
+    emit(source.get_polygon_count(), [&](Emitter& emitter, const Polygon_id polygon_id) {
+        const Polygon& polygon = source.polygons[polygon_id];
+        if (polygon.corner_count == 3) {
+            const Polygon_id new_polygon_id = emitter.make_polygon_from_polygon(polygon_id);
+            emitter.add_polygon_corners(new_polygon_id, polygon_id);
             return;
         }
 
-        i.polygon.for_each_corner_neighborhood_const(source, [&](auto& j) {
-            const Polygon_id new_polygon_id = destination.make_polygon();
-            make_new_corner_from_polygon_centroid(new_polygon_id, i.polygon_id);
-            make_new_corner_from_corner          (new_polygon_id, j.corner_id);
-            make_new_corner_from_corner          (new_polygon_id, j.next_corner_id);
+        polygon.for_each_corner_neighborhood_const(source, [&](auto& j) {
+            const Polygon_id new_polygon_id = emitter.make_polygon();
+            emitter.make_corner_from_polygon_centroid(new_polygon_id, polygon_id);
+            emitter.make_corner_from_corner          (new_polygon_id, j.corner_id);
+            emitter.make_corner_from_corner          (new_polygon_id, j.next_corner_id);
         });
     });
 
     post_processing();
 }
 
-auto triangulate(Geometry& source) -> Geometry
+auto triangulate(Geometry& source, erhe::concurrency::Thread_pool* const thread_pool) -> Geometry
 {
     return Geometry{
         fmt::format("triangulate({})", source.name),
-        [&source](auto& result) {
-            Triangulate operation{source, result};
+        [&source, thread_pool](auto& result) {
+            Triangulate operation{source, result, thread_pool};
         }
     };
 }
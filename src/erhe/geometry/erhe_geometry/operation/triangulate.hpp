@@ -9,11 +9,16 @@ class Triangulate
     : public Geometry_operation
 {
 public:
-    Triangulate(Geometry& src, Geometry& destination);
+    Triangulate(
+        Geometry&                       src,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
 };
 
 [[nodiscard]] auto triangulate(
-    erhe::geometry::Geometry& source
+    erhe::geometry::Geometry&       source,
+    erhe::concurrency::Thread_pool* thread_pool = nullptr
 ) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
@@ -12,8 +12,12 @@
 namespace erhe::geometry::operation
 {
 
-Truncate::Truncate(Geometry& source, Geometry& destination)
-    : Geometry_operation{source, destination}
+Truncate::Truncate(
+    Geometry&                             source,
+    Geometry&                             destination,
+    erhe::concurrency::Thread_pool* const thread_pool
+)
+    : Geometry_operation{source, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -26,10 +30,10 @@ Truncate::Truncate(Geometry& source, Geometry& destination)
 
     // New faces from old points, new face corner for each old point corner edge
     // 'midpoint' that is closest to the corner
-    source.for_each_point_const([&](auto& i) {
-        const Polygon_id new_polygon_id = destination.make_polygon();
+    emit(source.get_point_count(), [&](Emitter& emitter, const Point_id point_id) {
+        const Polygon_id new_polygon_id = emitter.make_polygon();
 
-        i.point.for_each_corner_const(source, [&](auto& j) {
+        source.points[point_id].for_each_corner_const(source, [&](auto& j) {
             const Polygon&  src_polygon        = source.polygons[j.corner.polygon_id];
             const Corner_id src_next_corner_id = src_polygon.next_corner(source, j.corner_id);
             const Corner&   src_next_corner    = source.corners[src_next_corner_id];
@@ -37,23 +41,23 @@ Truncate::Truncate(Geometry& source, Geometry& destination)
             if (src_next_corner.point_id > j.corner.point_id) {
                 edge_midpoint += 1;
             }
-            make_new_corner_from_point(new_polygon_id, edge_midpoint);
+            emitter.make_corner_from_point(new_polygon_id, edge_midpoint);
         });
     });
 
     // New faces from old faces, new face corner for each old corner edge 'midpoint'
-    source.for_each_polygon([&](auto& i) {
-        const Polygon_id new_polygon_id = destination.make_polygon();
-        i.polygon.for_each_corner_neighborhood(source, [&](auto& j) {
+    emit(source.get_polygon_count(), [&](Emitter& emitter, const Polygon_id polygon_id) {
+        const Polygon_id new_polygon_id = emitter.make_polygon();
+        source.polygons[polygon_id].for_each_corner_neighborhood_const(source, [&](auto& j) {
             const Point_id edge_midpoint = get_edge_new_point(j.corner.point_id, j.next_corner.point_id);
             const Point_id point_a       = edge_midpoint;
             const Point_id point_b       = edge_midpoint + 1;
             if (j.next_corner.point_id > j.corner.point_id) {
-                make_new_corner_from_point(new_polygon_id, point_b);
-                make_new_corner_from_point(new_polygon_id, point_a);
+                emitter.make_corner_from_point(new_polygon_id, point_b);
+                emitter.make_corner_from_point(new_polygon_id, point_a);
             } else {
-                make_new_corner_from_point(new_polygon_id, point_a);
-                make_new_corner_from_point(new_polygon_id, point_b);
+                emitter.make_corner_from_point(new_polygon_id, point_a);
+                emitter.make_corner_from_point(new_polygon_id, point_b);
             }
         });
     });
@@ -61,12 +65,12 @@ Truncate::Truncate(Geometry& source, Geometry& destination)
     post_processing();
 }
 
-auto truncate(Geometry& source) -> Geometry
+auto truncate(Geometry& source, erhe::concurrency::Thread_pool* const thread_pool) -> Geometry
 {
     return Geometry(
         fmt::format("truncate({})", source.name),
-        [&source](auto& result) {
-            Truncate operation{source, result};
+        [&source, thread_pool](auto& result) {
+            Truncate operation{source, result, thread_pool};
         }
     );
 }
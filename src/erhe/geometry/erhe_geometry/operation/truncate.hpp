@@ -9,11 +9,16 @@ class Truncate
     : public Geometry_operation
 {
 public:
-    Truncate(Geometry& source, Geometry& destination);
+    Truncate(
+        Geometry&                       source,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
 };
 
 [[nodiscard]] auto truncate(
-    erhe::geometry::Geometry& source
+    erhe::geometry::Geometry&       source,
+    erhe::concurrency::Thread_pool* thread_pool = nullptr
 ) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
@@ -1,7 +1,7 @@
 #include "erhe_geometry/operation/weld.hpp"
+#include "erhe_concurrency/parallel_for.hpp"
 #include "erhe_geometry/geometry.hpp"
 #include "erhe_geometry/geometry_log.hpp"
-#include "erhe_geometry/operation/octree.hpp"
 #include "erhe_log/log_glm.hpp"
 #include "erhe_profile/profile.hpp"
 #include "erhe_verify/verify.hpp"
@@ -12,6 +12,9 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
 #include <numeric>
 #include <sstream>
 
@@ -20,43 +23,205 @@ namespace erhe::geometry::operation
 
 using vec3 = glm::vec3;
 
+namespace {
+
+// Uniform grid for point merge queries. Cell size is the merge distance,
+// so points within merge distance from a location are in the 3x3x3 cells
+// around the location cell. Cells are hashed to buckets, and bucket point
+// lists are stored as offsets into a single point array.
+class Point_grid
+{
+public:
+    Point_grid(const std::vector<vec3>& points, const float cell_size)
+        : m_inverse_cell_size{1.0f / cell_size}
+    {
+        ERHE_PROFILE_FUNCTION();
+
+        const uint32_t point_count  = static_cast<uint32_t>(points.size());
+        const uint32_t bucket_count = std::bit_ceil(std::max(point_count * 2u, 16u));
+        m_bucket_mask = bucket_count - 1;
+
+        std::vector<uint32_t> point_buckets(point_count);
+        m_bucket_offsets.assign(static_cast<std::size_t>(bucket_count) + 1, 0);
+        for (uint32_t point_id = 0; point_id < point_count; ++point_id) {
+            const uint32_t bucket = get_bucket(get_cell(points[point_id]));
+            point_buckets[point_id] = bucket;
+            ++m_bucket_offsets[bucket + 1];
+        }
+        for (uint32_t bucket = 0; bucket < bucket_count; ++bucket) {
+            m_bucket_offsets[bucket + 1] += m_bucket_offsets[bucket];
+        }
+        m_bucket_points.resize(point_count);
+        std::vector<uint32_t> cursors{m_bucket_offsets.begin(), m_bucket_offsets.end() - 1};
+        for (uint32_t point_id = 0; point_id < point_count; ++point_id) {
+            m_bucket_points[cursors[point_buckets[point_id]]++] = point_id;
+        }
+    }
+
+    // Calls callback(Point_id) for points in cells around location. The
+    // callback must do the distance test. A point may be visited more than
+    // once, when neighboring cells hash to the same bucket.
+    template <typename Callback>
+    void for_each_point_near(const vec3& location, Callback&& callback) const
+    {
+        const std::array<int32_t, 3> center = get_cell(location);
+        for (int32_t dz = -1; dz <= 1; ++dz) {
+            for (int32_t dy = -1; dy <= 1; ++dy) {
+                for (int32_t dx = -1; dx <= 1; ++dx) {
+                    const uint32_t bucket = get_bucket({center[0] + dx, center[1] + dy, center[2] + dz});
+                    for (uint32_t i = m_bucket_offsets[bucket], end = m_bucket_offsets[bucket + 1]; i < end; ++i) {
+                        callback(m_bucket_points[i]);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    [[nodiscard]] auto get_cell(const vec3& location) const -> std::array<int32_t, 3>
+    {
+        const auto axis = [this](const float value) -> int32_t {
+            const float cell = std::floor(value * m_inverse_cell_size);
+            if (!std::isfinite(cell)) { // Non-finite values share one sentinel cell; casting NaN is undefined
+                return static_cast<int32_t>(s_cell_limit);
+            }
+            return static_cast<int32_t>(std::clamp(cell, -s_cell_limit, s_cell_limit));
+        };
+        return {axis(location.x), axis(location.y), axis(location.z)};
+    }
+
+    [[nodiscard]] auto get_bucket(const std::array<int32_t, 3>& cell) const -> uint32_t
+    {
+        const uint32_t hash =
+            (static_cast<uint32_t>(cell[0]) * 73856093u) ^
+            (static_cast<uint32_t>(cell[1]) * 19349663u) ^
+            (static_cast<uint32_t>(cell[2]) * 83492791u);
+        return hash & m_bucket_mask;
+    }
+
+    // Cell coordinates are clamped so that neighbor cell coordinates do not overflow
+    static constexpr float s_cell_limit = static_cast<float>(1 << 30);
+
+    float                 m_inverse_cell_size;
+    uint32_t              m_bucket_mask{0};
+    std::vector<uint32_t> m_bucket_offsets;
+    std::vector<uint32_t> m_bucket_points;
+};
+
+// Stable LSD radix sort of keys by bits [begin_bit, 64), 8 bits per pass.
+// Passes where all keys have the same digit are skipped.
+void radix_sort(std::vector<uint64_t>& keys, const unsigned int begin_bit)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    std::vector<uint64_t> scratch(keys.size());
+    for (unsigned int shift = begin_bit; shift < 64; shift += 8) {
+        std::array<std::size_t, 257> offsets{};
+        for (const uint64_t key : keys) {
+            ++offsets[((key >> shift) & 0xffu) + 1];
+        }
+        if (std::find(offsets.begin() + 1, offsets.end(), keys.size()) != offsets.end()) {
+            continue;
+        }
+        for (std::size_t digit = 0; digit < 256; ++digit) {
+            offsets[digit + 1] += offsets[digit];
+        }
+        for (const uint64_t key : keys) {
+            scratch[offsets[(key >> shift) & 0xffu]++] = key;
+        }
+        keys.swap(scratch);
+    }
+}
+
+constexpr uint8_t c_merge_target_no        = 0;
+constexpr uint8_t c_merge_target_yes       = 1;
+constexpr uint8_t c_merge_target_undecided = 2;
+
+} // anonymous namespace
+
+template <typename Function>
+void Weld::for_each_index(const uint32_t count, Function&& function)
+{
+    if (thread_pool != nullptr) {
+        erhe::concurrency::parallel_for(*thread_pool, uint32_t{0}, count, function);
+    } else {
+        for (uint32_t i = 0; i < count; ++i) {
+            function(i);
+        }
+    }
+}
+
+// Points are visited in point id order. A point becomes merge target if
+// there is no earlier merge target within merge distance. Each point is
+// merged to the last (highest id) merge target within merge distance.
+//
+// Points without any earlier point within merge distance are always merge
+// targets; those are found in parallel. Only the remaining points need to
+// be resolved in point id order.
 void Weld::find_point_merge_candidates()
 {
+    ERHE_PROFILE_FUNCTION();
+
     const auto* point_locations = source.point_attributes().find<vec3>(c_point_locations);
 
+    const uint32_t point_count = source.get_point_count();
     std::vector<glm::vec3> points;
-    points.resize(source.get_point_count());
+    points.resize(point_count);
     source.for_each_point_const(
         [&](const auto& i) {
             points[i.point_id] = point_locations->get(i.point_id);
         }
     );
 
-    unibn::Octree<glm::vec3> octree;
-    unibn::OctreeParams params;
-    octree.initialize(points);
-
-    source.for_each_point_const(
-        [&](const auto& i) {
-            if (m_point_id_merge_candidates[i.point_id] != i.point_id) {
-                //// log_merge->info("Point {} is already marked to be merged", i.point_id);
-                return; // continue already marked
+    const float      max_distance_squared = m_max_distance * m_max_distance;
+    const Point_grid grid{points, m_max_distance};
+    const auto is_near = [&](const Point_id a, const Point_id b) -> bool {
+        return glm::distance2(points[a], points[b]) < max_distance_squared;
+    };
+
+    std::vector<uint8_t> merge_target(point_count);
+    for_each_index(point_count, [&](const Point_id point_id) {
+        bool has_earlier_point = false;
+        grid.for_each_point_near(points[point_id], [&](const Point_id other_point_id) {
+            if ((other_point_id < point_id) && is_near(point_id, other_point_id)) {
+                has_earlier_point = true;
             }
+        });
+        merge_target[point_id] = has_earlier_point ? c_merge_target_undecided : c_merge_target_yes;
+    });
 
-            const glm::vec3 query_location = points[i.point_id];
-
-            std::vector<uint32_t> nearby_point_indices;
-            octree.radiusNeighbors<unibn::L2Distance<glm::vec3>>(
-                query_location,
-                m_max_distance,
-                nearby_point_indices
-            );
+    for (Point_id point_id = 0; point_id < point_count; ++point_id) {
+        if (merge_target[point_id] != c_merge_target_undecided) {
+            continue;
+        }
+        bool has_earlier_target = false;
+        grid.for_each_point_near(points[point_id], [&](const Point_id other_point_id) {
+            if (
+                (other_point_id < point_id) &&
+                (merge_target[other_point_id] == c_merge_target_yes) &&
+                is_near(point_id, other_point_id)
+            ) {
+                has_earlier_target = true;
+            }
+        });
+        merge_target[point_id] = has_earlier_target ? c_merge_target_no : c_merge_target_yes;
+    }
 
-            for (const auto merge_point_id : nearby_point_indices) {
-                m_point_id_merge_candidates[merge_point_id] = i.point_id;
+    for_each_index(point_count, [&](const Point_id point_id) {
+        Point_id target_point_id = point_id; // Kept only for non-finite locations
+        bool     found           = false;
+        grid.for_each_point_near(points[point_id], [&](const Point_id other_point_id) {
+            if (
+                (merge_target[other_point_id] == c_merge_target_yes) &&
+                (!found || (other_point_id > target_point_id)) &&
+                is_near(point_id, other_point_id)
+            ) {
+                target_point_id = other_point_id;
+                found           = true;
             }
-        }
-    );
+        });
+        m_point_id_merge_candidates[point_id] = target_point_id;
+    });
 
     //// std::stringstream ss;
     //// for (const auto id : m_point_id_merge_candidates) {
@@ -69,35 +234,30 @@ void Weld::find_point_merge_candidates()
 // (after considering point merges) is the first corner.
 void Weld::rotate_polygons_to_least_point_first()
 {
-    source.for_each_polygon([&](auto &i){
-        Polygon&      polygon         = i.polygon;
-        Corner_id     first_corner_id = source.polygon_corners[polygon.first_polygon_corner_id];
-        const Corner& first_corner    = source.corners[first_corner_id];
-        Point_id      min_point_id0   = first_corner.point_id;
-        Point_id      min_point_id    = m_point_id_merge_candidates[min_point_id0];
-        uint32_t      min_point_slot  = 0;
-        std::vector<Corner_id> copy_of_polygon_corners;
+    ERHE_PROFILE_FUNCTION();
+
+    // Each polygon only touches its own polygon corners
+    for_each_index(source.get_polygon_count(), [&](const Polygon_id polygon_id) {
+        const Polygon& polygon = source.polygons[polygon_id];
+        if (polygon.corner_count == 0) {
+            return;
+        }
+        const auto first = source.polygon_corners.begin() + polygon.first_polygon_corner_id;
+        Point_id   min_point_id   = m_point_id_merge_candidates[source.corners[*first].point_id];
+        uint32_t   min_point_slot = 0;
 
         // Find corner with smallest Point_id
-        for (uint32_t j = 0; j < polygon.corner_count; ++j) {
-            Polygon_corner_id polygon_corner_id = polygon.first_polygon_corner_id + j;
-            const Corner_id   corner_id         = source.polygon_corners[polygon_corner_id];
-            const Corner&     corner            = source.corners[corner_id];
-            const Point_id    point_id0         = corner.point_id;
-            const Point_id    point_id          = m_point_id_merge_candidates[point_id0];
-            copy_of_polygon_corners.push_back(corner_id);
+        for (uint32_t j = 1; j < polygon.corner_count; ++j) {
+            const Corner_id corner_id = *(first + j);
+            const Point_id  point_id  = m_point_id_merge_candidates[source.corners[corner_id].point_id];
             if (point_id < min_point_id) {
-                min_point_id = point_id;
+                min_point_id   = point_id;
                 min_point_slot = j;
             }
         }
 
         // Rotate corners of polygon
-        for (uint32_t j = 0; j < polygon.corner_count; ++j) {
-            Polygon_corner_id polygon_corner_id = polygon.first_polygon_corner_id + j;
-            const Corner_id   corner_id         = copy_of_polygon_corners.at((j + min_point_slot) % polygon.corner_count);
-            source.polygon_corners[polygon_corner_id] = corner_id;
-        }
+        std::rotate(first, first + min_point_slot, first + polygon.corner_count);
     });
 }
 
@@ -110,25 +270,27 @@ void Weld::rotate_polygons_to_least_point_first()
 // algorithm to find potentially equal and opposite polygons.
 void Weld::sort_polygons()
 {
-    std::sort(
-        m_polygon_id_sorted.begin(),
-        m_polygon_id_sorted.end(),
-        [this](const Polygon_id& lhs, const Polygon_id& rhs) {
-            Polygon&      lhs_polygon         = source.polygons       [lhs];
-            Corner_id     lhs_first_corner_id = source.polygon_corners[lhs_polygon.first_polygon_corner_id];
-            const Corner& lhs_first_corner    = source.corners        [lhs_first_corner_id];
-            Point_id      lhs_point_id0       = lhs_first_corner.point_id;
-            Point_id      lhs_point_id        = m_point_id_merge_candidates[lhs_point_id0];
-
-            Polygon&      rhs_polygon         = source.polygons       [rhs];
-            Corner_id     rhs_first_corner_id = source.polygon_corners[rhs_polygon.first_polygon_corner_id];
-            const Corner& rhs_first_corner    = source.corners        [rhs_first_corner_id];
-            Point_id      rhs_point_id0       = rhs_first_corner.point_id;
-            Point_id      rhs_point_id        = m_point_id_merge_candidates[rhs_point_id0];
-
-            return lhs_point_id < rhs_point_id;
-        }
-    );
+    ERHE_PROFILE_FUNCTION();
+
+    // Keys are packed as (merged first point id << 32) | polygon id. Polygons
+    // with the same first point stay in polygon id order.
+    std::vector<uint64_t> keys(m_polygon_id_sorted.size());
+    for_each_index(static_cast<uint32_t>(keys.size()), [&](const uint32_t i) {
+        const Polygon_id polygon_id = m_polygon_id_sorted[i];
+        const Polygon&   polygon    = source.polygons[polygon_id];
+        const Point_id   point_id   = (polygon.corner_count > 0)
+            ? m_point_id_merge_candidates[
+                source.corners[source.polygon_corners[polygon.first_polygon_corner_id]].point_id
+            ]
+            : Point_id{0};
+        keys[i] = (static_cast<uint64_t>(point_id) << 32) | polygon_id;
+    });
+
+    radix_sort(keys, 32);
+
+    for (std::size_t i = 0, end = keys.size(); i < end; ++i) {
+        m_polygon_id_sorted[i] = static_cast<Polygon_id>(keys[i] & 0xffffffffu);
+    }
 
     //// log_merge->info("Sorted polygons:");
     //// for (const auto id : m_polygon_id_sorted) {
@@ -312,10 +474,11 @@ void Weld::count_used_points()
 }
 
 Weld::Weld(
-    Geometry& source,
-    Geometry& destination
+    Geometry&                             source,
+    Geometry&                             destination,
+    erhe::concurrency::Thread_pool* const thread_pool
 )
-    : Geometry_operation{source, destination}
+    : Geometry_operation{source, destination, thread_pool}
 {
     ERHE_PROFILE_FUNCTION();
 
@@ -365,12 +528,12 @@ Weld::Weld(
     post_processing();
 }
 
-auto weld(Geometry& source) -> Geometry
+auto weld(Geometry& source, erhe::concurrency::Thread_pool* const thread_pool) -> Geometry
 {
     return Geometry(
         fmt::format("weld({})", source.name),
-        [&source](auto& result) {
-            Weld operation{source, result};
+        [&source, thread_pool](auto& result) {
+            Weld operation{source, result, thread_pool};
         }
     );
 }
@@ -19,7 +19,11 @@ class Weld
     : public Geometry_operation
 {
 public:
-    Weld(Geometry& source, Geometry& destination);
+    Weld(
+        Geometry&                       source,
+        Geometry&                       destination,
+        erhe::concurrency::Thread_pool* thread_pool = nullptr
+    );
 
 private:
     void sort_points_by_location             ();
@@ -32,6 +36,9 @@ private:
 
     auto format_polygon_points(const Polygon& polygon) const -> std::string;
 
+    template <typename Function>
+    void for_each_index(uint32_t count, Function&& function);
+
 
     float                   m_max_distance;
     uint32_t                m_used_point_count;
@@ -42,7 +49,8 @@ private:
 };
 
 [[nodiscard]] auto weld(
-    erhe::geometry::Geometry& source
+    erhe::geometry::Geometry&       source,
+    erhe::concurrency::Thread_pool* thread_pool = nullptr
 ) -> erhe::geometry::Geometry;
 
 } // namespace erhe::geometry::operation
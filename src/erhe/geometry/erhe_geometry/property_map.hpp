@@ -1,22 +1,25 @@
 #pragma once
 
+#include "erhe_geometry/interpolation_table.hpp"
+#include "erhe_geometry/transform_kernels.hpp"
+
 #include <glm/glm.hpp>
 
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <typeinfo>
 #include <vector>
 
 namespace erhe::geometry
 {
 
-// TODO Use cofactor matrix for bivectors?
 enum class Transform_mode : unsigned int {
     none = 0,             // texture coordinates, colors, ...
     position,             // position vectors
-    direction,            // normal and other plain direction vectors
+    direction,            // normal and other plain direction vectors, transformed with cofactor matrix
     direction_vec3_float, // tangent and bitangent with extra float that is not to be transformed
 };
 
@@ -27,12 +30,30 @@ enum class Interpolation_mode : unsigned int {
     normalized_vec3_float, // normalize(transform with cofactor matrix) = normal, tagent, bitangent
 };
 
+// Built-in property maps have small integer ids, used by
+// Property_map_collection for direct slot lookup. User defined property
+// maps use c_property_map_id_user and are found by name.
+using Property_map_id = uint32_t;
+
+inline constexpr Property_map_id c_property_map_id_user    = ~Property_map_id{0};
+inline constexpr std::size_t     c_property_map_slot_count = 32;
+
+// Returns id of the built-in property map with given name, or
+// c_property_map_id_user if there is none. User defined descriptors which
+// reuse a built-in name share the slot of that built-in property map.
+[[nodiscard]] auto get_builtin_property_map_id(const char* name) -> Property_map_id;
+
+// Key ranges passed to concurrent interpolate_range() calls must start at
+// multiples of this, so that ranges do not share presence bit words.
+inline constexpr std::size_t     c_property_map_key_alignment = 64;
+
 class Property_map_descriptor
 {
 public:
     const char*        name;
     Transform_mode     transform_mode;
     Interpolation_mode interpolation_mode;
+    Property_map_id    id{c_property_map_id_user};
 };
 
 template <typename Key_type>
@@ -53,9 +74,23 @@ public:
     virtual void remap_keys(const std::vector<Key_type>& key_old_to_new) = 0;
 
     virtual void interpolate(
-        Property_map_base<Key_type>*                                destination,
-        const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds
+        Property_map_base<Key_type>*         destination,
+        const Interpolation_table<Key_type>& key_new_to_olds
+    ) const = 0;
+
+    // interpolate() split to steps, for processing key ranges in parallel.
+    // begin_interpolate() sizes destination for key_count keys.
+    // interpolate_range() can be called concurrently for disjoint ranges
+    // starting at multiples of c_property_map_key_alignment.
+    // end_interpolate() updates destination presence counts.
+    virtual void begin_interpolate(Property_map_base<Key_type>* destination, std::size_t key_count) const = 0;
+    virtual void interpolate_range(
+        Property_map_base<Key_type>*         destination,
+        const Interpolation_table<Key_type>& key_new_to_olds,
+        std::size_t                          key_begin,
+        std::size_t                          key_end
     ) const = 0;
+    virtual void end_interpolate(Property_map_base<Key_type>* destination) const = 0;
 
     virtual void transform  (const glm::mat4 matrix) = 0;
     virtual void import_from(Property_map_base<Key_type>* source) = 0;
@@ -91,11 +126,37 @@ public:
     void trim      (std::size_t size) final;
     void remap_keys(const std::vector<Key_type>& key_new_to_old) final;
 
+    // True when every key below the highest key put is present
+    [[nodiscard]] auto all_present       () const -> bool;
+    [[nodiscard]] auto count_present     (std::size_t key_count) const -> std::size_t;
+    [[nodiscard]] auto is_fully_populated(std::size_t key_count) const -> bool;
+
+    // Contiguous values for keys [0, key_count). All keys must be present.
+    [[nodiscard]] auto get_span(std::size_t key_count) -> std::span<Value_type>;
+    [[nodiscard]] auto get_span(std::size_t key_count) const -> std::span<const Value_type>;
+
+    // Marks keys [0, key_count) present and returns their values for writing
+    [[nodiscard]] auto assign_span(std::size_t key_count) -> std::span<Value_type>;
+
+    // Packed presence bits, one per key in values, and bulk replacement of
+    // values and presence bits. Used by geometry serialization.
+    [[nodiscard]] auto get_present_words() const -> std::span<const uint64_t>;
+    void assign_raw(std::span<const Value_type> raw_values, std::span<const uint64_t> present_words);
+
     void interpolate(
-        Property_map_base<Key_type>*                                destination,
-        const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds
+        Property_map_base<Key_type>*         destination,
+        const Interpolation_table<Key_type>& key_new_to_olds
     ) const final;
 
+    void begin_interpolate(Property_map_base<Key_type>* destination, std::size_t key_count) const final;
+    void interpolate_range(
+        Property_map_base<Key_type>*         destination,
+        const Interpolation_table<Key_type>& key_new_to_olds,
+        std::size_t                          key_begin,
+        std::size_t                          key_end
+    ) const final;
+    void end_interpolate(Property_map_base<Key_type>* destination) const final;
+
     void transform  (const glm::mat4 matrix) final;
     void import_from(Property_map_base<Key_type>* source) final;
     void import_from(Property_map_base<Key_type>* source, const glm::mat4 transform) final;
@@ -104,10 +165,21 @@ public:
     static constexpr std::size_t s_grow_size = 4096;
 
     std::vector<Value_type> values;
-    std::vector<bool>       present; // Yes, I know vector<bool> has limitations
 
 private:
+    [[nodiscard]] auto test_present  (std::size_t i) const -> bool;
+    void set_present   (std::size_t i);
+    void reset_present (std::size_t i);
+    void resize_storage(std::size_t size);
+    void append_present(const Property_map& source, std::size_t offset);
+    void recount_present();
+
+    static constexpr std::size_t s_word_bits = c_property_map_key_alignment;
+
     Property_map_descriptor m_descriptor;
+    std::vector<uint64_t>   m_present;          // one bit per key, packed in words
+    std::size_t             m_present_count{0}; // number of present keys
+    std::size_t             m_present_end  {0}; // one past highest present key
 };
 
 } // namespace erhe::geometry
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
 #include <type_traits>
 
 #if !defined(ERHE_PROFILE_FUNCTION)
@@ -26,6 +27,92 @@
 namespace erhe::geometry
 {
 
+template <typename Key_type, typename Value_type>
+inline auto
+Property_map<Key_type, Value_type>::test_present(const std::size_t i) const -> bool
+{
+    return ((m_present[i / s_word_bits] >> (i % s_word_bits)) & 1u) != 0;
+}
+
+template <typename Key_type, typename Value_type>
+inline void
+Property_map<Key_type, Value_type>::set_present(const std::size_t i)
+{
+    uint64_t&      word = m_present[i / s_word_bits];
+    const uint64_t bit  = uint64_t{1} << (i % s_word_bits);
+    if ((word & bit) == 0) {
+        word |= bit;
+        ++m_present_count;
+    }
+    m_present_end = std::max(m_present_end, i + 1);
+}
+
+template <typename Key_type, typename Value_type>
+inline void
+Property_map<Key_type, Value_type>::reset_present(const std::size_t i)
+{
+    uint64_t&      word = m_present[i / s_word_bits];
+    const uint64_t bit  = uint64_t{1} << (i % s_word_bits);
+    if ((word & bit) != 0) {
+        word &= ~bit;
+        --m_present_count;
+    }
+    // m_present_end is not lowered; all_present() stays conservative
+}
+
+template <typename Key_type, typename Value_type>
+inline void
+Property_map<Key_type, Value_type>::resize_storage(const std::size_t size)
+{
+    values   .resize(size);
+    m_present.resize((size + s_word_bits - 1) / s_word_bits, 0);
+    if (m_present_end > size) {
+        // Shrinking; clear bits past the end of last word and recount
+        const std::size_t tail_bits = size % s_word_bits;
+        if (tail_bits != 0) {
+            m_present.back() &= (uint64_t{1} << tail_bits) - 1;
+        }
+        recount_present();
+    }
+}
+
+template <typename Key_type, typename Value_type>
+inline void
+Property_map<Key_type, Value_type>::recount_present()
+{
+    m_present_count = 0;
+    m_present_end   = 0;
+    for (std::size_t word_index = 0, end = m_present.size(); word_index < end; ++word_index) {
+        const uint64_t word = m_present[word_index];
+        if (word != 0) {
+            m_present_count += static_cast<std::size_t>(std::popcount(word));
+            m_present_end    = word_index * s_word_bits + static_cast<std::size_t>(std::bit_width(word));
+        }
+    }
+}
+
+template <typename Key_type, typename Value_type>
+inline void
+Property_map<Key_type, Value_type>::append_present(
+    const Property_map& source,
+    const std::size_t   offset
+)
+{
+    if ((offset % s_word_bits) == 0) {
+        std::copy(source.m_present.begin(), source.m_present.end(), m_present.begin() + offset / s_word_bits);
+    } else {
+        for (std::size_t i = 0; i < source.m_present_end; ++i) {
+            if (source.test_present(i)) {
+                m_present[(offset + i) / s_word_bits] |= uint64_t{1} << ((offset + i) % s_word_bits);
+            }
+        }
+    }
+    m_present_count += source.m_present_count;
+    if (source.m_present_end > 0) {
+        m_present_end = offset + source.m_present_end;
+    }
+}
+
 template <typename Key_type, typename Value_type>
 inline void
 Property_map<Key_type, Value_type>::clear()
@@ -33,7 +120,9 @@ Property_map<Key_type, Value_type>::clear()
     ERHE_PROFILE_FUNCTION();
 
     values.clear();
-    present.clear();
+    m_present.clear();
+    m_present_count = 0;
+    m_present_end   = 0;
 }
 
 template <typename Key_type, typename Value_type>
@@ -54,8 +143,7 @@ template <typename Key_type, typename Value_type>
 inline void
 Property_map<Key_type, Value_type>::trim(std::size_t size)
 {
-    values.resize(size);
-    present.resize(size);
+    resize_storage(size);
 }
 
 template <typename Key_type, typename Value_type>
@@ -63,12 +151,114 @@ inline void
 Property_map<Key_type, Value_type>::remap_keys(const std::vector<Key_type>& key_new_to_old)
 {
     const auto old_values  = values;
-    const auto old_present = present;
+    const auto old_present = m_present;
     for (Key_type new_key = 0, end = static_cast<Key_type>(key_new_to_old.size()); new_key < end; ++new_key) {
-        Key_type old_key = key_new_to_old[new_key];
-        values [new_key] = old_values[old_key];
-        present[new_key] = old_present[old_key];
+        const std::size_t old_key     = static_cast<std::size_t>(key_new_to_old[new_key]);
+        const bool        was_present = ((old_present[old_key / s_word_bits] >> (old_key % s_word_bits)) & 1u) != 0;
+        values[new_key] = old_values[old_key];
+        uint64_t&      word = m_present[new_key / s_word_bits];
+        const uint64_t bit  = uint64_t{1} << (new_key % s_word_bits);
+        word = was_present ? (word | bit) : (word & ~bit);
+    }
+    recount_present();
+}
+
+template <typename Key_type, typename Value_type>
+inline auto
+Property_map<Key_type, Value_type>::all_present() const -> bool
+{
+    return m_present_count == m_present_end;
+}
+
+template <typename Key_type, typename Value_type>
+inline auto
+Property_map<Key_type, Value_type>::count_present(const std::size_t key_count) const -> std::size_t
+{
+    const std::size_t end = std::min(key_count, m_present_end);
+    if (all_present()) {
+        return end;
+    }
+    const std::size_t full_words = end / s_word_bits;
+    std::size_t count = 0;
+    for (std::size_t word_index = 0; word_index < full_words; ++word_index) {
+        count += static_cast<std::size_t>(std::popcount(m_present[word_index]));
+    }
+    const std::size_t tail_bits = end % s_word_bits;
+    if (tail_bits != 0) {
+        count += static_cast<std::size_t>(std::popcount(m_present[full_words] & ((uint64_t{1} << tail_bits) - 1)));
+    }
+    return count;
+}
+
+template <typename Key_type, typename Value_type>
+inline auto
+Property_map<Key_type, Value_type>::is_fully_populated(const std::size_t key_count) const -> bool
+{
+    if (key_count > m_present_end) {
+        return false;
+    }
+    return all_present() || (count_present(key_count) == key_count);
+}
+
+template <typename Key_type, typename Value_type>
+inline auto
+Property_map<Key_type, Value_type>::get_span(const std::size_t key_count) -> std::span<Value_type>
+{
+    ERHE_VERIFY(is_fully_populated(key_count));
+    return std::span<Value_type>{values.data(), key_count};
+}
+
+template <typename Key_type, typename Value_type>
+inline auto
+Property_map<Key_type, Value_type>::get_span(const std::size_t key_count) const -> std::span<const Value_type>
+{
+    ERHE_VERIFY(is_fully_populated(key_count));
+    return std::span<const Value_type>{values.data(), key_count};
+}
+
+template <typename Key_type, typename Value_type>
+inline auto
+Property_map<Key_type, Value_type>::assign_span(const std::size_t key_count) -> std::span<Value_type>
+{
+    ERHE_PROFILE_FUNCTION();
+
+    if (values.size() < key_count) {
+        resize_storage(key_count);
+    }
+    const std::size_t full_words = key_count / s_word_bits;
+    std::fill(m_present.begin(), m_present.begin() + full_words, ~uint64_t{0});
+    const std::size_t tail_bits = key_count % s_word_bits;
+    if (tail_bits != 0) {
+        m_present[full_words] |= (uint64_t{1} << tail_bits) - 1;
+    }
+    recount_present();
+    return std::span<Value_type>{values.data(), key_count};
+}
+
+template <typename Key_type, typename Value_type>
+inline auto
+Property_map<Key_type, Value_type>::get_present_words() const -> std::span<const uint64_t>
+{
+    return std::span<const uint64_t>{m_present.data(), m_present.size()};
+}
+
+template <typename Key_type, typename Value_type>
+inline void
+Property_map<Key_type, Value_type>::assign_raw(
+    const std::span<const Value_type> raw_values,
+    const std::span<const uint64_t>   present_words
+)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    ERHE_VERIFY(present_words.size() == (raw_values.size() + s_word_bits - 1) / s_word_bits);
+    values   .assign(raw_values.begin(), raw_values.end());
+    m_present.assign(present_words.begin(), present_words.end());
+    const std::size_t tail_bits = values.size() % s_word_bits;
+    if (tail_bits != 0) {
+        m_present.back() &= (uint64_t{1} << tail_bits) - 1;
     }
+    recount_present();
 }
 
 template <typename Key_type, typename Value_type>
@@ -79,11 +269,10 @@ Property_map<Key_type, Value_type>::put(Key_type key, Value_type value)
 
     const std::size_t i = static_cast<std::size_t>(key);
     if (values.size() <= i) {
-        values.resize(i + s_grow_size);
-        present.resize(i + s_grow_size);
+        resize_storage(i + s_grow_size);
     }
     values[i] = value;
-    present[i] = true;
+    set_present(i);
 }
 
 template <typename Key_type, typename Value_type>
@@ -92,11 +281,10 @@ Property_map<Key_type, Value_type>::get(Key_type key) const -> Value_type
 {
     ERHE_PROFILE_FUNCTION();
 
-    const std::size_t i = static_cast<std::size_t>(key);
-    if ((values.size() <= i) || !present[i]) {
+    if (!has(key)) {
         ERHE_FATAL("Value not found");
     }
-    return values[i];
+    return values[static_cast<std::size_t>(key)];
 }
 
 template <typename Key_type, typename Value_type>
@@ -107,10 +295,9 @@ Property_map<Key_type, Value_type>::erase(Key_type key)
 
     const std::size_t i = static_cast<std::size_t>(key);
     if (values.size() <= i) {
-        values.resize(i + s_grow_size);
-        present.resize(i + s_grow_size);
+        resize_storage(i + s_grow_size);
     }
-    present[i] = false;
+    reset_present(i);
 }
 
 template <typename Key_type, typename Value_type>
@@ -119,11 +306,10 @@ Property_map<Key_type, Value_type>::maybe_get(Key_type key, Value_type& out_valu
 {
     ERHE_PROFILE_FUNCTION();
 
-    const std::size_t i = static_cast<size_t>(key);
-    if ((values.size() <= i) || !present[i]) {
+    if (!has(key)) {
         return false;
     }
-    out_value = values[i];
+    out_value = values[static_cast<std::size_t>(key)];
     return true;
 }
 
@@ -135,10 +321,10 @@ Property_map<Key_type, Value_type>::has(Key_type key) const -> bool
     ERHE_PROFILE_FUNCTION();
 
     const std::size_t i = static_cast<std::size_t>(key);
-    if ((values.size() <= i) || !present[i]) {
+    if (i >= m_present_end) {
         return false;
     }
-    return true;
+    return all_present() || test_present(i);
 }
 
 template <typename Key_type, typename Value_type>
@@ -157,8 +343,57 @@ Property_map<Key_type, Value_type>::constructor(
 template <typename Key_type, typename Value_type>
 inline void
 Property_map<Key_type, Value_type>::interpolate(
-    Property_map_base<Key_type>*                                destination_base,
-    const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds
+    Property_map_base<Key_type>*         destination,
+    const Interpolation_table<Key_type>& key_new_to_olds
+) const
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const std::size_t key_count = key_new_to_olds.key_count();
+    begin_interpolate(destination, key_count);
+    interpolate_range(destination, key_new_to_olds, 0, key_count);
+    end_interpolate  (destination);
+}
+
+template <typename Key_type, typename Value_type>
+inline void
+Property_map<Key_type, Value_type>::begin_interpolate(
+    Property_map_base<Key_type>* destination_base,
+    const std::size_t            key_count
+) const
+{
+    auto* destination = dynamic_cast<Property_map<Key_type, Value_type>*>(destination_base);
+    if (destination == nullptr) {
+        return;
+    }
+    if (m_descriptor.interpolation_mode == Interpolation_mode::none) {
+        return;
+    }
+    if (destination->values.size() < key_count) {
+        destination->resize_storage(key_count);
+    }
+}
+
+template <typename Key_type, typename Value_type>
+inline void
+Property_map<Key_type, Value_type>::end_interpolate(
+    Property_map_base<Key_type>* destination_base
+) const
+{
+    auto* destination = dynamic_cast<Property_map<Key_type, Value_type>*>(destination_base);
+    if (destination == nullptr) {
+        return;
+    }
+    destination->recount_present();
+}
+
+template <typename Key_type, typename Value_type>
+inline void
+Property_map<Key_type, Value_type>::interpolate_range(
+    Property_map_base<Key_type>*         destination_base,
+    const Interpolation_table<Key_type>& key_new_to_olds,
+    const std::size_t                    key_begin,
+    const std::size_t                    key_end
 ) const
 {
     ERHE_PROFILE_FUNCTION();
@@ -174,20 +409,25 @@ Property_map<Key_type, Value_type>::interpolate(
         return;
     }
 
+    const std::span<const uint32_t> offsets  = key_new_to_olds.get_offsets();
+    const std::span<const float>    weights  = key_new_to_olds.get_weights();
+    const std::span<const Key_type> old_keys = key_new_to_olds.get_old_keys();
+
     for (
-        std::size_t new_key = 0, end = key_new_to_olds.size();
+        std::size_t new_key = key_begin, end = std::min(key_end, key_new_to_olds.key_count());
         new_key < end;
         ++new_key
     ) {
-        const std::vector<std::pair<float, Key_type>>& old_keys = key_new_to_olds[new_key];
+        const uint32_t begin_source = offsets[new_key];
+        const uint32_t end_source   = offsets[new_key + 1];
 
         SPDLOG_LOGGER_TRACE(log_interpolate, "\tkey = {} from", new_key);
         float sum_weights{0.0f};
-        for (auto j : old_keys) {
-            const Key_type old_key = j.second;
-            SPDLOG_LOGGER_TRACE(log_interpolate, "\t\told key {} weight {}", static_cast<unsigned int>(old_key), static_cast<float>(j.first));
+        for (uint32_t j = begin_source; j < end_source; ++j) {
+            const Key_type old_key = old_keys[j];
+            SPDLOG_LOGGER_TRACE(log_interpolate, "\t\told key {} weight {}", static_cast<unsigned int>(old_key), weights[j]);
             if (has(old_key)) {
-                sum_weights += j.first;
+                sum_weights += weights[j];
             }
         }
 
@@ -199,9 +439,9 @@ Property_map<Key_type, Value_type>::interpolate(
         Value_type new_value(0);
         // TODO
         if constexpr (!std::is_same_v<Value_type, glm::uvec4>) {
-            for (auto j : old_keys) {
-                const float    weight  = j.first;
-                const Key_type old_key = j.second;
+            for (uint32_t j = begin_source; j < end_source; ++j) {
+                const float    weight  = weights[j];
+                const Key_type old_key = old_keys[j];
 
                 if (has(old_key)) {
                     const Value_type old_value = get(old_key);
@@ -236,7 +476,9 @@ Property_map<Key_type, Value_type>::interpolate(
 
         SPDLOG_LOGGER_TRACE(log_interpolate, "\tvalue = {}", new_value);
 
-        destination->put(static_cast<Key_type>(new_key), new_value);
+        // Storage is sized by begin_interpolate(); presence is counted by end_interpolate()
+        destination->values[new_key] = new_value;
+        destination->m_present[new_key / s_word_bits] |= uint64_t{1} << (new_key % s_word_bits);
     }
 }
 
@@ -268,6 +510,57 @@ template <>           struct transform_properties<glm::vec2> { static const bool
 template <>           struct transform_properties<glm::vec3> { static const bool is_transformable = true;  };
 template <>           struct transform_properties<glm::vec4> { static const bool is_transformable = true;  };
 
+// Writes transformed in to out. vec3 and vec4 values use the batch kernels
+// from transform_kernels.hpp; in and out may be the same span.
+template <typename Value_type>
+inline void transform_values(
+    const Transform_mode              transform_mode,
+    const glm::mat4&                  transform,
+    const std::span<const Value_type> in,
+    const std::span<Value_type>       out
+)
+{
+    switch (transform_mode) {
+        //using enum Transform_mode;
+        default:
+        case Transform_mode::none: {
+            if (in.data() != out.data()) {
+                std::copy(in.begin(), in.end(), out.begin());
+            }
+            break;
+        }
+
+        case Transform_mode::position: {
+            if constexpr (std::is_same_v<Value_type, glm::vec3> || std::is_same_v<Value_type, glm::vec4>) {
+                transform_points(transform, in, out);
+            } else {
+                for (std::size_t i = 0, end = in.size(); i < end; ++i) {
+                    out[i] = apply_transform(in[i], transform, 1.0f);
+                }
+            }
+            break;
+        }
+
+        case Transform_mode::direction: {
+            if constexpr (std::is_same_v<Value_type, glm::vec3>) {
+                transform_directions(direction_transform(transform), in, out);
+            } else if (in.data() != out.data()) {
+                std::copy(in.begin(), in.end(), out.begin());
+            }
+            break;
+        }
+
+        case Transform_mode::direction_vec3_float: {
+            if constexpr (std::is_same_v<Value_type, glm::vec4>) {
+                transform_directions(direction_transform(transform), in, out);
+            } else if (in.data() != out.data()) {
+                std::copy(in.begin(), in.end(), out.begin());
+            }
+            break;
+        }
+    }
+}
+
 template <typename Key_type, typename Value_type>
 inline void
 Property_map<Key_type, Value_type>::import_from(
@@ -282,13 +575,10 @@ Property_map<Key_type, Value_type>::import_from(
         return;
     }
 
-    ERHE_VERIFY(values.size() == present.size());
-    ERHE_VERIFY(source->values.size() == source->present.size());
-
-    values .reserve(values.size()  + source->values.size());
-    present.reserve(present.size() + source->present.size());
-    present.insert(present.end(), source->present.begin(), source->present.end());
+    const std::size_t offset = values.size();
     values.insert(values.end(), source->values.begin(), source->values.end());
+    m_present.resize((values.size() + s_word_bits - 1) / s_word_bits, 0);
+    append_present(*source, offset);
 }
 
 template <typename Key_type, typename Value_type>
@@ -299,62 +589,13 @@ Property_map<Key_type, Value_type>::transform(
 {
     ERHE_PROFILE_FUNCTION();
 
-    ERHE_VERIFY(values.size() == present.size());
-
     if constexpr(transform_properties<Value_type>::is_transformable) {
-        switch (m_descriptor.transform_mode) {
-            //using enum Transform_mode;
-            default:
-            case Transform_mode::none: {
-                break;
-            }
-
-            case Transform_mode::position: {
-                for (std::size_t i = 0, end = values.size(); i < end; ++i) {
-                    values[i] = apply_transform(values[i], transform, 1.0f);
-                }
-                break;
-            }
-
-            // TODO Use cofactor matrix for bivectors?
-            case Transform_mode::direction: {
-                if constexpr (std::is_same_v<Value_type, glm::vec3>) {
-                    const glm::mat4 inverse_transpose_transform = glm::inverse(glm::transpose(transform));
-                    for (std::size_t i = 0, end = values.size(); i < end; ++i) {
-                        values[i] = glm::normalize(
-                            apply_transform(
-                                values[i],
-                                inverse_transpose_transform,
-                                0.0f
-                            )
-                        );
-                    }
-                }
-                break;
-            }
-
-            // TODO Use cofactor matrix for bivectors?
-            case Transform_mode::direction_vec3_float: {
-                if constexpr (std::is_same_v<Value_type, glm::vec4>) {
-                    const glm::mat4 inverse_transpose_transform = glm::inverse(glm::transpose(transform));
-                    for (std::size_t i = 0, end = values.size(); i < end; ++i) {
-                        values[i] = glm::vec4{
-                            glm::normalize(
-                                apply_transform(
-                                    glm::vec3{
-                                        values[i]
-                                    },
-                                    inverse_transpose_transform,
-                                    0.0f
-                                )
-                            ),
-                            values[i].w
-                        };
-                    }
-                }
-                break;
-            }
-        }
+        transform_values(
+            m_descriptor.transform_mode,
+            transform,
+            std::span<const Value_type>{values},
+            std::span<Value_type>{values}
+        );
     }
 }
 
@@ -373,62 +614,20 @@ Property_map<Key_type, Value_type>::import_from(
         return;
     }
 
-    ERHE_VERIFY(values.size() == present.size());
-    ERHE_VERIFY(source->values.size() == source->present.size());
-
-    const auto combined_values_size = values.size()  + source->values.size();
-    const auto combined_present_size = present.size() + source->present.size();
-    values .reserve(combined_values_size);
-    present.reserve(combined_present_size);
-    present.insert(present.end(), source->present.begin(), source->present.end());
+    const std::size_t offset = values.size();
     if constexpr(!transform_properties<Value_type>::is_transformable) {
         values.insert(values.end(), source->values.begin(), source->values.end());
     } else {
-        switch (m_descriptor.transform_mode) {
-            //using enum Transform_mode;
-            default:
-            case Transform_mode::none: {
-                values.insert(values.end(), source->values.begin(), source->values.end());
-                break;
-            }
-
-            case Transform_mode::position: {
-                for (std::size_t i = 0, end = source->values.size(); i < end; ++i) {
-                    const Value_type source_value = source->values[i];
-                    const Value_type result       = apply_transform(source_value, transform, 1.0f);
-                    values.push_back(result);
-                }
-                break;
-            }
-
-            // TODO Use cofactor matrix for bivectors?
-            case Transform_mode::direction: {
-                if constexpr (std::is_same_v<Value_type, glm::vec3>) {
-                    const glm::mat4 inverse_transpose_transform = glm::inverse(glm::transpose(transform));
-                    for (std::size_t i = 0, end = source->values.size(); i < end; ++i) {
-                        const Value_type source_value = source->values[i];
-                        const Value_type result       = glm::normalize(apply_transform(source_value, inverse_transpose_transform, 0.0f));
-                        values.push_back(result);
-                    }
-                }
-                break;
-            }
-
-            // TODO Use cofactor matrix for bivectors?
-            case Transform_mode::direction_vec3_float: {
-                if constexpr (std::is_same_v<Value_type, glm::vec4>) {
-                    const glm::mat4 inverse_transpose_transform = glm::inverse(glm::transpose(transform));
-                    for (std::size_t i = 0, end = source->values.size(); i < end; ++i) {
-                        const Value_type source_value     = source->values[i];
-                        const glm::vec3  transformed_vec3 = glm::normalize(apply_transform(glm::vec3{source_value}, inverse_transpose_transform, 0.0f));
-                        const Value_type result           = glm::vec4{transformed_vec3, source_value.w};
-                        values.push_back(result);
-                    }
-                }
-                break;
-            }
-        }
+        values.resize(offset + source->values.size());
+        transform_values(
+            m_descriptor.transform_mode,
+            transform,
+            std::span<const Value_type>{source->values},
+            std::span<Value_type>{values}.subspan(offset)
+        );
     }
+    m_present.resize((values.size() + s_word_bits - 1) / s_word_bits, 0);
+    append_present(*source, offset);
 }
 
 } // namespace erhe::geometry
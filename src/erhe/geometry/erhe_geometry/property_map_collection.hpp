@@ -2,8 +2,11 @@
 
 #include "erhe_geometry/property_map.hpp"
 
+#include <array>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace erhe::geometry
 {
@@ -50,6 +53,15 @@ private:
     using Collection_type = std::vector<Entry>;
 
 public:
+    Property_map_collection() = default;
+    ~Property_map_collection() noexcept = default;
+
+    Property_map_collection(const Property_map_collection&) = delete;
+    void operator=         (const Property_map_collection&) = delete;
+
+    Property_map_collection(Property_map_collection&& other) noexcept;
+    auto operator=         (Property_map_collection&& other) noexcept -> Property_map_collection&;
+
     void clear();
 
     auto size() const -> size_t;
@@ -61,6 +73,10 @@ public:
 
     void insert(Property_map_base<Key_type>* map);
 
+    // Calls callback(Property_map_base<Key_type>*) for each property map, in insertion order
+    template <typename Callback>
+    void for_each(Callback&& callback) const;
+
     void remove(const std::string& name);
 
     template <typename Value_type>
@@ -83,17 +99,34 @@ public:
     void trim      (size_t size);
     void remap_keys(const std::vector<Key_type>& key_new_to_old);
     void interpolate(
-        Property_map_collection<Key_type>&                          destination,
-        const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds
+        Property_map_collection<Key_type>&   destination,
+        const Interpolation_table<Key_type>& key_new_to_olds
     );
 
+    // Creates destination maps for interpolate(), and returns them paired
+    // with their source maps. Property maps without interpolation are skipped.
+    [[nodiscard]] auto make_interpolation_targets(
+        Property_map_collection<Key_type>& destination
+    ) -> std::vector<std::pair<Property_map_base<Key_type>*, Property_map_base<Key_type>*>>;
+
     void merge_to            (Property_map_collection<Key_type>& source, const glm::mat4 transform);
     auto clone               () -> Property_map_collection<Key_type>;
     void transform           (const glm::mat4 matrix);
     auto clone_with_transform(const glm::mat4 matrix) -> Property_map_collection<Key_type>;
 
 private:
+    void add_entry    (Property_map_base<Key_type>* map);
+    void rebuild_slots();
+
+    [[nodiscard]] static auto is_builtin(const Property_map_descriptor& descriptor) -> bool;
+    [[nodiscard]] static auto get_slot  (const Property_map_descriptor& descriptor) -> Property_map_id;
+
     Collection_type m_entries;
+
+    // Built-in property maps by Property_map_descriptor::id. Points to the
+    // first entry with that id, or with the name of that built-in property
+    // map; other user defined property maps are not slotted.
+    std::array<Property_map_base<Key_type>*, c_property_map_slot_count> m_slots{};
 };
 
 } // namespace erhe::geometry
@@ -22,6 +22,72 @@
 namespace erhe::geometry
 {
 
+template <typename Key_type>
+inline Property_map_collection<Key_type>::Property_map_collection(Property_map_collection&& other) noexcept
+    : m_entries{std::move(other.m_entries)}
+    , m_slots  {other.m_slots}
+{
+    other.m_entries.clear();
+    other.m_slots.fill(nullptr);
+}
+
+template <typename Key_type>
+inline auto
+Property_map_collection<Key_type>::operator=(Property_map_collection&& other) noexcept -> Property_map_collection&
+{
+    if (this != &other) {
+        m_entries = std::move(other.m_entries);
+        m_slots   = other.m_slots;
+        other.m_entries.clear();
+        other.m_slots.fill(nullptr);
+    }
+    return *this;
+}
+
+template <typename Key_type>
+inline auto
+Property_map_collection<Key_type>::is_builtin(const Property_map_descriptor& descriptor) -> bool
+{
+    return descriptor.id < c_property_map_slot_count;
+}
+
+template <typename Key_type>
+inline auto
+Property_map_collection<Key_type>::get_slot(const Property_map_descriptor& descriptor) -> Property_map_id
+{
+    // User defined descriptor may reuse a built-in name; name lookups and
+    // slot lookups must find the same property map
+    return is_builtin(descriptor)
+        ? descriptor.id
+        : get_builtin_property_map_id(descriptor.name);
+}
+
+template <typename Key_type>
+inline void
+Property_map_collection<Key_type>::add_entry(Property_map_base<Key_type>* map)
+{
+    const Property_map_descriptor& descriptor = map->descriptor();
+    m_entries.emplace_back(descriptor.name, map);
+    const Property_map_id slot = get_slot(descriptor);
+    if ((slot < c_property_map_slot_count) && (m_slots[slot] == nullptr)) {
+        m_slots[slot] = map;
+    }
+    SPDLOG_LOGGER_TRACE(log_attribute_maps, "Added attribute map {}", descriptor.name);
+}
+
+template <typename Key_type>
+inline void
+Property_map_collection<Key_type>::rebuild_slots()
+{
+    m_slots.fill(nullptr);
+    for (const auto& entry : m_entries) {
+        const Property_map_id slot = get_slot(entry.value->descriptor());
+        if ((slot < c_property_map_slot_count) && (m_slots[slot] == nullptr)) {
+            m_slots[slot] = entry.value.get();
+        }
+    }
+}
+
 template <typename Key_type>
 inline void
 Property_map_collection<Key_type>::clear()
@@ -29,6 +95,7 @@ Property_map_collection<Key_type>::clear()
     ERHE_PROFILE_FUNCTION();
 
     m_entries.clear();
+    m_slots.fill(nullptr);
 }
 
 template <typename Key_type>
@@ -44,12 +111,17 @@ Property_map_collection<Key_type>::insert(Property_map_base<Key_type>* map)
 {
     ERHE_PROFILE_FUNCTION();
 
-    //// for (const auto& entry : m_entries)
-    //// {
-    ////     ERHE_VERIFY(entry.key != map->descriptor().name);
-    //// }
-    m_entries.emplace_back(map->descriptor().name, map);
-    SPDLOG_LOGGER_TRACE(log_attribute_maps, "Added attribute map {}", map->descriptor().name);
+    add_entry(map);
+}
+
+template <typename Key_type>
+template <typename Callback>
+inline void
+Property_map_collection<Key_type>::for_each(Callback&& callback) const
+{
+    for (const auto& entry : m_entries) {
+        callback(entry.value.get());
+    }
 }
 
 template <typename Key_type>
@@ -62,12 +134,13 @@ Property_map_collection<Key_type>::remove(const std::string& name)
         std::remove_if(
             m_entries.begin(),
             m_entries.end(),
-            [name](const Entry& entry) {
+            [&name](const Entry& entry) {
                 return entry.key == name;
             }
         ),
         m_entries.end()
     );
+    rebuild_slots();
 }
 
 template <typename Key_type>
@@ -96,6 +169,10 @@ Property_map_collection<Key_type>::find_base(
 {
     ERHE_PROFILE_FUNCTION();
 
+    if (is_builtin(descriptor)) {
+        return m_slots[descriptor.id];
+    }
+
     for (const auto& entry : m_entries) {
         if (entry.key == descriptor.name) {
             return entry.value.get();
@@ -113,15 +190,8 @@ Property_map_collection<Key_type>::create(
 {
     ERHE_PROFILE_FUNCTION();
 
-    //// for (const auto& entry : m_entries)
-    //// {
-    ////     ERHE_VERIFY(entry.key != descriptor.name);
-    //// }
-
     const auto p = new Property_map<Key_type, Value_type>(descriptor);
-    m_entries.emplace_back(descriptor.name, p);
-    SPDLOG_LOGGER_TRACE(log_attribute_maps, "Added attribute map {}", descriptor.name);
-
+    add_entry(p);
     return p;
 }
 
@@ -134,6 +204,18 @@ Property_map_collection<Key_type>::find(
 {
     ERHE_PROFILE_FUNCTION();
 
+    if (is_builtin(descriptor)) {
+        Property_map_base<Key_type>* const p = m_slots[descriptor.id];
+        if (p == nullptr) {
+            return nullptr;
+        }
+        const auto typed_p = dynamic_cast<Property_map<Key_type, Value_type>*>(p);
+        if (typed_p != nullptr) {
+            return typed_p;
+        }
+        // Same descriptor with another value type - fall through to full scan
+    }
+
     for (const auto& entry : m_entries) {
         if (entry.key == descriptor.name) {
             const auto p       = entry.value.get();
@@ -155,21 +237,12 @@ Property_map_collection<Key_type>::find_or_create(
 {
     ERHE_PROFILE_FUNCTION();
 
-    for (const auto& entry : m_entries) {
-        if (entry.key == descriptor.name) {
-            const auto p       = entry.value.get();
-            const auto typed_p = dynamic_cast<Property_map<Key_type, Value_type>*>(p);
-            if (typed_p != nullptr) {
-                return typed_p;
-            }
-        }
+    Property_map<Key_type, Value_type>* const existing = find<Value_type>(descriptor);
+    if (existing != nullptr) {
+        return existing;
     }
 
-    // New entry
-    const auto p = new Property_map<Key_type, Value_type>(descriptor);
-    m_entries.emplace_back(descriptor.name, p);
-    SPDLOG_LOGGER_TRACE(log_attribute_maps, "Added attribute map {}", descriptor.name);
-    return p;
+    return create<Value_type>(descriptor);
 }
 
 template <typename Key_type>
@@ -197,11 +270,25 @@ Property_map_collection<Key_type>::remap_keys(const std::vector<Key_type>& key_n
 template <typename Key_type>
 inline void
 Property_map_collection<Key_type>::interpolate(
-    Property_map_collection<Key_type>&                          destination,
-    const std::vector<std::vector<std::pair<float, Key_type>>>& key_new_to_olds)
+    Property_map_collection<Key_type>&   destination,
+    const Interpolation_table<Key_type>& key_new_to_olds)
 {
     ERHE_PROFILE_FUNCTION();
 
+    for (const auto& [src_map, destination_map] : make_interpolation_targets(destination)) {
+        SPDLOG_LOGGER_TRACE(log_interpolate, "interpolating {}", src_map->descriptor().name);
+        src_map->interpolate(destination_map, key_new_to_olds);
+    }
+}
+
+template <typename Key_type>
+inline auto
+Property_map_collection<Key_type>::make_interpolation_targets(
+    Property_map_collection<Key_type>& destination
+) -> std::vector<std::pair<Property_map_base<Key_type>*, Property_map_base<Key_type>*>>
+{
+    std::vector<std::pair<Property_map_base<Key_type>*, Property_map_base<Key_type>*>> result;
+    result.reserve(m_entries.size());
     for (auto& entry : m_entries) {
         Property_map_base<Key_type>* src_map    = entry.value.get();
         const auto&                  descriptor = src_map->descriptor();
@@ -209,12 +296,10 @@ Property_map_collection<Key_type>::interpolate(
             continue;
         }
         Property_map_base<Key_type>* destination_map = src_map->constructor(descriptor);
-
-        SPDLOG_LOGGER_TRACE(log_interpolate, "interpolating {}", src_map->descriptor().name);
-        src_map->interpolate(destination_map, key_new_to_olds);
-
         destination.insert(destination_map);
+        result.emplace_back(src_map, destination_map);
     }
+    return result;
 }
 
 template <typename Key_type>
@@ -68,7 +68,7 @@ auto make_box(
             geometry.compute_polygon_corner_texcoords(corner_texcoords);
             geometry.compute_polygon_normals();
             geometry.compute_polygon_centroids();
-            geometry.compute_tangents(true, true, false, false, true, true);
+            geometry.compute_tangents({.override_existing = true});
         }
     };
 }
@@ -108,7 +108,7 @@ auto make_box(
             geometry.compute_polygon_corner_texcoords(corner_texcoords);
             geometry.compute_polygon_normals();
             geometry.compute_polygon_centroids();
-            geometry.compute_tangents(true, true, false, false, true, true);
+            geometry.compute_tangents({.override_existing = true});
         }
     };
 }
@@ -46,7 +46,7 @@ auto make_cuboctahedron(const double r) -> Geometry
             geometry.make_point_corners();
             geometry.build_edges();
             geometry.generate_polygon_texture_coordinates(true);
-            geometry.compute_tangents(true, true, false, false, true, true);
+            geometry.compute_tangents({.override_existing = true});
         }
     };
 }
@@ -100,7 +100,7 @@ auto make_dodecahedron(const double r) -> Geometry
             geometry.make_point_corners();
             geometry.build_edges();
             geometry.generate_polygon_texture_coordinates(true);
-            geometry.compute_tangents(true, true, false, false, true, true);
+            geometry.compute_tangents({.override_existing = true});
         }
     };
 }
@@ -154,7 +154,7 @@ auto make_icosahedron(const double r) -> Geometry
             geometry.make_point_corners();
             geometry.build_edges();
             geometry.generate_polygon_texture_coordinates(true);
-            geometry.compute_tangents(true, true, false, false, true, true);
+            geometry.compute_tangents({.override_existing = true});
         }
     };
 }
@@ -185,7 +185,7 @@ auto make_octahedron(const double r) -> Geometry
             geometry.make_point_corners();
             geometry.build_edges();
             geometry.generate_polygon_texture_coordinates(true);
-            geometry.compute_tangents(true, true, false, false, true, true);
+            geometry.compute_tangents({.override_existing = true});
         }
     };
 }
@@ -213,7 +213,7 @@ auto make_tetrahedron(double r) -> Geometry
             geometry.make_point_corners();
             geometry.build_edges();
             geometry.generate_polygon_texture_coordinates(true);
-            geometry.compute_tangents(true, true, false, false, true, true);
+            geometry.compute_tangents({.override_existing = true});
         }
     };
 }
@@ -251,7 +251,7 @@ auto make_cube(const double r) -> Geometry
             //geometry.generate_polygon_texture_coordinates(true);
             geometry.compute_polygon_normals();
             geometry.compute_polygon_centroids();
-            geometry.compute_tangents(true, true, false, false, true, true);
+            geometry.compute_tangents({.override_existing = true});
         }
     };
 }
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <span>
+
+namespace erhe::geometry
+{
+
+// Batch transforms for property map values.
+//
+// Values are processed in blocks of c_transform_block_size. Each block is
+// loaded from array of structures to local structure of arrays, transformed
+// with lane loops that have no dependencies between lanes, and stored back.
+// The lane loops are vectorized by the compiler for the target instruction
+// set. Remaining values are transformed one at a time with the same
+// arithmetic, so results do not depend on position within the array.
+//
+// Input and output may be the same span.
+
+inline constexpr std::size_t c_transform_block_size = 8;
+
+// Matrix for transforming normals and other direction vectors by m:
+// cofactor of the upper 3x3 of m, negated when the determinant is negative.
+// Direction matches inverse transpose, and it exists for singular matrices.
+[[nodiscard]] inline auto direction_transform(const glm::mat4& m) -> glm::mat3
+{
+    const glm::vec3 c0 {m[0]};
+    const glm::vec3 c1 {m[1]};
+    const glm::vec3 c2 {m[2]};
+    const glm::vec3 r0 = glm::cross(c1, c2);
+    const glm::vec3 r1 = glm::cross(c2, c0);
+    const glm::vec3 r2 = glm::cross(c0, c1);
+    const float     s  = (glm::dot(c0, r0) < 0.0f) ? -1.0f : 1.0f;
+    return glm::mat3{s * r0, s * r1, s * r2};
+}
+
+// out[i] = vec3{m * vec4{in[i], 1}}
+inline void transform_points(
+    const glm::mat4&                 m,
+    const std::span<const glm::vec3> in,
+    const std::span<glm::vec3>       out
+)
+{
+    assert(out.size() >= in.size());
+
+    const float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+    const float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+    const float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+    const float m30 = m[3][0], m31 = m[3][1], m32 = m[3][2];
+
+    constexpr std::size_t N = c_transform_block_size;
+    const std::size_t count = in.size();
+    std::size_t i = 0;
+    for (; i + N <= count; i += N) {
+        float x[N], y[N], z[N];
+        for (std::size_t l = 0; l < N; ++l) {
+            x[l] = in[i + l].x;
+            y[l] = in[i + l].y;
+            z[l] = in[i + l].z;
+        }
+        float rx[N], ry[N], rz[N];
+        for (std::size_t l = 0; l < N; ++l) {
+            rx[l] = m00 * x[l] + m10 * y[l] + m20 * z[l] + m30;
+            ry[l] = m01 * x[l] + m11 * y[l] + m21 * z[l] + m31;
+            rz[l] = m02 * x[l] + m12 * y[l] + m22 * z[l] + m32;
+        }
+        for (std::size_t l = 0; l < N; ++l) {
+            out[i + l] = glm::vec3{rx[l], ry[l], rz[l]};
+        }
+    }
+    for (; i < count; ++i) {
+        const glm::vec3 v = in[i];
+        out[i] = glm::vec3{
+            m00 * v.x + m10 * v.y + m20 * v.z + m30,
+            m01 * v.x + m11 * v.y + m21 * v.z + m31,
+            m02 * v.x + m12 * v.y + m22 * v.z + m32
+        };
+    }
+}
+
+// out[i] = m * in[i]
+inline void transform_points(
+    const glm::mat4&                 m,
+    const std::span<const glm::vec4> in,
+    const std::span<glm::vec4>       out
+)
+{
+    assert(out.size() >= in.size());
+
+    constexpr std::size_t N = c_transform_block_size;
+    const std::size_t count = in.size();
+    std::size_t i = 0;
+    for (; i + N <= count; i += N) {
+        float x[N], y[N], z[N], w[N];
+        for (std::size_t l = 0; l < N; ++l) {
+            x[l] = in[i + l].x;
+            y[l] = in[i + l].y;
+            z[l] = in[i + l].z;
+            w[l] = in[i + l].w;
+        }
+        float r[4][N];
+        for (int c = 0; c < 4; ++c) {
+            const float mx = m[0][c], my = m[1][c], mz = m[2][c], mw = m[3][c];
+            for (std::size_t l = 0; l < N; ++l) {
+                r[c][l] = mx * x[l] + my * y[l] + mz * z[l] + mw * w[l];
+            }
+        }
+        for (std::size_t l = 0; l < N; ++l) {
+            out[i + l] = glm::vec4{r[0][l], r[1][l], r[2][l], r[3][l]};
+        }
+    }
+    for (; i < count; ++i) {
+        const glm::vec4 v = in[i];
+        glm::vec4 result;
+        for (int c = 0; c < 4; ++c) {
+            result[c] = m[0][c] * v.x + m[1][c] * v.y + m[2][c] * v.z + m[3][c] * v.w;
+        }
+        out[i] = result;
+    }
+}
+
+namespace detail {
+
+template <std::size_t N>
+inline void transform_normalize_block(
+    const glm::mat3& n,
+    const float      (&x)[N],
+    const float      (&y)[N],
+    const float      (&z)[N],
+    float            (&rx)[N],
+    float            (&ry)[N],
+    float            (&rz)[N]
+)
+{
+    const float n00 = n[0][0], n01 = n[0][1], n02 = n[0][2];
+    const float n10 = n[1][0], n11 = n[1][1], n12 = n[1][2];
+    const float n20 = n[2][0], n21 = n[2][1], n22 = n[2][2];
+    for (std::size_t l = 0; l < N; ++l) {
+        const float tx = n00 * x[l] + n10 * y[l] + n20 * z[l];
+        const float ty = n01 * x[l] + n11 * y[l] + n21 * z[l];
+        const float tz = n02 * x[l] + n12 * y[l] + n22 * z[l];
+        const float s  = 1.0f / std::sqrt(tx * tx + ty * ty + tz * tz);
+        rx[l] = tx * s;
+        ry[l] = ty * s;
+        rz[l] = tz * s;
+    }
+}
+
+} // namespace detail
+
+// out[i] = normalize(n * in[i]), where n is from direction_transform()
+inline void transform_directions(
+    const glm::mat3&                 n,
+    const std::span<const glm::vec3> in,
+    const std::span<glm::vec3>       out
+)
+{
+    assert(out.size() >= in.size());
+
+    constexpr std::size_t N = c_transform_block_size;
+    const std::size_t count = in.size();
+    std::size_t i = 0;
+    for (; i + N <= count; i += N) {
+        float x[N], y[N], z[N];
+        for (std::size_t l = 0; l < N; ++l) {
+            x[l] = in[i + l].x;
+            y[l] = in[i + l].y;
+            z[l] = in[i + l].z;
+        }
+        float rx[N], ry[N], rz[N];
+        detail::transform_normalize_block<N>(n, x, y, z, rx, ry, rz);
+        for (std::size_t l = 0; l < N; ++l) {
+            out[i + l] = glm::vec3{rx[l], ry[l], rz[l]};
+        }
+    }
+    for (; i < count; ++i) {
+        float x[1]{in[i].x}, y[1]{in[i].y}, z[1]{in[i].z};
+        float rx[1], ry[1], rz[1];
+        detail::transform_normalize_block<1>(n, x, y, z, rx, ry, rz);
+        out[i] = glm::vec3{rx[0], ry[0], rz[0]};
+    }
+}
+
+// out[i] = vec4{normalize(n * vec3{in[i]}), in[i].w}, for tangents with
+// handedness in w. n is from direction_transform().
+inline void transform_directions(
+    const glm::mat3&                 n,
+    const std::span<const glm::vec4> in,
+    const std::span<glm::vec4>       out
+)
+{
+    assert(out.size() >= in.size());
+
+    constexpr std::size_t N = c_transform_block_size;
+    const std::size_t count = in.size();
+    std::size_t i = 0;
+    for (; i + N <= count; i += N) {
+        float x[N], y[N], z[N], w[N];
+        for (std::size_t l = 0; l < N; ++l) {
+            x[l] = in[i + l].x;
+            y[l] = in[i + l].y;
+            z[l] = in[i + l].z;
+            w[l] = in[i + l].w;
+        }
+        float rx[N], ry[N], rz[N];
+        detail::transform_normalize_block<N>(n, x, y, z, rx, ry, rz);
+        for (std::size_t l = 0; l < N; ++l) {
+            out[i + l] = glm::vec4{rx[l], ry[l], rz[l], w[l]};
+        }
+    }
+    for (; i < count; ++i) {
+        float x[1]{in[i].x}, y[1]{in[i].y}, z[1]{in[i].z};
+        const float w = in[i].w;
+        float rx[1], ry[1], rz[1];
+        detail::transform_normalize_block<1>(n, x, y, z, rx, ry, rz);
+        out[i] = glm::vec4{rx[0], ry[0], rz[0], w};
+    }
+}
+
+} // namespace erhe::geometry
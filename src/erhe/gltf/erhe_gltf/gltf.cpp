@@ -391,7 +391,8 @@ public:
         Image_transfer&                           image_transfer,
         const std::shared_ptr<erhe::scene::Node>& root_node,
         erhe::scene::Layer_id                     mesh_layer_id,
-        std::filesystem::path                     path
+        std::filesystem::path                     path,
+        erhe::concurrency::Thread_pool*           thread_pool
     )
         : m_data_out         {gltf_data}
         , m_graphics_instance{graphics_instance}
@@ -399,6 +400,7 @@ public:
         , m_root_node        {root_node}
         , m_mesh_layer_id    {mesh_layer_id}
         , m_path             {path}
+        , m_thread_pool      {thread_pool}
     {
         if (!open(path)) {
             return;
@@ -1039,9 +1041,13 @@ private:
     class Primitive_to_geometry
     {
     public:
-        explicit Primitive_to_geometry(const cgltf_primitive* primitive)
-            : primitive{primitive}
-            , geometry {std::make_shared<erhe::geometry::Geometry>()}
+        Primitive_to_geometry(
+            const cgltf_primitive*          primitive,
+            erhe::concurrency::Thread_pool* thread_pool
+        )
+            : primitive  {primitive}
+            , thread_pool{thread_pool}
+            , geometry   {std::make_shared<erhe::geometry::Geometry>()}
         {
             std::unordered_map<cgltf_attribute_type, cgltf_int> attribute_max_index;
             for (cgltf_size i = 0; i < primitive->attributes_count; ++i) {
@@ -1092,8 +1098,8 @@ private:
                 }
             }
             parse_vertex_data();
-            geometry->make_point_corners();
-            geometry->build_edges();
+            geometry->make_point_corners(thread_pool);
+            geometry->build_edges(true, thread_pool);
         }
         void get_used_indices()
         {
@@ -1439,6 +1445,7 @@ private:
         }
 
         const cgltf_primitive*                    primitive                {nullptr};
+        erhe::concurrency::Thread_pool*           thread_pool              {nullptr};
         std::shared_ptr<erhe::geometry::Geometry> geometry                 {};
         cgltf_size                                min_index                {0};
         cgltf_size                                max_index                {0};
@@ -1472,13 +1479,13 @@ private:
     std::vector<Geometry_entry> m_geometries;
     void load_new_primitive_geometry(const cgltf_primitive* primitive, Geometry_entry& geometry_entry)
     {
-        Primitive_to_geometry primitive_to_geometry{primitive};
+        Primitive_to_geometry primitive_to_geometry{primitive, m_thread_pool};
         geometry_entry.geometry = primitive_to_geometry.geometry;
         if (primitive_to_geometry.corner_tangents.empty()) {
             if (primitive_to_geometry.corner_texcoords.empty()) {
                 primitive_to_geometry.geometry->generate_polygon_texture_coordinates();
             }
-            primitive_to_geometry.geometry->compute_tangents();
+            primitive_to_geometry.geometry->compute_tangents({}, m_thread_pool);
         }
         geometry_entry.geometry_primitive = std::make_shared<erhe::primitive::Geometry_primitive>(
             geometry_entry.geometry
@@ -1660,6 +1667,7 @@ private:
     std::shared_ptr<erhe::scene::Node> m_root_node;
     erhe::scene::Layer_id              m_mesh_layer_id;
     std::filesystem::path              m_path;
+    erhe::concurrency::Thread_pool*    m_thread_pool{nullptr};
     std::string                        m_file_contents; // GLB needs file contents in memory
     cgltf_data*                        m_data{nullptr};
 };
@@ -1669,11 +1677,12 @@ auto parse_gltf(
     Image_transfer&                           image_transfer,
     const std::shared_ptr<erhe::scene::Node>& root_node,
     erhe::scene::Layer_id                     mesh_layer_id,
-    std::filesystem::path                     path
+    std::filesystem::path                     path,
+    erhe::concurrency::Thread_pool*           thread_pool
 ) -> Gltf_data
 {
     Gltf_data result;
-    Gltf_parser parser{result, graphics_instance, image_transfer, root_node, mesh_layer_id, path};
+    Gltf_parser parser{result, graphics_instance, image_transfer, root_node, mesh_layer_id, path, thread_pool};
     parser.parse_and_build();
     return result;
 }
@@ -4,6 +4,9 @@
 #include <filesystem>
 #include <vector>
 
+namespace erhe::concurrency {
+    class Thread_pool;
+}
 namespace erhe::geometry {
     class Geometry;
 }
@@ -69,7 +72,8 @@ public:
     Image_transfer&                           image_transfer,
     const std::shared_ptr<erhe::scene::Node>& root_node,
     erhe::scene::Layer_id                     mesh_layer_id,
-    std::filesystem::path                     path
+    std::filesystem::path                     path,
+    erhe::concurrency::Thread_pool*           thread_pool = nullptr // used for geometry connectivity and tangents
 ) -> Gltf_data;
 
 [[nodiscard]] auto scan_gltf(std::filesystem::path path) -> Gltf_scan;
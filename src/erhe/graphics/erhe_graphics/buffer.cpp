@@ -249,6 +249,16 @@ auto Buffer::map() const -> gsl::span<std::byte>
     return m_map;
 }
 
+auto Buffer::is_persistently_mapped() const noexcept -> bool
+{
+    return
+        !m_map.empty() &&
+        erhe::bit::test_all_rhs_bits_set(
+            m_map_buffer_access_mask,
+            gl::Map_buffer_access_mask::map_persistent_bit
+        );
+}
+
 auto Buffer::target() const noexcept -> gl::Buffer_target
 {
     return m_target;
@@ -357,6 +367,7 @@ auto Buffer::map_all_bytes(
 ) noexcept -> gsl::span<std::byte>
 {
     Expects(m_map.empty());
+    ERHE_VERIFY(!is_persistently_mapped()); // Mapping again would lose persistent mapping in unmap()
     Expects(gl_name() != 0);
 
     log_buffer->trace(
@@ -404,6 +415,7 @@ auto Buffer::map_bytes(
 {
     ERHE_VERIFY(byte_count > 0);
     Expects(m_map.empty());
+    ERHE_VERIFY(!is_persistently_mapped()); // Mapping again would lose persistent mapping in unmap()
     Expects(gl_name() != 0);
 
     log_buffer->trace(
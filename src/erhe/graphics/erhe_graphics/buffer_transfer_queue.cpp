@@ -3,6 +3,8 @@
 #include "erhe_graphics/buffer_transfer_queue.hpp"
 #include "erhe_gl/enum_bit_mask_operators.hpp"
 #include "erhe_gl/enum_string_functions.hpp"
+#include "erhe_gl/wrapper_enums.hpp"
+#include "erhe_gl/wrapper_functions.hpp"
 #include "erhe_graphics/buffer.hpp"
 #include "erhe_graphics/graphics_log.hpp"
 #include "erhe_graphics/scoped_buffer_mapping.hpp"
@@ -11,9 +13,35 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+
 namespace erhe::graphics
 {
 
+namespace {
+
+// Blocks until GPU has completed all commands issued so far
+void wait_for_gpu_idle()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const GLsync fence = gl::fence_sync(gl::Sync_condition::sync_gpu_commands_complete, 0);
+    for (;;) {
+        const gl::Sync_status status = gl::client_wait_sync(
+            fence,
+            gl::Sync_object_mask::sync_flush_commands_bit,
+            1'000'000'000 // nanoseconds
+        );
+        if (status != gl::Sync_status::timeout_expired) {
+            ERHE_VERIFY(status != gl::Sync_status::wait_failed);
+            break;
+        }
+    }
+    gl::delete_sync(fence);
+}
+
+} // anonymous namespace
+
 Buffer_transfer_queue::Buffer_transfer_queue()
 {
 }
@@ -41,12 +69,54 @@ void Buffer_transfer_queue::enqueue(
     m_queued.emplace_back(buffer, offset, std::move(data));
 }
 
+void Buffer_transfer_queue::enqueue_flush(
+    Buffer&           buffer,
+    const std::size_t byte_offset,
+    const std::size_t byte_count
+)
+{
+    ERHE_VERIFY(buffer.is_persistently_mapped());
+
+    const std::lock_guard<std::mutex> lock{m_mutex};
+
+    SPDLOG_LOGGER_TRACE(
+        log_buffer,
+        "queued buffer {} flush offset = {} size = {}",
+        buffer.gl_name(),
+        byte_offset,
+        byte_count
+    );
+    m_queued_flushes.push_back(
+        Flush_entry{
+            .target      = &buffer,
+            .byte_offset = byte_offset,
+            .byte_count  = byte_count
+        }
+    );
+}
+
 void Buffer_transfer_queue::flush()
 {
     ERHE_PROFILE_FUNCTION();
 
     const std::lock_guard<std::mutex> lock{m_mutex};
 
+    // Queued transfers may overwrite data which is used by GPU commands
+    // still in flight. Unlike glMapBufferRange(), writes to persistently
+    // mapped memory are not synchronized by the driver, so wait for GPU
+    // before copying. Ranges written directly (enqueue_flush()) are freshly
+    // allocated and not used by GPU yet; they need no wait.
+    const bool has_persistent_target = std::any_of(
+        m_queued.begin(),
+        m_queued.end(),
+        [](const Transfer_entry& entry) {
+            return entry.target.is_persistently_mapped();
+        }
+    );
+    if (has_persistent_target) {
+        wait_for_gpu_idle();
+    }
+
     for (const auto& entry : m_queued) {
         SPDLOG_LOGGER_TRACE(
             log_buffer,
@@ -56,6 +126,21 @@ void Buffer_transfer_queue::flush()
             entry.target_offset,
             entry.data.size()
         );
+        // Persistently mapped buffer must not be mapped again, data is
+        // copied to the existing mapping and written range is flushed below
+        if (entry.target.is_persistently_mapped()) {
+            const gsl::span<std::byte> map = entry.target.map();
+            ERHE_VERIFY(entry.target_offset + entry.data.size() <= map.size_bytes());
+            memcpy(map.data() + entry.target_offset, entry.data.data(), entry.data.size());
+            m_queued_flushes.push_back(
+                Flush_entry{
+                    .target      = &entry.target,
+                    .byte_offset = entry.target_offset,
+                    .byte_count  = entry.data.size()
+                }
+            );
+            continue;
+        }
         Scoped_buffer_mapping<uint8_t> scoped_mapping{
             entry.target,
             entry.target_offset,
@@ -67,6 +152,45 @@ void Buffer_transfer_queue::flush()
         memcpy(destination.data(), entry.data.data(), entry.data.size());
     }
     m_queued.clear();
+
+    if (m_queued_flushes.empty()) {
+        return;
+    }
+
+    std::sort(
+        m_queued_flushes.begin(),
+        m_queued_flushes.end(),
+        [](const Flush_entry& lhs, const Flush_entry& rhs) {
+            if (lhs.target != rhs.target) {
+                return lhs.target->gl_name() < rhs.target->gl_name();
+            }
+            return lhs.byte_offset < rhs.byte_offset;
+        }
+    );
+
+    Flush_entry range = m_queued_flushes.front();
+    const auto flush_range = [](const Flush_entry& entry) {
+        SPDLOG_LOGGER_TRACE(
+            log_buffer,
+            "buffer flush {} offset = {} size = {}",
+            entry.target->gl_name(),
+            entry.byte_offset,
+            entry.byte_count
+        );
+        entry.target->flush_bytes(entry.byte_offset, entry.byte_count);
+    };
+    for (std::size_t i = 1, end = m_queued_flushes.size(); i < end; ++i) {
+        const Flush_entry& entry = m_queued_flushes[i];
+        const std::size_t range_end = range.byte_offset + range.byte_count;
+        if ((entry.target == range.target) && (entry.byte_offset <= range_end)) {
+            range.byte_count = std::max(range_end, entry.byte_offset + entry.byte_count) - range.byte_offset;
+            continue;
+        }
+        flush_range(range);
+        range = entry;
+    }
+    flush_range(range);
+    m_queued_flushes.clear();
 }
 
 } // namespace erhe::graphics
@@ -48,6 +48,14 @@ public:
         std::vector<uint8_t> data;
     };
 
+    class Flush_entry
+    {
+    public:
+        Buffer*     target     {nullptr};
+        std::size_t byte_offset{0};
+        std::size_t byte_count {0};
+    };
+
     void flush();
 
     void enqueue(
@@ -56,9 +64,18 @@ public:
         std::vector<uint8_t>&& data
     );
 
+    // For persistently mapped buffers which have been written to directly.
+    // flush() issues explicit flushes for these ranges, merging adjacent ranges.
+    void enqueue_flush(
+        Buffer&     buffer,
+        std::size_t byte_offset,
+        std::size_t byte_count
+    );
+
 private:
     std::mutex                  m_mutex;
     std::vector<Transfer_entry> m_queued;
+    std::vector<Flush_entry>    m_queued_flushes;
 };
 
 
@@ -13,6 +13,7 @@ namespace erhe::graphics
 class Fragment_outputs;
 class Shader_resource;
 class Vertex_attribute_mappings;
+class Vertex_format;
 class Gl_shader;
 
 class Shader_stage_extension
@@ -56,6 +57,7 @@ public:
     std::vector<const Shader_resource*>              struct_types             {};
     std::vector<const Shader_resource*>              interface_blocks         {};
     const Vertex_attribute_mappings*                 vertex_attribute_mappings{nullptr};
+    const Vertex_format*                             vertex_format            {nullptr}; // for decoding encoded attributes
     const Fragment_outputs*                          fragment_outputs         {nullptr};
     const Shader_resource*                           default_uniform_block    {nullptr}; // contains sampler uniforms
     std::vector<Shader_stage>                        shaders                  {};
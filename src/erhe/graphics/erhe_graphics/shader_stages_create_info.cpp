@@ -2,6 +2,7 @@
 #include "erhe_graphics/instance.hpp"
 #include "erhe_graphics/shader_stages.hpp"
 #include "erhe_graphics/vertex_attribute_mappings.hpp"
+#include "erhe_graphics/vertex_format.hpp"
 #include "erhe_file/file.hpp"
 #include "erhe_verify/verify.hpp"
 
@@ -32,6 +33,27 @@ auto glsl_token(gl::Attribute_type type) -> const char*
     }
 }
 
+namespace {
+
+// Inverse of encode_octahedral() in erhe_primitive/buffer_writer.cpp
+constexpr const char* c_decode_octahedral_source =
+    "vec3 erhe_decode_octahedral(vec2 e)\n"
+    "{\n"
+    "    vec3  v = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));\n"
+    "    float t = max(-v.z, 0.0);\n"
+    "    v.x += (v.x >= 0.0) ? -t : t;\n"
+    "    v.y += (v.y >= 0.0) ? -t : t;\n"
+    "    return normalize(v);\n"
+    "}\n"
+    "\n"
+    "vec4 erhe_decode_octahedral_tangent(vec4 e)\n"
+    "{\n"
+    "    return vec4(erhe_decode_octahedral(e.xy), (e.z < 0.0) ? -1.0 : 1.0);\n"
+    "}\n"
+    "\n";
+
+} // anonymous namespace
+
 auto Shader_stages_create_info::attributes_source() const -> std::string
 {
     std::stringstream sb;
@@ -41,14 +63,44 @@ auto Shader_stages_create_info::attributes_source() const -> std::string
         (vertex_attribute_mappings != nullptr) &&
         (vertex_attribute_mappings->mappings.size() > 0)
     ) {
+        // Encoded attributes are declared with their stored type and
+        // suffixed name, and the mapping name is defined to decode them.
+        // This keeps shader sources independent of vertex format.
+        std::stringstream decode_sb;
         sb << "// Attributes\n";
         for (const auto& mapping : vertex_attribute_mappings->mappings) {
+            const Vertex_attribute* attribute = (vertex_format != nullptr)
+                ? vertex_format->find_attribute_maybe(
+                    mapping.src_usage.type,
+                    static_cast<unsigned int>(mapping.src_usage.index)
+                )
+                : nullptr;
+            if (
+                (attribute != nullptr) &&
+                (attribute->data_type.encoding == Vertex_attribute::Encoding::octahedral)
+            ) {
+                const bool is_tangent = (mapping.shader_type == gl::Attribute_type::float_vec4);
+                sb << "in layout(location = " << mapping.layout_location << ") ";
+                sb << glsl_token(attribute->shader_type) << " ";
+                sb << mapping.name << "_octahedral;\n";
+                decode_sb << "#define " << mapping.name << " ";
+                decode_sb << (is_tangent ? "erhe_decode_octahedral_tangent(" : "erhe_decode_octahedral(");
+                decode_sb << mapping.name << "_octahedral)\n";
+                continue;
+            }
             sb << "in layout(location = " << mapping.layout_location << ") ";
             sb << glsl_token(mapping.shader_type) << " ";
             sb << mapping.name,
             sb << ";\n";
         }
         sb << "\n";
+        const std::string decode_source = decode_sb.str();
+        if (!decode_source.empty()) {
+            sb << "// Attribute decoding\n";
+            sb << c_decode_octahedral_source;
+            sb << decode_source;
+            sb << "\n";
+        }
     }
 
     return sb.str();
@@ -21,7 +21,8 @@ auto Vertex_attribute::Data_type::operator==(const Data_type& other) const -> bo
     return
         (type       == other.type)       &&
         (normalized == other.normalized) &&
-        (dimension  == other.dimension);
+        (dimension  == other.dimension)  &&
+        (encoding   == other.encoding);
 }
 
 auto Vertex_attribute::Data_type::operator!=(const Data_type& other) const -> bool
@@ -75,4 +76,13 @@ auto Vertex_attribute::desc(const Usage_type usage) -> const char*
     }
 }
 
+auto Vertex_attribute::desc(const Encoding encoding) -> const char*
+{
+    switch (encoding) {
+        case Encoding::none:       return "none";
+        case Encoding::octahedral: return "octahedral";
+        default:                   return "?";
+    }
+}
+
 } // namespace erhe::graphics
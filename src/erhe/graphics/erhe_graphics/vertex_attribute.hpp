@@ -39,6 +39,12 @@ public:
         std::size_t index{0};
     };
 
+    // How values are packed into data type components
+    enum class Encoding : unsigned int {
+        none       = 0,
+        octahedral = 1  // unit vector in two components, optional sign in third component
+    };
+
     // type, normalized, dimension -> dvec3 for example is double, false, 3
     class Data_type
     {
@@ -49,9 +55,11 @@ public:
         gl::Vertex_attrib_type type      {gl::Vertex_attrib_type::float_};
         bool                   normalized{false};
         std::size_t            dimension {0};
+        Encoding               encoding  {Encoding::none};
     };
 
     [[nodiscard]] static auto desc(Usage_type usage) -> const char*;
+    [[nodiscard]] static auto desc(Encoding encoding) -> const char*;
 
     [[nodiscard]] auto size      () const -> std::size_t;
     [[nodiscard]] auto operator==(const Vertex_attribute& other) const -> bool;
@@ -159,6 +167,38 @@ public:
             }
         };
     }
+    [[nodiscard]] static auto normal0_oct_short2() -> Vertex_attribute
+    {
+        return Vertex_attribute{
+            .usage = {
+                .type       = Usage_type::normal,
+                .index      = 0
+            },
+            .shader_type    = gl::Attribute_type::float_vec2,
+            .data_type = {
+                .type       = gl::Vertex_attrib_type::short_,
+                .normalized = true,
+                .dimension  = 2,
+                .encoding   = Encoding::octahedral
+            }
+        };
+    }
+    [[nodiscard]] static auto normal1_oct_short2() -> Vertex_attribute
+    {
+        return Vertex_attribute{
+            .usage = {
+                .type       = Usage_type::normal,
+                .index      = 1
+            },
+            .shader_type    = gl::Attribute_type::float_vec2,
+            .data_type = {
+                .type       = gl::Vertex_attrib_type::short_,
+                .normalized = true,
+                .dimension  = 2,
+                .encoding   = Encoding::octahedral
+            }
+        };
+    }
     [[nodiscard]] static auto tangent_float3() -> Vertex_attribute
     {
         return Vertex_attribute{
@@ -185,6 +225,22 @@ public:
             }
         };
     }
+    // xy: octahedral tangent, z: bitangent sign, w: unused (keeps 4 byte alignment)
+    [[nodiscard]] static auto tangent_oct_short4() -> Vertex_attribute
+    {
+        return Vertex_attribute{
+            .usage = {
+                .type       = Usage_type::tangent
+            },
+            .shader_type    = gl::Attribute_type::float_vec4,
+            .data_type = {
+                .type       = gl::Vertex_attrib_type::short_,
+                .normalized = true,
+                .dimension  = 4,
+                .encoding   = Encoding::octahedral
+            }
+        };
+    }
     [[nodiscard]] static auto bitangent_float3() -> Vertex_attribute
     {
         return Vertex_attribute{
@@ -226,6 +282,34 @@ public:
             }
         };
     }
+    [[nodiscard]] static auto texcoord0_half2() -> Vertex_attribute
+    {
+        return Vertex_attribute{
+            .usage = {
+                .type      = Usage_type::tex_coord,
+                .index     = 0
+            },
+            .shader_type   = gl::Attribute_type::float_vec2,
+            .data_type = {
+                .type      = gl::Vertex_attrib_type::half_float,
+                .dimension = 2
+            }
+        };
+    }
+    [[nodiscard]] static auto texcoord1_half2() -> Vertex_attribute
+    {
+        return Vertex_attribute{
+            .usage = {
+                .type      = Usage_type::tex_coord,
+                .index     = 1
+            },
+            .shader_type   = gl::Attribute_type::float_vec2,
+            .data_type = {
+                .type      = gl::Vertex_attrib_type::half_float,
+                .dimension = 2
+            }
+        };
+    }
     [[nodiscard]] static auto color_ubyte4() -> Vertex_attribute
     {
         return Vertex_attribute{
@@ -283,6 +367,21 @@ public:
             }
         };
     }
+    [[nodiscard]] static auto joint_weights0_ubyte4() -> Vertex_attribute
+    {
+        return Vertex_attribute{
+            .usage = {
+                .type       = Usage_type::joint_weights,
+                .index      = 0
+            },
+            .shader_type    = gl::Attribute_type::float_vec4,
+            .data_type = {
+                .type       = gl::Vertex_attrib_type::unsigned_byte,
+                .normalized = true,
+                .dimension  = 4
+            }
+        };
+    }
     [[nodiscard]] static auto joint_weights0_float4() -> Vertex_attribute
     {
         return Vertex_attribute{
@@ -131,17 +131,17 @@ IWorld::~IWorld() noexcept
 {
 }
 
-auto IWorld::create() -> IWorld*
+auto IWorld::create(const IWorld_create_info&) -> IWorld*
 {
     return new Bullet_world();
 }
 
-auto IWorld::create_shared() -> std::shared_ptr<IWorld>
+auto IWorld::create_shared(const IWorld_create_info&) -> std::shared_ptr<IWorld>
 {
     return std::make_shared<Bullet_world>();
 }
 
-auto IWorld::create_unique() -> std::unique_ptr<IWorld>
+auto IWorld::create_unique(const IWorld_create_info&) -> std::unique_ptr<IWorld>
 {
     return std::make_unique<Bullet_world>();
 }
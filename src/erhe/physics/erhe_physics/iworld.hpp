@@ -8,6 +8,10 @@
 #include <string>
 #include <vector>
 
+namespace erhe::concurrency {
+    class Thread_pool;
+}
+
 namespace erhe::physics
 {
 
@@ -16,14 +20,25 @@ class IDebug_draw;
 class IRigid_body;
 class IRigid_body_create_info;
 
+class IWorld_create_info
+{
+public:
+    // When set, physics jobs are executed in this thread pool instead of
+    // physics library private worker threads.
+    erhe::concurrency::Thread_pool* thread_pool{nullptr};
+
+    // Maximum number of worker threads used for physics jobs, 0 = all
+    int                             thread_count{0};
+};
+
 class IWorld
 {
 public:
     virtual ~IWorld() noexcept;
 
-    [[nodiscard]] static auto create       () -> IWorld*;
-    [[nodiscard]] static auto create_shared() -> std::shared_ptr<IWorld>;
-    [[nodiscard]] static auto create_unique() -> std::unique_ptr<IWorld>;
+    [[nodiscard]] static auto create       (const IWorld_create_info& create_info = {}) -> IWorld*;
+    [[nodiscard]] static auto create_shared(const IWorld_create_info& create_info = {}) -> std::shared_ptr<IWorld>;
+    [[nodiscard]] static auto create_unique(const IWorld_create_info& create_info = {}) -> std::unique_ptr<IWorld>;
 
     [[nodiscard]] virtual auto create_rigid_body       (
         const IRigid_body_create_info& create_info,
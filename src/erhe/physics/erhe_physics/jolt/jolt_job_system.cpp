@@ -0,0 +1,123 @@
+#include "erhe_physics/jolt/jolt_job_system.hpp"
+#include "erhe_physics/physics_log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace erhe::physics
+{
+
+Jolt_job_system::Jolt_job_system(
+    erhe::concurrency::Thread_pool& thread_pool,
+    const unsigned int              max_jobs,
+    const unsigned int              max_barriers,
+    const int                       max_concurrency
+)
+    : JPH::JobSystemWithBarrier{max_barriers}
+    , m_max_workers{
+        // At least one, so that jobs also run when pool has no worker threads
+        std::max(1, (max_concurrency > 0) ? std::min(max_concurrency, thread_pool.size()) : thread_pool.size())
+    }
+    , m_max_concurrency{
+        // Pool workers used by physics + the thread calling PhysicsSystem::Update()
+        ((max_concurrency > 0) ? std::min(max_concurrency, thread_pool.size()) : thread_pool.size()) + 1
+    }
+    , m_queue{thread_pool, "physics", erhe::concurrency::Priority::HIGH}
+{
+    m_jobs.Init(max_jobs, max_jobs);
+}
+
+Jolt_job_system::~Jolt_job_system() noexcept
+{
+    m_queue.wait();
+}
+
+auto Jolt_job_system::GetMaxConcurrency() const -> int
+{
+    return m_max_concurrency;
+}
+
+auto Jolt_job_system::CreateJob(
+    const char*         inName,
+    const JPH::ColorArg inColor,
+    const JobFunction&  inJobFunction,
+    const JPH::uint32   inNumDependencies
+) -> JobHandle
+{
+    JPH::uint32 index;
+    for (;;) {
+        index = m_jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+        if (index != Available_jobs::cInvalidObjectIndex) {
+            break;
+        }
+        log_physics->warn("No Jolt jobs available, increase max jobs");
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    Job* job = &m_jobs.Get(index);
+
+    // Construct handle to keep a reference, the job is queued below and may immediately complete
+    JobHandle handle{job};
+
+    if (inNumDependencies == 0) {
+        QueueJob(job);
+    }
+
+    return handle;
+}
+
+void Jolt_job_system::QueueJob(Job* inJob)
+{
+    // Reference is released when the job has been executed
+    inJob->AddRef();
+
+    bool start_worker{false};
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_pending_jobs.push_back(inJob);
+        if (m_active_workers < m_max_workers) {
+            ++m_active_workers;
+            start_worker = true;
+        }
+    }
+    if (start_worker) {
+        m_queue.enqueue(
+            [this]()
+            {
+                run_jobs();
+            }
+        );
+    }
+}
+
+void Jolt_job_system::run_jobs()
+{
+    for (;;) {
+        Job* job{nullptr};
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if (m_pending_jobs.empty()) {
+                --m_active_workers;
+                return;
+            }
+            job = m_pending_jobs.front();
+            m_pending_jobs.pop_front();
+        }
+        job->Execute();
+        job->Release();
+    }
+}
+
+void Jolt_job_system::QueueJobs(Job** inJobs, const JPH::uint inNumJobs)
+{
+    for (JPH::uint i = 0; i < inNumJobs; ++i) {
+        QueueJob(inJobs[i]);
+    }
+}
+
+void Jolt_job_system::FreeJob(Job* inJob)
+{
+    m_jobs.DestructObject(inJob);
+}
+
+} // namespace erhe::physics
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "erhe_concurrency/concurrent_queue.hpp"
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+
+#include <deque>
+#include <mutex>
+
+namespace erhe::physics
+{
+
+// JPH::JobSystem implementation which runs Jolt jobs in a shared
+// erhe::concurrency::Thread_pool instead of private Jolt worker threads.
+// Barrier waits are cooperative; the waiting thread executes jobs too.
+// At most max_concurrency pool workers (all when 0) run physics jobs at a
+// time. Jobs are kept in a queue of their own, and only that many pool
+// tasks drain it.
+class Jolt_job_system final
+    : public JPH::JobSystemWithBarrier
+{
+public:
+    Jolt_job_system(
+        erhe::concurrency::Thread_pool& thread_pool,
+        unsigned int                    max_jobs,
+        unsigned int                    max_barriers,
+        int                             max_concurrency
+    );
+    ~Jolt_job_system() noexcept override;
+
+    // Implements JPH::JobSystem
+    auto GetMaxConcurrency() const -> int override;
+    auto CreateJob(
+        const char*        inName,
+        JPH::ColorArg      inColor,
+        const JobFunction& inJobFunction,
+        JPH::uint32        inNumDependencies = 0
+    ) -> JobHandle override;
+
+protected:
+    // Implements JPH::JobSystem
+    void QueueJob (Job* inJob) override;
+    void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+    void FreeJob  (Job* inJob) override;
+
+private:
+    using Available_jobs = JPH::FixedSizeFreeList<Job>;
+
+    void run_jobs();
+
+    Available_jobs                      m_jobs;
+    int                                 m_max_workers;
+    int                                 m_max_concurrency;
+    std::mutex                          m_mutex;
+    std::deque<Job*>                    m_pending_jobs;      // protected by m_mutex
+    int                                 m_active_workers{0}; // protected by m_mutex
+    erhe::concurrency::Concurrent_queue m_queue;
+};
+
+} // namespace erhe::physics
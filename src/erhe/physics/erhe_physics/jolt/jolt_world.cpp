@@ -1,6 +1,7 @@
 #include "erhe_physics/jolt/jolt_world.hpp"
 #include "erhe_log/log_glm.hpp"
 #include "erhe_physics/jolt/jolt_constraint.hpp"
+#include "erhe_physics/jolt/jolt_job_system.hpp"
 #include "erhe_physics/jolt/jolt_rigid_body.hpp"
 #include "erhe_physics/jolt/glm_conversions.hpp"
 #include "erhe_physics/idebug_draw.hpp"
@@ -9,6 +10,7 @@
 
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Core/Factory.h>
+#include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Physics/Body/Body.h>
 
 namespace erhe::physics
@@ -153,19 +155,19 @@ IWorld::~IWorld() noexcept
 {
 }
 
-auto IWorld::create() -> IWorld*
+auto IWorld::create(const IWorld_create_info& create_info) -> IWorld*
 {
-    return new Jolt_world();
+    return new Jolt_world(create_info);
 }
 
-auto IWorld::create_shared() -> std::shared_ptr<IWorld>
+auto IWorld::create_shared(const IWorld_create_info& create_info) -> std::shared_ptr<IWorld>
 {
-    return std::make_shared<Jolt_world>();
+    return std::make_shared<Jolt_world>(create_info);
 }
 
-auto IWorld::create_unique() -> std::unique_ptr<IWorld>
+auto IWorld::create_unique(const IWorld_create_info& create_info) -> std::unique_ptr<IWorld>
 {
-    return std::make_unique<Jolt_world>();
+    return std::make_unique<Jolt_world>(create_info);
 }
 
 //// void register_empty_shape();
@@ -187,10 +189,24 @@ Jolt_world::Initialize_first::Initialize_first()
     ////register_empty_shape();
 }
 
-Jolt_world::Jolt_world()
+Jolt_world::Jolt_world(const IWorld_create_info& create_info)
     : m_temp_allocator{10 * 1024 * 1024}
-    , m_job_system    {JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, 10}
 {
+    if (create_info.thread_pool != nullptr) {
+        m_job_system = std::make_unique<Jolt_job_system>(
+            *create_info.thread_pool,
+            JPH::cMaxPhysicsJobs,
+            JPH::cMaxPhysicsBarriers,
+            create_info.thread_count
+        );
+    } else {
+        m_job_system = std::make_unique<JPH::JobSystemThreadPool>(
+            JPH::cMaxPhysicsJobs,
+            JPH::cMaxPhysicsBarriers,
+            (create_info.thread_count > 0) ? create_info.thread_count : -1
+        );
+    }
+
     //m_debug_renderer              = std::make_unique<Jolt_debug_renderer             >();
     m_broad_phase_layer_interface = std::make_unique<Broad_phase_layer_interface_impl>();
     m_physics_system.Init(
@@ -230,7 +246,7 @@ void Jolt_world::update_fixed_step(const double dt)
         cCollisionSteps,
         //cIntegrationSubSteps,
         &m_temp_allocator,
-        &m_job_system
+        m_job_system.get()
     );
 }
 
@@ -4,7 +4,7 @@
 
 #include <Jolt/Jolt.h>
 #include <Jolt/Core/TempAllocator.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
+#include <Jolt/Core/JobSystem.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseLayer.h>
 #include <Jolt/Physics/Collision/ContactListener.h>
@@ -56,7 +56,7 @@ class Jolt_world
     , public JPH::ContactListener
 {
 public:
-    Jolt_world();
+    explicit Jolt_world(const IWorld_create_info& create_info);
     virtual ~Jolt_world() noexcept override;
 
     // Implements IWorld
@@ -123,7 +123,7 @@ private:
     const Jolt_collision_filter                    m_collision_filter;
 
     JPH::TempAllocatorImpl                         m_temp_allocator;
-    JPH::JobSystemThreadPool                       m_job_system;
+    std::unique_ptr<JPH::JobSystem>                m_job_system;
     std::unique_ptr<JPH::BroadPhaseLayerInterface> m_broad_phase_layer_interface;
     JPH::PhysicsSystem                             m_physics_system;
     //std::unique_ptr<Jolt_debug_renderer>           m_debug_renderer;
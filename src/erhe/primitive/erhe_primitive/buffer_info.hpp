@@ -16,9 +16,10 @@ class Buffer_sink;
 class Buffer_info
 {
 public:
-    gl::Buffer_usage                     usage        {gl::Buffer_usage::static_draw};
-    Normal_style                         normal_style {Normal_style::corner_normals};
-    gl::Draw_elements_type               index_type   {gl::Draw_elements_type::unsigned_short};
+    gl::Buffer_usage                     usage            {gl::Buffer_usage::static_draw};
+    Normal_style                         normal_style     {Normal_style::corner_normals};
+    gl::Draw_elements_type               index_type       {gl::Draw_elements_type::unsigned_short};
+    bool                                 narrow_index_type{false}; // use unsigned_short instead of unsigned_int when vertex count allows
     const erhe::graphics::Vertex_format& vertex_format;
     Buffer_sink&                         buffer_sink;
 };
@@ -3,14 +3,40 @@
 #include "erhe_graphics/buffer.hpp"
 #include "erhe_graphics/buffer_transfer_queue.hpp"
 #include "erhe_raytrace/ibuffer.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <cstring>
 
 namespace erhe::primitive
 {
 
+namespace {
+
+[[nodiscard]] auto get_persistent_map(erhe::graphics::Buffer& buffer) -> gsl::span<std::uint8_t>
+{
+    if (!buffer.is_persistently_mapped()) {
+        return {};
+    }
+    const gsl::span<std::byte> map = buffer.map();
+    return gsl::span<std::uint8_t>{reinterpret_cast<std::uint8_t*>(map.data()), map.size_bytes()};
+}
+
+} // anonymous namespace
+
 Buffer_sink::~Buffer_sink() noexcept
 {
 }
 
+auto Buffer_sink::get_vertex_span(const Buffer_range&) const -> gsl::span<std::uint8_t>
+{
+    return {};
+}
+
+auto Buffer_sink::get_index_span(const Buffer_range&) const -> gsl::span<std::uint8_t>
+{
+    return {};
+}
+
 Gl_buffer_sink::Gl_buffer_sink(
     erhe::graphics::Buffer_transfer_queue& buffer_transfer_queue,
     erhe::graphics::Buffer&                vertex_buffer,
@@ -53,8 +79,50 @@ auto Gl_buffer_sink::allocate_index_buffer(
     };
 }
 
+auto Gl_buffer_sink::get_vertex_span(const Buffer_range& buffer_range) const -> gsl::span<std::uint8_t>
+{
+    const gsl::span<std::uint8_t> map = get_persistent_map(m_vertex_buffer);
+    if (map.empty()) {
+        return {};
+    }
+    return map.subspan(buffer_range.byte_offset, buffer_range.count * buffer_range.element_size);
+}
+
+auto Gl_buffer_sink::get_index_span(const Buffer_range& buffer_range) const -> gsl::span<std::uint8_t>
+{
+    const gsl::span<std::uint8_t> map = get_persistent_map(m_index_buffer);
+    if (map.empty()) {
+        return {};
+    }
+    return map.subspan(buffer_range.byte_offset, buffer_range.count * buffer_range.element_size);
+}
+
+void Gl_buffer_sink::write_mapped(
+    erhe::graphics::Buffer&       buffer,
+    const gsl::span<std::uint8_t> map,
+    const std::size_t             offset,
+    const gsl::span<std::uint8_t> data,
+    const bool                    direct_write
+) const
+{
+    if (data.empty()) {
+        return;
+    }
+    if (direct_write) {
+        ERHE_VERIFY(data.data() == map.data() + offset);
+    } else {
+        std::memcpy(map.subspan(offset, data.size_bytes()).data(), data.data(), data.size_bytes());
+    }
+    m_buffer_transfer_queue.enqueue_flush(buffer, offset, data.size_bytes());
+}
+
 void Gl_buffer_sink::enqueue_index_data(std::size_t offset, std::vector<uint8_t>&& data) const
 {
+    const gsl::span<std::uint8_t> map = get_persistent_map(m_index_buffer);
+    if (!map.empty()) {
+        write_mapped(m_index_buffer, map, offset, gsl::make_span(data), false);
+        return;
+    }
     m_buffer_transfer_queue.enqueue(
         m_index_buffer,
         offset,
@@ -64,6 +132,11 @@ void Gl_buffer_sink::enqueue_index_data(std::size_t offset, std::vector<uint8_t>
 
 void Gl_buffer_sink::enqueue_vertex_data(std::size_t offset, std::vector<uint8_t>&& data) const
 {
+    const gsl::span<std::uint8_t> map = get_persistent_map(m_vertex_buffer);
+    if (!map.empty()) {
+        write_mapped(m_vertex_buffer, map, offset, gsl::make_span(data), false);
+        return;
+    }
     m_buffer_transfer_queue.enqueue(
         m_vertex_buffer,
         offset,
@@ -73,6 +146,12 @@ void Gl_buffer_sink::enqueue_vertex_data(std::size_t offset, std::vector<uint8_t
 
 void Gl_buffer_sink::buffer_ready(Vertex_buffer_writer& writer) const
 {
+    const gsl::span<std::uint8_t> map = get_persistent_map(m_vertex_buffer);
+    if (!map.empty()) {
+        write_mapped(m_vertex_buffer, map, writer.start_offset(), writer.vertex_data_span, writer.direct_write);
+        writer.vertex_data = std::vector<std::uint8_t>{};
+        return;
+    }
     m_buffer_transfer_queue.enqueue(
         m_vertex_buffer,
         writer.start_offset(),
@@ -82,6 +161,12 @@ void Gl_buffer_sink::buffer_ready(Vertex_buffer_writer& writer) const
 
 void Gl_buffer_sink::buffer_ready(Index_buffer_writer& writer) const
 {
+    const gsl::span<std::uint8_t> map = get_persistent_map(m_index_buffer);
+    if (!map.empty()) {
+        write_mapped(m_index_buffer, map, writer.start_offset(), writer.index_data_span, writer.direct_write);
+        writer.index_data = std::vector<std::uint8_t>{};
+        return;
+    }
     m_buffer_transfer_queue.enqueue(
         m_index_buffer,
         writer.start_offset(),
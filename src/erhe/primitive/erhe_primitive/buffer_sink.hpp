@@ -2,6 +2,8 @@
 
 #include "erhe_primitive/buffer_range.hpp"
 
+#include <gsl/span>
+
 #include <vector>
 #include <cstdint>
 
@@ -38,12 +40,24 @@ public:
         std::size_t index_element_size
     ) -> Buffer_range = 0;
 
+    // Returns memory where data for an allocated range can be written
+    // directly, or empty span if data must be passed to buffer_ready().
+    // Memory returned may be write only.
+    [[nodiscard]] virtual auto get_vertex_span(const Buffer_range& buffer_range) const -> gsl::span<std::uint8_t>;
+    [[nodiscard]] virtual auto get_index_span (const Buffer_range& buffer_range) const -> gsl::span<std::uint8_t>;
+
     virtual void enqueue_index_data (std::size_t offset, std::vector<uint8_t>&& data) const = 0;
     virtual void enqueue_vertex_data(std::size_t offset, std::vector<uint8_t>&& data) const = 0;
     virtual void buffer_ready       (Vertex_buffer_writer& writer) const = 0;
     virtual void buffer_ready       (Index_buffer_writer&  writer) const = 0;
 };
 
+// If vertex and index buffers are persistently mapped, data is written
+// directly to mapped buffer memory (or copied there once, when data must be
+// post-processed), and only flushes for written ranges are queued to
+// buffer_transfer_queue. Otherwise data is queued to buffer_transfer_queue.
+// Mapping is looked up from the buffer on each use, so it is never stale if
+// a buffer is unmapped or mapped again.
 class Gl_buffer_sink
     : public Buffer_sink
 {
@@ -64,12 +78,23 @@ public:
         std::size_t index_element_size
     ) -> Buffer_range override;
 
+    [[nodiscard]] auto get_vertex_span(const Buffer_range& buffer_range) const -> gsl::span<std::uint8_t> override;
+    [[nodiscard]] auto get_index_span (const Buffer_range& buffer_range) const -> gsl::span<std::uint8_t> override;
+
     void enqueue_index_data (std::size_t offset, std::vector<uint8_t>&& data) const override;
     void enqueue_vertex_data(std::size_t offset, std::vector<uint8_t>&& data) const override;
     void buffer_ready       (Vertex_buffer_writer& writer) const                    override;
     void buffer_ready       (Index_buffer_writer&  writer) const                    override;
 
 private:
+    void write_mapped(
+        erhe::graphics::Buffer& buffer,
+        gsl::span<std::uint8_t> map,
+        std::size_t             offset,
+        gsl::span<std::uint8_t> data,
+        bool                    direct_write
+    ) const;
+
     erhe::graphics::Buffer_transfer_queue& m_buffer_transfer_queue;
     erhe::graphics::Buffer&                m_vertex_buffer;
     erhe::graphics::Buffer&                m_index_buffer;
@@ -9,12 +9,81 @@
 #include <glm/gtc/packing.hpp>
 #include <gsl/span>
 
+#include <algorithm>
+#include <cmath>
+
 namespace erhe::primitive
 {
 
 namespace
 {
 
+using Encoding = erhe::graphics::Vertex_attribute::Encoding;
+
+inline auto pack_snorm16(const float value) -> int16_t
+{
+    const float clamped = std::max(-1.0f, std::min(value, 1.0f));
+    return static_cast<int16_t>(std::round(clamped * 32767.0f));
+}
+
+inline auto pack_unorm8(const float value) -> uint8_t
+{
+    const float clamped = std::max(0.0f, std::min(value, 1.0f));
+    return static_cast<uint8_t>(std::round(clamped * 255.0f));
+}
+
+// Quantizes joint weights so that the four bytes sum to 255. Weights are
+// normalized first, and the rounding error is added to the largest weight.
+inline void write_joint_weights_unorm8(
+    const gsl::span<std::uint8_t> destination,
+    const glm::vec4               value
+)
+{
+    auto* const ptr = reinterpret_cast<uint8_t*>(destination.data());
+    float clamped[4];
+    float sum = 0.0f;
+    for (int i = 0; i < 4; ++i) {
+        clamped[i] = std::max(0.0f, std::min(value[i], 1.0f));
+        sum += clamped[i];
+    }
+    if (!(sum > 0.0f)) {
+        ptr[0] = ptr[1] = ptr[2] = ptr[3] = 0;
+        return;
+    }
+    int quantized[4];
+    int total   = 0;
+    int largest = 0;
+    for (int i = 0; i < 4; ++i) {
+        quantized[i] = static_cast<int>(std::round(clamped[i] / sum * 255.0f));
+        total += quantized[i];
+        if (clamped[i] > clamped[largest]) {
+            largest = i;
+        }
+    }
+    quantized[largest] += 255 - total;
+    for (int i = 0; i < 4; ++i) {
+        ptr[i] = static_cast<uint8_t>(std::max(0, std::min(quantized[i], 255)));
+    }
+}
+
+// Maps unit vector to [-1, 1]^2 by projecting to octahedron and unfolding
+// the lower hemisphere. Decoded in shaders by erhe_decode_octahedral().
+inline auto encode_octahedral(const glm::vec3 v) -> glm::vec2
+{
+    const float l1_norm = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+    if (l1_norm == 0.0f) {
+        return glm::vec2{0.0f, 0.0f};
+    }
+    const glm::vec3 p = v / l1_norm;
+    if (p.z >= 0.0f) {
+        return glm::vec2{p.x, p.y};
+    }
+    return glm::vec2{
+        (1.0f - std::abs(p.y)) * ((p.x >= 0.0f) ? 1.0f : -1.0f),
+        (1.0f - std::abs(p.x)) * ((p.y >= 0.0f) ? 1.0f : -1.0f)
+    };
+}
+
 inline void write_low(
     const gsl::span<std::uint8_t> destination,
     const gl::Draw_elements_type  type,
@@ -49,6 +118,30 @@ inline void write_low(
     }
 }
 
+inline auto read_low(
+    const gsl::span<std::uint8_t> source,
+    const gl::Draw_elements_type  type
+) -> uint32_t
+{
+    switch (type) {
+        case gl::Draw_elements_type::unsigned_byte: {
+            return *reinterpret_cast<const uint8_t*>(source.data());
+        }
+
+        case gl::Draw_elements_type::unsigned_short: {
+            return *reinterpret_cast<const uint16_t*>(source.data());
+        }
+
+        case gl::Draw_elements_type::unsigned_int: {
+            return *reinterpret_cast<const uint32_t*>(source.data());
+        }
+
+        default: {
+            ERHE_FATAL("bad index type");
+        }
+    }
+}
+
 inline void write_low(
     const gsl::span<std::uint8_t> destination,
     const gl::Vertex_attrib_type  type,
@@ -107,12 +200,14 @@ inline void write_low(
         }
         case gl::Vertex_attrib_type::unsigned_byte: {
             auto* const ptr = reinterpret_cast<uint8_t*>(destination.data());
-            float scaled_x = std::max(0.0f, std::min(value.x * 255.0f, 255.0f));
-            float scaled_y = std::max(0.0f, std::min(value.y * 255.0f, 255.0f));
-            Expects(scaled_x <= 0xffU);
-            Expects(scaled_y <= 0xffU);
-            ptr[0] = static_cast<uint8_t>(scaled_x) & 0xffU;
-            ptr[1] = static_cast<uint8_t>(scaled_y) & 0xffU;
+            ptr[0] = pack_unorm8(value.x);
+            ptr[1] = pack_unorm8(value.y);
+            break;
+        }
+        case gl::Vertex_attrib_type::short_: {
+            auto* const ptr = reinterpret_cast<int16_t*>(destination.data());
+            ptr[0] = pack_snorm16(value.x);
+            ptr[1] = pack_snorm16(value.y);
             break;
         }
         default: {
@@ -145,15 +240,9 @@ inline void write_low(
         }
         case gl::Vertex_attrib_type::unsigned_byte: {
             auto* const ptr = reinterpret_cast<uint8_t*>(destination.data());
-            float scaled_x = std::max(0.0f, std::min(value.x * 255.0f, 255.0f));
-            float scaled_y = std::max(0.0f, std::min(value.y * 255.0f, 255.0f));
-            float scaled_z = std::max(0.0f, std::min(value.z * 255.0f, 255.0f));
-            Expects(scaled_x <= 0xffU);
-            Expects(scaled_y <= 0xffU);
-            Expects(scaled_z <= 0xffU);
-            ptr[0] = static_cast<uint8_t>(scaled_x) & 0xffU;
-            ptr[1] = static_cast<uint8_t>(scaled_y) & 0xffU;
-            ptr[2] = static_cast<uint8_t>(scaled_z) & 0xffU;
+            ptr[0] = pack_unorm8(value.x);
+            ptr[1] = pack_unorm8(value.y);
+            ptr[2] = pack_unorm8(value.z);
             break;
         }
         default: {
@@ -189,18 +278,18 @@ inline void write_low(
         }
         case gl::Vertex_attrib_type::unsigned_byte: {
             auto* const ptr = reinterpret_cast<uint8_t*>(destination.data());
-            float scaled_x = std::max(0.0f, std::min(value.x * 255.0f, 255.0f));
-            float scaled_y = std::max(0.0f, std::min(value.y * 255.0f, 255.0f));
-            float scaled_z = std::max(0.0f, std::min(value.z * 255.0f, 255.0f));
-            float scaled_w = std::max(0.0f, std::min(value.w * 255.0f, 255.0f));
-            Expects(scaled_x <= 0xffU);
-            Expects(scaled_y <= 0xffU);
-            Expects(scaled_z <= 0xffU);
-            Expects(scaled_w <= 0xffU);
-            ptr[0] = static_cast<uint8_t>(scaled_x) & 0xffU;
-            ptr[1] = static_cast<uint8_t>(scaled_y) & 0xffU;
-            ptr[2] = static_cast<uint8_t>(scaled_z) & 0xffU;
-            ptr[3] = static_cast<uint8_t>(scaled_w) & 0xffU;
+            ptr[0] = pack_unorm8(value.x);
+            ptr[1] = pack_unorm8(value.y);
+            ptr[2] = pack_unorm8(value.z);
+            ptr[3] = pack_unorm8(value.w);
+            break;
+        }
+        case gl::Vertex_attrib_type::short_: {
+            auto* const ptr = reinterpret_cast<int16_t*>(destination.data());
+            ptr[0] = pack_snorm16(value.x);
+            ptr[1] = pack_snorm16(value.y);
+            ptr[2] = pack_snorm16(value.z);
+            ptr[3] = pack_snorm16(value.w);
             break;
         }
         default: {
@@ -269,9 +358,16 @@ Vertex_buffer_writer::Vertex_buffer_writer(
     , buffer_sink  {buffer_sink}
 {
     Expects(build_context.root.geometry_mesh != nullptr);
-    const auto& vertex_buffer_range = build_context.root.geometry_mesh->vertex_buffer_range;
-    vertex_data.resize(vertex_buffer_range.count * vertex_buffer_range.element_size);
-    vertex_data_span = gsl::make_span(vertex_data);
+
+    // Vertex buffer range is not yet allocated when vertices are welded
+    if (!build_context.root.build_info.weld_vertices) {
+        vertex_data_span = buffer_sink.get_vertex_span(build_context.root.geometry_mesh->vertex_buffer_range);
+        direct_write     = !vertex_data_span.empty();
+    }
+    if (!direct_write) {
+        vertex_data.resize(build_context.root.total_vertex_count * build_context.root.vertex_stride);
+        vertex_data_span = gsl::make_span(vertex_data);
+    }
 }
 
 Vertex_buffer_writer::~Vertex_buffer_writer() noexcept
@@ -290,17 +386,27 @@ Index_buffer_writer::Index_buffer_writer(
 )
     : build_context  {build_context}
     , buffer_sink    {buffer_sink}
-    , index_type     {build_context.root.build_info.buffer_info.index_type}
+    , index_type     {build_context.root.index_type}
     , index_type_size{build_context.root.geometry_mesh->index_buffer_range.element_size}
 {
     Expects(build_context.root.geometry_mesh != nullptr);
     const auto& geometry_mesh = *build_context.root.geometry_mesh;
     const auto& index_buffer_range = geometry_mesh.index_buffer_range;
     const auto& mesh_info          = build_context.root.mesh_info;
-    index_data.resize(index_buffer_range.count * index_type_size);
-    index_data_span = gsl::make_span(index_data);
+    const auto& build_info         = build_context.root.build_info;
 
-    const auto& primitive_types = build_context.root.build_info.primitive_types;
+    // Welding and vertex cache optimization read indices back, which
+    // should not be done from write only buffer sink memory
+    if (!build_info.weld_vertices && !build_info.optimize_vertex_cache) {
+        index_data_span = buffer_sink.get_index_span(index_buffer_range);
+        direct_write    = !index_data_span.empty();
+    }
+    if (!direct_write) {
+        index_data.resize(index_buffer_range.count * index_type_size);
+        index_data_span = gsl::make_span(index_data);
+    }
+
+    const auto& primitive_types = build_info.primitive_types;
 
     if (primitive_types.corner_points) {
         corner_point_index_data_span = index_data_span.subspan(
@@ -358,6 +464,17 @@ void Vertex_buffer_writer::write(
     const glm::vec3              value
 )
 {
+    if (attribute.encoding == Encoding::octahedral) {
+        write_low(
+            vertex_data_span.subspan(
+                vertex_write_offset + attribute.offset,
+                attribute.size
+            ),
+            attribute.data_type,
+            encode_octahedral(value)
+        );
+        return;
+    }
     write_low(
         vertex_data_span.subspan(
             vertex_write_offset + attribute.offset,
@@ -373,6 +490,33 @@ void Vertex_buffer_writer::write(
     const glm::vec4              value
 )
 {
+    if (attribute.encoding == Encoding::octahedral) {
+        // xyz is unit vector, w is handedness sign
+        const glm::vec2 encoded = encode_octahedral(glm::vec3{value});
+        write_low(
+            vertex_data_span.subspan(
+                vertex_write_offset + attribute.offset,
+                attribute.size
+            ),
+            attribute.data_type,
+            glm::vec4{encoded.x, encoded.y, (value.w < 0.0f) ? -1.0f : 1.0f, 0.0f}
+        );
+        return;
+    }
+    if (
+        (attribute.data_type == gl::Vertex_attrib_type::unsigned_byte) &&
+        (attribute.attribute != nullptr) &&
+        (attribute.attribute->usage.type == erhe::graphics::Vertex_attribute::Usage_type::joint_weights)
+    ) {
+        write_joint_weights_unorm8(
+            vertex_data_span.subspan(
+                vertex_write_offset + attribute.offset,
+                attribute.size
+            ),
+            value
+        );
+        return;
+    }
     write_low(
         vertex_data_span.subspan(
             vertex_write_offset + attribute.offset,
@@ -449,4 +593,14 @@ void Index_buffer_writer::write_centroid(const uint32_t v0)
     ++polygon_centroid_indices_written;
 }
 
+auto Index_buffer_writer::read_index(const std::size_t index) const -> uint32_t
+{
+    return read_low(index_data_span.subspan(index * index_type_size, index_type_size), index_type);
+}
+
+void Index_buffer_writer::write_index(const std::size_t index, const uint32_t value)
+{
+    write_low(index_data_span.subspan(index * index_type_size, index_type_size), index_type, value);
+}
+
 }
@@ -45,9 +45,10 @@ public:
     Build_context&            build_context;
     Buffer_sink&              buffer_sink;
     Buffer_range              buffer_range;
-    std::vector<std::uint8_t> vertex_data;
+    std::vector<std::uint8_t> vertex_data;      // unused when writing directly to buffer sink memory
     gsl::span<std::uint8_t>   vertex_data_span;
     std::size_t               vertex_write_offset{0};
+    bool                      direct_write       {false};
 };
 
 /// Writes 8/16/32 -bit indices to byte buffer/memory
@@ -68,6 +69,10 @@ public:
     void write_edge    (const uint32_t v0, const uint32_t v1);
     void write_centroid(const uint32_t v0);
 
+    // Access to already written indices, index is relative to start of index buffer range
+    [[nodiscard]] auto read_index(const std::size_t index) const -> uint32_t;
+    void write_index(const std::size_t index, const uint32_t value);
+
     [[nodiscard]] auto start_offset  () -> std::size_t;
 
     Build_context&               build_context;
@@ -75,8 +80,9 @@ public:
     Buffer_range                 buffer_range;
     const gl::Draw_elements_type index_type;
     const std::size_t            index_type_size{0};
-    std::vector<std::uint8_t>    index_data;
+    std::vector<std::uint8_t>    index_data; // unused when writing directly to buffer sink memory
     gsl::span<std::uint8_t>      index_data_span;
+    bool                         direct_write{false};
     gsl::span<std::uint8_t>      corner_point_index_data_span;
     gsl::span<std::uint8_t>      triangle_fill_index_data_span;
     gsl::span<std::uint8_t>      edge_line_index_data_span;
@@ -4,6 +4,8 @@
 
 #include <glm/glm.hpp>
 
+#include <cstddef>
+
 namespace erhe::graphics {
     class Vertex_attribute_mappings;
 }
@@ -20,6 +22,19 @@ public:
     bool centroid_points{false};
 };
 
+// Detail levels built in addition to the full detail mesh. Each level
+// keeps triangle_ratio of the triangles of the previous level, and is used
+// when the projected bounding sphere diameter of the primitive is below
+// screen_size pixels, scaled by screen_size_ratio for each further level.
+class Lod_info
+{
+public:
+    std::size_t level_count      {0};
+    float       triangle_ratio   {0.5f};
+    float       screen_size      {256.0f};
+    float       screen_size_ratio{0.5f};
+};
+
 class Build_info
 {
 public:
@@ -30,6 +45,9 @@ public:
     Normal_style                               normal_style             {Normal_style::corner_normals};
     erhe::graphics::Vertex_attribute_mappings* vertex_attribute_mappings{nullptr};
     bool                                       autocolor                {false};
+    Lod_info                                   lod                      {};
+    bool                                       weld_vertices            {false}; // merge vertices with identical attributes
+    bool                                       optimize_vertex_cache    {false}; // reorder fill triangles for vertex cache and overdraw
 };
 
 } // namespace erhe::primitive
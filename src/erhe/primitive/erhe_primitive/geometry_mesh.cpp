@@ -14,6 +14,16 @@ auto Geometry_mesh::base_index() const -> uint32_t
     return static_cast<uint32_t>(index_buffer_range.byte_offset / index_buffer_range.element_size);
 }
 
+// Derived from index element size, all index ranges share the same type
+auto Geometry_mesh::index_type() const -> gl::Draw_elements_type
+{
+    switch (index_buffer_range.element_size) {
+        case 1:  return gl::Draw_elements_type::unsigned_byte;
+        case 2:  return gl::Draw_elements_type::unsigned_short;
+        default: return gl::Draw_elements_type::unsigned_int;
+    }
+}
+
 auto Geometry_mesh::index_range(const Primitive_mode primitive_mode) const -> Index_range
 {
     switch (primitive_mode) {
@@ -26,6 +26,7 @@ public:
     [[nodiscard]] auto base_vertex() const -> uint32_t;
     [[nodiscard]] auto base_index () const -> uint32_t;
     [[nodiscard]] auto index_range(const Primitive_mode primitive_mode) const -> Index_range;
+    [[nodiscard]] auto index_type () const -> gl::Draw_elements_type;
 
     erhe::math::Bounding_box    bounding_box;
     erhe::math::Bounding_sphere bounding_sphere;
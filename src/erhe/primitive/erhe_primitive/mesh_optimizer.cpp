@@ -0,0 +1,352 @@
+#include "erhe_primitive/mesh_optimizer.hpp"
+#include "erhe_hash/hash.hpp"
+#include "erhe_profile/profile.hpp"
+#include "erhe_verify/verify.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace erhe::primitive
+{
+
+namespace {
+
+constexpr uint32_t c_none = std::numeric_limits<uint32_t>::max();
+
+// Vertex is in cache if fewer than cache_size vertices have been
+// inserted after it. Same time stamp scheme as in the Tipsify paper.
+class Fifo_cache
+{
+public:
+    Fifo_cache(const std::size_t vertex_count, const std::size_t cache_size)
+        : m_time_stamps(vertex_count, 0)
+        , m_cache_size {cache_size}
+        , m_time       {cache_size + 1}
+    {
+    }
+
+    [[nodiscard]] auto get_age(const uint32_t vertex) const -> std::size_t
+    {
+        return m_time - m_time_stamps[vertex];
+    }
+
+    // Returns true on cache miss
+    auto access(const uint32_t vertex) -> bool
+    {
+        if (get_age(vertex) > m_cache_size) {
+            m_time_stamps[vertex] = m_time++;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    std::vector<std::size_t> m_time_stamps;
+    std::size_t              m_cache_size;
+    std::size_t              m_time;
+};
+
+void tipsify(
+    const std::span<const uint32_t> indices,
+    const std::size_t               vertex_count,
+    const std::size_t               cache_size,
+    std::vector<uint32_t>&          triangle_order
+)
+{
+    const std::size_t triangle_count = indices.size() / 3;
+
+    // Vertex to triangle adjacency, and number of not yet emitted triangles for each vertex
+    std::vector<uint32_t> live_count(vertex_count, 0);
+    for (const uint32_t vertex : indices) {
+        ++live_count[vertex];
+    }
+    std::vector<uint32_t> adjacency_offsets(vertex_count + 1, 0);
+    for (std::size_t vertex = 0; vertex < vertex_count; ++vertex) {
+        adjacency_offsets[vertex + 1] = adjacency_offsets[vertex] + live_count[vertex];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> fill_offsets{adjacency_offsets.begin(), adjacency_offsets.end() - 1};
+        for (std::size_t i = 0, end = indices.size(); i < end; ++i) {
+            adjacency[fill_offsets[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    Fifo_cache            cache{vertex_count, cache_size};
+    std::vector<bool>     emitted(triangle_count, false);
+    std::vector<uint32_t> dead_end_stack;
+    std::vector<uint32_t> candidates;
+    uint32_t              cursor{0};
+    uint32_t              fanning_vertex{0};
+
+    const auto skip_dead_end = [&]() -> uint32_t {
+        while (!dead_end_stack.empty()) {
+            const uint32_t vertex = dead_end_stack.back();
+            dead_end_stack.pop_back();
+            if (live_count[vertex] > 0) {
+                return vertex;
+            }
+        }
+        for (; cursor < vertex_count; ++cursor) {
+            if (live_count[cursor] > 0) {
+                return cursor;
+            }
+        }
+        return c_none;
+    };
+
+    while (fanning_vertex != c_none) {
+        candidates.clear();
+        for (uint32_t i = adjacency_offsets[fanning_vertex], end = adjacency_offsets[fanning_vertex + 1]; i < end; ++i) {
+            const uint32_t triangle = adjacency[i];
+            if (emitted[triangle]) {
+                continue;
+            }
+            for (uint32_t corner = 0; corner < 3; ++corner) {
+                const uint32_t vertex = indices[triangle * 3 + corner];
+                dead_end_stack.push_back(vertex);
+                candidates.push_back(vertex);
+                --live_count[vertex];
+                cache.access(vertex);
+            }
+            emitted[triangle] = true;
+            triangle_order.push_back(triangle);
+        }
+
+        // Prefer the candidate that entered the cache earliest, if it still
+        // remains in cache after all of its remaining triangles are emitted.
+        uint32_t    next_vertex  {c_none};
+        std::size_t best_priority{0};
+        for (const uint32_t vertex : candidates) {
+            if (live_count[vertex] == 0) {
+                continue;
+            }
+            std::size_t priority{0};
+            const std::size_t age = cache.get_age(vertex);
+            if (age + 2 * live_count[vertex] <= cache_size) {
+                priority = age;
+            }
+            if ((next_vertex == c_none) || (priority > best_priority)) {
+                best_priority = priority;
+                next_vertex   = vertex;
+            }
+        }
+        fanning_vertex = (next_vertex != c_none) ? next_vertex : skip_dead_end();
+    }
+
+    ERHE_VERIFY(triangle_order.size() == triangle_count);
+}
+
+void sort_clusters_for_overdraw(
+    const std::span<const uint32_t>  indices,
+    const std::size_t                vertex_count,
+    const std::span<const glm::vec3> vertex_positions,
+    const std::size_t                cache_size,
+    std::vector<uint32_t>&           triangle_order
+)
+{
+    const std::size_t triangle_count = triangle_order.size();
+
+    const auto get_triangle = [&](const uint32_t triangle, glm::vec3& centroid, glm::vec3& normal) {
+        const glm::vec3 p0 = vertex_positions[indices[triangle * 3 + 0]];
+        const glm::vec3 p1 = vertex_positions[indices[triangle * 3 + 1]];
+        const glm::vec3 p2 = vertex_positions[indices[triangle * 3 + 2]];
+        centroid = (p0 + p1 + p2) / 3.0f;
+        normal   = glm::cross(p1 - p0, p2 - p0); // length is twice the area
+    };
+
+    // Clusters start at triangles which miss the cache with all corners
+    std::vector<uint32_t> cluster_starts;
+    {
+        Fifo_cache cache{vertex_count, cache_size};
+        for (std::size_t i = 0; i < triangle_count; ++i) {
+            const uint32_t triangle = triangle_order[i];
+            uint32_t miss_count = 0;
+            for (uint32_t corner = 0; corner < 3; ++corner) {
+                if (cache.access(indices[triangle * 3 + corner])) {
+                    ++miss_count;
+                }
+            }
+            if ((i == 0) || (miss_count == 3)) {
+                cluster_starts.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+    const std::size_t cluster_count = cluster_starts.size();
+    if (cluster_count < 2) {
+        return;
+    }
+    cluster_starts.push_back(static_cast<uint32_t>(triangle_count));
+
+    glm::vec3 mesh_centroid{0.0f};
+    float     mesh_area    {0.0f};
+    for (const uint32_t triangle : triangle_order) {
+        glm::vec3 centroid;
+        glm::vec3 normal;
+        get_triangle(triangle, centroid, normal);
+        const float area = glm::length(normal);
+        mesh_centroid += area * centroid;
+        mesh_area     += area;
+    }
+    if (mesh_area == 0.0f) {
+        return;
+    }
+    mesh_centroid /= mesh_area;
+
+    std::vector<float> cluster_sort_keys(cluster_count, 0.0f);
+    for (std::size_t cluster = 0; cluster < cluster_count; ++cluster) {
+        glm::vec3 cluster_centroid{0.0f};
+        glm::vec3 cluster_normal  {0.0f};
+        float     cluster_area    {0.0f};
+        for (uint32_t i = cluster_starts[cluster], end = cluster_starts[cluster + 1]; i < end; ++i) {
+            glm::vec3 centroid;
+            glm::vec3 normal;
+            get_triangle(triangle_order[i], centroid, normal);
+            const float area = glm::length(normal);
+            cluster_centroid += area * centroid;
+            cluster_normal   += normal;
+            cluster_area     += area;
+        }
+        const float normal_length = glm::length(cluster_normal);
+        if ((cluster_area > 0.0f) && (normal_length > 0.0f)) {
+            cluster_sort_keys[cluster] = glm::dot(cluster_centroid / cluster_area - mesh_centroid, cluster_normal / normal_length);
+        }
+    }
+
+    std::vector<uint32_t> clusters(cluster_count);
+    for (std::size_t cluster = 0; cluster < cluster_count; ++cluster) {
+        clusters[cluster] = static_cast<uint32_t>(cluster);
+    }
+    std::stable_sort(
+        clusters.begin(),
+        clusters.end(),
+        [&cluster_sort_keys](const uint32_t lhs, const uint32_t rhs) {
+            return cluster_sort_keys[lhs] > cluster_sort_keys[rhs];
+        }
+    );
+
+    std::vector<uint32_t> sorted_order;
+    sorted_order.reserve(triangle_count);
+    for (const uint32_t cluster : clusters) {
+        sorted_order.insert(
+            sorted_order.end(),
+            triangle_order.begin() + cluster_starts[cluster],
+            triangle_order.begin() + cluster_starts[cluster + 1]
+        );
+    }
+    triangle_order = std::move(sorted_order);
+}
+
+} // anonymous namespace
+
+auto weld_vertices(
+    const std::span<std::uint8_t> vertex_data,
+    const std::size_t             vertex_stride,
+    std::vector<uint32_t>&        remap
+) -> std::size_t
+{
+    ERHE_PROFILE_FUNCTION();
+
+    ERHE_VERIFY(vertex_stride > 0);
+
+    const std::size_t vertex_count = vertex_data.size() / vertex_stride;
+    remap.resize(vertex_count);
+
+    // Open addressing hash table of unique vertex indices, load factor at most 2/3
+    std::size_t table_size = 1;
+    while (table_size < vertex_count + vertex_count / 2) {
+        table_size *= 2;
+    }
+    const std::size_t     table_mask = table_size - 1;
+    std::vector<uint32_t> table(table_size, c_none);
+
+    // Unique vertices are moved down as they are found. Vertex i is always
+    // read before anything is written to it, since unique_count <= i.
+    std::uint8_t* const data = vertex_data.data();
+    std::size_t unique_count = 0;
+    for (std::size_t i = 0; i < vertex_count; ++i) {
+        const std::uint8_t* const vertex = data + i * vertex_stride;
+        std::size_t slot = erhe::hash::hash(vertex, vertex_stride) & table_mask;
+        for (;;) {
+            const uint32_t entry = table[slot];
+            if (entry == c_none) {
+                if (unique_count != i) {
+                    std::memcpy(data + unique_count * vertex_stride, vertex, vertex_stride);
+                }
+                table[slot] = static_cast<uint32_t>(unique_count);
+                remap[i]    = static_cast<uint32_t>(unique_count);
+                ++unique_count;
+                break;
+            }
+            if (std::memcmp(data + entry * vertex_stride, vertex, vertex_stride) == 0) {
+                remap[i] = entry;
+                break;
+            }
+            slot = (slot + 1) & table_mask;
+        }
+    }
+
+    return unique_count;
+}
+
+void optimize_triangle_order(
+    const std::span<uint32_t>        indices,
+    const std::size_t                vertex_count,
+    const std::span<const glm::vec3> vertex_positions,
+    std::vector<uint32_t>&           triangle_order,
+    const std::size_t                cache_size
+)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    ERHE_VERIFY(indices.size() % 3 == 0);
+    ERHE_VERIFY(cache_size > 0);
+    for (const uint32_t vertex : indices) {
+        ERHE_VERIFY(vertex < vertex_count);
+    }
+
+    triangle_order.clear();
+    triangle_order.reserve(indices.size() / 3);
+    if (indices.empty()) {
+        return;
+    }
+
+    tipsify(indices, vertex_count, cache_size, triangle_order);
+
+    if (!vertex_positions.empty()) {
+        ERHE_VERIFY(vertex_positions.size() >= vertex_count);
+        sort_clusters_for_overdraw(indices, vertex_count, vertex_positions, cache_size, triangle_order);
+    }
+
+    const std::vector<uint32_t> old_indices{indices.begin(), indices.end()};
+    for (std::size_t i = 0, end = triangle_order.size(); i < end; ++i) {
+        const uint32_t old_triangle = triangle_order[i];
+        indices[i * 3 + 0] = old_indices[old_triangle * 3 + 0];
+        indices[i * 3 + 1] = old_indices[old_triangle * 3 + 1];
+        indices[i * 3 + 2] = old_indices[old_triangle * 3 + 2];
+    }
+}
+
+auto get_average_cache_miss_ratio(
+    const std::span<const uint32_t> indices,
+    const std::size_t               vertex_count,
+    const std::size_t               cache_size
+) -> float
+{
+    const std::size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0) {
+        return 0.0f;
+    }
+
+    Fifo_cache  cache{vertex_count, cache_size};
+    std::size_t miss_count{0};
+    for (const uint32_t vertex : indices) {
+        if (cache.access(vertex)) {
+            ++miss_count;
+        }
+    }
+    return static_cast<float>(miss_count) / static_cast<float>(triangle_count);
+}
+
+} // namespace erhe::primitive
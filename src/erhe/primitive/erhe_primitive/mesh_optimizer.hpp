@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace erhe::primitive
+{
+
+// Merges vertices with identical bytes. vertex_data is compacted in place,
+// keeping first occurrences in their original order. remap is filled with
+// the new index for each old vertex. Returns the unique vertex count.
+[[nodiscard]] auto weld_vertices(
+    std::span<std::uint8_t> vertex_data,
+    std::size_t             vertex_stride,
+    std::vector<uint32_t>&  remap
+) -> std::size_t;
+
+// Reorders triangles for post-transform vertex cache locality using
+// Tipsify (Sander, Nehab and Barczak 2007). The result is then split into
+// clusters at cache misses of whole triangles, and clusters are sorted so
+// that outward facing clusters far from the mesh center are drawn first,
+// which reduces overdraw independent of view direction. vertex_positions
+// is used only for sorting clusters, and can be empty to skip it.
+//
+// indices are rewritten in place. triangle_order is filled with the old
+// triangle index for each new triangle.
+void optimize_triangle_order(
+    std::span<uint32_t>        indices,
+    std::size_t                vertex_count,
+    std::span<const glm::vec3> vertex_positions,
+    std::vector<uint32_t>&     triangle_order,
+    std::size_t                cache_size = 16
+);
+
+// Average cache miss ratio (vertex shader invocations per triangle) for a
+// FIFO post-transform cache of cache_size entries
+[[nodiscard]] auto get_average_cache_miss_ratio(
+    std::span<const uint32_t> indices,
+    std::size_t               vertex_count,
+    std::size_t               cache_size = 16
+) -> float;
+
+} // namespace erhe::primitive
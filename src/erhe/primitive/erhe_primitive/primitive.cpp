@@ -2,7 +2,10 @@
 #include "erhe_primitive/buffer_sink.hpp"
 #include "erhe_primitive/primitive_builder.hpp"
 #include "erhe_primitive/build_info.hpp"
+#include "erhe_primitive/primitive_log.hpp"
 #include "erhe_geometry/geometry.hpp"
+#include "erhe_geometry/operation/simplify.hpp"
+#include "erhe_profile/profile.hpp"
 #include "erhe_raytrace/ibuffer.hpp"
 #include "erhe_raytrace/igeometry.hpp"
 #include "erhe_verify/verify.hpp"
@@ -177,6 +180,7 @@ Geometry_primitive::Geometry_primitive(
     , gl_geometry_mesh{make_geometry_mesh(*geometry.get(), build_info, normal_style)}
     , raytrace        {*geometry.get()}
 {
+    build_lod_chain(build_info);
 }
 
 Geometry_primitive::Geometry_primitive(
@@ -190,6 +194,7 @@ Geometry_primitive::Geometry_primitive(
     , gl_geometry_mesh{make_geometry_mesh(*render_geometry.get(), build_info, normal_style)}
     , raytrace        {*collision_geometry.get()}
 {
+    build_lod_chain(build_info);
 }
 
 Geometry_primitive::~Geometry_primitive() noexcept = default;
@@ -202,7 +207,94 @@ void Geometry_primitive::build_from_geometry(
     normal_style     = normal_style_in;
     gl_geometry_mesh = make_geometry_mesh(*source_geometry.get(), build_info, normal_style);
     raytrace         = Geometry_raytrace{*source_geometry.get()};
+    build_lod_chain(build_info);
 }
 
+void Geometry_primitive::build_lod_chain(const Build_info& build_info)
+{
+    lods.clear();
+    const Lod_info& lod_info = build_info.lod;
+    if ((lod_info.level_count == 0) || !source_geometry) {
+        return;
+    }
+
+    ERHE_PROFILE_FUNCTION();
+
+    // Simplification needs at least this much reduction per level to be worth another level
+    constexpr float max_triangle_ratio = 0.9f;
+
+    // Lod meshes use the index type of the full detail mesh, so renderers
+    // can group primitives by index type without knowing the selected lod.
+    Build_info lod_build_info = build_info;
+    lod_build_info.buffer_info.index_type        = gl_geometry_mesh.index_type();
+    lod_build_info.buffer_info.narrow_index_type = false;
+
+    std::shared_ptr<erhe::geometry::Geometry> previous_geometry = source_geometry;
+    std::size_t previous_triangle_count = previous_geometry->count_polygon_triangles();
+    float       max_screen_size         = lod_info.screen_size;
+    for (std::size_t level = 0; level < lod_info.level_count; ++level) {
+        auto geometry = std::make_shared<erhe::geometry::Geometry>(
+            erhe::geometry::operation::simplify(*previous_geometry.get(), lod_info.triangle_ratio)
+        );
+        const std::size_t triangle_count = geometry->count_polygon_triangles();
+        if (
+            (triangle_count == 0) ||
+            (static_cast<float>(triangle_count) > max_triangle_ratio * static_cast<float>(previous_triangle_count))
+        ) {
+            break;
+        }
+        log_primitive_builder->trace(
+            "{} lod {}: {} triangles, max screen size {}",
+            source_geometry->name, level + 1, triangle_count, max_screen_size
+        );
+        lods.push_back(
+            Lod_mesh{
+                .gl_geometry_mesh = make_geometry_mesh(*geometry.get(), lod_build_info, normal_style),
+                .max_screen_size  = max_screen_size
+            }
+        );
+        previous_geometry       = geometry;
+        previous_triangle_count = triangle_count;
+        max_screen_size        *= lod_info.screen_size_ratio;
+    }
+}
+
+auto Geometry_primitive::get_geometry_mesh(const float screen_size) const -> const Geometry_mesh&
+{
+    const Geometry_mesh* geometry_mesh = &gl_geometry_mesh;
+    for (const Lod_mesh& lod : lods) {
+        if (screen_size >= lod.max_screen_size) {
+            break;
+        }
+        geometry_mesh = &lod.gl_geometry_mesh;
+    }
+    return *geometry_mesh;
+}
+
+void build_from_geometry(
+    const std::span<const std::shared_ptr<Geometry_primitive>> geometry_primitives,
+    const Build_info&                                          build_info,
+    const Normal_style                                         normal_style,
+    erhe::concurrency::Thread_pool*                            thread_pool
+)
+{
+    ERHE_PROFILE_FUNCTION();
+
+    std::vector<const erhe::geometry::Geometry*> geometries;
+    geometries.reserve(geometry_primitives.size());
+    for (const auto& geometry_primitive : geometry_primitives) {
+        geometries.push_back(geometry_primitive->source_geometry.get());
+    }
+
+    std::vector<Geometry_mesh> geometry_meshes = make_geometry_meshes(geometries, build_info, normal_style, thread_pool);
+
+    for (std::size_t i = 0, end = geometry_primitives.size(); i < end; ++i) {
+        Geometry_primitive& geometry_primitive = *geometry_primitives[i].get();
+        geometry_primitive.normal_style     = normal_style;
+        geometry_primitive.gl_geometry_mesh = std::move(geometry_meshes[i]);
+        geometry_primitive.raytrace         = Geometry_raytrace{*geometry_primitive.source_geometry.get()};
+        geometry_primitive.build_lod_chain(build_info);
+    }
+}
 
 } // namespace erhe::primitive
@@ -5,7 +5,12 @@
 
 #include <memory>
 #include <optional>
+#include <span>
+#include <vector>
 
+namespace erhe::concurrency {
+    class Thread_pool;
+}
 namespace erhe::geometry {
     class Geometry;
 }
@@ -34,6 +39,14 @@ public:
     std::unique_ptr<erhe::raytrace::IGeometry> rt_geometry     {};
 };
 
+// Reduced detail version of Geometry_primitive::gl_geometry_mesh
+class Lod_mesh
+{
+public:
+    Geometry_mesh gl_geometry_mesh{};
+    float         max_screen_size {0.0f}; // used when projected size in pixels is below this
+};
+
 class Geometry_primitive
 {
 public:
@@ -59,9 +72,18 @@ public:
         const Normal_style normal_style
     );
 
+    // Builds lods from source_geometry as specified by build_info.lod.
+    // Stops early when simplification no longer reduces triangle count.
+    void build_lod_chain(const Build_info& build_info);
+
+    // Returns gl_geometry_mesh, or the lowest detail lod mesh which is
+    // allowed for the projected bounding sphere diameter in pixels
+    [[nodiscard]] auto get_geometry_mesh(float screen_size) const -> const Geometry_mesh&;
+
     std::shared_ptr<erhe::geometry::Geometry> source_geometry {};
     Normal_style                              normal_style    {Normal_style::none};
     Geometry_mesh                             gl_geometry_mesh{};
+    std::vector<Lod_mesh>                     lods            {}; // decreasing detail
     Geometry_raytrace                         raytrace;
 };
 
@@ -74,4 +96,14 @@ public:
 
 [[nodiscard]] auto primitive_type(Primitive_mode primitive_mode) -> std::optional<gl::Primitive_type>;
 
+// Same as calling Geometry_primitive::build_from_geometry() for each geometry
+// primitive, except that gl geometry meshes are built in parallel using
+// make_geometry_meshes().
+void build_from_geometry(
+    std::span<const std::shared_ptr<Geometry_primitive>> geometry_primitives,
+    const Build_info&                                    build_info,
+    Normal_style                                         normal_style,
+    erhe::concurrency::Thread_pool*                      thread_pool
+);
+
 } // namespace erhe::primitive
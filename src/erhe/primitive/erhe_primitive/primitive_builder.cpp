@@ -5,8 +5,10 @@
 #include "erhe_primitive/buffer_sink.hpp"
 #include "erhe_primitive/buffer_writer.hpp"
 #include "erhe_primitive/index_range.hpp"
+#include "erhe_primitive/mesh_optimizer.hpp"
 #include "erhe_primitive/primitive_log.hpp"
 #include "erhe_primitive/geometry_mesh.hpp"
+#include "erhe_concurrency/parallel_for.hpp"
 #include "erhe_geometry/geometry.hpp"
 #include "erhe_geometry/property_map.hpp"
 #include "erhe_gl/enum_string_functions.hpp"
@@ -18,6 +20,8 @@
 
 #include <glm/glm.hpp>
 
+#include <optional>
+
 namespace erhe::primitive
 {
 
@@ -46,7 +50,8 @@ using mat4 = glm::mat4;
 Build_context_root::Build_context_root(
     const erhe::geometry::Geometry& geometry,
     const Build_info&               build_info,
-    Geometry_mesh*                  geometry_mesh
+    Geometry_mesh*                  geometry_mesh,
+    const bool                      allocate
 )
     : geometry          {geometry}
     , build_info        {build_info}
@@ -56,10 +61,21 @@ Build_context_root::Build_context_root(
 {
     ERHE_PROFILE_FUNCTION();
 
-    get_mesh_info         ();
-    get_vertex_attributes ();
-    allocate_vertex_buffer();
-    allocate_index_buffer ();
+    get_mesh_info        ();
+    get_vertex_attributes();
+
+    if (allocate) {
+        allocate_buffers();
+    }
+}
+
+void Build_context_root::allocate_buffers()
+{
+    // With welding, vertex buffer is allocated after welding, once vertex count is known
+    if (!build_info.weld_vertices) {
+        allocate_vertex_buffer();
+    }
+    allocate_index_buffer();
 }
 
 void Build_context_root::get_mesh_info()
@@ -123,6 +139,17 @@ void Build_context_root::get_mesh_info()
     }
 
     SPDLOG_LOGGER_INFO(log_primitive_builder, "Total {} vertices", total_vertex_count);
+
+    // Vertex count is known only now, so narrow index type is chosen here.
+    // Welding only reduces vertex count, so this is safe for welding, too.
+    index_type = build_info.buffer_info.index_type;
+    if (
+        build_info.buffer_info.narrow_index_type &&
+        (index_type == gl::Draw_elements_type::unsigned_int) &&
+        (total_vertex_count <= 0x10000u)
+    ) {
+        index_type = gl::Draw_elements_type::unsigned_short;
+    }
 }
 
 void Build_context_root::get_vertex_attributes()
@@ -163,8 +190,7 @@ void Build_context_root::allocate_index_buffer()
 
     Expects(total_index_count > 0);
 
-    const gl::Draw_elements_type index_type     {build_info.buffer_info.index_type};
-    const std::size_t            index_type_size{size_of_type(index_type)};
+    const std::size_t index_type_size{size_of_type(index_type)};
 
     log_primitive_builder->trace(
         "allocating index buffer "
@@ -279,19 +305,7 @@ void Primitive_builder::build(Geometry_mesh* geometry_mesh)
         m_normal_style,
         geometry_mesh
     };
-
-    const Primitive_types& primitive_types = m_build_info.primitive_types;
-    if (primitive_types.fill_triangles) {
-        build_context.build_polygon_fill();
-    }
-
-    if (primitive_types.edge_lines) {
-        build_context.build_edge_lines();
-    }
-
-    if (primitive_types.centroid_points) {
-        build_context.build_centroid_points();
-    }
+    build_context.build();
 }
 
 Build_context::Build_context(
@@ -311,6 +325,49 @@ Build_context::Build_context(
     root.calculate_bounding_volume(property_maps.point_locations);
 }
 
+Build_context::Build_context(
+    Build_context_root&& root_in,
+    const Normal_style   normal_style
+)
+    : root         {std::move(root_in)}
+    , normal_style {normal_style}
+    , vertex_writer{*this, root.build_info.buffer_info.buffer_sink}
+    , index_writer {*this, root.build_info.buffer_info.buffer_sink}
+    , property_maps{root.geometry, root.build_info.primitive_types, root.build_info.buffer_info.vertex_format}
+{
+    Expects(property_maps.point_locations != nullptr);
+
+    root.calculate_bounding_volume(property_maps.point_locations);
+}
+
+void Build_context::build(const bool allocate_welded_vertex_buffer)
+{
+    const Build_info&      build_info      = root.build_info;
+    const Primitive_types& primitive_types = build_info.primitive_types;
+    if (primitive_types.fill_triangles) {
+        build_polygon_fill();
+    }
+
+    if (primitive_types.edge_lines) {
+        build_edge_lines();
+    }
+
+    if (primitive_types.centroid_points) {
+        build_centroid_points();
+    }
+
+    if (build_info.weld_vertices) {
+        weld_vertices();
+        if (allocate_welded_vertex_buffer) {
+            root.allocate_vertex_buffer();
+        }
+    }
+
+    if (build_info.optimize_vertex_cache && primitive_types.fill_triangles) {
+        optimize_triangle_order();
+    }
+}
+
 Build_context::~Build_context() noexcept
 {
     ERHE_VERIFY(vertex_index == root.total_vertex_count);
@@ -906,6 +963,95 @@ void Build_context::build_centroid_points()
     }
 }
 
+void Build_context::weld_vertices()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const std::size_t old_vertex_count = root.total_vertex_count;
+    std::vector<uint32_t> remap;
+    const std::size_t vertex_count = erhe::primitive::weld_vertices(
+        vertex_writer.vertex_data,
+        root.vertex_stride,
+        remap
+    );
+    ERHE_VERIFY(remap.size() == old_vertex_count);
+
+    for (std::size_t i = 0; i < root.total_index_count; ++i) {
+        index_writer.write_index(i, remap[index_writer.read_index(i)]);
+    }
+
+    for (uint32_t& vertex_id : root.geometry_mesh->corner_to_vertex_id) {
+        vertex_id = remap[vertex_id];
+    }
+
+    const Corner_id corner_id_end = root.geometry.get_corner_count();
+    for (corner_id = 0; corner_id < corner_id_end; ++corner_id) {
+        uint32_t vertex_id{0};
+        if (property_maps.corner_indices->maybe_get(corner_id, vertex_id)) {
+            property_maps.corner_indices->put(corner_id, remap[vertex_id]);
+        }
+    }
+
+    vertex_writer.vertex_data.resize(vertex_count * root.vertex_stride);
+    vertex_writer.vertex_data_span = gsl::make_span(vertex_writer.vertex_data);
+    vertex_index            = static_cast<uint32_t>(vertex_count);
+    root.total_vertex_count = vertex_count;
+
+    SPDLOG_LOGGER_TRACE(log_primitive_builder, "Welded {} vertices to {}", old_vertex_count, vertex_count);
+}
+
+void Build_context::optimize_triangle_order()
+{
+    ERHE_PROFILE_FUNCTION();
+
+    Geometry_mesh&    geometry_mesh  = *root.geometry_mesh;
+    const std::size_t first_index    = geometry_mesh.triangle_fill_indices.first_index;
+    const std::size_t index_count    = index_writer.triangle_indices_written;
+    const std::size_t triangle_count = index_count / 3;
+    const std::size_t vertex_count   = root.total_vertex_count;
+
+    std::vector<uint32_t> indices(index_count);
+    for (std::size_t i = 0; i < index_count; ++i) {
+        indices[i] = index_writer.read_index(first_index + i);
+    }
+
+    // Positions are taken from geometry, vertex buffer may not contain float positions
+    std::vector<vec3> vertex_positions(vertex_count, vec3{0.0f});
+    const Corner_id corner_id_end = root.geometry.get_corner_count();
+    for (corner_id = 0; corner_id < corner_id_end; ++corner_id) {
+        const Corner& corner = root.geometry.corners[corner_id];
+        property_maps.point_locations->maybe_get(corner.point_id, vertex_positions[geometry_mesh.corner_to_vertex_id[corner_id]]);
+    }
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+    const float acmr_before = get_average_cache_miss_ratio(indices, vertex_count);
+#endif
+
+    std::vector<uint32_t> triangle_order;
+    erhe::primitive::optimize_triangle_order(indices, vertex_count, vertex_positions, triangle_order);
+
+    for (std::size_t i = 0; i < index_count; ++i) {
+        index_writer.write_index(first_index + i, indices[i]);
+    }
+
+    const std::vector<uint32_t> old_primitive_id_to_polygon_id{
+        geometry_mesh.primitive_id_to_polygon_id.begin(),
+        geometry_mesh.primitive_id_to_polygon_id.begin() + triangle_count
+    };
+    for (std::size_t i = 0; i < triangle_count; ++i) {
+        geometry_mesh.primitive_id_to_polygon_id[i] = old_primitive_id_to_polygon_id[triangle_order[i]];
+    }
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+    const float acmr_after = get_average_cache_miss_ratio(indices, vertex_count);
+    SPDLOG_LOGGER_TRACE(
+        log_primitive_builder,
+        "Optimized {} triangles, vertex cache miss ratio {} -> {}",
+        triangle_count, acmr_before, acmr_after
+    );
+#endif
+}
+
 void Build_context_root::allocate_index_range(
     const gl::Primitive_type primitive_type,
     const std::size_t        index_count,
@@ -936,4 +1082,88 @@ auto make_geometry_mesh(
     return builder.build();
 }
 
+auto make_geometry_meshes(
+    const std::span<const erhe::geometry::Geometry* const> geometries,
+    const Build_info&                                      build_info,
+    const Normal_style                                     normal_style,
+    erhe::concurrency::Thread_pool*                        thread_pool
+) -> std::vector<Geometry_mesh>
+{
+    ERHE_PROFILE_FUNCTION();
+
+    const std::size_t geometry_count = geometries.size();
+    std::vector<Geometry_mesh> geometry_meshes(geometry_count);
+    if (thread_pool == nullptr) {
+        for (std::size_t i = 0; i < geometry_count; ++i) {
+            Expects(geometries[i] != nullptr);
+            Primitive_builder builder{*geometries[i], build_info, normal_style};
+            builder.build(&geometry_meshes[i]);
+        }
+        return geometry_meshes;
+    }
+
+    // Count vertices and indices, and lay out index ranges within each geometry mesh
+    std::vector<std::optional<Build_context_root>> roots(geometry_count);
+    erhe::concurrency::parallel_for_each_task(
+        *thread_pool,
+        std::size_t{0},
+        geometry_count,
+        [&](const std::size_t i) {
+            Expects(geometries[i] != nullptr);
+            roots[i].emplace(*geometries[i], build_info, &geometry_meshes[i], false);
+        }
+    );
+
+    // Buffer ranges are allocated in geometry order, so that the same input
+    // always produces the same buffer layout
+    for (std::optional<Build_context_root>& root : roots) {
+        root->allocate_buffers();
+    }
+
+    if (!build_info.weld_vertices) {
+        erhe::concurrency::parallel_for_each_task(
+            *thread_pool,
+            std::size_t{0},
+            geometry_count,
+            [&](const std::size_t i) {
+                Build_context build_context{std::move(roots[i].value()), normal_style};
+                build_context.build();
+            }
+        );
+        SPDLOG_LOGGER_TRACE(log_primitive_builder, "Built {} geometry meshes", geometry_count);
+        return geometry_meshes;
+    }
+
+    // With welding, vertex counts are known only after welding. Build
+    // contexts are kept until vertex buffer ranges have been allocated,
+    // again in geometry order. Vertex data is handed to buffer sink when
+    // the build context is destroyed.
+    std::vector<std::optional<Build_context>> build_contexts(geometry_count);
+    erhe::concurrency::parallel_for_each_task(
+        *thread_pool,
+        std::size_t{0},
+        geometry_count,
+        [&](const std::size_t i) {
+            build_contexts[i].emplace(std::move(roots[i].value()), normal_style);
+            build_contexts[i]->build(false);
+        }
+    );
+
+    for (std::optional<Build_context>& build_context : build_contexts) {
+        build_context->root.allocate_vertex_buffer();
+    }
+
+    erhe::concurrency::parallel_for_each_task(
+        *thread_pool,
+        std::size_t{0},
+        geometry_count,
+        [&](const std::size_t i) {
+            build_contexts[i].reset();
+        }
+    );
+
+    SPDLOG_LOGGER_TRACE(log_primitive_builder, "Built {} geometry meshes", geometry_count);
+    return geometry_meshes;
+}
+
 } // namespace erhe::primitive
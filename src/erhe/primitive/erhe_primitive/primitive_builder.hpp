@@ -14,6 +14,13 @@
 #include <glm/glm.hpp>
 
 #include <cstddef>
+#include <span>
+#include <vector>
+
+namespace erhe::concurrency
+{
+    class Thread_pool;
+}
 
 namespace erhe::graphics
 {
@@ -48,15 +55,19 @@ public:
 class Build_context_root
 {
 public:
+    // If allocate is false, allocate_buffers() must be called before
+    // Build_context is constructed.
     Build_context_root(
         const erhe::geometry::Geometry& geometry,
         const Build_info&               build_info,
-        Geometry_mesh*                  geometry_mesh
+        Geometry_mesh*                  geometry_mesh,
+        bool                            allocate = true
     );
 
     void get_mesh_info            ();
     void get_vertex_attributes    ();
     void calculate_bounding_volume(erhe::geometry::Property_map<erhe::geometry::Point_id, glm::vec3>* point_locations);
+    void allocate_buffers         ();
     void allocate_vertex_buffer   ();
     void allocate_index_buffer    ();
     void allocate_index_range(
@@ -75,6 +86,7 @@ public:
     std::size_t                          vertex_stride     {0};
     std::size_t                          total_vertex_count{0};
     std::size_t                          total_index_count {0};
+    gl::Draw_elements_type               index_type        {gl::Draw_elements_type::unsigned_int};
 };
 
 class Build_context
@@ -86,12 +98,25 @@ public:
         const Normal_style              normal_style,
         Geometry_mesh*                  geometry_mesh
     );
+    Build_context(
+        Build_context_root&& root,
+        const Normal_style   normal_style
+    );
     ~Build_context() noexcept;
 
+    // Builds all primitive types requested by build_info, followed by post-processing.
+    // With vertex welding and allocate_welded_vertex_buffer false, caller must
+    // call root.allocate_vertex_buffer() before build context is destroyed.
+    void build(bool allocate_welded_vertex_buffer = true);
+
     void build_polygon_fill   ();
     void build_edge_lines     ();
     void build_centroid_points();
 
+    // Post-processing, after all primitives have been built
+    void weld_vertices          ();
+    void optimize_triangle_order();
+
     Build_context_root root;
 
 private:
@@ -159,4 +184,20 @@ public:
     const Normal_style              normal_style = Normal_style::corner_normals
 ) -> Geometry_mesh;
 
+// Builds geometry meshes for many geometries at once. Buffer ranges for all
+// geometries are allocated first, in geometry order, and then vertex and
+// index data for each geometry is built in its own thread pool task, each
+// task writing only to its own ranges. With vertex welding, vertex counts
+// are known only after welding, so vertex buffer ranges are allocated in
+// geometry order after all geometries have been welded, before vertex data
+// is handed to the buffer sink. The buffer layout is the same for the same
+// input. Geometries are only read, and without thread pool this is the same
+// as calling make_geometry_mesh() for each.
+[[nodiscard]] auto make_geometry_meshes(
+    std::span<const erhe::geometry::Geometry* const> geometries,
+    const Build_info&                                build_info,
+    const Normal_style                               normal_style = Normal_style::corner_normals,
+    erhe::concurrency::Thread_pool*                  thread_pool  = nullptr
+) -> std::vector<Geometry_mesh>;
+
 } // namespace erhe::primitive
@@ -25,10 +25,11 @@ public:
 
     [[nodiscard]] auto is_valid() -> bool;
 
-    const erhe::graphics::Vertex_attribute* attribute{nullptr};
-    gl::Vertex_attrib_type                  data_type{gl::Vertex_attrib_type::float_};
-    std::size_t                             offset   {std::numeric_limits<std::size_t>::max()};
-    std::size_t                             size     {0};
+    const erhe::graphics::Vertex_attribute*           attribute{nullptr};
+    gl::Vertex_attrib_type                            data_type{gl::Vertex_attrib_type::float_};
+    erhe::graphics::Vertex_attribute::Encoding        encoding {erhe::graphics::Vertex_attribute::Encoding::none};
+    std::size_t                                       offset   {std::numeric_limits<std::size_t>::max()};
+    std::size_t                                       size     {0};
 };
 
 } // namespace erhe::primitive
@@ -48,6 +48,8 @@ auto Embree_buffer::allocate_bytes(
     const std::size_t alignment
 ) noexcept -> std::size_t
 {
+    const std::lock_guard<std::mutex> lock{m_allocate_mutex};
+
     while ((m_next_free_byte % alignment) != 0)
     {
         ++m_next_free_byte;
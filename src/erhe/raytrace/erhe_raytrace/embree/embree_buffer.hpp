@@ -4,6 +4,7 @@
 
 #include <embree3/rtcore.h>
 
+#include <mutex>
 #include <string>
 
 namespace erhe::raytrace
@@ -24,6 +25,7 @@ public:
     [[nodiscard]] auto debug_label   () const -> std::string_view override;
 
 private:
+    std::mutex  m_allocate_mutex;
     RTCBuffer   m_buffer;
     std::size_t m_capacity_byte_count{0};
     std::size_t m_next_free_byte     {0};
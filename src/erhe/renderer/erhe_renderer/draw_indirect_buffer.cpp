@@ -6,7 +6,9 @@
 #include "erhe_renderer/renderer_log.hpp"
 
 #include "erhe_gl/draw_indirect.hpp"
+#include "erhe_primitive/primitive.hpp"
 #include "erhe_scene/mesh.hpp"
+#include "erhe_scene/node.hpp"
 #include "erhe_profile/profile.hpp"
 #include "erhe_verify/verify.hpp"
 
@@ -14,9 +16,38 @@
 ////#   include <imgui/imgui.h>
 ////#endif
 
+#include <algorithm>
+#include <limits>
+
 namespace erhe::renderer
 {
 
+namespace {
+
+// Projected bounding sphere diameter in pixels
+[[nodiscard]] auto get_screen_size(
+    const Lod_selection&               lod_selection,
+    const glm::mat4&                   world_from_node,
+    const erhe::math::Bounding_sphere& bounding_sphere
+) -> float
+{
+    const glm::vec4 center = world_from_node * glm::vec4{bounding_sphere.center, 1.0f};
+    const float     w      = (lod_selection.clip_from_world * center).w;
+    if (w <= 0.0f) {
+        return std::numeric_limits<float>::max();
+    }
+    const float scale = std::max(
+        {
+            glm::length(glm::vec3{world_from_node[0]}),
+            glm::length(glm::vec3{world_from_node[1]}),
+            glm::length(glm::vec3{world_from_node[2]})
+        }
+    );
+    return 2.0f * bounding_sphere.radius * scale * lod_selection.pixel_scale / w;
+}
+
+} // anonymous namespace
+
 Draw_indirect_buffer::Draw_indirect_buffer(
     erhe::graphics::Instance& graphics_instance
 )
@@ -24,6 +55,8 @@ Draw_indirect_buffer::Draw_indirect_buffer(
 {
     auto ini = erhe::configuration::get_ini("erhe.ini", "renderer");
     ini->get("max_draw_count", m_max_draw_count);
+    ini->get("lod_enable",     m_lod_enable);
+    ini->get("lod_bias",       m_lod_bias);
 
     Multi_buffer::allocate(
         gl::Buffer_target::draw_indirect_buffer,
@@ -34,7 +67,9 @@ Draw_indirect_buffer::Draw_indirect_buffer(
 auto Draw_indirect_buffer::update(
     const gsl::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
     erhe::primitive::Primitive_mode                            primitive_mode,
-    const erhe::Item_filter&                                   filter
+    const erhe::Item_filter&                                   filter,
+    const gl::Draw_elements_type                               index_type,
+    const Lod_selection*                                       lod_selection
 ) -> Draw_indirect_buffer_range
 {
     ERHE_PROFILE_FUNCTION();
@@ -74,9 +109,24 @@ auto Draw_indirect_buffer::update(
             break;
         }
 
+        const erhe::scene::Node* node = mesh->get_node();
+        const bool use_lod = m_lod_enable && (lod_selection != nullptr) && (node != nullptr);
+        const glm::mat4 world_from_node = use_lod ? node->world_from_node() : glm::mat4{1.0f};
+
         for (auto& primitive : mesh->get_primitives()) {
-            const auto& geometry_mesh = primitive.geometry_primitive->gl_geometry_mesh;
-            const auto  index_range   = geometry_mesh.index_range(primitive_mode);
+            const erhe::primitive::Geometry_primitive& geometry_primitive = *primitive.geometry_primitive.get();
+            const erhe::primitive::Geometry_mesh*      geometry_mesh      = &geometry_primitive.gl_geometry_mesh;
+            if (geometry_mesh->index_type() != index_type) {
+                continue;
+            }
+            if (use_lod && !geometry_primitive.lods.empty()) {
+                const float screen_size = m_lod_bias * get_screen_size(*lod_selection, world_from_node, geometry_mesh->bounding_sphere);
+                const erhe::primitive::Geometry_mesh& lod_mesh = geometry_primitive.get_geometry_mesh(screen_size);
+                if (lod_mesh.index_range(primitive_mode).index_count > 0) {
+                    geometry_mesh = &lod_mesh;
+                }
+            }
+            const auto index_range = geometry_mesh->index_range(primitive_mode);
             if (index_range.index_count == 0) {
                 continue;
             }
@@ -92,9 +142,9 @@ auto Draw_indirect_buffer::update(
                 index_count = std::min(index_count, static_cast<uint32_t>(m_max_index_count));
             }
 
-            const uint32_t base_index  = geometry_mesh.base_index();
+            const uint32_t base_index  = geometry_mesh->base_index();
             const uint32_t first_index = static_cast<uint32_t>(index_range.first_index + base_index);
-            const uint32_t base_vertex = geometry_mesh.base_vertex();
+            const uint32_t base_vertex = geometry_mesh->base_vertex();
 
             const gl::Draw_elements_indirect_command draw_command{
                 index_count,
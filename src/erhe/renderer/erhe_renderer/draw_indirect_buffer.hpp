@@ -2,6 +2,11 @@
 
 #include "erhe_renderer/multi_buffer.hpp"
 #include "erhe_primitive/enums.hpp"
+#include "erhe_gl/wrapper_enums.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
 
 namespace erhe {
     class Item_filter;
@@ -21,6 +26,22 @@ public:
     std::size_t  draw_indirect_count{0};
 };
 
+// Index types that geometry meshes may use. Renderers issue one multi draw
+// call for each index type that is present.
+static constexpr std::array<gl::Draw_elements_type, 3> c_draw_elements_types{
+    gl::Draw_elements_type::unsigned_byte,
+    gl::Draw_elements_type::unsigned_short,
+    gl::Draw_elements_type::unsigned_int
+};
+
+// Camera parameters for choosing primitive level of detail by projected size
+class Lod_selection
+{
+public:
+    glm::mat4 clip_from_world{1.0f};
+    float     pixel_scale    {0.0f}; // 0.5 * viewport height * clip_from_camera[1][1]
+};
+
 class Draw_indirect_buffer
     : public Multi_buffer
 {
@@ -29,19 +50,26 @@ public:
         erhe::graphics::Instance& graphics_instance
     );
 
-    // Can discard return value
+    // Can discard return value.
+    // Only primitives with index_type are included, as each multi draw
+    // call uses single index type.
+    // Full detail meshes are used if lod_selection is nullptr.
     auto update(
         const gsl::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
         erhe::primitive::Primitive_mode                            primitive_mode,
-        const erhe::Item_filter&                            filter
+        const erhe::Item_filter&                                   filter,
+        gl::Draw_elements_type                                     index_type,
+        const Lod_selection*                                       lod_selection = nullptr
     ) -> Draw_indirect_buffer_range;
 
     //// void debug_properties_window();
 
 private:
-    bool m_max_index_count_enable{false};
-    int  m_max_index_count       {256};
-    int  m_max_draw_count        {8000};
+    bool  m_max_index_count_enable{false};
+    int   m_max_index_count       {256};
+    int   m_max_draw_count        {8000};
+    bool  m_lod_enable            {true};
+    float m_lod_bias              {1.0f};
 };
 
 } // namespace erhe::renderer
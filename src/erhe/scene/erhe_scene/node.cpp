@@ -17,16 +17,16 @@ namespace erhe::scene
 
 using namespace erhe;
 
-uint64_t Node_transforms::s_global_update_serial = 0;
+std::atomic<uint64_t> Node_transforms::s_global_update_serial{0};
 
 auto Node_transforms::get_current_serial() -> uint64_t
 {
-    return s_global_update_serial;
+    return s_global_update_serial.load(std::memory_order_relaxed);
 }
 
 auto Node_transforms::get_next_serial() -> uint64_t
 {
-    return ++s_global_update_serial;
+    return s_global_update_serial.fetch_add(1, std::memory_order_relaxed) + 1;
 }
 
 Node_data::Node_data() = default;
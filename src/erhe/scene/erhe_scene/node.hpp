@@ -3,6 +3,7 @@
 #include "erhe_item/hierarchy.hpp"
 #include "erhe_scene/trs_transform.hpp"
 
+#include <atomic>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -35,7 +36,8 @@ public:
     static auto get_next_serial   () -> uint64_t;
 
 private:
-    static uint64_t s_global_update_serial;
+    // Scenes are updated in parallel by the editor
+    static std::atomic<uint64_t> s_global_update_serial;
 };
 
 class Node_data
@@ -108,6 +108,8 @@ void Forward_renderer::render(const Render_parameters& parameters)
     );
 
     gl::viewport(viewport.x, viewport.y, viewport.width, viewport.height);
+    erhe::renderer::Lod_selection  lod_selection;
+    erhe::renderer::Lod_selection* lod_selection_ptr{nullptr};
     if (camera != nullptr) {
         const auto range = m_camera_buffers.update(
             *camera->projection(),
@@ -116,6 +118,11 @@ void Forward_renderer::render(const Render_parameters& parameters)
             camera->get_exposure()
         );
         m_camera_buffers.bind(range);
+
+        const erhe::scene::Camera_projection_transforms projection_transforms = camera->projection_transforms(viewport);
+        lod_selection.clip_from_world = projection_transforms.clip_from_world.get_matrix();
+        lod_selection.pixel_scale     = 0.5f * static_cast<float>(viewport.height) * projection_transforms.clip_from_camera.get_matrix()[1][1];
+        lod_selection_ptr = &lod_selection;
     }
 
     if (!m_graphics_instance.info.use_bindless_texture) {
@@ -198,23 +205,25 @@ void Forward_renderer::render(const Render_parameters& parameters)
                 continue;
             }
 
-            const auto primitive_range            = m_primitive_buffers.update(meshes, filter, parameters.primitive_settings);
-            const auto draw_indirect_buffer_range = m_draw_indirect_buffers.update(meshes, primitive_mode, filter);
-            if (draw_indirect_buffer_range.draw_indirect_count == 0) {
-                continue;
-            }
-            m_primitive_buffers.bind(primitive_range);
-            m_draw_indirect_buffers.bind(draw_indirect_buffer_range.range);
-
-            {
-                //ERHE_PROFILE_SCOPE("mdi");
-                gl::multi_draw_elements_indirect(
-                    pipeline.data.input_assembly.primitive_topology,
-                    parameters.index_type,
-                    reinterpret_cast<const void *>(draw_indirect_buffer_range.range.first_byte_offset),
-                    static_cast<GLsizei>(draw_indirect_buffer_range.draw_indirect_count),
-                    static_cast<GLsizei>(sizeof(gl::Draw_elements_indirect_command))
-                );
+            for (const gl::Draw_elements_type index_type : erhe::renderer::c_draw_elements_types) {
+                const auto draw_indirect_buffer_range = m_draw_indirect_buffers.update(meshes, primitive_mode, filter, index_type, lod_selection_ptr);
+                if (draw_indirect_buffer_range.draw_indirect_count == 0) {
+                    continue;
+                }
+                const auto primitive_range = m_primitive_buffers.update(meshes, filter, parameters.primitive_settings, index_type);
+                m_primitive_buffers.bind(primitive_range);
+                m_draw_indirect_buffers.bind(draw_indirect_buffer_range.range);
+
+                {
+                    //ERHE_PROFILE_SCOPE("mdi");
+                    gl::multi_draw_elements_indirect(
+                        pipeline.data.input_assembly.primitive_topology,
+                        index_type,
+                        reinterpret_cast<const void *>(draw_indirect_buffer_range.range.first_byte_offset),
+                        static_cast<GLsizei>(draw_indirect_buffer_range.draw_indirect_count),
+                        static_cast<GLsizei>(sizeof(gl::Draw_elements_indirect_command))
+                    );
+                }
             }
         }
 
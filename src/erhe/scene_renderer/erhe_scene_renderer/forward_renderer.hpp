@@ -48,8 +48,6 @@ public:
     class Render_parameters
     {
     public:
-        gl::Draw_elements_type                                             index_type       {gl::Draw_elements_type::unsigned_int};
-
         const glm::vec3                                                    ambient_light    {0.0f};
         const erhe::scene::Camera*                                         camera           {nullptr};
         const Light_projections*                                           light_projections{nullptr};
@@ -71,6 +71,7 @@ auto Primitive_buffer::update(
     const gsl::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
     const erhe::Item_filter&                                   filter,
     const Primitive_interface_settings&                        settings,
+    const gl::Draw_elements_type                               index_type,
     bool                                                       use_id_ranges
 ) -> erhe::renderer::Buffer_range
 {
@@ -133,6 +134,12 @@ auto Primitive_buffer::update(
 
         std::size_t mesh_primitive_index{0};
         for (const auto& primitive : mesh->get_primitives()) {
+            const auto& geometry_mesh = primitive.geometry_primitive->gl_geometry_mesh;
+            if (geometry_mesh.index_type() != index_type) {
+                ++mesh_primitive_index;
+                continue;
+            }
+
             if ((m_writer.write_offset + entry_size) > m_writer.write_end) {
                 log_render->critical("primitive buffer capacity {} exceeded", buffer.capacity_byte_count());
                 ERHE_FATAL("primitive buffer capacity exceeded");
@@ -147,7 +154,6 @@ auto Primitive_buffer::update(
             ////     m_writer.write_offset
             //// );
 
-            const auto&    geometry_mesh = primitive.geometry_primitive->gl_geometry_mesh;
             const uint32_t count         = static_cast<uint32_t>(geometry_mesh.triangle_fill_indices.index_count);
             const uint32_t power_of_two  = erhe::math::next_power_of_two(count);
             const uint32_t mask          = power_of_two - 1;
@@ -196,12 +202,13 @@ auto Primitive_buffer::update(
                         .offset          = m_id_offset,
                         .length          = count,
                         .mesh            = mesh.get(),
-                        .primitive_index = mesh_primitive_index++
+                        .primitive_index = mesh_primitive_index
                     }
                 );
 
                 m_id_offset += count;
             }
+            ++mesh_primitive_index;
         }
     }
 
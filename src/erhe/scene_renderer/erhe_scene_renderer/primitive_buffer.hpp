@@ -1,5 +1,6 @@
 #pragma once
 
+#include "erhe_gl/wrapper_enums.hpp"
 #include "erhe_graphics/shader_resource.hpp"
 #include "erhe_renderer/multi_buffer.hpp"
 
@@ -108,10 +109,13 @@ public:
 
     using Mesh_layer_collection = std::vector<const erhe::scene::Mesh_layer*>;
 
+    // Only primitives with index_type are included, matching
+    // erhe::renderer::Draw_indirect_buffer::update()
     auto update(
         const gsl::span<const std::shared_ptr<erhe::scene::Mesh>>& meshes,
         const erhe::Item_filter&                                   filter,
         const Primitive_interface_settings&                        settings,
+        gl::Draw_elements_type                                     index_type,
         bool                                                       use_id_ranges = false
     ) -> erhe::renderer::Buffer_range;
 
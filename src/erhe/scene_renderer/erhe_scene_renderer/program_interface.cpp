@@ -174,6 +174,7 @@ auto Program_interface::make_prototype(
     const std::filesystem::path vs_path = shader_path / std::filesystem::path(create_info.name + ".vert");
 
     create_info.vertex_attribute_mappings = &attribute_mappings,
+    create_info.vertex_format             = vertex_format,
     create_info.fragment_outputs          = &fragment_outputs,
     create_info.struct_types.push_back(&material_interface.material_struct);
     create_info.struct_types.push_back(&light_interface.light_struct);
@@ -47,6 +47,7 @@ public:
 
     erhe::graphics::Fragment_outputs          fragment_outputs;
     erhe::graphics::Vertex_attribute_mappings attribute_mappings;
+    const erhe::graphics::Vertex_format*      vertex_format{nullptr}; // set before making programs, if it has encoded attributes
 
     Camera_interface    camera_interface;
     Joint_interface     joint_interface;
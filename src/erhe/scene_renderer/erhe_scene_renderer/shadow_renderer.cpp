@@ -33,6 +33,19 @@ using erhe::graphics::Color_blend_state;
 
 static constexpr std::string_view c_shadow_renderer_initialize_component{"Shadow_renderer::initialize_component()"};
 
+namespace {
+
+// Buffer ranges for primitives of one index type, drawn with one multi draw call
+class Index_type_draw
+{
+public:
+    gl::Draw_elements_type                     index_type;
+    erhe::renderer::Buffer_range               primitive_range;
+    erhe::renderer::Draw_indirect_buffer_range draw_indirect_buffer_range;
+};
+
+} // anonymous namespace
+
 Shadow_renderer::Shadow_renderer(
     erhe::graphics::Instance& graphics_instance,
     Program_interface&        program_interface
@@ -176,16 +189,27 @@ auto Shadow_renderer::render(const Render_parameters& parameters) -> bool
 
     log_shadow_renderer->trace("Rendering shadow map to '{}'", parameters.texture->debug_label());
 
+    std::vector<Index_type_draw> draws;
+    draws.reserve(erhe::renderer::c_draw_elements_types.size());
     for (const auto& meshes : mesh_spans) {
-        const auto primitive_range = m_primitive_buffers.update(meshes, shadow_filter, Primitive_interface_settings{});
-        const auto draw_indirect_buffer_range = m_draw_indirect_buffers.update(
-            meshes,
-            erhe::primitive::Primitive_mode::polygon_fill,
-            shadow_filter
-        );
-        if (draw_indirect_buffer_range.draw_indirect_count > 0) {
-            m_primitive_buffers.bind(primitive_range);
-            m_draw_indirect_buffers.bind(draw_indirect_buffer_range.range);
+        draws.clear();
+        for (const gl::Draw_elements_type index_type : erhe::renderer::c_draw_elements_types) {
+            const auto draw_indirect_buffer_range = m_draw_indirect_buffers.update(
+                meshes,
+                erhe::primitive::Primitive_mode::polygon_fill,
+                shadow_filter,
+                index_type
+            );
+            if (draw_indirect_buffer_range.draw_indirect_count == 0) {
+                continue;
+            }
+            draws.push_back(
+                Index_type_draw{
+                    .index_type                 = index_type,
+                    .primitive_range            = m_primitive_buffers.update(meshes, shadow_filter, Primitive_interface_settings{}, index_type),
+                    .draw_indirect_buffer_range = draw_indirect_buffer_range
+                }
+            );
         }
 
         for (const auto& light : lights) {
@@ -221,23 +245,25 @@ auto Shadow_renderer::render(const Render_parameters& parameters) -> bool
                 );
             }
 
-            if (draw_indirect_buffer_range.draw_indirect_count == 0) {
+            if (draws.empty()) {
                 continue;
             }
 
             const auto control_range = m_light_buffers.update_control(light_index);
             m_light_buffers.bind_control_buffer(control_range);
 
-            {
+            for (const Index_type_draw& draw : draws) {
                 static constexpr std::string_view c_id_mdi{"mdi"};
 
                 ERHE_PROFILE_SCOPE("mdi");
                 //ERHE_PROFILE_GPU_SCOPE(c_id_mdi);
+                m_primitive_buffers.bind(draw.primitive_range);
+                m_draw_indirect_buffers.bind(draw.draw_indirect_buffer_range.range);
                 gl::multi_draw_elements_indirect(
                     pipeline.data.input_assembly.primitive_topology,
-                    parameters.index_type,
-                    reinterpret_cast<const void *>(draw_indirect_buffer_range.range.first_byte_offset),
-                    static_cast<GLsizei>(draw_indirect_buffer_range.draw_indirect_count),
+                    draw.index_type,
+                    reinterpret_cast<const void *>(draw.draw_indirect_buffer_range.range.first_byte_offset),
+                    static_cast<GLsizei>(draw.draw_indirect_buffer_range.draw_indirect_count),
                     static_cast<GLsizei>(sizeof(gl::Draw_elements_indirect_command))
                 );
             }
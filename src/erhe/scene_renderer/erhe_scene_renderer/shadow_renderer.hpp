@@ -51,7 +51,6 @@ public:
     {
     public:
         const erhe::graphics::Vertex_input_state*                  vertex_input_state;
-        gl::Draw_elements_type                                     index_type;
 
         const erhe::scene::Camera*                                 view_camera;
         const erhe::math::Viewport                                 view_camera_viewport;
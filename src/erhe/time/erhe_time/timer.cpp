@@ -61,6 +61,15 @@ void Timer::end()
     m_end_time = std::chrono::steady_clock::now();
 }
 
+void Timer::set(
+    const std::chrono::steady_clock::time_point start_time,
+    const std::chrono::steady_clock::time_point end_time
+)
+{
+    m_start_time = start_time;
+    m_end_time   = end_time;
+}
+
 Scoped_timer::Scoped_timer(Timer& timer)
     : m_timer{timer}
 {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <mutex>
 #include <optional>
@@ -23,6 +24,10 @@ public:
     [[nodiscard]] auto label   () const -> const char*;
     void begin();
     void end  ();
+    void set  (
+        std::chrono::steady_clock::time_point start_time,
+        std::chrono::steady_clock::time_point end_time
+    );
 
     static auto all_timers() -> std::vector<Timer*>;
 
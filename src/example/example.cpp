@@ -168,7 +168,6 @@ public:
 
         m_forward_renderer.render(
             erhe::scene_renderer::Forward_renderer::Render_parameters{
-                .index_type             = gl::Draw_elements_type::unsigned_int,
                 .ambient_light          = glm::vec3{0.1f, 0.1f, 0.1f},
                 .camera                 = m_camera.get(),
                 .light_projections      = &light_projections,